@@ -76,6 +76,8 @@ extern "C" {
 #ifdef __cplusplus
 }
 
+class SecFimcSw;
+
 class SecFimc
 {
 public:
@@ -95,7 +97,33 @@ public:
         MODE_MAX,
     };
 
+    /*
+     * BACKEND_AUTO uses the software backend when the node can't be opened.
+     * The software backend takes CPU addresses in set*Addr(), not physical
+     * ones, check isSwBackend() before handing buffers over.
+     */
+    enum BACKEND {
+        BACKEND_HW = 0,
+        BACKEND_SW,
+        BACKEND_AUTO,
+    };
+
 private:
+    /* last programmed parameters, to skip unchanged set*Params() calls */
+    struct paramCache {
+        bool                    valid;
+        unsigned int            width;
+        unsigned int            height;
+        unsigned int            cropX;
+        unsigned int            cropY;
+        unsigned int            cropWidth;
+        unsigned int            cropHeight;
+        int                     colorFormat;
+        int                     rotVal;
+        unsigned int            fimcWidth;  /* crop size after the size check */
+        unsigned int            fimcHeight;
+    };
+
     bool                        mFlagCreate;
     int                         mDev;
     int                         mFimcMode;
@@ -114,6 +142,15 @@ private:
     bool                        mFlagSetSrcParam;
     bool                        mFlagSetDstParam;
     bool                        mFlagStreamOn;
+    bool                        mFlagSetRotVal;
+    bool                        mFlagAsyncStream;
+    int                         mNumOfSrcBuf;
+    int                         mNumOfInFlight;
+    int                         mInFlightHead;
+    int                         mInFlightDst[MAX_DST_BUFFERS];
+
+    struct paramCache           mSrcParamCache;
+    struct paramCache           mDstParamCache;
 
     s5p_fimc_t                  mS5pFimc;
     struct v4l2_capability      mFimcCap;
@@ -121,13 +158,17 @@ private:
     SecBuffer                   mSrcBuffer;
     SecBuffer                   mDstBuffer[MAX_DST_BUFFERS];
 
+    SecFimcSw                  *mSwFimc;
+
 public:
     SecFimc();
     virtual ~SecFimc();
 
-    virtual bool create(enum DEV dev, enum MODE mode, int numOfBuf);
+    virtual bool create(enum DEV dev, enum MODE mode, int numOfBuf,
+                        enum BACKEND backend = BACKEND_HW);
     virtual bool destroy(void);
     bool flagCreate(void);
+    bool isSwBackend(void);
 
     int  getFd(void);
 
@@ -171,9 +212,26 @@ public:
     virtual bool setColorKey(bool enable = true, int colorKey = 0xff);
 
     virtual bool draw(int src_index, int dst_index);
+    virtual bool drawAsync(int src_index, int dst_index);
+    virtual int  waitDone(void);
 
 private:
+    bool m_createSw(int numOfBuf);
     bool m_streamOn(void);
+    bool m_streamOff(void);
+    bool m_setSrcBufNum(int num);
+    void m_setSrcBufSize(void);
+    bool m_hitParamCache(struct paramCache *cache,
+                         unsigned int width, unsigned int height,
+                         unsigned int cropX, unsigned int cropY,
+                         unsigned int cropWidth, unsigned int cropHeight,
+                         int colorFormat, int rotVal);
+    void m_setParamCache(struct paramCache *cache,
+                         unsigned int width, unsigned int height,
+                         unsigned int cropX, unsigned int cropY,
+                         unsigned int cropWidth, unsigned int cropHeight,
+                         int colorFormat, int rotVal,
+                         unsigned int fimcWidth, unsigned int fimcHeight);
     bool m_checkSrcSize(unsigned int width, unsigned int height,
                         unsigned int cropX, unsigned int cropY,
                         unsigned int *cropWidth, unsigned int *cropHeight,
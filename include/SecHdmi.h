@@ -47,6 +47,7 @@
 
 #include "../libhdmi/libsForhdmi/libedid/libedid.h"
 #include "../libhdmi/libsForhdmi/libcec/libcec.h"
+#include "../libhdmi/libsForhdmi/libcec/cec_engine.h"
 
 #include "../libhdmi/SecHdmi/SecHdmiCommon.h"
 #include "../libhdmi/SecHdmi/SecHdmiV4L2Utils.h"
@@ -83,12 +84,12 @@ private :
 
         private:
             sp<SecHdmi>         mSecHdmi;
-            Mutex               mThreadLoopLock;
             Mutex               mThreadControlLock;
             virtual bool        threadLoop();
             enum CECDeviceType  mDevtype;
             int                 mLaddr;
             int                 mPaddr;
+            struct CECEngine   *mEngine;
 
         public:
             CECThread(sp<SecHdmi> secHdmi)
@@ -97,7 +98,8 @@ private :
                 mSecHdmi(secHdmi),
                 mDevtype(CEC_DEVICE_PLAYER),
                 mLaddr(0),
-                mPaddr(0){
+                mPaddr(0),
+                mEngine(NULL){
             };
             virtual ~CECThread();
 
@@ -115,11 +117,23 @@ private :
     bool         mFlagLayerEnable[HDMI_LAYER_MAX];
     bool         mFlagHdmiStart[HDMI_LAYER_MAX];
 
-    int          mSrcWidth[HDMI_LAYER_MAX];
-    int          mSrcHeight[HDMI_LAYER_MAX];
-    int          mSrcColorFormat[HDMI_LAYER_MAX];
-    int          mHdmiResolutionWidth[HDMI_LAYER_MAX];
-    int          mHdmiResolutionHeight[HDMI_LAYER_MAX];
+    // the configuration a layer was last set up with. flush() only calls
+    // m_reset() when the requested one differs, so switching between the
+    // UI and video layers reuses their prepared state.
+    struct HdmiLayerConfig {
+        bool         prepared;
+        int          srcWidth;
+        int          srcHeight;
+        int          srcColorFormat;
+        int          dstWidth;
+        int          dstHeight;
+        int          resolutionWidth;
+        int          resolutionHeight;
+        bool         hwcMode;
+        unsigned int rotVal;
+    };
+
+    HdmiLayerConfig mLayerConfig[HDMI_LAYER_MAX];
 
     int          mHdmiDstWidth;
     int          mHdmiDstHeight;
@@ -165,8 +179,6 @@ private :
 
     int          mDstWidth[HDMI_LAYER_MAX];
     int          mDstHeight[HDMI_LAYER_MAX];
-    int          mPrevDstWidth[HDMI_LAYER_MAX];
-    int          mPrevDstHeight[HDMI_LAYER_MAX];
 
     int          mDefaultFBFd;
     int          mDisplayWidth;
@@ -205,6 +217,10 @@ public :
 
 private:
 
+    void        m_getLayerConfig(int w, int h, int colorFormat, int hdmiLayer, int hwcLayer,
+                                 HdmiLayerConfig *config);
+    bool        m_layerPrepared(int hdmiLayer, const HdmiLayerConfig *config);
+    void        m_invalidateLayers(void);
     bool        m_reset(int w, int h, int colorFormat, int hdmiLayer, int hwcLayer);
     bool        m_startHdmi(int hdmiLayer, unsigned int num_of_plane);
     bool        m_startHdmi(int hdmiLayer);
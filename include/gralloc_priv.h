@@ -72,19 +72,6 @@ struct private_module_t {
     };
 };
 
-#ifdef USE_PARTIAL_FLUSH
-struct private_handle_rect {
-    int handle;
-    int stride;
-    int l;
-    int t;
-    int w;
-    int h;
-    int locked;
-    struct private_handle_rect *next;
-};
-#endif
-
 #ifdef __cplusplus
 struct private_handle_t : public native_handle
 {
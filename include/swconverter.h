@@ -480,4 +480,53 @@ void csc_RGBA8888_to_YUV420SP_NEON(
     unsigned int width,
     unsigned int height);
 
+/*
+ * Converts ARGB8888 to NV12T
+ * Y and UV are written directly to 64x32 tiles without a linear copy
+ *
+ * @param y_dst
+ *   Y plane address of NV12T[out]
+ *
+ * @param uv_dst
+ *   UV plane address of NV12T[out]
+ *
+ * @param rgb_src
+ *   Address of ARGB8888[in]
+ *
+ * @param width
+ *   Width of ARGB8888[in]
+ *   it should be even
+ *
+ * @param height
+ *   Height of ARGB8888[in]
+ *   it should be even
+ */
+void csc_ARGB8888_to_NV12T(
+    unsigned char *y_dst,
+    unsigned char *uv_dst,
+    unsigned char *rgb_src,
+    unsigned int width,
+    unsigned int height);
+
+void csc_ARGB8888_to_NV12T_NEON(
+    unsigned char *y_dst,
+    unsigned char *uv_dst,
+    unsigned char *rgb_src,
+    unsigned int width,
+    unsigned int height);
+
+void csc_RGBA8888_to_NV12T(
+    unsigned char *y_dst,
+    unsigned char *uv_dst,
+    unsigned char *rgb_src,
+    unsigned int width,
+    unsigned int height);
+
+void csc_RGBA8888_to_NV12T_NEON(
+    unsigned char *y_dst,
+    unsigned char *uv_dst,
+    unsigned char *rgb_src,
+    unsigned int width,
+    unsigned int height);
+
 #endif /*COLOR_SPACE_CONVERTOR_H_*/
@@ -18,7 +18,8 @@ LOCAL_PATH:= $(call my-dir)
 include $(CLEAR_VARS)
 
 LOCAL_PRELINK_MODULE := false
-LOCAL_SHARED_LIBRARIES := liblog libutils libcutils
+LOCAL_SHARED_LIBRARIES := liblog libutils libcutils libswscaler
+LOCAL_STATIC_LIBRARIES := libswconverter
 ifeq ($(BOARD_SUPPORT_SYSMMU),true)
 LOCAL_SHARED_LIBRARIES+= libMali
 endif
@@ -46,7 +47,9 @@ LOCAL_C_INCLUDES := \
 	$(LOCAL_PATH)/../include \
 	framework/base/include
 
-LOCAL_SRC_FILES := SecFimc.cpp
+LOCAL_SRC_FILES := \
+	SecFimc.cpp \
+	SecFimcSw.cpp
 
 LOCAL_MODULE_TAGS := eng
 LOCAL_MODULE := libfimc
@@ -33,6 +33,7 @@
 #include <cutils/log.h>
 
 #include "SecFimc.h"
+#include "SecFimcSw.h"
 
 #define  FIMC2_DEV_NAME  "/dev/video2"
 
@@ -534,6 +535,8 @@ SecFimc::SecFimc()
 {
     memset(&mFimcCap, 0, sizeof(struct v4l2_capability));
     memset(&mS5pFimc, 0, sizeof(s5p_fimc_t));
+    memset(&mSrcParamCache, 0, sizeof(mSrcParamCache));
+    memset(&mDstParamCache, 0, sizeof(mDstParamCache));
 
     mRotVal = 0;
     mFlipVal=0; //yqf test	
@@ -542,6 +545,11 @@ SecFimc::SecFimc()
     mHwVersion = 0;
     mGlobalAlpha = 0x0;
     mFlagStreamOn = false;
+    mFlagSetRotVal = false;
+    mFlagAsyncStream = false;
+    mNumOfSrcBuf = 0;
+    mNumOfInFlight = 0;
+    mInFlightHead = 0;
     mFlagSetSrcParam = false;
     mFlagSetDstParam = false;
     mFlagGlobalAlpha = false;
@@ -551,6 +559,7 @@ SecFimc::SecFimc()
     mFd = 0;
     mDev = 0;
     mColorKey = 0x0;
+    mSwFimc = NULL;
 }
 
 SecFimc::~SecFimc()
@@ -562,7 +571,7 @@ SecFimc::~SecFimc()
     }
 }
 
-bool SecFimc::create(enum DEV dev, enum MODE mode, int numOfBuf)
+bool SecFimc::create(enum DEV dev, enum MODE mode, int numOfBuf, enum BACKEND backend)
 {
     if (mFlagCreate == true) {
         LOGE("%s::Already Created fail", __func__);
@@ -595,10 +604,19 @@ bool SecFimc::create(enum DEV dev, enum MODE mode, int numOfBuf)
     }
 
     mNumOfBuf = numOfBuf;
+    /*
+     * draw() converts one frame at a time from a single source buffer.
+     * In M2M mode drawAsync() raises this to one source buffer per
+     * destination buffer when it starts its stream, see m_setSrcBufNum().
+     */
+    mNumOfSrcBuf = 1;
 
     for (int i = 0; i < MAX_DST_BUFFERS; i++)
         mDstBuffer[i] = zeroBuf;
 
+    if (backend == BACKEND_SW)
+        return m_createSw(numOfBuf);
+
 #ifdef BOARD_USE_V4L2
     switch(mDev) {
     case DEV_0:
@@ -624,8 +642,13 @@ bool SecFimc::create(enum DEV dev, enum MODE mode, int numOfBuf)
 
     mFd = open(node, O_RDWR);
     if (mFd < 0) {
-        LOGE("%s::open(%s) failed", __func__, node);
         mFd = 0;
+        if (backend == BACKEND_AUTO) {
+            LOGW("%s::open(%s) failed (%s), use the software backend",
+                    __func__, node, strerror(errno));
+            return m_createSw(numOfBuf);
+        }
+        LOGE("%s::open(%s) failed", __func__, node);
         goto err;
     }
 
@@ -711,18 +734,17 @@ bool SecFimc::destroy()
         return false;
     }
 
-    if (mFlagStreamOn == true) {
-        if (fimc_v4l2_stream_off(mFd, V4L2_BUF_TYPE_SRC) < 0) {
-            LOGE("%s::fimc_v4l2_stream_off() failed", __func__);
-            return false;
-        }
-#ifdef BOARD_USE_V4L2
-        if (fimc_v4l2_stream_off(mFd, V4L2_BUF_TYPE_DST) < 0) {
-            LOGE("%s::fimc_v4l2_stream_off() failed", __func__);
-            return false;
-        }
-#endif
-        mFlagStreamOn = false;
+    if (mSwFimc != NULL) {
+        bool ret = mSwFimc->destroy();
+        delete mSwFimc;
+        mSwFimc = NULL;
+        mFlagCreate = false;
+        return ret;
+    }
+
+    if (m_streamOff() == false) {
+        LOGE("%s::m_streamOff() failed", __func__);
+        return false;
     }
 
     if (fimc_v4l2_clr_buf(mFd, V4L2_BUF_TYPE_SRC, V4L2_MEMORY_TYPE_SRC) < 0) {
@@ -745,6 +767,11 @@ bool SecFimc::destroy()
         close(mFd);
     mFd = 0;
 
+    mSrcParamCache.valid = false;
+    mDstParamCache.valid = false;
+    mFlagSetSrcParam = false;
+    mFlagSetDstParam = false;
+    mFlagSetRotVal = false;
     mFlagCreate = false;
 
     return true;
@@ -755,13 +782,24 @@ bool SecFimc::flagCreate(void)
     return mFlagCreate;
 }
 
+bool SecFimc::isSwBackend(void)
+{
+    return (mSwFimc != NULL);
+}
+
 int SecFimc::getFd(void)
 {
+    if (mSwFimc != NULL)
+        return mSwFimc->getFd();
+
     return mFd;
 }
 
 SecBuffer * SecFimc::getMemAddr(int index)
 {
+    if (mSwFimc != NULL)
+        return mSwFimc->getMemAddr(index);
+
     if (mFlagCreate == false) {
         LOGE("%s::Not yet created", __func__);
         return false;
@@ -772,6 +810,9 @@ SecBuffer * SecFimc::getMemAddr(int index)
 
 int SecFimc::getHWVersion(void)
 {
+    if (mSwFimc != NULL)
+        return mSwFimc->getHWVersion();
+
     if (mFlagCreate == false) {
         LOGE("%s::Not yet created", __func__);
         return false;
@@ -790,6 +831,9 @@ bool SecFimc::setSrcParams(unsigned int width, unsigned int height,
     LOGD("%s", __func__);
 #endif
 
+    if (mSwFimc != NULL)
+        return mSwFimc->setSrcParams(width, height, cropX, cropY, cropWidth, cropHeight, colorFormat, forceChange);
+
     if (mFlagCreate == false) {
         LOGE("%s::Not yet created", __func__);
         return false;
@@ -801,6 +845,18 @@ bool SecFimc::setSrcParams(unsigned int width, unsigned int height,
         return false;
     }
 
+    if (m_hitParamCache(&mSrcParamCache, width, height, cropX, cropY,
+                        *cropWidth, *cropHeight, colorFormat, 0) == true) {
+        if (   forceChange == false
+            && (mSrcParamCache.fimcWidth != *cropWidth || mSrcParamCache.fimcHeight != *cropHeight)) {
+            LOGE("%s::invalid source params", __func__);
+            return false;
+        }
+        *cropWidth  = mSrcParamCache.fimcWidth;
+        *cropHeight = mSrcParamCache.fimcHeight;
+        return true;
+    }
+
     s5p_fimc_params_t *params = &(mS5pFimc.params);
 
     unsigned int fimcWidth  = *cropWidth;
@@ -831,8 +887,15 @@ bool SecFimc::setSrcParams(unsigned int width, unsigned int height,
         && (params->src.start_y == cropY)
         && (params->src.width == fimcWidth)
         && (params->src.height == fimcHeight)
-        && (params->src.color_space == (unsigned int)v4l2ColorFormat))
+        && (params->src.color_space == (unsigned int)v4l2ColorFormat)) {
+        m_setParamCache(&mSrcParamCache, width, height, cropX, cropY,
+                        *cropWidth, *cropHeight, colorFormat, 0, fimcWidth, fimcHeight);
+        *cropWidth  = fimcWidth;
+        *cropHeight = fimcHeight;
         return true;
+    }
+
+    mSrcParamCache.valid = false;
 
     params->src.full_width  = width;
     params->src.full_height = height;
@@ -855,11 +918,14 @@ bool SecFimc::setSrcParams(unsigned int width, unsigned int height,
         return false;
     }
 
-    if (fimc_v4l2_req_buf(mFd, 1, V4L2_BUF_TYPE_SRC, V4L2_MEMORY_TYPE_SRC) < 0) {
+    if (fimc_v4l2_req_buf(mFd, mNumOfSrcBuf, V4L2_BUF_TYPE_SRC, V4L2_MEMORY_TYPE_SRC) < 0) {
         LOGE("%s::fimc_v4l2_req_buf()[src] failed", __func__);
         return false;
     }
 
+    m_setParamCache(&mSrcParamCache, width, height, cropX, cropY,
+                    *cropWidth, *cropHeight, colorFormat, 0, fimcWidth, fimcHeight);
+
     *cropWidth  = fimcWidth;
     *cropHeight = fimcHeight;
 
@@ -872,6 +938,9 @@ bool SecFimc::getSrcParams(unsigned int *width, unsigned int *height,
                            unsigned int *cropWidth, unsigned int *cropHeight,
                            int *colorFormat)
 {
+    if (mSwFimc != NULL)
+        return mSwFimc->getSrcParams(width, height, cropX, cropY, cropWidth, cropHeight, colorFormat);
+
     struct v4l2_format fmt;
     struct v4l2_crop crop;
 
@@ -927,6 +996,9 @@ bool SecFimc::setSrcAddr(unsigned int physYAddr,
     LOGD("%s", __func__);
 #endif
 
+    if (mSwFimc != NULL)
+        return mSwFimc->setSrcAddr(physYAddr, physCbAddr, physCrAddr, colorFormat);
+
     if (mFlagCreate == false) {
         LOGE("%s::Not yet created", __func__);
         return false;
@@ -978,6 +1050,9 @@ bool SecFimc::setDstParams(unsigned int width, unsigned int height,
     LOGD("%s", __func__);
 #endif
 
+    if (mSwFimc != NULL)
+        return mSwFimc->setDstParams(width, height, cropX, cropY, cropWidth, cropHeight, colorFormat, forceChange);
+
     if (mFlagCreate == false) {
         LOGE("%s::Not yet created", __func__);
         return false;
@@ -989,6 +1064,18 @@ bool SecFimc::setDstParams(unsigned int width, unsigned int height,
         return false;
     }
 
+    if (m_hitParamCache(&mDstParamCache, width, height, cropX, cropY,
+                        *cropWidth, *cropHeight, colorFormat, mRotVal) == true) {
+        if (   forceChange == false
+            && (mDstParamCache.fimcWidth != *cropWidth || mDstParamCache.fimcHeight != *cropHeight)) {
+            LOGE("%s::Invalid destination params", __func__);
+            return false;
+        }
+        *cropWidth  = mDstParamCache.fimcWidth;
+        *cropHeight = mDstParamCache.fimcHeight;
+        return true;
+    }
+
     s5p_fimc_params_t *params = &(mS5pFimc.params);
 
     unsigned int fimcWidth  = *cropWidth;
@@ -1050,6 +1137,8 @@ bool SecFimc::setDstParams(unsigned int width, unsigned int height,
     params->dst.color_space = v4l2ColorFormat;
     dst_planes = (dst_planes == -1) ? 1 : dst_planes;
 
+    mDstParamCache.valid = false;
+
 #ifdef BOARD_USE_V4L2
     if (mFlagSetDstParam == true) {
         if (fimc_v4l2_clr_buf(mFd, V4L2_BUF_TYPE_DST, V4L2_MEMORY_TYPE_DST) < 0) {
@@ -1083,6 +1172,9 @@ bool SecFimc::setDstParams(unsigned int width, unsigned int height,
     }
 #endif
 
+    m_setParamCache(&mDstParamCache, width, height, cropX, cropY,
+                    *cropWidth, *cropHeight, colorFormat, mRotVal, fimcWidth, fimcHeight);
+
     *cropWidth  = fimcWidth;
     *cropHeight = fimcHeight;
 
@@ -1095,6 +1187,9 @@ bool SecFimc::getDstParams(unsigned int *width, unsigned int *height,
                            unsigned int *cropWidth, unsigned int *cropHeight,
                            int *colorFormat)
 {
+    if (mSwFimc != NULL)
+        return mSwFimc->getDstParams(width, height, cropX, cropY, cropWidth, cropHeight, colorFormat);
+
     struct v4l2_framebuffer fbuf;
     struct v4l2_format      fmt;
     struct v4l2_crop        crop;
@@ -1163,6 +1258,9 @@ bool SecFimc::setDstAddr(unsigned int physYAddr, unsigned int physCbAddr, unsign
     LOGD("%s", __func__);
 #endif
 
+    if (mSwFimc != NULL)
+        return mSwFimc->setDstAddr(physYAddr, physCbAddr, physCrAddr, buf_index);
+
     s5p_fimc_params_t *params = &(mS5pFimc.params);
 
     if (mFlagCreate == false) {
@@ -1205,6 +1303,9 @@ bool SecFimc::setDstAddr(unsigned int physYAddr, unsigned int physCbAddr, unsign
 //added yqf, test
 bool SecFimc::setFlipVal(unsigned int flipVal)
 {
+    if (mSwFimc != NULL)
+        return mSwFimc->setFlipVal(flipVal);
+
     struct v4l2_control vc;
 
     if (mFlagCreate == false) {
@@ -1240,6 +1341,9 @@ else if(flipVal==2){
 
 bool SecFimc::setRotVal(unsigned int rotVal)
 {
+    if (mSwFimc != NULL)
+        return mSwFimc->setRotVal(rotVal);
+
     struct v4l2_control vc;
 
     if (mFlagCreate == false) {
@@ -1247,17 +1351,24 @@ bool SecFimc::setRotVal(unsigned int rotVal)
         return false;
     }
 
+    if (mFlagSetRotVal == true && mRotVal == (int)rotVal)
+        return true;
+
     if (fimc_v4l2_s_ctrl(mFd, V4L2_ROTATE, rotVal) < 0) {
         LOGE("%s::fimc_v4l2_s_ctrl(V4L2_ROTATE) failed", __func__);
         return false;
     }
 
     mRotVal = rotVal;
+    mFlagSetRotVal = true;
     return true;
 }
 
 bool SecFimc::setGlobalAlpha(bool enable, int alpha)
 {
+    if (mSwFimc != NULL)
+        return mSwFimc->setGlobalAlpha(enable, alpha);
+
     struct v4l2_framebuffer fbuf;
     struct v4l2_format fmt;
 
@@ -1316,6 +1427,9 @@ bool SecFimc::setGlobalAlpha(bool enable, int alpha)
 
 bool SecFimc::setLocalAlpha(bool enable)
 {
+    if (mSwFimc != NULL)
+        return mSwFimc->setLocalAlpha(enable);
+
     if (mFlagCreate == false) {
         LOGE("%s::Not yet created", __func__);
         return false;
@@ -1334,6 +1448,9 @@ bool SecFimc::setLocalAlpha(bool enable)
 
 bool SecFimc::setColorKey(bool enable, int colorKey)
 {
+    if (mSwFimc != NULL)
+        return mSwFimc->setColorKey(enable, colorKey);
+
     struct v4l2_framebuffer fbuf;
     struct v4l2_format fmt;
 
@@ -1392,6 +1509,9 @@ bool SecFimc::draw(int src_index, int dst_index)
     LOGD("%s", __func__);
 #endif
 
+    if (mSwFimc != NULL)
+        return mSwFimc->draw(src_index, dst_index);
+
     if (mFlagCreate == false) {
         LOGE("%s::Not yet created", __func__);
         return false;
@@ -1415,6 +1535,21 @@ bool SecFimc::draw(int src_index, int dst_index)
     dst_planes  = (dst_planes == -1) ? 1 : dst_planes;
 
 #ifdef BOARD_USE_V4L2
+    if (mFlagAsyncStream == true) {
+        if (0 < mNumOfInFlight) {
+            LOGE("%s::%d drawAsync() frames are not done", __func__, mNumOfInFlight);
+            return false;
+        }
+        if (m_streamOff() == false) {
+            LOGE("%s::m_streamOff failed", __func__);
+            return false;
+        }
+        if (m_setSrcBufNum(1) == false) {
+            LOGE("%s::m_setSrcBufNum(1) failed", __func__);
+            return false;
+        }
+    }
+
     if (mFlagStreamOn == false) {
         if (m_streamOn() == false) {
             LOGE("%s::m_streamOn failed", __func__);
@@ -1473,6 +1608,179 @@ err :
     return true;
 }
 
+/*
+ * Queue one conversion and return without waiting for it. Up to
+ * numOfBuf frames are kept in flight in M2M mode,
+ * waitDone() returns the destination index of the oldest one.
+ * The overlay (non M2M) mode has no queue, the frame is drawn at once.
+ */
+bool SecFimc::drawAsync(int src_index, int dst_index)
+{
+#ifdef DEBUG_LIB_FIMC
+    LOGD("%s", __func__);
+#endif
+
+    if (mSwFimc != NULL)
+        return mSwFimc->drawAsync(src_index, dst_index);
+
+    if (mFlagCreate == false) {
+        LOGE("%s::Not yet created", __func__);
+        return false;
+    }
+
+    if (mFlagSetSrcParam == false) {
+        LOGE("%s::mFlagSetSrcParam == false fail", __func__);
+        return false;
+    }
+
+    if (mFlagSetDstParam == false) {
+        LOGE("%s::mFlagSetDstParam == false fail", __func__);
+        return false;
+    }
+
+#ifdef BOARD_USE_V4L2
+    int numOfSrcBuf = mNumOfBuf;
+#else
+    int numOfSrcBuf = mNumOfSrcBuf;
+#endif
+
+    if (   src_index < 0 || numOfSrcBuf <= src_index
+        || dst_index < 0 || mNumOfBuf <= dst_index) {
+        LOGE("%s::invalid index (src : %d, dst : %d)", __func__, src_index, dst_index);
+        return false;
+    }
+
+    if (mNumOfBuf <= mNumOfInFlight) {
+        LOGE("%s::too many frames in flight (%d)", __func__, mNumOfInFlight);
+        return false;
+    }
+
+#ifdef BOARD_USE_V4L2
+    s5p_fimc_params_t *params = &(mS5pFimc.params);
+    int src_planes = m_getYuvPlanes(params->src.color_space);
+    int dst_planes = m_getYuvPlanes(params->dst.color_space);
+    src_planes  = (src_planes == -1) ? 1 : src_planes;
+    dst_planes  = (dst_planes == -1) ? 1 : dst_planes;
+
+    /* draw() keeps every destination buffer queued, restart the stream */
+    if (mFlagStreamOn == true && mFlagAsyncStream == false) {
+        if (m_streamOff() == false) {
+            LOGE("%s::m_streamOff failed", __func__);
+            return false;
+        }
+    }
+
+    if (mFlagStreamOn == false && m_setSrcBufNum(numOfSrcBuf) == false) {
+        LOGE("%s::m_setSrcBufNum(%d) failed", __func__, numOfSrcBuf);
+        return false;
+    }
+
+    m_setSrcBufSize();
+
+    if (fimc_v4l2_queue(mFd, &(mSrcBuffer), V4L2_BUF_TYPE_SRC, V4L2_MEMORY_TYPE_SRC, src_index, src_planes) < 0) {
+        LOGE("%s::fimc_v4l2_queue[src](index : %d) failed", __func__, src_index);
+        return false;
+    }
+
+    if (fimc_v4l2_queue(mFd, &(mDstBuffer[dst_index]), V4L2_BUF_TYPE_DST, V4L2_MEMORY_TYPE_DST, dst_index, dst_planes) < 0) {
+        LOGE("%s::fimc_v4l2_queue[dst](index : %d) failed", __func__, dst_index);
+        /*
+         * The source buffer is queued without a destination. A running
+         * stream would pair it with the next frame, so stop it and drop
+         * the frames in flight; otherwise clear the source queue.
+         */
+        if (mFlagStreamOn == true) {
+            if (0 < mNumOfInFlight)
+                LOGE("%s::%d frames in flight dropped", __func__, mNumOfInFlight);
+            m_streamOff();
+        } else {
+            m_setSrcBufNum(numOfSrcBuf);
+        }
+        return false;
+    }
+
+    if (mFlagStreamOn == false) {
+        mFlagStreamOn    = true;
+        mFlagAsyncStream = true;
+
+        if (   fimc_v4l2_stream_on(mFd, V4L2_BUF_TYPE_SRC) < 0
+            || fimc_v4l2_stream_on(mFd, V4L2_BUF_TYPE_DST) < 0) {
+            LOGE("%s::fimc_v4l2_stream_on() failed", __func__);
+            m_streamOff();
+            return false;
+        }
+    }
+#else
+    if (draw(src_index, dst_index) == false)
+        return false;
+#endif
+
+    mInFlightDst[(mInFlightHead + mNumOfInFlight) % MAX_DST_BUFFERS] = dst_index;
+    mNumOfInFlight++;
+
+    return true;
+}
+
+int SecFimc::waitDone(void)
+{
+#ifdef DEBUG_LIB_FIMC
+    LOGD("%s", __func__);
+#endif
+
+    if (mSwFimc != NULL)
+        return mSwFimc->waitDone();
+
+    int dst_index;
+
+    if (mNumOfInFlight <= 0) {
+        LOGE("%s::no frame in flight", __func__);
+        return -1;
+    }
+
+    dst_index = mInFlightDst[mInFlightHead];
+    mInFlightHead = (mInFlightHead + 1) % MAX_DST_BUFFERS;
+    mNumOfInFlight--;
+
+#ifdef BOARD_USE_V4L2
+    s5p_fimc_params_t *params = &(mS5pFimc.params);
+    int src_planes = m_getYuvPlanes(params->src.color_space);
+    int dst_planes = m_getYuvPlanes(params->dst.color_space);
+    int src_index;
+    src_planes  = (src_planes == -1) ? 1 : src_planes;
+    dst_planes  = (dst_planes == -1) ? 1 : dst_planes;
+
+    if (fimc_v4l2_dequeue(mFd, V4L2_BUF_TYPE_DST, V4L2_MEMORY_TYPE_DST, &dst_index, dst_planes) < 0) {
+        LOGE("%s::fimc_v4l2_dequeue[dst] failed", __func__);
+        m_streamOff();
+        return -1;
+    }
+
+    if (fimc_v4l2_dequeue(mFd, V4L2_BUF_TYPE_SRC, V4L2_MEMORY_TYPE_SRC, &src_index, src_planes) < 0) {
+        LOGE("%s::fimc_v4l2_dequeue[src] failed", __func__);
+        m_streamOff();
+        return -1;
+    }
+#endif
+
+    return dst_index;
+}
+
+bool SecFimc::m_createSw(int numOfBuf)
+{
+    mSwFimc = new SecFimcSw();
+
+    if (mSwFimc->create(numOfBuf) == false) {
+        LOGE("%s::SecFimcSw create failed", __func__);
+        delete mSwFimc;
+        mSwFimc = NULL;
+        return false;
+    }
+
+    mFlagCreate = true;
+
+    return true;
+}
+
 bool SecFimc::m_streamOn()
 {
 #ifdef DEBUG_LIB_FIMC
@@ -1486,21 +1794,7 @@ bool SecFimc::m_streamOn()
     src_planes = (src_planes == -1) ? 1 : src_planes;
     dst_planes = (dst_planes == -1) ? 1 : dst_planes;
 
-    if (params->src.color_space == V4L2_PIX_FMT_RGB32) {
-        mSrcBuffer.size.extS[0] = params->src.full_height * params->src.full_width * 4;
-
-    } else if (   (params->src.color_space == V4L2_PIX_FMT_NV12MT)
-               || (params->src.color_space == V4L2_PIX_FMT_NV12M)) {
-        mSrcBuffer.size.extS[0] = params->src.full_height * params->src.full_width;
-        mSrcBuffer.size.extS[1] = params->src.full_height * params->src.full_width / 2;
-    } else if (   (params->src.color_space == V4L2_PIX_FMT_YUV420)
-               || (params->src.color_space == V4L2_PIX_FMT_YUV420M)) {
-        mSrcBuffer.size.extS[0] = params->src.full_height * params->src.full_width;
-        mSrcBuffer.size.extS[1] = params->src.full_height * params->src.full_width / 4;
-        mSrcBuffer.size.extS[2] = params->src.full_height * params->src.full_width / 4;
-    } else {
-        mSrcBuffer.size.extS[0] = params->src.full_height * params->src.full_width * 2;
-    }
+    m_setSrcBufSize();
 
     if (fimc_v4l2_queue(mFd, &(mSrcBuffer), V4L2_BUF_TYPE_SRC, V4L2_MEMORY_TYPE_SRC, 0, src_planes) < 0) {
         LOGE("%s::fimc_v4l2_queue(index : %d) (mSrcBufNum : %d) failed", __func__, 0, 1);
@@ -1529,6 +1823,112 @@ bool SecFimc::m_streamOn()
     return true;
 }
 
+bool SecFimc::m_streamOff()
+{
+#ifdef DEBUG_LIB_FIMC
+    LOGD("%s", __func__);
+#endif
+
+    if (mFlagStreamOn == false)
+        return true;
+
+    mFlagStreamOn    = false;
+    mFlagAsyncStream = false;
+    mNumOfInFlight   = 0;
+    mInFlightHead    = 0;
+
+    if (fimc_v4l2_stream_off(mFd, V4L2_BUF_TYPE_SRC) < 0) {
+        LOGE("%s::fimc_v4l2_stream_off() failed", __func__);
+        return false;
+    }
+#ifdef BOARD_USE_V4L2
+    if (fimc_v4l2_stream_off(mFd, V4L2_BUF_TYPE_DST) < 0) {
+        LOGE("%s::fimc_v4l2_stream_off() failed", __func__);
+        return false;
+    }
+#endif
+    return true;
+}
+
+/* re-request the source buffers, which also drops any queued one */
+bool SecFimc::m_setSrcBufNum(int num)
+{
+#ifdef BOARD_USE_V4L2
+    if (fimc_v4l2_clr_buf(mFd, V4L2_BUF_TYPE_SRC, V4L2_MEMORY_TYPE_SRC) < 0) {
+        LOGE("%s::fimc_v4l2_clr_buf()[src] failed", __func__);
+        return false;
+    }
+
+    if (fimc_v4l2_req_buf(mFd, num, V4L2_BUF_TYPE_SRC, V4L2_MEMORY_TYPE_SRC) < 0) {
+        LOGE("%s::fimc_v4l2_req_buf()[src] failed", __func__);
+        return false;
+    }
+
+    mNumOfSrcBuf = num;
+#endif
+    return true;
+}
+
+void SecFimc::m_setSrcBufSize()
+{
+#ifdef BOARD_USE_V4L2
+    s5p_fimc_params_t *params = &(mS5pFimc.params);
+
+    if (params->src.color_space == V4L2_PIX_FMT_RGB32) {
+        mSrcBuffer.size.extS[0] = params->src.full_height * params->src.full_width * 4;
+
+    } else if (   (params->src.color_space == V4L2_PIX_FMT_NV12MT)
+               || (params->src.color_space == V4L2_PIX_FMT_NV12M)) {
+        mSrcBuffer.size.extS[0] = params->src.full_height * params->src.full_width;
+        mSrcBuffer.size.extS[1] = params->src.full_height * params->src.full_width / 2;
+    } else if (   (params->src.color_space == V4L2_PIX_FMT_YUV420)
+               || (params->src.color_space == V4L2_PIX_FMT_YUV420M)) {
+        mSrcBuffer.size.extS[0] = params->src.full_height * params->src.full_width;
+        mSrcBuffer.size.extS[1] = params->src.full_height * params->src.full_width / 4;
+        mSrcBuffer.size.extS[2] = params->src.full_height * params->src.full_width / 4;
+    } else {
+        mSrcBuffer.size.extS[0] = params->src.full_height * params->src.full_width * 2;
+    }
+#endif
+}
+
+bool SecFimc::m_hitParamCache(struct paramCache *cache,
+                              unsigned int width, unsigned int height,
+                              unsigned int cropX, unsigned int cropY,
+                              unsigned int cropWidth, unsigned int cropHeight,
+                              int colorFormat, int rotVal)
+{
+    return (   (cache->valid == true)
+            && (cache->width == width)
+            && (cache->height == height)
+            && (cache->cropX == cropX)
+            && (cache->cropY == cropY)
+            && (cache->cropWidth == cropWidth)
+            && (cache->cropHeight == cropHeight)
+            && (cache->colorFormat == colorFormat)
+            && (cache->rotVal == rotVal));
+}
+
+void SecFimc::m_setParamCache(struct paramCache *cache,
+                              unsigned int width, unsigned int height,
+                              unsigned int cropX, unsigned int cropY,
+                              unsigned int cropWidth, unsigned int cropHeight,
+                              int colorFormat, int rotVal,
+                              unsigned int fimcWidth, unsigned int fimcHeight)
+{
+    cache->width       = width;
+    cache->height      = height;
+    cache->cropX       = cropX;
+    cache->cropY       = cropY;
+    cache->cropWidth   = cropWidth;
+    cache->cropHeight  = cropHeight;
+    cache->colorFormat = colorFormat;
+    cache->rotVal      = rotVal;
+    cache->fimcWidth   = fimcWidth;
+    cache->fimcHeight  = fimcHeight;
+    cache->valid       = true;
+}
+
 bool SecFimc::m_checkSrcSize(unsigned int width, unsigned int height,
                              unsigned int cropX, unsigned int cropY,
                              unsigned int *cropWidth, unsigned int *cropHeight,
@@ -0,0 +1,1102 @@
+/*
+ * Copyright@ Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file      SecFimcSw.cpp
+ * \brief     software backend of the Fimc HAL MODULE
+ *
+ * Plain conversions (detile, NV12 copy/upscale, RGB to NV12) use the
+ * NEON kernels of libswconverter and libswscaler. Everything else
+ * (crop, downscale, rotation, flip, alpha) goes through a nearest
+ * neighbour path with precomputed row and column maps.
+ *
+ * Source and destination addresses are CPU addresses, as USERPTR
+ * buffers of the V4L2 node. Nothing is mapped from physical memory and
+ * no cache maintenance is needed.
+ */
+
+#define LOG_TAG "libfimc"
+#include <cutils/log.h>
+
+#include <stdlib.h>
+
+#include "SecFimcSw.h"
+#include "swscaler.h"
+
+extern "C" {
+#include "swconverter.h"
+}
+
+//#define DEBUG_LIB_FIMC
+
+#ifndef LOGD
+#define LOGE ALOGE
+#define LOGI ALOGI
+#define LOGV ALOGV
+#define LOGD ALOGD
+#define LOGW ALOGW
+#endif
+
+#define SW_ALIGN(x, a)      (((x) + (a) - 1) & ~((a) - 1))
+#define SW_MIN(x, y)        (((x) < (y)) ? (x) : (y))
+#define SW_MAX(x, y)        (((x) > (y)) ? (x) : (y))
+
+static inline bool is_tiled_fmt(unsigned int fmt)
+{
+    switch (fmt) {
+    case V4L2_PIX_FMT_NV12T:
+#ifdef BOARD_USE_V4L2
+    case V4L2_PIX_FMT_NV12MT:
+#endif
+        return true;
+    default:
+        return false;
+    }
+}
+
+static inline bool is_rgb_fmt(unsigned int fmt)
+{
+    return (fmt == V4L2_PIX_FMT_RGB32 || fmt == V4L2_PIX_FMT_RGB565);
+}
+
+/* multi planar aliases have the same memory layout per plane */
+static inline unsigned int linear_fmt(unsigned int fmt)
+{
+    switch (fmt) {
+#ifdef BOARD_USE_V4L2
+    case V4L2_PIX_FMT_NV12M:
+        return V4L2_PIX_FMT_NV12;
+    case V4L2_PIX_FMT_YUV420M:
+        return V4L2_PIX_FMT_YUV420;
+#endif
+    default:
+        return fmt;
+    }
+}
+
+static int get_planes(unsigned int fmt)
+{
+    switch (linear_fmt(fmt)) {
+    case V4L2_PIX_FMT_NV12:
+    case V4L2_PIX_FMT_NV21:
+    case V4L2_PIX_FMT_NV16:
+    case V4L2_PIX_FMT_NV61:
+        return 2;
+    case V4L2_PIX_FMT_YUV420:
+        return 3;
+    default:
+        return is_tiled_fmt(fmt) ? 2 : 1;
+    }
+}
+
+static unsigned int get_plane_size(unsigned int fmt, unsigned int width, unsigned int height, int plane)
+{
+    unsigned int frame_size = width * height;
+
+    if (is_tiled_fmt(fmt)) {
+        if (plane == 0)
+            return SW_ALIGN(width, 128) * SW_ALIGN(height, 32);
+        return SW_ALIGN(width, 128) * SW_ALIGN(height >> 1, 32);
+    }
+
+    switch (linear_fmt(fmt)) {
+    case V4L2_PIX_FMT_RGB32:
+        return frame_size << 2;
+    case V4L2_PIX_FMT_RGB565:
+    case V4L2_PIX_FMT_YUYV:
+    case V4L2_PIX_FMT_UYVY:
+        return frame_size << 1;
+    case V4L2_PIX_FMT_NV12:
+    case V4L2_PIX_FMT_NV21:
+        return (plane == 0) ? frame_size : (frame_size >> 1);
+    case V4L2_PIX_FMT_NV16:
+    case V4L2_PIX_FMT_NV61:
+        return frame_size;
+    case V4L2_PIX_FMT_YUV420:
+        return (plane == 0) ? frame_size : (frame_size >> 2);
+    default:
+        return 0;
+    }
+}
+
+/* fill the Cb/Cr addresses the caller left as 0, like SecFimc::setSrcAddr() */
+static void fill_plane_addr(SecBuffer *buf, unsigned int fmt, unsigned int width, unsigned int height)
+{
+    int planes = get_planes(fmt);
+
+    if (2 <= planes && buf->phys.extP[1] == 0)
+        buf->phys.extP[1] = buf->phys.extP[0] + get_plane_size(fmt, width, height, 0);
+
+    if (3 == planes && buf->phys.extP[2] == 0)
+        buf->phys.extP[2] = buf->phys.extP[1] + get_plane_size(fmt, width, height, 1);
+
+    for (int i = 0; i < 3; i++)
+        buf->virt.extP[i] = (char *)buf->phys.extP[i];
+}
+
+/* the NEON tiling kernels work on 16 pixel wide, even height frames */
+static inline bool is_tiled_size_ok(const SecFimcSw::swImage *img)
+{
+    return !(img->width & 15) && !(img->height & 1);
+}
+
+static inline int clip_255(int value)
+{
+    if (value < 0)
+        return 0;
+    if (255 < value)
+        return 255;
+    return value;
+}
+
+/* BT.601 limited range, the same coefficients as libswconverter */
+static inline void rgb_to_yuv(int *px)
+{
+    int r = px[0], g = px[1], b = px[2];
+
+    px[0] = ((( 66 * r) + (129 * g) + ( 25 * b) + 128) >> 8) +  16;
+    px[1] = (((-38 * r) - ( 74 * g) + (112 * b) + 128) >> 8) + 128;
+    px[2] = (((112 * r) - ( 94 * g) - ( 18 * b) + 128) >> 8) + 128;
+}
+
+static inline void yuv_to_rgb(int *px)
+{
+    int c = px[0] - 16, d = px[1] - 128, e = px[2] - 128;
+
+    px[0] = clip_255((298 * c           + 409 * e + 128) >> 8);
+    px[1] = clip_255((298 * c - 100 * d - 208 * e + 128) >> 8);
+    px[2] = clip_255((298 * c + 516 * d           + 128) >> 8);
+}
+
+/* px is {R, G, B, A} for RGB formats and {Y, Cb, Cr, 0xff} for YUV formats */
+static inline void read_pixel(const SecFimcSw::swImage *img, int x, int y, int *px)
+{
+    unsigned int w = img->width;
+    unsigned char *p;
+    unsigned char *c;
+    unsigned short v;
+
+    px[3] = 0xff;
+
+    switch (img->fmt) {
+    case V4L2_PIX_FMT_RGB32:
+        p = img->plane[0] + ((y * w + x) << 2);
+        px[0] = p[0];
+        px[1] = p[1];
+        px[2] = p[2];
+        px[3] = p[3];
+        break;
+    case V4L2_PIX_FMT_RGB565:
+        v = ((unsigned short *)img->plane[0])[y * w + x];
+        px[0] = ((v >> 8) & 0xf8) | (v >> 13);
+        px[1] = ((v >> 3) & 0xfc) | ((v >> 9) & 0x3);
+        px[2] = ((v << 3) & 0xf8) | ((v >> 2) & 0x7);
+        break;
+    case V4L2_PIX_FMT_YUYV:
+        p = img->plane[0] + ((y * w + (x & ~1)) << 1);
+        px[0] = p[(x & 1) << 1];
+        px[1] = p[1];
+        px[2] = p[3];
+        break;
+    case V4L2_PIX_FMT_UYVY:
+        p = img->plane[0] + ((y * w + (x & ~1)) << 1);
+        px[0] = p[((x & 1) << 1) + 1];
+        px[1] = p[0];
+        px[2] = p[2];
+        break;
+    case V4L2_PIX_FMT_NV12:
+    case V4L2_PIX_FMT_NV21:
+        px[0] = img->plane[0][y * w + x];
+        c = img->plane[1] + (y >> 1) * w + (x & ~1);
+        px[1] = (img->fmt == V4L2_PIX_FMT_NV12) ? c[0] : c[1];
+        px[2] = (img->fmt == V4L2_PIX_FMT_NV12) ? c[1] : c[0];
+        break;
+    case V4L2_PIX_FMT_NV16:
+    case V4L2_PIX_FMT_NV61:
+        px[0] = img->plane[0][y * w + x];
+        c = img->plane[1] + y * w + (x & ~1);
+        px[1] = (img->fmt == V4L2_PIX_FMT_NV16) ? c[0] : c[1];
+        px[2] = (img->fmt == V4L2_PIX_FMT_NV16) ? c[1] : c[0];
+        break;
+    case V4L2_PIX_FMT_YUV420:
+        px[0] = img->plane[0][y * w + x];
+        px[1] = img->plane[1][(y >> 1) * (w >> 1) + (x >> 1)];
+        px[2] = img->plane[2][(y >> 1) * (w >> 1) + (x >> 1)];
+        break;
+    default:
+        px[0] = px[1] = px[2] = 0;
+        break;
+    }
+}
+
+/* chroma of subsampled formats is taken from the even pixel */
+static inline void write_pixel(const SecFimcSw::swImage *img, int x, int y, const int *px)
+{
+    unsigned int w = img->width;
+    unsigned char *p;
+    unsigned char *c;
+
+    switch (img->fmt) {
+    case V4L2_PIX_FMT_RGB32:
+        p = img->plane[0] + ((y * w + x) << 2);
+        p[0] = px[0];
+        p[1] = px[1];
+        p[2] = px[2];
+        p[3] = px[3];
+        break;
+    case V4L2_PIX_FMT_RGB565:
+        ((unsigned short *)img->plane[0])[y * w + x] =
+            ((px[0] & 0xf8) << 8) | ((px[1] & 0xfc) << 3) | (px[2] >> 3);
+        break;
+    case V4L2_PIX_FMT_YUYV:
+        p = img->plane[0] + ((y * w + (x & ~1)) << 1);
+        p[(x & 1) << 1] = px[0];
+        if (!(x & 1)) {
+            p[1] = px[1];
+            p[3] = px[2];
+        }
+        break;
+    case V4L2_PIX_FMT_UYVY:
+        p = img->plane[0] + ((y * w + (x & ~1)) << 1);
+        p[((x & 1) << 1) + 1] = px[0];
+        if (!(x & 1)) {
+            p[0] = px[1];
+            p[2] = px[2];
+        }
+        break;
+    case V4L2_PIX_FMT_NV12:
+    case V4L2_PIX_FMT_NV21:
+        img->plane[0][y * w + x] = px[0];
+        if (!(x & 1) && !(y & 1)) {
+            c = img->plane[1] + (y >> 1) * w + x;
+            c[0] = (img->fmt == V4L2_PIX_FMT_NV12) ? px[1] : px[2];
+            c[1] = (img->fmt == V4L2_PIX_FMT_NV12) ? px[2] : px[1];
+        }
+        break;
+    case V4L2_PIX_FMT_NV16:
+    case V4L2_PIX_FMT_NV61:
+        img->plane[0][y * w + x] = px[0];
+        if (!(x & 1)) {
+            c = img->plane[1] + y * w + x;
+            c[0] = (img->fmt == V4L2_PIX_FMT_NV16) ? px[1] : px[2];
+            c[1] = (img->fmt == V4L2_PIX_FMT_NV16) ? px[2] : px[1];
+        }
+        break;
+    case V4L2_PIX_FMT_YUV420:
+        img->plane[0][y * w + x] = px[0];
+        if (!(x & 1) && !(y & 1)) {
+            img->plane[1][(y >> 1) * (w >> 1) + (x >> 1)] = px[1];
+            img->plane[2][(y >> 1) * (w >> 1) + (x >> 1)] = px[2];
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/*
+ * map[i] is the source coordinate of destination coordinate i,
+ * sampled at the pixel centre in 16.16 fixed point
+ */
+static void build_map(int *map, int dstLen, int srcStart, int srcLen, bool reverse)
+{
+    unsigned int step = ((unsigned int)srcLen << 16) / dstLen;
+    unsigned int pos  = step >> 1;
+
+    for (int i = 0; i < dstLen; i++) {
+        int s = pos >> 16;
+        if (srcLen <= s)
+            s = srcLen - 1;
+        map[i] = srcStart + (reverse ? (srcLen - 1 - s) : s);
+        pos += step;
+    }
+}
+
+SecFimcSw::SecFimcSw()
+:   mFlagCreate(false)
+{
+    memset(&mSrc, 0, sizeof(mSrc));
+    memset(&mDst, 0, sizeof(mDst));
+    memset(mDstAlloc, 0, sizeof(mDstAlloc));
+
+    mDstAllocSize = 0;
+    mNumOfBuf = 0;
+    mRotVal = 0;
+    mFlipVal = 0;
+    mFlagGlobalAlpha = false;
+    mGlobalAlpha = 0xff;
+    mFlagLocalAlpha = false;
+    mFlagSetSrcParam = false;
+    mFlagSetDstParam = false;
+    mNumOfInFlight = 0;
+    mInFlightHead = 0;
+    mTmpSrc = NULL;
+    mTmpSrcSize = 0;
+    mTmpDst = NULL;
+    mTmpDstSize = 0;
+    mColMap = NULL;
+    mRowMap = NULL;
+    mMapLen = 0;
+}
+
+SecFimcSw::~SecFimcSw()
+{
+    if (mFlagCreate == true) {
+        if (destroy() == false)
+            LOGE("%s::destroy failed", __func__);
+    }
+}
+
+bool SecFimcSw::create(int numOfBuf)
+{
+    SecBuffer zeroBuf;
+
+    if (mFlagCreate == true) {
+        LOGE("%s::Already Created fail", __func__);
+        return false;
+    }
+
+    if (numOfBuf <= 0 || MAX_DST_BUFFERS < numOfBuf) {
+        LOGE("%s::invalid numOfBuf(%d)", __func__, numOfBuf);
+        return false;
+    }
+
+    mNumOfBuf = numOfBuf;
+    mSrcBuffer = zeroBuf;
+    for (int i = 0; i < MAX_DST_BUFFERS; i++)
+        mDstBuffer[i] = zeroBuf;
+
+    mFlagCreate = true;
+
+    return true;
+}
+
+bool SecFimcSw::destroy(void)
+{
+    if (mFlagCreate == false) {
+        LOGE("%s::Already Destroyed fail", __func__);
+        return false;
+    }
+
+    m_freeDstBuf();
+
+    free(mTmpSrc);
+    mTmpSrc = NULL;
+    mTmpSrcSize = 0;
+    free(mTmpDst);
+    mTmpDst = NULL;
+    mTmpDstSize = 0;
+    free(mColMap);
+    mColMap = NULL;
+    free(mRowMap);
+    mRowMap = NULL;
+    mMapLen = 0;
+
+    mNumOfInFlight = 0;
+    mInFlightHead = 0;
+    mFlagSetSrcParam = false;
+    mFlagSetDstParam = false;
+    mFlagCreate = false;
+
+    return true;
+}
+
+/* there is no device node, see SecFimc::getFd() */
+int SecFimcSw::getFd(void)
+{
+    return -1;
+}
+
+/* no FIMC IP version, see SecFimc::getHWVersion() */
+int SecFimcSw::getHWVersion(void)
+{
+    if (mFlagCreate == false)
+        LOGE("%s::Not yet created", __func__);
+
+    return 0;
+}
+
+SecBuffer * SecFimcSw::getMemAddr(int index)
+{
+    if (mFlagCreate == false) {
+        LOGE("%s::Not yet created", __func__);
+        return NULL;
+    }
+
+    if (index < 0 || mNumOfBuf <= index) {
+        LOGE("%s::invalid index(%d)", __func__, index);
+        return NULL;
+    }
+
+    return &mDstBuffer[index];
+}
+
+bool SecFimcSw::setSrcParams(unsigned int width, unsigned int height,
+                             unsigned int cropX, unsigned int cropY,
+                             unsigned int *cropWidth, unsigned int *cropHeight,
+                             int colorFormat,
+                             bool forceChange)
+{
+    if (mFlagCreate == false) {
+        LOGE("%s::Not yet created", __func__);
+        return false;
+    }
+
+    int v4l2ColorFormat = HAL_PIXEL_FORMAT_2_V4L2_PIX(colorFormat);
+    if (v4l2ColorFormat < 0 || m_isSupported(v4l2ColorFormat) == false) {
+        LOGE("%s::not supported color format(%d)", __func__, colorFormat);
+        return false;
+    }
+
+    if (   width == 0 || height == 0
+        || width <= cropX || height <= cropY
+        || *cropWidth == 0 || *cropHeight == 0) {
+        LOGE("%s::invalid source params", __func__);
+        return false;
+    }
+
+    unsigned int swWidth  = SW_MIN(*cropWidth,  width  - cropX);
+    unsigned int swHeight = SW_MIN(*cropHeight, height - cropY);
+
+    if ((swWidth != *cropWidth || swHeight != *cropHeight) && forceChange == false) {
+        LOGE("%s::invalid source params", __func__);
+        return false;
+    }
+
+    mSrc.full_width  = width;
+    mSrc.full_height = height;
+    mSrc.start_x     = cropX;
+    mSrc.start_y     = cropY;
+    mSrc.width       = swWidth;
+    mSrc.height      = swHeight;
+    mSrc.color_space = v4l2ColorFormat;
+
+    *cropWidth  = swWidth;
+    *cropHeight = swHeight;
+
+    mFlagSetSrcParam = true;
+    return true;
+}
+
+bool SecFimcSw::getSrcParams(unsigned int *width, unsigned int *height,
+                             unsigned int *cropX, unsigned int *cropY,
+                             unsigned int *cropWidth, unsigned int *cropHeight,
+                             int *colorFormat)
+{
+    if (mFlagSetSrcParam == false) {
+        LOGE("%s::mFlagSetSrcParam == false fail", __func__);
+        return false;
+    }
+
+    *width       = mSrc.full_width;
+    *height      = mSrc.full_height;
+    *cropX       = mSrc.start_x;
+    *cropY       = mSrc.start_y;
+    *cropWidth   = mSrc.width;
+    *cropHeight  = mSrc.height;
+    *colorFormat = mSrc.color_space;
+
+    return true;
+}
+
+bool SecFimcSw::setSrcAddr(unsigned int physYAddr,
+                           unsigned int physCbAddr,
+                           unsigned int physCrAddr,
+                           int colorFormat)
+{
+    if (mFlagCreate == false) {
+        LOGE("%s::Not yet created", __func__);
+        return false;
+    }
+
+    mSrcBuffer.phys.extP[0] = physYAddr;
+    mSrcBuffer.phys.extP[1] = physCbAddr;
+    mSrcBuffer.phys.extP[2] = physCrAddr;
+
+    if (colorFormat == HAL_PIXEL_FORMAT_YV12) {
+        /* Cr plane comes first in memory, swap as SecFimc::setSrcAddr() */
+        unsigned int frame_size = mSrc.full_width * mSrc.full_height;
+        unsigned int crAddr = physCbAddr ? physCbAddr : physYAddr + frame_size;
+        unsigned int cbAddr = physCrAddr ? physCrAddr : crAddr + (frame_size >> 2);
+
+        mSrcBuffer.phys.extP[1] = cbAddr;
+        mSrcBuffer.phys.extP[2] = crAddr;
+        for (int i = 0; i < 3; i++)
+            mSrcBuffer.virt.extP[i] = (char *)mSrcBuffer.phys.extP[i];
+    } else {
+        fill_plane_addr(&mSrcBuffer, mSrc.color_space, mSrc.full_width, mSrc.full_height);
+    }
+
+    return true;
+}
+
+bool SecFimcSw::setDstParams(unsigned int width, unsigned int height,
+                             unsigned int cropX, unsigned int cropY,
+                             unsigned int *cropWidth, unsigned int *cropHeight,
+                             int colorFormat,
+                             bool forceChange)
+{
+    if (mFlagCreate == false) {
+        LOGE("%s::Not yet created", __func__);
+        return false;
+    }
+
+    int v4l2ColorFormat = HAL_PIXEL_FORMAT_2_V4L2_PIX(colorFormat);
+    if (v4l2ColorFormat < 0 || m_isSupported(v4l2ColorFormat) == false) {
+        LOGE("%s::not supported color format(%d)", __func__, colorFormat);
+        return false;
+    }
+
+    if (   width == 0 || height == 0
+        || width <= cropX || height <= cropY
+        || *cropWidth == 0 || *cropHeight == 0) {
+        LOGE("%s::Invalid destination params", __func__);
+        return false;
+    }
+
+    unsigned int swWidth  = SW_MIN(*cropWidth,  width  - cropX);
+    unsigned int swHeight = SW_MIN(*cropHeight, height - cropY);
+
+    if ((swWidth != *cropWidth || swHeight != *cropHeight) && forceChange == false) {
+        LOGE("%s::Invalid destination params", __func__);
+        return false;
+    }
+
+    /* same memory layout as SecFimc::setDstParams() */
+    if (90 == mRotVal || 270 == mRotVal) {
+        mDst.full_width  = height;
+        mDst.full_height = width;
+
+        if (90 == mRotVal) {
+            mDst.start_x = cropY;
+            mDst.start_y = width - (cropX + swWidth);
+        } else {
+            mDst.start_x = height - (cropY + swHeight);
+            mDst.start_y = cropX;
+        }
+
+        mDst.width  = swHeight;
+        mDst.height = swWidth;
+    } else {
+        mDst.full_width  = width;
+        mDst.full_height = height;
+
+        if (180 == mRotVal) {
+            mDst.start_x = width - (cropX + swWidth);
+            mDst.start_y = height - (cropY + swHeight);
+        } else {
+            mDst.start_x = cropX;
+            mDst.start_y = cropY;
+        }
+
+        mDst.width  = swWidth;
+        mDst.height = swHeight;
+    }
+    mDst.color_space = v4l2ColorFormat;
+
+    if (m_allocDstBuf() == false) {
+        LOGE("%s::m_allocDstBuf failed", __func__);
+        return false;
+    }
+
+    *cropWidth  = swWidth;
+    *cropHeight = swHeight;
+
+    mFlagSetDstParam = true;
+    return true;
+}
+
+bool SecFimcSw::getDstParams(unsigned int *width, unsigned int *height,
+                             unsigned int *cropX, unsigned int *cropY,
+                             unsigned int *cropWidth, unsigned int *cropHeight,
+                             int *colorFormat)
+{
+    if (mFlagSetDstParam == false) {
+        LOGE("%s::mFlagSetDstParam == false fail", __func__);
+        return false;
+    }
+
+    *width       = mDst.full_width;
+    *height      = mDst.full_height;
+    *cropX       = mDst.start_x;
+    *cropY       = mDst.start_y;
+    *cropWidth   = mDst.width;
+    *cropHeight  = mDst.height;
+    *colorFormat = mDst.color_space;
+
+    return true;
+}
+
+bool SecFimcSw::setDstAddr(unsigned int physYAddr, unsigned int physCbAddr, unsigned int physCrAddr, int buf_index)
+{
+    if (mFlagCreate == false) {
+        LOGE("%s::Not yet created", __func__);
+        return false;
+    }
+
+    if (buf_index < 0 || mNumOfBuf <= buf_index) {
+        LOGE("%s::invalid buf_index(%d)", __func__, buf_index);
+        return false;
+    }
+
+    mDstBuffer[buf_index].phys.extP[0] = physYAddr;
+    mDstBuffer[buf_index].phys.extP[1] = physCbAddr;
+    mDstBuffer[buf_index].phys.extP[2] = physCrAddr;
+
+    fill_plane_addr(&mDstBuffer[buf_index], mDst.color_space, mDst.full_width, mDst.full_height);
+
+    return true;
+}
+
+bool SecFimcSw::setRotVal(unsigned int rotVal)
+{
+    if (mFlagCreate == false) {
+        LOGE("%s::Not yet created", __func__);
+        return false;
+    }
+
+    if (rotVal != 0 && rotVal != 90 && rotVal != 180 && rotVal != 270) {
+        LOGE("%s::invalid rotVal(%d)", __func__, rotVal);
+        return false;
+    }
+
+    mRotVal = rotVal;
+    return true;
+}
+
+bool SecFimcSw::setFlipVal(unsigned int flipVal)
+{
+    if (mFlagCreate == false) {
+        LOGE("%s::Not yet created", __func__);
+        return false;
+    }
+
+    /* 1 : horizontal, 2 : vertical, others : none, as SecFimc */
+    mFlipVal = (flipVal == 1 || flipVal == 2) ? flipVal : 0;
+    return true;
+}
+
+bool SecFimcSw::setGlobalAlpha(bool enable, int alpha)
+{
+    if (mFlagCreate == false) {
+        LOGE("%s::Not yet created", __func__);
+        return false;
+    }
+
+    mFlagGlobalAlpha = enable;
+    mGlobalAlpha     = alpha & 0xff;
+    return true;
+}
+
+bool SecFimcSw::setLocalAlpha(bool enable)
+{
+    if (mFlagCreate == false) {
+        LOGE("%s::Not yet created", __func__);
+        return false;
+    }
+
+    mFlagLocalAlpha = enable;
+    return true;
+}
+
+bool SecFimcSw::setColorKey(bool enable, int colorKey)
+{
+    if (mFlagCreate == false) {
+        LOGE("%s::Not yet created", __func__);
+        return false;
+    }
+
+    if (enable == true) {
+        LOGE("%s::color key is not supported by the software backend", __func__);
+        return false;
+    }
+
+    return true;
+}
+
+bool SecFimcSw::draw(int src_index, int dst_index)
+{
+#ifdef DEBUG_LIB_FIMC
+    LOGD("%s", __func__);
+#endif
+
+    struct swImage src;
+    struct swImage dst;
+    struct swImage tiledDst;
+    bool tiledOut = false;
+
+    if (mFlagCreate == false) {
+        LOGE("%s::Not yet created", __func__);
+        return false;
+    }
+
+    if (mFlagSetSrcParam == false) {
+        LOGE("%s::mFlagSetSrcParam == false fail", __func__);
+        return false;
+    }
+
+    if (mFlagSetDstParam == false) {
+        LOGE("%s::mFlagSetDstParam == false fail", __func__);
+        return false;
+    }
+
+    if (dst_index < 0 || mNumOfBuf <= dst_index) {
+        LOGE("%s::invalid dst_index(%d)", __func__, dst_index);
+        return false;
+    }
+
+    if (   m_getImage(&mSrc, &mSrcBuffer, &src) == false
+        || m_getImage(&mDst, &mDstBuffer[dst_index], &dst) == false) {
+        LOGE("%s::m_getImage failed", __func__);
+        return false;
+    }
+
+    if (m_drawFast(&src, &dst) == true)
+        return true;
+
+    if (   (is_tiled_fmt(src.fmt) && is_tiled_size_ok(&src) == false)
+        || (is_tiled_fmt(dst.fmt) && is_tiled_size_ok(&dst) == false)) {
+        LOGE("%s::NV12T needs a 16 pixel aligned width and an even height (src %dx%d, dst %dx%d)",
+                __func__, src.width, src.height, dst.width, dst.height);
+        return false;
+    }
+
+    if (is_tiled_fmt(src.fmt)) {
+        unsigned int frameSize = src.width * src.height;
+        unsigned char *tmp = m_getTmp(&mTmpSrc, &mTmpSrcSize, frameSize + (frameSize >> 1));
+        if (tmp == NULL)
+            return false;
+
+        csc_tiled_to_linear_y_neon(tmp, src.plane[0], src.width, src.height);
+        csc_tiled_to_linear_uv_neon(tmp + frameSize, src.plane[1], src.width, src.height >> 1);
+
+        src.fmt      = V4L2_PIX_FMT_NV12;
+        src.plane[0] = tmp;
+        src.plane[1] = tmp + frameSize;
+    }
+
+    if (is_tiled_fmt(dst.fmt)) {
+        unsigned int frameSize = dst.width * dst.height;
+        unsigned char *tmp = m_getTmp(&mTmpDst, &mTmpDstSize, frameSize + (frameSize >> 1));
+        if (tmp == NULL)
+            return false;
+
+        tiledDst = dst;
+        tiledOut = true;
+
+        dst.fmt      = V4L2_PIX_FMT_YUV420;
+        dst.plane[0] = tmp;
+        dst.plane[1] = tmp + frameSize;
+        dst.plane[2] = tmp + frameSize + (frameSize >> 2);
+
+        /* keep what is outside the crop or under the blended area */
+        if (   mDst.width != mDst.full_width || mDst.height != mDst.full_height
+            || mFlagGlobalAlpha == true || mFlagLocalAlpha == true) {
+            csc_tiled_to_linear_y_neon(dst.plane[0], tiledDst.plane[0], dst.width, dst.height);
+            csc_tiled_to_linear_uv_deinterleave_neon(dst.plane[1], dst.plane[2],
+                    tiledDst.plane[1], dst.width, dst.height >> 1);
+        }
+    }
+
+    if (m_drawGeneric(&src, &dst) == false)
+        return false;
+
+    if (tiledOut == true) {
+        csc_linear_to_tiled_y_neon(tiledDst.plane[0], dst.plane[0], dst.width, dst.height);
+        csc_linear_to_tiled_uv_neon(tiledDst.plane[1], dst.plane[1], dst.plane[2],
+                dst.width, dst.height >> 1);
+    }
+
+    return true;
+}
+
+/*
+ * The software backend has nothing to overlap with, the frame is
+ * drawn at once and waitDone() only hands back the destination index.
+ */
+bool SecFimcSw::drawAsync(int src_index, int dst_index)
+{
+    if (MAX_DST_BUFFERS <= mNumOfInFlight || mNumOfBuf <= mNumOfInFlight) {
+        LOGE("%s::too many frames in flight (%d)", __func__, mNumOfInFlight);
+        return false;
+    }
+
+    if (draw(src_index, dst_index) == false)
+        return false;
+
+    mInFlightDst[(mInFlightHead + mNumOfInFlight) % MAX_DST_BUFFERS] = dst_index;
+    mNumOfInFlight++;
+
+    return true;
+}
+
+int SecFimcSw::waitDone(void)
+{
+    int dst_index;
+
+    if (mNumOfInFlight <= 0) {
+        LOGE("%s::no frame in flight", __func__);
+        return -1;
+    }
+
+    dst_index = mInFlightDst[mInFlightHead];
+    mInFlightHead = (mInFlightHead + 1) % MAX_DST_BUFFERS;
+    mNumOfInFlight--;
+
+    return dst_index;
+}
+
+bool SecFimcSw::m_isSupported(unsigned int fmt)
+{
+    return (get_plane_size(fmt, 2, 2, 0) != 0);
+}
+
+bool SecFimcSw::m_getImage(s5p_fimc_img_info *info, SecBuffer *buf, struct swImage *img)
+{
+    int planes = get_planes(info->color_space);
+
+    img->fmt    = is_tiled_fmt(info->color_space) ? info->color_space : linear_fmt(info->color_space);
+    img->width  = info->full_width;
+    img->height = info->full_height;
+
+    for (int i = 0; i < MAX_PLANES; i++) {
+        img->plane[i] = NULL;
+        if (planes <= i)
+            continue;
+
+        if (buf->virt.extP[i] == NULL) {
+            LOGE("%s::plane %d has no address", __func__, i);
+            return false;
+        }
+
+        img->plane[i] = (unsigned char *)buf->virt.extP[i];
+    }
+
+    return true;
+}
+
+/* point every destination buffer to its own malloc()ed frame */
+bool SecFimcSw::m_allocDstBuf(void)
+{
+    SecBuffer zeroBuf;
+    int planes = get_planes(mDst.color_space);
+    unsigned int size = 0;
+
+    for (int i = 0; i < planes; i++)
+        size += get_plane_size(mDst.color_space, mDst.full_width, mDst.full_height, i);
+
+    if (mDstAllocSize < size) {
+        m_freeDstBuf();
+
+        for (int i = 0; i < mNumOfBuf; i++) {
+            mDstAlloc[i] = (unsigned char *)malloc(size);
+            if (mDstAlloc[i] == NULL) {
+                LOGE("%s::malloc(%d) failed", __func__, size);
+                m_freeDstBuf();
+                return false;
+            }
+        }
+        mDstAllocSize = size;
+    }
+
+    for (int i = 0; i < mNumOfBuf; i++) {
+        SecBuffer *buf = &mDstBuffer[i];
+
+        *buf = zeroBuf;
+        buf->phys.extP[0] = (unsigned int)mDstAlloc[i];
+        fill_plane_addr(buf, mDst.color_space, mDst.full_width, mDst.full_height);
+
+        for (int j = 0; j < planes; j++)
+            buf->size.extS[j] = get_plane_size(mDst.color_space, mDst.full_width, mDst.full_height, j);
+    }
+
+    return true;
+}
+
+void SecFimcSw::m_freeDstBuf(void)
+{
+    SecBuffer zeroBuf;
+
+    for (int i = 0; i < MAX_DST_BUFFERS; i++) {
+        free(mDstAlloc[i]);
+        mDstAlloc[i] = NULL;
+        mDstBuffer[i] = zeroBuf;
+    }
+    mDstAllocSize = 0;
+}
+
+unsigned char *SecFimcSw::m_getTmp(unsigned char **tmp, unsigned int *tmpSize, unsigned int size)
+{
+    if (*tmpSize < size) {
+        free(*tmp);
+        *tmp = (unsigned char *)malloc(size);
+        if (*tmp == NULL) {
+            LOGE("%s::malloc(%d) failed", __func__, size);
+            *tmpSize = 0;
+            return NULL;
+        }
+        *tmpSize = size;
+    }
+
+    return *tmp;
+}
+
+/* whole frame conversions one of the NEON kernels does directly */
+bool SecFimcSw::m_drawFast(struct swImage *src, struct swImage *dst)
+{
+    if (   mRotVal != 0 || mFlipVal != 0
+        || mFlagGlobalAlpha == true || mFlagLocalAlpha == true)
+        return false;
+
+    if (   mSrc.start_x != 0 || mSrc.start_y != 0
+        || mSrc.width != mSrc.full_width || mSrc.height != mSrc.full_height
+        || mDst.start_x != 0 || mDst.start_y != 0
+        || mDst.width != mDst.full_width || mDst.height != mDst.full_height)
+        return false;
+
+    bool sameSize = (src->width == dst->width && src->height == dst->height);
+
+    /* the NEON kernels work on 16 pixel wide, even height frames */
+    if ((src->width & 15) || (dst->width & 15) || (src->height & 1) || (dst->height & 1))
+        return false;
+
+    if (is_tiled_fmt(src->fmt) && dst->fmt == V4L2_PIX_FMT_NV12 && sameSize) {
+        csc_tiled_to_linear_y_neon(dst->plane[0], src->plane[0], src->width, src->height);
+        csc_tiled_to_linear_uv_neon(dst->plane[1], src->plane[1], src->width, src->height >> 1);
+        return true;
+    }
+
+    if (src->fmt == V4L2_PIX_FMT_YUV420 && is_tiled_fmt(dst->fmt) && sameSize) {
+        csc_linear_to_tiled_y_neon(dst->plane[0], src->plane[0], src->width, src->height);
+        csc_linear_to_tiled_uv_neon(dst->plane[1], src->plane[1], src->plane[2],
+                src->width, src->height >> 1);
+        return true;
+    }
+
+    if (   src->fmt == V4L2_PIX_FMT_NV12 && dst->fmt == V4L2_PIX_FMT_NV12
+        && src->width <= dst->width && src->height <= dst->height) {
+        SW_Scale_up(src->width, src->height, dst->width, dst->height,
+                    src->plane[0], src->plane[1], dst->plane[0], dst->plane[1]);
+        return true;
+    }
+
+    if (src->fmt == V4L2_PIX_FMT_RGB32 && dst->fmt == V4L2_PIX_FMT_NV12 && sameSize) {
+        csc_RGBA8888_to_YUV420SP_NEON(dst->plane[0], dst->plane[1], src->plane[0],
+                src->width, src->height);
+        return true;
+    }
+
+    if (src->fmt == V4L2_PIX_FMT_RGB565 && dst->fmt == V4L2_PIX_FMT_NV12 && sameSize) {
+        csc_RGB565_to_YUV420SP(dst->plane[0], dst->plane[1], src->plane[0],
+                src->width, src->height);
+        return true;
+    }
+
+    return false;
+}
+
+bool SecFimcSw::m_drawGeneric(struct swImage *src, struct swImage *dst)
+{
+    bool rotated = (mRotVal == 90 || mRotVal == 270);
+    bool hflip   = (mFlipVal == 1);
+    bool vflip   = (mFlipVal == 2);
+    bool srcYuv  = !is_rgb_fmt(src->fmt);
+    bool dstYuv  = !is_rgb_fmt(dst->fmt);
+    bool localAlpha = (mFlagLocalAlpha == true && src->fmt == V4L2_PIX_FMT_RGB32);
+    int  globalAlpha = (mFlagGlobalAlpha == true) ? mGlobalAlpha : 0xff;
+    unsigned int dstW = mDst.width;
+    unsigned int dstH = mDst.height;
+    unsigned int mapLen = SW_MAX(dstW, dstH);
+    int px[4];
+    int under[4];
+
+    if (mMapLen < mapLen) {
+        free(mColMap);
+        free(mRowMap);
+        mColMap = (int *)malloc(mapLen * sizeof(int));
+        mRowMap = (int *)malloc(mapLen * sizeof(int));
+        if (mColMap == NULL || mRowMap == NULL) {
+            LOGE("%s::malloc(%d) failed", __func__, mapLen);
+            free(mColMap);
+            free(mRowMap);
+            mColMap = NULL;
+            mRowMap = NULL;
+            mMapLen = 0;
+            return false;
+        }
+        mMapLen = mapLen;
+    }
+
+    /*
+     * flip is applied in source space before the clockwise rotation.
+     * rotated: a destination column walks source rows, a row walks columns
+     */
+    switch (mRotVal) {
+    case 90:
+        build_map(mColMap, dstW, mSrc.start_y, mSrc.height, !vflip);
+        build_map(mRowMap, dstH, mSrc.start_x, mSrc.width,  hflip);
+        break;
+    case 180:
+        build_map(mColMap, dstW, mSrc.start_x, mSrc.width,  !hflip);
+        build_map(mRowMap, dstH, mSrc.start_y, mSrc.height, !vflip);
+        break;
+    case 270:
+        build_map(mColMap, dstW, mSrc.start_y, mSrc.height, vflip);
+        build_map(mRowMap, dstH, mSrc.start_x, mSrc.width,  !hflip);
+        break;
+    default:
+        build_map(mColMap, dstW, mSrc.start_x, mSrc.width,  hflip);
+        build_map(mRowMap, dstH, mSrc.start_y, mSrc.height, vflip);
+        break;
+    }
+
+    for (unsigned int j = 0; j < dstH; j++) {
+        int dy = mDst.start_y + j;
+
+        for (unsigned int i = 0; i < dstW; i++) {
+            int dx = mDst.start_x + i;
+            int alpha = globalAlpha;
+
+            if (rotated == true)
+                read_pixel(src, mRowMap[j], mColMap[i], px);
+            else
+                read_pixel(src, mColMap[i], mRowMap[j], px);
+
+            if (localAlpha == true)
+                alpha = (alpha * px[3] + 127) / 255;
+
+            if (srcYuv != dstYuv) {
+                if (dstYuv == true)
+                    rgb_to_yuv(px);
+                else
+                    yuv_to_rgb(px);
+            }
+
+            if (alpha < 0xff) {
+                read_pixel(dst, dx, dy, under);
+                for (int k = 0; k < 3; k++)
+                    px[k] = (px[k] * alpha + under[k] * (0xff - alpha) + 127) / 255;
+                px[3] = 0xff;
+            } else if (srcYuv == true) {
+                px[3] = 0xff;
+            }
+
+            write_pixel(dst, dx, dy, px);
+        }
+    }
+
+    return true;
+}
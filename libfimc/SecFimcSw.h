@@ -0,0 +1,138 @@
+/*
+ * Copyright@ Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file      SecFimcSw.h
+ * \brief     header file for the software backend of the Fimc HAL MODULE
+ *
+ * The CPU does the colour conversion, scaling, rotation/flip and
+ * alpha blending that FIMC does in hardware. The addresses given to
+ * set*Addr() are CPU (virtual) addresses, and the destination buffers
+ * of getMemAddr() are allocated with malloc(). No device is used.
+ * Only SecFimc uses this class, see SecFimc::create().
+ */
+
+#ifndef __SEC_FIMC_SW_H__
+#define __SEC_FIMC_SW_H__
+
+#include "SecFimc.h"
+
+class SecFimcSw
+{
+public:
+    /* one plane set of a frame, in memory layout */
+    struct swImage {
+        unsigned int            fmt;
+        unsigned int            width;
+        unsigned int            height;
+        unsigned char          *plane[MAX_PLANES];
+    };
+
+private:
+    bool                        mFlagCreate;
+    int                         mNumOfBuf;
+    int                         mRotVal;
+    int                         mFlipVal;
+    bool                        mFlagGlobalAlpha;
+    int                         mGlobalAlpha;
+    bool                        mFlagLocalAlpha;
+    bool                        mFlagSetSrcParam;
+    bool                        mFlagSetDstParam;
+
+    int                         mNumOfInFlight;
+    int                         mInFlightHead;
+    int                         mInFlightDst[MAX_DST_BUFFERS];
+
+    s5p_fimc_img_info           mSrc;
+    s5p_fimc_img_info           mDst;
+
+    SecBuffer                   mSrcBuffer;
+    SecBuffer                   mDstBuffer[MAX_DST_BUFFERS];
+
+    unsigned char              *mDstAlloc[MAX_DST_BUFFERS];
+    unsigned int                mDstAllocSize;
+
+    unsigned char              *mTmpSrc;
+    unsigned int                mTmpSrcSize;
+    unsigned char              *mTmpDst;
+    unsigned int                mTmpDstSize;
+
+    int                        *mColMap;
+    int                        *mRowMap;
+    unsigned int                mMapLen;
+
+public:
+    SecFimcSw();
+    virtual ~SecFimcSw();
+
+    bool create(int numOfBuf);
+    bool destroy(void);
+
+    int  getFd(void);
+    int  getHWVersion(void);
+    SecBuffer * getMemAddr(int index = 0);
+
+    bool setSrcParams(unsigned int width, unsigned int height,
+                      unsigned int cropX, unsigned int cropY,
+                      unsigned int *cropWidth, unsigned int *cropHeight,
+                      int colorFormat,
+                      bool forceChange = true);
+
+    bool getSrcParams(unsigned int *width, unsigned int *height,
+                      unsigned int *cropX, unsigned int *cropY,
+                      unsigned int *cropWidth, unsigned int *cropHeight,
+                      int *colorFormat);
+
+    bool setSrcAddr(unsigned int physYAddr,
+                    unsigned int physCbAddr = 0,
+                    unsigned int physCrAddr = 0,
+                    int colorFormat = 0);
+
+    bool setDstParams(unsigned int width, unsigned int height,
+                      unsigned int cropX, unsigned int cropY,
+                      unsigned int *cropWidth, unsigned int *cropHeight,
+                      int colorFormat,
+                      bool forceChange = true);
+
+    bool getDstParams(unsigned int *width, unsigned int *height,
+                      unsigned int *cropX, unsigned int *cropY,
+                      unsigned int *cropWidth, unsigned int *cropHeight,
+                      int *colorFormat);
+
+    bool setDstAddr(unsigned int physYAddr, unsigned int physCbAddr = 0,
+                    unsigned int physCrAddr = 0, int buf_index = 0);
+
+    bool setRotVal(unsigned int rotVal);
+    bool setFlipVal(unsigned int flipVal);
+    bool setGlobalAlpha(bool enable = true, int alpha = 0xff);
+    bool setLocalAlpha(bool enable);
+    bool setColorKey(bool enable = true, int colorKey = 0xff);
+
+    bool draw(int src_index, int dst_index);
+    bool drawAsync(int src_index, int dst_index);
+    int  waitDone(void);
+
+private:
+    bool m_isSupported(unsigned int fmt);
+    bool m_getImage(s5p_fimc_img_info *info, SecBuffer *buf, struct swImage *img);
+    bool m_allocDstBuf(void);
+    void m_freeDstBuf(void);
+    unsigned char *m_getTmp(unsigned char **tmp, unsigned int *tmpSize, unsigned int size);
+    bool m_drawFast(struct swImage *src, struct swImage *dst);
+    bool m_drawGeneric(struct swImage *src, struct swImage *dst);
+};
+
+#endif //__SEC_FIMC_SW_H__
@@ -9,7 +9,12 @@ LOCAL_MODULE_TAGS := optional
 
 LOCAL_SRC_FILES:= \
 	FimgApi.cpp   \
-	FimgExynos4.cpp
+	FimgExynos4.cpp \
+	FimgSw.cpp
+
+ifeq ($(BOARD_USES_FIMGAPI_SW),true)
+LOCAL_CFLAGS += -DUSE_FIMGAPI_SW
+endif
 
 LOCAL_SHARED_LIBRARIES:= liblog libutils libbinder
 
@@ -19,4 +24,6 @@ LOCAL_PRELINK_MODULE := false
 
 include $(BUILD_SHARED_LIBRARY)
 
+include $(call all-makefiles-under,$(LOCAL_PATH))
+
 endif
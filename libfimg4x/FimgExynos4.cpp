@@ -22,6 +22,7 @@
 #include <utils/Log.h>
 
 #include "FimgExynos4.h"
+#include "FimgSw.h"
 
 namespace android
 {
@@ -291,7 +292,17 @@ extern "C" struct FimgApi * createFimgApi()
     else
         fimgApiAutoFreeThread->SetOneMoreSleep();
 
-    return FimgV4x::CreateInstance();
+#ifdef USE_FIMGAPI_SW
+    return FimgSw::CreateInstance();
+#else
+    FimgApi * ptrFimgApi = FimgV4x::CreateInstance();
+    if (ptrFimgApi == NULL) {
+        PRINT("%s::G2D is not available, use software\n", __func__);
+        ptrFimgApi = FimgSw::CreateInstance();
+    }
+
+    return ptrFimgApi;
+#endif
 }
 
 extern "C" void destroyFimgApi(FimgApi * ptrFimgApi)
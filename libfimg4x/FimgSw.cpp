@@ -0,0 +1,677 @@
+/*
+**
+** Copyright 2009 Samsung Electronics Co, Ltd.
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+**
+*/
+
+#define LOG_NDEBUG 0
+#define LOG_TAG "FimgSw"
+#include <utils/Log.h>
+
+#ifdef __ARM_NEON__
+#include <arm_neon.h>
+#endif
+
+#include "FimgSw.h"
+
+#define FIMG_SW_MIN(x, y)   (((x) < (y)) ? (x) : (y))
+#define FIMG_SW_MAX(x, y)   (((x) > (y)) ? (x) : (y))
+
+namespace android
+{
+Mutex      FimgSw::m_instanceLock;
+FimgApi *  FimgSw::m_ptrFimgApi = NULL;
+
+//---------------------------------------------------------------------------//
+// pixel helpers, every line is handled as canonical 0xAARRGGBB words
+//---------------------------------------------------------------------------//
+
+/* x / 255 rounded, exact for x <= 255 * 255, the NEON path computes the same */
+static inline unsigned int div255(unsigned int x)
+{
+    return (x + 128 + ((x + 128) >> 8)) >> 8;
+}
+
+static inline bool isSupportedFormat(struct fimg2d_image *image)
+{
+    switch (image->fmt) {
+    case CF_XRGB_8888:
+    case CF_ARGB_8888:
+        return (image->order < ARGB_ORDER_END);
+    case CF_RGB_565:
+    case CF_XRGB_4444:
+    case CF_ARGB_4444:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static inline int bytesPerPixel(enum color_format fmt)
+{
+    return (fmt == CF_XRGB_8888 || fmt == CF_ARGB_8888) ? 4 : 2;
+}
+
+static inline unsigned int decodePixel(const unsigned char *row, int x,
+                                       enum color_format fmt, enum pixel_order order)
+{
+    unsigned int w;
+    unsigned int v;
+
+    switch (fmt) {
+    case CF_XRGB_8888:
+    case CF_ARGB_8888:
+        w = ((const unsigned int *)row)[x];
+        switch (order) {
+        case RGB_AX:
+            w = (w >> 8) | (w << 24);
+            break;
+        case AX_BGR:
+            w = (w & 0xff00ff00) | ((w >> 16) & 0xff) | ((w & 0xff) << 16);
+            break;
+        case BGR_AX:
+            w = (w << 24) | ((w & 0xff00) << 8) | ((w >> 8) & 0xff00) | (w >> 24);
+            break;
+        default:
+            break;
+        }
+        if (fmt == CF_XRGB_8888)
+            w |= 0xff000000;
+        return w;
+    case CF_RGB_565:
+        v = ((const unsigned short *)row)[x];
+        return 0xff000000
+             | ((((v >> 8) & 0xf8) | (v >> 13)) << 16)
+             | ((((v >> 3) & 0xfc) | ((v >> 9) & 0x3)) << 8)
+             | (((v << 3) & 0xf8) | ((v >> 2) & 0x7));
+    case CF_XRGB_4444:
+    case CF_ARGB_4444:
+        v = ((const unsigned short *)row)[x];
+        w = ((v & 0xf000) << 12) | ((v & 0x0f00) << 8) | ((v & 0x00f0) << 4) | (v & 0x000f);
+        w |= w << 4;
+        if (fmt == CF_XRGB_4444)
+            w |= 0xff000000;
+        return w;
+    default:
+        return 0;
+    }
+}
+
+static inline void encodePixel(unsigned char *row, int x, unsigned int w,
+                               enum color_format fmt, enum pixel_order order)
+{
+    switch (fmt) {
+    case CF_XRGB_8888:
+    case CF_ARGB_8888:
+        switch (order) {
+        case RGB_AX:
+            w = (w << 8) | (w >> 24);
+            break;
+        case AX_BGR:
+            w = (w & 0xff00ff00) | ((w >> 16) & 0xff) | ((w & 0xff) << 16);
+            break;
+        case BGR_AX:
+            w = (w << 24) | ((w & 0xff00) << 8) | ((w >> 8) & 0xff00) | (w >> 24);
+            break;
+        default:
+            break;
+        }
+        ((unsigned int *)row)[x] = w;
+        break;
+    case CF_RGB_565:
+        ((unsigned short *)row)[x] =
+              ((w >> 8) & 0xf800) | ((w >> 5) & 0x07e0) | ((w >> 3) & 0x001f);
+        break;
+    case CF_XRGB_4444:
+    case CF_ARGB_4444:
+        ((unsigned short *)row)[x] =
+              ((w >> 16) & 0xf000) | ((w >> 12) & 0x0f00) | ((w >> 8) & 0x00f0) | ((w >> 4) & 0x000f);
+        break;
+    default:
+        break;
+    }
+}
+
+static inline unsigned int premultiply(unsigned int w)
+{
+    unsigned int a = w >> 24;
+
+    if (a == 0xff)
+        return w;
+
+    return (a << 24)
+         | (div255(((w >> 16) & 0xff) * a) << 16)
+         | (div255(((w >>  8) & 0xff) * a) <<  8)
+         |  div255(( w        & 0xff) * a);
+}
+
+static inline unsigned int unpremultiply(unsigned int w)
+{
+    unsigned int a = w >> 24;
+
+    if (a == 0xff)
+        return w;
+    if (a == 0)
+        return 0;
+
+    return (a << 24)
+         | (FIMG_SW_MIN((((w >> 16) & 0xff) * 255 + (a >> 1)) / a, 255) << 16)
+         | (FIMG_SW_MIN((((w >>  8) & 0xff) * 255 + (a >> 1)) / a, 255) <<  8)
+         |  FIMG_SW_MIN((( w        & 0xff) * 255 + (a >> 1)) / a, 255);
+}
+
+/* global alpha on a premultiplied pixel scales every channel */
+static inline unsigned int scaleAlpha(unsigned int w, unsigned int alpha)
+{
+    return (div255((w >> 24) * alpha) << 24)
+         | (div255(((w >> 16) & 0xff) * alpha) << 16)
+         | (div255(((w >>  8) & 0xff) * alpha) <<  8)
+         |  div255(( w        & 0xff) * alpha);
+}
+
+/* dst = src + dst * (255 - src alpha), premultiplied */
+static void blendLineSrcOver(unsigned int *dst, const unsigned int *src, int num)
+{
+    int i = 0;
+
+#ifdef __ARM_NEON__
+    for (; i + 8 <= num; i += 8) {
+        uint8x8x4_t s = vld4_u8((const uint8_t *)(src + i));
+        uint8x8x4_t d = vld4_u8((const uint8_t *)(dst + i));
+        uint8x8_t inv = vmvn_u8(s.val[3]);
+
+        for (int c = 0; c < 4; c++) {
+            uint16x8_t t = vmull_u8(d.val[c], inv);
+            d.val[c] = vqadd_u8(s.val[c], vrshrn_n_u16(vrsraq_n_u16(t, t, 8), 8));
+        }
+
+        vst4_u8((uint8_t *)(dst + i), d);
+    }
+#endif
+
+    for (; i < num; i++) {
+        unsigned int s = src[i];
+        unsigned int d = dst[i];
+        unsigned int inv = 0xff - (s >> 24);
+        unsigned int out = 0;
+
+        for (int shift = 0; shift < 32; shift += 8) {
+            unsigned int c = ((s >> shift) & 0xff) + div255(((d >> shift) & 0xff) * inv);
+            out |= FIMG_SW_MIN(c, 0xff) << shift;
+        }
+
+        dst[i] = out;
+    }
+}
+
+/*
+ * map[i] is the source coordinate of destination coordinate i, sampled at
+ * the pixel centre in 16.16 fixed point. For bilinear scaling next[i] is
+ * the neighbouring source coordinate and frac[i] its weight out of 256.
+ */
+static void buildMap(int *map, int *next, int *frac, int dstLen,
+                     int srcStart, int srcLen, bool reverse)
+{
+    unsigned int step = ((unsigned int)srcLen << 16) / dstLen;
+
+    if (next == NULL) {
+        unsigned int pos = step >> 1;
+
+        for (int i = 0; i < dstLen; i++) {
+            int s = pos >> 16;
+            if (srcLen <= s)
+                s = srcLen - 1;
+            map[i] = srcStart + (reverse ? (srcLen - 1 - s) : s);
+            pos += step;
+        }
+        return;
+    }
+
+    /* centre of destination pixel i is at (i + 0.5) * step - 0.5 in the source */
+    int pos = (int)(step >> 1) - 0x8000;
+
+    for (int i = 0; i < dstLen; i++) {
+        int s0 = 0;
+        int f  = 0;
+
+        if (0 < pos) {
+            s0 = pos >> 16;
+            f  = (pos >> 8) & 0xff;
+        }
+        if (srcLen - 1 <= s0) {
+            s0 = srcLen - 1;
+            f  = 0;
+        }
+
+        int s1 = (f == 0) ? s0 : s0 + 1;
+
+        map[i]  = srcStart + (reverse ? (srcLen - 1 - s0) : s0);
+        next[i] = srcStart + (reverse ? (srcLen - 1 - s1) : s1);
+        frac[i] = f;
+        pos += step;
+    }
+}
+
+static inline unsigned int lerpPixel(unsigned int a, unsigned int b, unsigned int f)
+{
+    unsigned int out = 0;
+
+    for (int shift = 0; shift < 32; shift += 8) {
+        unsigned int c = ((a >> shift) & 0xff) * (256 - f) + ((b >> shift) & 0xff) * f;
+        out |= ((c + 128) >> 8) << shift;
+    }
+
+    return out;
+}
+
+/* 2x2 taps weighted by fx, fy out of 256, premultiplied first when blending */
+static inline unsigned int samplePixel(struct fimg2d_image *img, unsigned char *base,
+                                       int x0, int x1, int fx, int y0, int y1, int fy,
+                                       bool toPremult)
+{
+    unsigned char *row0 = base + y0 * img->stride;
+    unsigned char *row1 = base + y1 * img->stride;
+    unsigned int p00 = decodePixel(row0, x0, img->fmt, img->order);
+    unsigned int p01 = decodePixel(row0, x1, img->fmt, img->order);
+    unsigned int p10 = decodePixel(row1, x0, img->fmt, img->order);
+    unsigned int p11 = decodePixel(row1, x1, img->fmt, img->order);
+
+    if (toPremult == true) {
+        p00 = premultiply(p00);
+        p01 = premultiply(p01);
+        p10 = premultiply(p10);
+        p11 = premultiply(p11);
+    }
+
+    return lerpPixel(lerpPixel(p00, p01, fx), lerpPixel(p10, p11, fx), fy);
+}
+
+static inline bool isValidImage(struct fimg2d_image *image)
+{
+    struct fimg2d_rect *rect = &image->rect;
+
+    if (image->addr.type != ADDR_USER && image->addr.type != ADDR_USER_RSVD) {
+        PRINT("%s::addr type(%d) is not supported\n", __func__, image->addr.type);
+        return false;
+    }
+
+    if (image->addr.start == 0 || isSupportedFormat(image) == false) {
+        PRINT("%s::invalid image(addr 0x%lx, fmt %d)\n", __func__, image->addr.start, image->fmt);
+        return false;
+    }
+
+    if (   rect->x1 < 0 || rect->y1 < 0
+        || image->width < rect->x2 || image->height < rect->y2
+        || rect->x2 <= rect->x1 || rect->y2 <= rect->y1
+        || image->stride < image->width * bytesPerPixel(image->fmt)) {
+        PRINT("%s::invalid rect(%d, %d, %d, %d) of %dx%d\n", __func__,
+              rect->x1, rect->y1, rect->x2, rect->y2, image->width, image->height);
+        return false;
+    }
+
+    return true;
+}
+
+//---------------------------------------------------------------------------//
+
+FimgSw::FimgSw()
+         : m_colMap(NULL),
+           m_rowMap(NULL),
+           m_mapLen(0),
+           m_bilinear(false),
+           m_lineBuf(NULL),
+           m_lineLen(0)
+{
+    m_lock = new Mutex(Mutex::SHARED, "FimgSw");
+}
+
+FimgSw::~FimgSw()
+{
+    delete m_lock;
+}
+
+FimgApi *FimgSw::CreateInstance()
+{
+    Mutex::Autolock autolock(m_instanceLock);
+
+    if (m_ptrFimgApi == NULL)
+        m_ptrFimgApi = new FimgSw;
+
+    if (m_ptrFimgApi->FlagCreate() == false && m_ptrFimgApi->Create() == false) {
+        PRINT("%s::Create() fail\n", __func__);
+        return NULL;
+    }
+
+    return m_ptrFimgApi;
+}
+
+void FimgSw::DestroyInstance(void)
+{
+    Mutex::Autolock autolock(m_instanceLock);
+
+    if (m_ptrFimgApi == NULL)
+        return;
+
+    if (m_ptrFimgApi->FlagCreate() == true && m_ptrFimgApi->Destroy() == false) {
+        PRINT("%s::Destroy() fail\n", __func__);
+        return;
+    }
+
+    delete (FimgSw *)m_ptrFimgApi;
+    m_ptrFimgApi = NULL;
+}
+
+bool FimgSw::t_Create(void)
+{
+    return true;
+}
+
+bool FimgSw::t_Destroy(void)
+{
+    free(m_colMap);
+    free(m_rowMap);
+    free(m_lineBuf);
+    m_colMap  = NULL;
+    m_rowMap  = NULL;
+    m_lineBuf = NULL;
+    m_mapLen  = 0;
+    m_lineLen = 0;
+
+    return true;
+}
+
+bool FimgSw::t_Stretch(struct fimg2d_blit *cmd)
+{
+    struct fimg2d_image *src = cmd->src;
+    struct fimg2d_image *dst = cmd->dst;
+    struct fimg2d_rect  *dstRect;
+    unsigned char       *dstBase;
+    unsigned char       *srcBase = NULL;
+    unsigned int        *srcLine;
+    unsigned int        *dstLine;
+    unsigned int         alpha = cmd->param.g_alpha;
+    bool                 premult = (cmd->param.premult == PREMULTIPLIED);
+    bool                 rotated = (cmd->param.rotate == ROT_90 || cmd->param.rotate == ROT_270);
+    /* SRC and fill without global alpha store the source as is */
+    bool                 blend = (cmd->op == BLIT_OP_SRC_OVER || alpha != 0xff);
+    bool                 toPremult = (blend == true && premult == false);
+    int                  dw, dh;
+    int                  cx1, cy1, cx2, cy2;
+
+    if (m_CheckBlit(cmd) == false)
+        return false;
+
+    dstRect = &dst->rect;
+    dw = dstRect->x2 - dstRect->x1;
+    dh = dstRect->y2 - dstRect->y1;
+
+    /* write window, clipping is in dst image coordinates */
+    cx1 = dstRect->x1;
+    cy1 = dstRect->y1;
+    cx2 = dstRect->x2;
+    cy2 = dstRect->y2;
+    if (cmd->param.clipping.enable == true) {
+        cx1 = FIMG_SW_MAX(cx1, cmd->param.clipping.x1);
+        cy1 = FIMG_SW_MAX(cy1, cmd->param.clipping.y1);
+        cx2 = FIMG_SW_MIN(cx2, cmd->param.clipping.x2);
+        cy2 = FIMG_SW_MIN(cy2, cmd->param.clipping.y2);
+        if (cx2 <= cx1 || cy2 <= cy1)
+            return true;
+    }
+
+    dstBase = (unsigned char *)dst->addr.start;
+
+    if (cmd->op != BLIT_OP_SOLID_FILL) {
+        struct fimg2d_rect *srcRect = &src->rect;
+        int bpp = bytesPerPixel(src->fmt);
+
+        srcBase = (unsigned char *)src->addr.start;
+
+        /* same format, same size, no transform : plain row copy */
+        if (   cmd->op == BLIT_OP_SRC && cmd->param.rotate == ORIGIN && alpha == 0xff
+            && src->fmt == dst->fmt && src->order == dst->order
+            && srcRect->x2 - srcRect->x1 == dw && srcRect->y2 - srcRect->y1 == dh) {
+            for (int y = cy1; y < cy2; y++) {
+                memcpy(dstBase + y * dst->stride + cx1 * bpp,
+                       srcBase + (srcRect->y1 + y - dstRect->y1) * src->stride
+                               + (srcRect->x1 + cx1 - dstRect->x1) * bpp,
+                       (cx2 - cx1) * bpp);
+            }
+            return true;
+        }
+    }
+
+    if (m_PrepareBuf(FIMG_SW_MAX(dw, dh), dw) == false)
+        return false;
+
+    srcLine = m_lineBuf;
+    dstLine = m_lineBuf + dw;
+
+    if (cmd->op != BLIT_OP_SOLID_FILL)
+        m_BuildMap(cmd, dw, dh);
+
+    int *colNext = m_colMap + m_mapLen;
+    int *colFrac = m_colMap + m_mapLen * 2;
+    int *rowNext = m_rowMap + m_mapLen;
+    int *rowFrac = m_rowMap + m_mapLen * 2;
+
+    for (int y = cy1; y < cy2; y++) {
+        unsigned char *dstRow = dstBase + y * dst->stride;
+        int j = y - dstRect->y1;
+
+        /* 1. source line, premultiplied when blending */
+        if (cmd->op == BLIT_OP_SOLID_FILL) {
+            unsigned int color = (unsigned int)cmd->param.solid_color;
+            if (toPremult == true)
+                color = premultiply(color);
+            for (int x = cx1; x < cx2; x++)
+                srcLine[x - dstRect->x1] = color;
+        } else if (m_bilinear == true) {
+            for (int x = cx1; x < cx2; x++) {
+                int i = x - dstRect->x1;
+                if (rotated == true)
+                    srcLine[i] = samplePixel(src, srcBase, m_rowMap[j], rowNext[j], rowFrac[j],
+                                             m_colMap[i], colNext[i], colFrac[i], toPremult);
+                else
+                    srcLine[i] = samplePixel(src, srcBase, m_colMap[i], colNext[i], colFrac[i],
+                                             m_rowMap[j], rowNext[j], rowFrac[j], toPremult);
+            }
+        } else {
+            if (rotated == true) {
+                int sx = m_rowMap[j];
+                for (int x = cx1; x < cx2; x++) {
+                    int i = x - dstRect->x1;
+                    srcLine[i] = decodePixel(srcBase + m_colMap[i] * src->stride, sx, src->fmt, src->order);
+                }
+            } else {
+                unsigned char *srcRow = srcBase + m_rowMap[j] * src->stride;
+                for (int x = cx1; x < cx2; x++) {
+                    int i = x - dstRect->x1;
+                    srcLine[i] = decodePixel(srcRow, m_colMap[i], src->fmt, src->order);
+                }
+            }
+
+            if (toPremult == true) {
+                for (int x = cx1; x < cx2; x++)
+                    srcLine[x - dstRect->x1] = premultiply(srcLine[x - dstRect->x1]);
+            }
+        }
+
+        if (alpha != 0xff) {
+            for (int x = cx1; x < cx2; x++)
+                srcLine[x - dstRect->x1] = scaleAlpha(srcLine[x - dstRect->x1], alpha);
+        }
+
+        /* 2. compose */
+        unsigned int *outLine = srcLine + (cx1 - dstRect->x1);
+
+        if (cmd->op == BLIT_OP_SRC_OVER) {
+            for (int x = cx1; x < cx2; x++) {
+                unsigned int d = decodePixel(dstRow, x, dst->fmt, dst->order);
+                dstLine[x - dstRect->x1] = (premult == true) ? d : premultiply(d);
+            }
+            blendLineSrcOver(dstLine + (cx1 - dstRect->x1), outLine, cx2 - cx1);
+            outLine = dstLine + (cx1 - dstRect->x1);
+        }
+
+        /* 3. store */
+        for (int x = cx1; x < cx2; x++) {
+            unsigned int w = outLine[x - cx1];
+            if (toPremult == true)
+                w = unpremultiply(w);
+            encodePixel(dstRow, x, w, dst->fmt, dst->order);
+        }
+    }
+
+    return true;
+}
+
+bool FimgSw::t_Sync(void)
+{
+    return true;
+}
+
+bool FimgSw::t_Lock(void)
+{
+    m_lock->lock();
+    return true;
+}
+
+bool FimgSw::t_UnLock(void)
+{
+    m_lock->unlock();
+    return true;
+}
+
+bool FimgSw::m_CheckBlit(struct fimg2d_blit *cmd)
+{
+    switch (cmd->op) {
+    case BLIT_OP_SOLID_FILL:
+    case BLIT_OP_SRC:
+    case BLIT_OP_SRC_OVER:
+        break;
+    default:
+        PRINT("%s::op(%d) is not supported\n", __func__, cmd->op);
+        return false;
+    }
+
+    if (cmd->param.rotate > YFLIP) {
+        PRINT("%s::rotate(%d) is not supported\n", __func__, cmd->param.rotate);
+        return false;
+    }
+
+    if (cmd->msk != NULL || cmd->dst == NULL || isValidImage(cmd->dst) == false)
+        return false;
+
+    if (cmd->op != BLIT_OP_SOLID_FILL) {
+        if (cmd->src == NULL || isValidImage(cmd->src) == false)
+            return false;
+        if (cmd->param.repeat.mode != NO_REPEAT || cmd->param.bluscr.mode != OPAQUE) {
+            PRINT("%s::repeat(%d)/bluescreen(%d) is not supported\n", __func__,
+                  cmd->param.repeat.mode, cmd->param.bluscr.mode);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool FimgSw::m_PrepareBuf(unsigned int mapLen, unsigned int lineLen)
+{
+    /* map, next and frac of every coordinate */
+    if (m_mapLen < mapLen) {
+        free(m_colMap);
+        free(m_rowMap);
+        m_colMap = (int *)malloc(mapLen * 3 * sizeof(int));
+        m_rowMap = (int *)malloc(mapLen * 3 * sizeof(int));
+        m_mapLen = mapLen;
+    }
+
+    if (m_lineLen < lineLen) {
+        free(m_lineBuf);
+        m_lineBuf = (unsigned int *)malloc(lineLen * 2 * sizeof(unsigned int));
+        m_lineLen = lineLen;
+    }
+
+    if (m_colMap == NULL || m_rowMap == NULL || m_lineBuf == NULL) {
+        PRINT("%s::malloc fail\n", __func__);
+        t_Destroy();
+        return false;
+    }
+
+    return true;
+}
+
+/*
+ * colMap walks a destination row, rowMap walks destination rows.
+ * Rotated (clockwise) : colMap gives source y, rowMap gives source x.
+ * Bilinear taps are only built when the blit scales.
+ */
+void FimgSw::m_BuildMap(struct fimg2d_blit *cmd, int dw, int dh)
+{
+    struct fimg2d_rect *s = &cmd->src->rect;
+    int sw = s->x2 - s->x1;
+    int sh = s->y2 - s->y1;
+    bool rotated = (cmd->param.rotate == ROT_90 || cmd->param.rotate == ROT_270);
+    int colLen = rotated ? sh : sw;
+    int rowLen = rotated ? sw : sh;
+    int colStart = rotated ? s->y1 : s->x1;
+    int rowStart = rotated ? s->x1 : s->y1;
+    bool colReverse;
+    bool rowReverse;
+
+    m_bilinear = (cmd->param.scaling.mode == SCALING_BILINEAR && (colLen != dw || rowLen != dh));
+
+    switch (cmd->param.rotate) {
+    case ROT_90:
+        colReverse = true;
+        rowReverse = false;
+        break;
+    case ROT_180:
+        colReverse = true;
+        rowReverse = true;
+        break;
+    case ROT_270:
+        colReverse = false;
+        rowReverse = true;
+        break;
+    case XFLIP:
+        colReverse = true;
+        rowReverse = false;
+        break;
+    case YFLIP:
+        colReverse = false;
+        rowReverse = true;
+        break;
+    case ORIGIN:
+    default:
+        colReverse = false;
+        rowReverse = false;
+        break;
+    }
+
+    if (m_bilinear == true) {
+        buildMap(m_colMap, m_colMap + m_mapLen, m_colMap + m_mapLen * 2,
+                 dw, colStart, colLen, colReverse);
+        buildMap(m_rowMap, m_rowMap + m_mapLen, m_rowMap + m_mapLen * 2,
+                 dh, rowStart, rowLen, rowReverse);
+    } else {
+        buildMap(m_colMap, NULL, NULL, dw, colStart, colLen, colReverse);
+        buildMap(m_rowMap, NULL, NULL, dh, rowStart, rowLen, rowReverse);
+    }
+}
+
+}; // namespace android
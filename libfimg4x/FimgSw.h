@@ -0,0 +1,89 @@
+/*
+**
+** Copyright 2009 Samsung Electronics Co, Ltd.
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+**
+*/
+
+#ifndef FIMG_SW_H
+#define FIMG_SW_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <utils/threads.h>
+
+#include "FimgApi.h"
+
+#include "sec_g2d_4x.h"
+
+namespace android
+{
+
+//---------------------------------------------------------------------------//
+// class FimgSw : public FimgApi
+//
+// CPU implementation of the fimg2d_blit subset used in this tree:
+//   op       : SOLID_FILL, SRC, SRC_OVER
+//   rotate   : ORIGIN, ROT_90, ROT_180, ROT_270, XFLIP, YFLIP
+//   scaling  : nearest, SCALING_BILINEAR with 8 bit weights
+//   format   : ARGB/XRGB_8888 in any ARGB order, RGB_565, ARGB/XRGB_4444
+//   address  : ADDR_USER, ADDR_USER_RSVD (virtual addresses)
+// SRC and SOLID_FILL without global alpha store the source unchanged,
+// only blending goes through premultiplied alpha. Results only depend on
+// the command, so they can be used as reference images. Unsupported
+// commands fail, nothing is written.
+//---------------------------------------------------------------------------//
+class FimgSw : public FimgApi
+{
+private :
+    Mutex          *m_lock;
+
+    int            *m_colMap;
+    int            *m_rowMap;
+    unsigned int    m_mapLen;
+    bool            m_bilinear;
+    unsigned int   *m_lineBuf;
+    unsigned int    m_lineLen;
+
+    static Mutex    m_instanceLock;
+    static FimgApi *m_ptrFimgApi;
+
+protected :
+    FimgSw();
+    virtual ~FimgSw();
+
+public:
+    static FimgApi *CreateInstance();
+    static void     DestroyInstance(void);
+
+protected:
+    virtual bool    t_Create(void);
+    virtual bool    t_Destroy(void);
+    virtual bool    t_Stretch(struct fimg2d_blit *cmd);
+    virtual bool    t_Sync(void);
+    virtual bool    t_Lock(void);
+    virtual bool    t_UnLock(void);
+
+private:
+    bool            m_CheckBlit(struct fimg2d_blit *cmd);
+    bool            m_PrepareBuf(unsigned int mapLen, unsigned int lineLen);
+    void            m_BuildMap(struct fimg2d_blit *cmd, int dw, int dh);
+};
+
+}; // namespace android
+
+#endif // FIMG_SW_H
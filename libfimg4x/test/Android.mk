@@ -0,0 +1,28 @@
+# Copyright (C) 2008 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+LOCAL_PATH:= $(call my-dir)
+
+# pixel exact checks of the software G2D backend: fimg_sw_test
+include $(CLEAR_VARS)
+LOCAL_SRC_FILES := fimg_sw_test.cpp \
+	../FimgApi.cpp ../FimgExynos4.cpp ../FimgSw.cpp
+LOCAL_C_INCLUDES := \
+	$(LOCAL_PATH)/.. \
+	external/skia/include/core
+LOCAL_CFLAGS += -DUSE_FIMGAPI_SW
+LOCAL_SHARED_LIBRARIES := liblog libutils libbinder
+LOCAL_MODULE := fimg_sw_test
+LOCAL_MODULE_TAGS := tests
+include $(BUILD_EXECUTABLE)
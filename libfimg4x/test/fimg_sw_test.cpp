@@ -0,0 +1,185 @@
+/*
+**
+** Copyright 2009 Samsung Electronics Co, Ltd.
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+**
+**
+*/
+
+/*
+ * Regression test of the software G2D backend (FimgSw), run through
+ * stretchFimgApi() with USE_FIMGAPI_SW. Every case checks exact pixels.
+ *
+ * usage: fimg_sw_test
+ * Returns 1 if any case fails.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "FimgApi.h"
+
+static int num_failed;
+
+static void set_image(struct fimg2d_image *img, void *addr, int width, int height,
+        enum color_format fmt, int bpp)
+{
+    memset(img, 0, sizeof(*img));
+    img->width      = width;
+    img->height     = height;
+    img->stride     = width * bpp;
+    img->order      = AX_RGB;
+    img->fmt        = fmt;
+    img->addr.type  = ADDR_USER;
+    img->addr.start = (unsigned long)addr;
+    img->rect.x2    = width;
+    img->rect.y2    = height;
+}
+
+static void set_blit(struct fimg2d_blit *cmd, enum blit_op op, struct fimg2d_image *src,
+        struct fimg2d_image *dst)
+{
+    memset(cmd, 0, sizeof(*cmd));
+    cmd->op             = op;
+    cmd->src            = src;
+    cmd->dst            = dst;
+    cmd->param.g_alpha  = 0xff;
+    cmd->param.premult  = NON_PREMULTIPLIED;
+    cmd->param.rotate   = ORIGIN;
+    cmd->sync           = BLIT_SYNC;
+}
+
+static void check(const char *name, struct fimg2d_blit *cmd, const void *got,
+        const void *expect, int num, int bpp)
+{
+    bool ok = (stretchFimgApi(cmd) == 0);
+
+    for (int i = 0; ok && i < num; i++) {
+        unsigned int g = (bpp == 4) ? ((const unsigned int *)got)[i]
+                                    : ((const unsigned short *)got)[i];
+        unsigned int e = (bpp == 4) ? ((const unsigned int *)expect)[i]
+                                    : ((const unsigned short *)expect)[i];
+        if (g != e) {
+            printf("%-20s pixel %d: got 0x%0*x, expected 0x%0*x\n",
+                    name, i, bpp * 2, g, bpp * 2, e);
+            ok = false;
+        }
+    }
+
+    printf("%-20s %s\n", name, ok ? "ok" : "FAILED");
+    if (ok == false)
+        num_failed++;
+}
+
+/* SRC without global alpha must not round trip through premultiplied alpha */
+static void test_src_keeps_color(void)
+{
+    unsigned int src[1] = { 0x30c08020 };
+    unsigned int dst[4];
+    unsigned int expect[4] = { 0x30c08020, 0x30c08020, 0x30c08020, 0x30c08020 };
+    struct fimg2d_image s, d;
+    struct fimg2d_blit cmd;
+
+    set_image(&s, src, 1, 1, CF_ARGB_8888, 4);
+    set_image(&d, dst, 2, 2, CF_ARGB_8888, 4);
+    set_blit(&cmd, BLIT_OP_SRC, &s, &d);
+    check("src_keeps_color", &cmd, dst, expect, 4, 4);
+}
+
+static void test_fill_keeps_color(void)
+{
+    unsigned int dst[2];
+    unsigned int expect[2] = { 0x30c08020, 0x30c08020 };
+    struct fimg2d_image d;
+    struct fimg2d_blit cmd;
+
+    set_image(&d, dst, 2, 1, CF_ARGB_8888, 4);
+    set_blit(&cmd, BLIT_OP_SOLID_FILL, NULL, &d);
+    cmd.param.solid_color = 0x30c08020;
+    check("fill_keeps_color", &cmd, dst, expect, 2, 4);
+}
+
+static void test_src_over(void)
+{
+    unsigned int src[1] = { 0x80ff0000 };
+    unsigned int dst[1] = { 0xff0000ff };
+    unsigned int expect[1] = { 0xff80007f };
+    struct fimg2d_image s, d;
+    struct fimg2d_blit cmd;
+
+    set_image(&s, src, 1, 1, CF_ARGB_8888, 4);
+    set_image(&d, dst, 1, 1, CF_ARGB_8888, 4);
+    set_blit(&cmd, BLIT_OP_SRC_OVER, &s, &d);
+    check("src_over", &cmd, dst, expect, 1, 4);
+}
+
+/* clockwise: the source row becomes the destination column */
+static void test_rotate_90(void)
+{
+    unsigned int src[2] = { 0xff112233, 0xff445566 };
+    unsigned int dst[2];
+    unsigned int expect[2] = { 0xff112233, 0xff445566 };
+    struct fimg2d_image s, d;
+    struct fimg2d_blit cmd;
+
+    set_image(&s, src, 2, 1, CF_ARGB_8888, 4);
+    set_image(&d, dst, 1, 2, CF_ARGB_8888, 4);
+    set_blit(&cmd, BLIT_OP_SRC, &s, &d);
+    cmd.param.rotate = ROT_90;
+    check("rotate_90", &cmd, dst, expect, 2, 4);
+}
+
+static void test_bilinear_upscale(void)
+{
+    unsigned int src[2] = { 0xff000000, 0xffffffff };
+    unsigned int dst[8];
+    unsigned int expect[8] = { 0xff000000, 0xff404040, 0xffbfbfbf, 0xffffffff,
+                               0xff000000, 0xff404040, 0xffbfbfbf, 0xffffffff };
+    struct fimg2d_image s, d;
+    struct fimg2d_blit cmd;
+
+    set_image(&s, src, 2, 1, CF_ARGB_8888, 4);
+    set_image(&d, dst, 4, 2, CF_ARGB_8888, 4);
+    set_blit(&cmd, BLIT_OP_SRC, &s, &d);
+    cmd.param.scaling.mode = SCALING_BILINEAR;
+    check("bilinear_upscale", &cmd, dst, expect, 8, 4);
+}
+
+/* the HDMI UI layer: non-premultiplied ARGB8888 scaled to ARGB4444 */
+static void test_hdmi_ui_4444(void)
+{
+    unsigned int src[2] = { 0x80ff0000, 0x8000ff00 };
+    unsigned short dst[4];
+    unsigned short expect[4] = { 0x8f00, 0x8b40, 0x84b0, 0x80f0 };
+    struct fimg2d_image s, d;
+    struct fimg2d_blit cmd;
+
+    set_image(&s, src, 2, 1, CF_ARGB_8888, 4);
+    set_image(&d, dst, 4, 1, CF_ARGB_4444, 2);
+    set_blit(&cmd, BLIT_OP_SRC, &s, &d);
+    cmd.param.scaling.mode = SCALING_BILINEAR;
+    check("hdmi_ui_4444", &cmd, dst, expect, 4, 2);
+}
+
+int main(void)
+{
+    test_src_keeps_color();
+    test_fill_keeps_color();
+    test_src_over();
+    test_rotate_90();
+    test_bilinear_upscale();
+    test_hdmi_ui_4444();
+
+    return num_failed ? 1 : 0;
+}
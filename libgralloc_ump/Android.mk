@@ -34,7 +34,9 @@ LOCAL_C_INCLUDES += $(LOCAL_PATH)/../include
 LOCAL_SRC_FILES := \
 	gralloc_module.cpp \
 	alloc_device.cpp \
-	framebuffer_device.cpp
+	framebuffer_device.cpp \
+	gralloc_rsvd.cpp \
+	gralloc_rect.cpp
 
 LOCAL_MODULE_TAGS := optional
 #LOCAL_MODULE := gralloc.default
@@ -40,6 +40,8 @@
 #include "gralloc_priv.h"
 #include "gralloc_helper.h"
 #include "framebuffer_device.h"
+#include "gralloc_rsvd.h"
+#include "gralloc_rect.h"
 
 #include "ump.h"
 #include "ump_ref_drv.h"
@@ -80,24 +82,32 @@
 #define OMX_COLOR_FormatYUV420SemiPlanar 0x15
 #endif
 
-#define PFX_NODE_MEM   "/dev/fimg2d"
 #define MALI_DDK_VERSION_R3P1 0
-static int gMemfd = 0;
 
 bool ion_dev_open = true;
 static pthread_mutex_t l_surface= PTHREAD_MUTEX_INITIALIZER;
-static int buffer_offset = 0;
+static unsigned int rsvd_paddr = 0;
 static int gfd = 0;
 
-#ifdef USE_PARTIAL_FLUSH
-extern struct private_handle_rect *rect_list;
-extern private_handle_rect *find_rect(int secure_id);
-extern private_handle_rect *find_last_rect(int secure_id);
-extern int release_rect(int secure_id);
-#endif
-
 #define EXYNOS4_ALIGN( value, base ) (((value) + ((base) - 1)) & ~((base) - 1))
 
+/*
+ * Freed UMP/ION buffers always go back to the kernel. Their secure id and
+ * ION fd were handed to every client of the buffer and stay imported
+ * there until the client unregisters, which cannot be seen from here, so
+ * handing the memory to a new owner could alias it with a stale import.
+ */
+static void release_ump_buffer(private_handle_t const* hnd)
+{
+    ump_mapped_pointer_release((ump_handle)hnd->ump_mem_handle);
+    ump_reference_release((ump_handle)hnd->ump_mem_handle);
+
+    if (hnd->flags & private_handle_t::PRIV_FLAGS_USES_ION) {
+        ion_unmap((void*)hnd->base, hnd->size);
+        ion_free(hnd->fd);
+    }
+}
+
 static int gralloc_alloc_buffer(alloc_device_t* dev, size_t size, int usage,
                                 buffer_handle_t* pHandle, int w, int h,
                                 int format, int bpp, int stride_raw, int stride)
@@ -108,11 +118,10 @@ static int gralloc_alloc_buffer(alloc_device_t* dev, size_t size, int usage,
 
     size = round_up_to_page_size(size);
     if (usage & GRALLOC_USAGE_HW_FIMC1) {
-        int dev_fd=0;
         char node[20];
         int ret;
-        int paddr=0;
-        int offset=0;
+        size_t offset = 0;
+        void *region;
 
         struct v4l2_control     vc;
         sprintf(node, "%s", PFX_NODE_FIMC1);
@@ -122,23 +131,38 @@ static int gralloc_alloc_buffer(alloc_device_t* dev, size_t size, int usage,
 
             if (gfd < 0) {
                 ALOGE("%s:: %s Post processor open error\n", __func__, node);
-                return false;
+                gfd = 0;
+                return -1;
             }
         }
 
-        vc.id = V4L2_CID_RESERVED_MEM_BASE_ADDR;
-        vc.value = 0;
-        ret = ioctl(gfd, VIDIOC_G_CTRL, &vc);
+        if (rsvd_paddr == 0) {
+            vc.id = V4L2_CID_RESERVED_MEM_BASE_ADDR;
+            vc.value = 0;
+            ret = ioctl(gfd, VIDIOC_G_CTRL, &vc);
+            if (ret < 0) {
+                ALOGE("Error in video VIDIOC_G_CTRL - V4L2_CID_RESERVED_MEM_BAES_ADDR (%d)\n", ret);
+                return -1;
+            }
+            rsvd_paddr = (unsigned int)vc.value;
+        }
+
+        ret = rsvd_heap_alloc(size, &offset);
         if (ret < 0) {
-            ALOGE("Error in video VIDIOC_G_CTRL - V4L2_CID_RESERVED_MEM_BAES_ADDR (%d)\n", ret);
-            return false;
+            struct rsvd_heap_stats stats;
+
+            if (rsvd_heap_get_stats(&stats) == 0)
+                ALOGE("%s::FIMC1 reserved memory is full (size %d, used %d/%d, largest free %d, fragmentation %d%%)",
+                        __func__, size, stats.used, stats.total, stats.largest_free, stats.fragmentation);
+            return ret;
         }
-        paddr = (unsigned int)vc.value;
 
-        if ((buffer_offset + size) >= FIMC1_RESERVED_SIZE * 1024)
-            buffer_offset = 0;
+        region = rsvd_mem_map(rsvd_paddr);
+        if (region == NULL) {
+            rsvd_heap_free(offset);
+            return -1;
+        }
 
-        paddr += buffer_offset;
         private_handle_t* hnd = new private_handle_t(private_handle_t::PRIV_FLAGS_USES_IOCTL, size, 0,
                 private_handle_t::LOCK_STATE_MAPPED, 0, 0);
 
@@ -148,27 +172,15 @@ static int gralloc_alloc_buffer(alloc_device_t* dev, size_t size, int usage,
         hnd->width = w;
         hnd->height = h;
         hnd->bpp = bpp;
-        hnd->paddr = paddr;
-        hnd->offset = buffer_offset;
+        hnd->paddr = rsvd_paddr + offset;
+        hnd->offset = offset;
         hnd->stride = stride;
         hnd->fd = gfd;
         hnd->uoffset = (EXYNOS4_ALIGN((EXYNOS4_ALIGN(hnd->width, 16) * EXYNOS4_ALIGN(hnd->height, 16)), 4096));
         hnd->voffset = (EXYNOS4_ALIGN((EXYNOS4_ALIGN((hnd->width >> 1), 16) * EXYNOS4_ALIGN((hnd->height >> 1), 16)), 4096));
-        buffer_offset += size;
-
-        if (gMemfd == 0) {
-            gMemfd = open(PFX_NODE_MEM, O_RDWR);
-            if (gMemfd < 0) {
-                ALOGE("%s:: %s exynos-mem open error\n", __func__, PFX_NODE_MEM);
-                return false;
-            }
-        }
-
-        size_t size = FIMC1_RESERVED_SIZE * 1024;
-
-        void *mappedAddress = mmap(0, size,
-               PROT_READ|PROT_WRITE, MAP_SHARED, gMemfd, (hnd->paddr - hnd->offset));
-        hnd->base = intptr_t(mappedAddress) + hnd->offset;
+        hnd->base = intptr_t(region) + hnd->offset;
+        if (gralloc_rect_add(gralloc_rect_key(hnd)) < 0)
+            ALOGE("paddr: 0x%x, rect add error", hnd->paddr);
         return 0;
     } else {
         ion_buffer ion_fd = 0;
@@ -234,17 +246,8 @@ static int gralloc_alloc_buffer(alloc_device_t* dev, size_t size, int usage,
                     private_handle_t::LOCK_STATE_MAPPED, ump_id, ump_mem_handle, ion_fd, 0, 0);
                     if (NULL != hnd) {
                         *pHandle = hnd;
-#ifdef USE_PARTIAL_FLUSH
-                        if (hnd->flags & private_handle_t::PRIV_FLAGS_USES_UMP) {
-                            private_handle_rect *psRect;
-                            private_handle_rect *psFRect;
-                            psRect = (private_handle_rect *)calloc(1, sizeof(private_handle_rect));
-                            psRect->handle = (int)hnd->ump_id;
-                            psRect->stride = (int)hnd->stride_raw;
-                            psFRect = find_last_rect((int)hnd->ump_id);
-                            psFRect->next = psRect;
-                        }
-#endif
+                        if (gralloc_rect_tracked(hnd) && gralloc_rect_add(gralloc_rect_key(hnd)) < 0)
+                            ALOGE("secure id: 0x%x, rect add error", (int)hnd->ump_id);
                         hnd->format = format;
                         hnd->usage = usage;
                         hnd->width = w;
@@ -446,6 +449,9 @@ static int alloc_device_free(alloc_device_t* dev, buffer_handle_t handle)
     private_handle_t const* hnd = reinterpret_cast<private_handle_t const*>(handle);
     private_module_t* m = reinterpret_cast<private_module_t*>(dev->common.module);
     pthread_mutex_lock(&l_surface);
+    if (gralloc_rect_tracked(hnd) && gralloc_rect_remove(gralloc_rect_key(hnd)) < 0)
+        ALOGE("key: 0x%x, release error", gralloc_rect_key(hnd));
+
     if (hnd->flags & private_handle_t::PRIV_FLAGS_FRAMEBUFFER) {
         /* free this buffer */
         const size_t bufferSize = m->finfo.line_length * m->info.yres;
@@ -453,31 +459,12 @@ static int alloc_device_free(alloc_device_t* dev, buffer_handle_t handle)
         m->bufferMask &= ~(1<<index);
         close(hnd->fd);
     } else if (hnd->flags & private_handle_t::PRIV_FLAGS_USES_IOCTL) {
-        void* base = (void*)(intptr_t(hnd->base) - hnd->offset);
-        size_t size = FIMC1_RESERVED_SIZE * 1024;
-        if (munmap(base, size) < 0)
-            ALOGE("Could not unmap %s", strerror(errno));
-        if (0 < gMemfd) {
-            close(gMemfd);
-            gMemfd = 0;
-        }
+        rsvd_heap_free(hnd->offset);
+        rsvd_mem_unmap();
     } else if (hnd->flags & private_handle_t::PRIV_FLAGS_USES_UMP) {
-#ifdef USE_PARTIAL_FLUSH
-        if (!release_rect((int)hnd->ump_id))
-            ALOGE("secure id: 0x%x, release error",(int)hnd->ump_id);
-#endif
-        ump_mapped_pointer_release((ump_handle)hnd->ump_mem_handle);
-        ump_reference_release((ump_handle)hnd->ump_mem_handle);
+        release_ump_buffer(hnd);
     } else if (hnd->flags & private_handle_t::PRIV_FLAGS_USES_ION) {
-#ifdef USE_PARTIAL_FLUSH
-        if (!release_rect((int)hnd->ump_id))
-            ALOGE("secure id: 0x%x, release error",(int)hnd->ump_id);
-#endif
-        ump_mapped_pointer_release((ump_handle)hnd->ump_mem_handle);
-        ump_reference_release((ump_handle)hnd->ump_mem_handle);
-
-        ion_unmap((void*)hnd->base, hnd->size);
-        ion_free(hnd->fd);
+        release_ump_buffer(hnd);
     }
     pthread_mutex_unlock(&l_surface);
     delete hnd;
@@ -485,6 +472,21 @@ static int alloc_device_free(alloc_device_t* dev, buffer_handle_t handle)
     return 0;
 }
 
+static void alloc_device_dump(alloc_device_t* dev, char *buff, int buff_len)
+{
+    struct rsvd_heap_stats rsvd;
+
+    if (buff == NULL || buff_len <= 0)
+        return;
+
+    buff[0] = '\0';
+    if (rsvd_heap_get_stats(&rsvd) == 0)
+        snprintf(buff, buff_len,
+                "  FIMC1 reserved: %d buffers, %u/%u KB, largest free %u KB, fragmentation %d%%\n",
+                rsvd.num_allocs, rsvd.used / 1024, rsvd.total / 1024,
+                rsvd.largest_free / 1024, rsvd.fragmentation);
+}
+
 static int alloc_device_close(struct hw_device_t *device)
 {
     alloc_device_t* dev = reinterpret_cast<alloc_device_t*>(device);
@@ -528,6 +530,7 @@ int alloc_device_open(hw_module_t const* module, const char* name, hw_device_t**
     dev->common.close = alloc_device_close;
     dev->alloc = alloc_device_alloc;
     dev->free = alloc_device_free;
+    dev->dump = alloc_device_dump;
 
     *device = &dev->common;
 
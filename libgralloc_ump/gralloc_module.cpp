@@ -43,6 +43,8 @@
 #include "gralloc_priv.h"
 #include "alloc_device.h"
 #include "framebuffer_device.h"
+#include "gralloc_rsvd.h"
+#include "gralloc_rect.h"
 
 #include "ump.h"
 #include "ump_ref_drv.h"
@@ -59,63 +61,6 @@ static int gMemfd = 0;
 
 /* we need this for now because pmem cannot mmap at an offset */
 #define PMEM_HACK   1
-#ifdef USE_PARTIAL_FLUSH
-struct private_handle_rect *rect_list;
-
-private_handle_rect *find_rect(int secure_id)
-{
-    private_handle_rect *psRect;
-
-    for (psRect = rect_list; psRect; psRect = psRect->next)
-        if (psRect->handle == secure_id)
-            break;
-    if (!psRect)
-        return NULL;
-
-    return psRect;
-}
-
-private_handle_rect *find_last_rect(int secure_id)
-{
-    private_handle_rect *psRect;
-    private_handle_rect *psFRect;
-
-    if (rect_list == NULL) {
-        rect_list = (private_handle_rect *)calloc(1, sizeof(private_handle_rect));
-        return rect_list;
-    }
-
-    for (psRect = rect_list; psRect; psRect = psRect->next) {
-        if (psRect->handle == secure_id)
-            return psFRect;
-        psFRect = psRect;
-    }
-    return psFRect;
-}
-
-int release_rect(int secure_id)
-{
-    private_handle_rect *psRect;
-    private_handle_rect *psTRect;
-
-    for (psRect = rect_list; psRect; psRect = psRect->next) {
-        if (psRect->next) {
-            if (psRect->next->handle == secure_id) {
-                if (psRect->next->next)
-                    psTRect = psRect->next->next;
-                else
-                    psTRect = NULL;
-
-                free(psRect->next);
-                psRect->next = psTRect;
-                return 1;
-            }
-        }
-    }
-
-    return 0;
-}
-#endif
 
 static int gralloc_map(gralloc_module_t const* module,
         buffer_handle_t handle, void** vaddr)
@@ -123,13 +68,9 @@ static int gralloc_map(gralloc_module_t const* module,
     private_handle_t* hnd = (private_handle_t*)handle;
     if (!(hnd->flags & private_handle_t::PRIV_FLAGS_FRAMEBUFFER)) {
         if (hnd->flags & private_handle_t::PRIV_FLAGS_USES_IOCTL) {
-            size_t size = FIMC1_RESERVED_SIZE * 1024;
-            void *mappedAddress = mmap(0, size,
-                    PROT_READ|PROT_WRITE, MAP_SHARED, gMemfd, (hnd->paddr - hnd->offset));
-            if (mappedAddress == MAP_FAILED) {
-                ALOGE("Could not mmap %s fd(%d)", strerror(errno),hnd->fd);
-                return -errno;
-            }
+            void *mappedAddress = rsvd_mem_map(hnd->paddr - hnd->offset);
+            if (mappedAddress == NULL)
+                return -EINVAL;
             hnd->base = intptr_t(mappedAddress) + hnd->offset;
         } else if (hnd->flags & private_handle_t::PRIV_FLAGS_USES_ION) {
             size_t size = hnd->size;
@@ -166,10 +107,7 @@ static int gralloc_unmap(gralloc_module_t const* module,
     private_handle_t* hnd = (private_handle_t*)handle;
     if (!(hnd->flags & private_handle_t::PRIV_FLAGS_FRAMEBUFFER)) {
         if (hnd->flags & private_handle_t::PRIV_FLAGS_USES_IOCTL) {
-            void* base = (void*)(intptr_t(hnd->base) - hnd->offset);
-            size_t size = FIMC1_RESERVED_SIZE * 1024;
-            if (munmap(base, size) < 0)
-                ALOGE("Could not unmap %s", strerror(errno));
+            rsvd_mem_unmap();
         } else if (hnd->flags & private_handle_t::PRIV_FLAGS_USES_ION) {
             void* base = (void*)hnd->base;
             size_t size = hnd->size;
@@ -221,17 +159,8 @@ static int gralloc_register_buffer(gralloc_module_t const* module, buffer_handle
     /* if this handle was created in this process, then we keep it as is. */
     private_handle_t* hnd = (private_handle_t*)handle;
 
-#ifdef USE_PARTIAL_FLUSH
-    if (hnd->flags & private_handle_t::PRIV_FLAGS_USES_UMP) {
-        private_handle_rect *psRect;
-        private_handle_rect *psFRect;
-        psRect = (private_handle_rect *)calloc(1, sizeof(private_handle_rect));
-        psRect->handle = (int)hnd->ump_id;
-        psRect->stride = (int)hnd->stride;
-        psFRect = find_last_rect((int)hnd->ump_id);
-        psFRect->next = psRect;
-    }
-#endif
+    if (gralloc_rect_tracked(hnd) && gralloc_rect_add(gralloc_rect_key(hnd)) < 0)
+        ALOGE("key: 0x%x, rect add error", gralloc_rect_key(hnd));
 
     // wjj, when WFD, use GRALLOC_USAGE_HW_VIDEO_ENCODER, 
     // ANW pid is same as SF pid, but need to create ump handle because WFD's BQ is in different pid.
@@ -328,11 +257,8 @@ static int gralloc_unregister_buffer(gralloc_module_t const* module, buffer_hand
 
     private_handle_t* hnd = (private_handle_t*)handle;
 
-#ifdef USE_PARTIAL_FLUSH
-    if (hnd->flags & private_handle_t::PRIV_FLAGS_USES_UMP)
-        if (!release_rect((int)hnd->ump_id))
-            ALOGE("secureID: 0x%x, release error", (int)hnd->ump_id);
-#endif
+    if (gralloc_rect_tracked(hnd) && gralloc_rect_remove(gralloc_rect_key(hnd)) < 0)
+        ALOGE("key: 0x%x, release error", gralloc_rect_key(hnd));
     ALOGE_IF(hnd->lockState & private_handle_t::LOCK_STATE_READ_MASK,
             "[unregister] handle %p still locked (state=%08x)", hnd, hnd->lockState);
 
@@ -387,19 +313,10 @@ static int gralloc_lock(gralloc_module_t const* module, buffer_handle_t handle,
 
     private_handle_t* hnd = (private_handle_t*)handle;
 
-#ifdef SAMSUNG_EXYNOS_CACHE_UMP
-    if (hnd->flags & private_handle_t::PRIV_FLAGS_USES_UMP) {
-#ifdef USE_PARTIAL_FLUSH
-        private_handle_rect *psRect;
-        psRect = find_rect((int)hnd->ump_id);
-        psRect->l = l;
-        psRect->t = t;
-        psRect->w = w;
-        psRect->h= h;
-        psRect->locked = 1;
-#endif
-    }
-#endif
+    /* only CPU writes need cache maintenance on unlock */
+    if ((usage & GRALLOC_USAGE_SW_WRITE_MASK) && gralloc_rect_tracked(hnd))
+        gralloc_rect_mark(gralloc_rect_key(hnd), l, t, w, h);
+
     if (usage & (GRALLOC_USAGE_SW_READ_MASK | GRALLOC_USAGE_SW_WRITE_MASK))
         *vaddr = (void*)hnd->base;
 
@@ -420,31 +337,53 @@ static int gralloc_unlock(gralloc_module_t const* module, buffer_handle_t handle
 
     private_handle_t* hnd = (private_handle_t*)handle;
 
+    struct gralloc_rect_dirty dirty;
+    struct gralloc_range range[GRALLOC_RANGE_MAX];
+    int num_ranges = -1;
+
+    /*
+     * whole rows written since the last unlock, nothing for read only
+     * locks, -1 (everything) when the buffer is not tracked
+     */
+    if (gralloc_rect_tracked(hnd) && gralloc_rect_take(gralloc_rect_key(hnd), &dirty) == 0)
+        num_ranges = gralloc_rect_ranges(hnd, &dirty, range);
+
+    if (num_ranges < 0) {
+        num_ranges = 1;
+        range[0].offset = 0;
+        range[0].len = hnd->size;
 #ifdef SAMSUNG_EXYNOS_CACHE_UMP
-    if (hnd->flags & private_handle_t::PRIV_FLAGS_USES_UMP) {
-#ifdef USE_PARTIAL_FLUSH
-        private_handle_rect *psRect;
-        psRect = find_rect((int)hnd->ump_id);
-        ump_cpu_msync_now((ump_handle)hnd->ump_mem_handle, UMP_MSYNC_CLEAN,
-                (void *)(hnd->base + (psRect->stride * psRect->t)), psRect->stride * psRect->h );
+    } else if (hnd->flags & private_handle_t::PRIV_FLAGS_USES_UMP) {
+        for (int i = 0; i < num_ranges; i++)
+            ump_cpu_msync_now((ump_handle)hnd->ump_mem_handle, UMP_MSYNC_CLEAN,
+                    (void *)(hnd->base + range[i].offset), range[i].len);
         return 0;
 #endif
-        ump_cpu_msync_now((ump_handle)hnd->ump_mem_handle, UMP_MSYNC_CLEAN_AND_INVALIDATE, NULL, 0);
     }
+
+#ifdef SAMSUNG_EXYNOS_CACHE_UMP
+    if (hnd->flags & private_handle_t::PRIV_FLAGS_USES_UMP)
+        ump_cpu_msync_now((ump_handle)hnd->ump_mem_handle, UMP_MSYNC_CLEAN_AND_INVALIDATE, NULL, 0);
 #endif
-    if (hnd->flags & private_handle_t::PRIV_FLAGS_USES_ION)
-        ion_msync(hnd->ion_client, hnd->fd, IMSYNC_DEV_TO_RW | IMSYNC_SYNC_FOR_DEV, hnd->size, hnd->offset);
+    if (hnd->flags & private_handle_t::PRIV_FLAGS_USES_ION) {
+        for (int i = 0; i < num_ranges; i++)
+            ion_msync(hnd->ion_client, hnd->fd, IMSYNC_DEV_TO_RW | IMSYNC_SYNC_FOR_DEV,
+                    range[i].len, hnd->offset + range[i].offset);
+    }
 
     if (hnd->flags & private_handle_t::PRIV_FLAGS_USES_IOCTL) {
         int ret;
         exynos_mem_flush_range mem;
-        mem.start = hnd->paddr;
-        mem.length = hnd->size;
 
-        ret = ioctl(gMemfd, EXYNOS_MEM_PADDR_CACHE_FLUSH, &mem);
-        if (ret < 0) {
-            ALOGE("Error in exynos-mem : EXYNOS_MEM_PADDR_CACHE_FLUSH (%d)\n", ret);
-            return false;
+        for (int i = 0; i < num_ranges; i++) {
+            mem.start = hnd->paddr + range[i].offset;
+            mem.length = range[i].len;
+
+            ret = ioctl(gMemfd, EXYNOS_MEM_PADDR_CACHE_FLUSH, &mem);
+            if (ret < 0) {
+                ALOGE("Error in exynos-mem : EXYNOS_MEM_PADDR_CACHE_FLUSH (%d)\n", ret);
+                return false;
+            }
         }
     }
 
@@ -0,0 +1,380 @@
+/*
+ * Copyright (C) 2010 ARM Limited. All rights reserved.
+ *
+ * Portions of this code have been modified from the original.
+ * These modifications are:
+ *    * gralloc_rect_*()
+ *
+ * Copyright (C) 2008 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cutils/log.h>
+
+#include "sec_format.h"
+#include "gralloc_rect.h"
+
+#ifndef OMX_COLOR_FormatYUV420Planar
+#define OMX_COLOR_FormatYUV420Planar 0x13
+#endif
+
+#ifndef OMX_COLOR_FormatYUV420SemiPlanar
+#define OMX_COLOR_FormatYUV420SemiPlanar 0x15
+#endif
+
+#define RECT_MIN_SLOTS      (64)
+
+enum {
+    SLOT_EMPTY = 0,
+    SLOT_USED,
+    SLOT_DELETED,
+};
+
+struct rect_slot {
+    int                       state;
+    int                       key;
+    int                       refs;
+    struct gralloc_rect_dirty dirty;
+};
+
+static pthread_mutex_t rect_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct rect_slot *rect_table = NULL;
+static unsigned int rect_num_slots = 0;     /* power of two */
+static unsigned int rect_num_used = 0;
+static unsigned int rect_num_deleted = 0;
+
+static inline unsigned int rect_hash(int key)
+{
+    return ((unsigned int)key * 2654435761U) & (rect_num_slots - 1);
+}
+
+/* the slot of key, or NULL */
+static struct rect_slot *rect_find(int key)
+{
+    if (rect_table == NULL)
+        return NULL;
+
+    for (unsigned int i = rect_hash(key), n = 0; n < rect_num_slots;
+         i = (i + 1) & (rect_num_slots - 1), n++) {
+        struct rect_slot *slot = &rect_table[i];
+
+        if (slot->state == SLOT_EMPTY)
+            return NULL;
+        if (slot->state == SLOT_USED && slot->key == key)
+            return slot;
+    }
+
+    return NULL;
+}
+
+/* the first empty or deleted slot of key's probe sequence */
+static struct rect_slot *rect_free_slot(int key)
+{
+    for (unsigned int i = rect_hash(key); ; i = (i + 1) & (rect_num_slots - 1)) {
+        if (rect_table[i].state != SLOT_USED)
+            return &rect_table[i];
+    }
+}
+
+/* keep the load, deleted slots included, under one half */
+static int rect_resize(void)
+{
+    struct rect_slot *old_table = rect_table;
+    unsigned int old_num_slots = rect_num_slots;
+    unsigned int num_slots = RECT_MIN_SLOTS;
+    struct rect_slot *table;
+
+    if ((rect_num_used + rect_num_deleted + 1) * 2 <= rect_num_slots)
+        return 0;
+
+    while (num_slots < (rect_num_used + 1) * 4)
+        num_slots <<= 1;
+
+    table = (struct rect_slot *)calloc(num_slots, sizeof(struct rect_slot));
+    if (table == NULL) {
+        ALOGE("%s::calloc fail", __func__);
+        return -ENOMEM;
+    }
+
+    rect_table = table;
+    rect_num_slots = num_slots;
+    rect_num_deleted = 0;
+
+    for (unsigned int i = 0; i < old_num_slots; i++) {
+        if (old_table[i].state == SLOT_USED)
+            *rect_free_slot(old_table[i].key) = old_table[i];
+    }
+
+    free(old_table);
+    return 0;
+}
+
+int gralloc_rect_add(int key)
+{
+    struct rect_slot *slot;
+    int ret = 0;
+
+    pthread_mutex_lock(&rect_lock);
+
+    slot = rect_find(key);
+    if (slot != NULL) {
+        slot->refs++;
+        goto done;
+    }
+
+    ret = rect_resize();
+    if (ret < 0)
+        goto done;
+
+    slot = rect_free_slot(key);
+    if (slot->state == SLOT_DELETED)
+        rect_num_deleted--;
+
+    memset(slot, 0, sizeof(*slot));
+    slot->state = SLOT_USED;
+    slot->key = key;
+    slot->refs = 1;
+    rect_num_used++;
+
+done:
+    pthread_mutex_unlock(&rect_lock);
+    return ret;
+}
+
+int gralloc_rect_remove(int key)
+{
+    struct rect_slot *slot;
+    int ret = 0;
+
+    pthread_mutex_lock(&rect_lock);
+
+    slot = rect_find(key);
+    if (slot == NULL) {
+        ret = -EINVAL;
+    } else if (--slot->refs == 0) {
+        slot->state = SLOT_DELETED;
+        rect_num_used--;
+        rect_num_deleted++;
+    }
+
+    pthread_mutex_unlock(&rect_lock);
+    return ret;
+}
+
+int gralloc_rect_mark(int key, int l, int t, int w, int h)
+{
+    struct gralloc_rect_dirty *dirty;
+    struct rect_slot *slot;
+
+    pthread_mutex_lock(&rect_lock);
+
+    slot = rect_find(key);
+    if (slot == NULL) {
+        pthread_mutex_unlock(&rect_lock);
+        return -EINVAL;
+    }
+
+    dirty = &slot->dirty;
+    if (dirty->full)
+        goto done;
+
+    if (w <= 0 || h <= 0 || l < 0 || t < 0) {
+        dirty->full = 1;
+        dirty->num = 0;
+        goto done;
+    }
+
+    if (dirty->num == GRALLOC_RECT_MAX) {
+        /* no room, fold everything into the bounding box */
+        struct gralloc_rect *u = &dirty->rect[0];
+        int r = u->l + u->w;
+        int b = u->t + u->h;
+
+        for (int i = 1; i < dirty->num; i++) {
+            struct gralloc_rect *c = &dirty->rect[i];
+            if (c->l < u->l) u->l = c->l;
+            if (c->t < u->t) u->t = c->t;
+            if (r < c->l + c->w) r = c->l + c->w;
+            if (b < c->t + c->h) b = c->t + c->h;
+        }
+        if (l < u->l) u->l = l;
+        if (t < u->t) u->t = t;
+        if (r < l + w) r = l + w;
+        if (b < t + h) b = t + h;
+
+        u->w = r - u->l;
+        u->h = b - u->t;
+        dirty->num = 1;
+        goto done;
+    }
+
+    dirty->rect[dirty->num].l = l;
+    dirty->rect[dirty->num].t = t;
+    dirty->rect[dirty->num].w = w;
+    dirty->rect[dirty->num].h = h;
+    dirty->num++;
+
+done:
+    pthread_mutex_unlock(&rect_lock);
+    return 0;
+}
+
+int gralloc_rect_take(int key, struct gralloc_rect_dirty *dirty)
+{
+    struct rect_slot *slot;
+
+    pthread_mutex_lock(&rect_lock);
+
+    slot = rect_find(key);
+    if (slot == NULL) {
+        pthread_mutex_unlock(&rect_lock);
+        return -EINVAL;
+    }
+
+    *dirty = slot->dirty;
+    slot->dirty.full = 0;
+    slot->dirty.num = 0;
+
+    pthread_mutex_unlock(&rect_lock);
+    return 0;
+}
+
+struct rect_plane {
+    int offset;
+    int row_bytes;      /* 0: the plane runs to the end of the buffer */
+    int vshift;
+};
+
+/*
+ * plane layout as alloc_device_alloc() lays the formats out. the chroma
+ * of a software writer may follow the Android YV12/NV21 layout instead and
+ * start at stride * height, below hnd->uoffset when the height is not a
+ * multiple of 16. so the chroma is flushed whole, from the lower of the
+ * two offsets to the end of the buffer.
+ */
+static int rect_planes(private_handle_t const* hnd, struct rect_plane *plane)
+{
+    int chroma = hnd->stride * hnd->height;
+
+    if (hnd->uoffset < chroma)
+        chroma = hnd->uoffset;
+
+    switch (hnd->format) {
+    case HAL_PIXEL_FORMAT_RGBA_8888:
+    case HAL_PIXEL_FORMAT_RGBX_8888:
+    case HAL_PIXEL_FORMAT_BGRA_8888:
+        plane[0].offset = 0;
+        plane[0].row_bytes = hnd->stride * 4;
+        plane[0].vshift = 0;
+        return 1;
+    case HAL_PIXEL_FORMAT_RGB_888:
+        plane[0].offset = 0;
+        plane[0].row_bytes = hnd->stride * 3;
+        plane[0].vshift = 0;
+        return 1;
+    case HAL_PIXEL_FORMAT_RGB_565:
+    case HAL_PIXEL_FORMAT_RGBA_5551:
+    case HAL_PIXEL_FORMAT_RGBA_4444:
+        plane[0].offset = 0;
+        plane[0].row_bytes = hnd->stride * 2;
+        plane[0].vshift = 0;
+        return 1;
+    case HAL_PIXEL_FORMAT_YCbCr_420_SP:
+    case HAL_PIXEL_FORMAT_YCrCb_420_SP:
+    case HAL_PIXEL_FORMAT_CUSTOM_YCrCb_420_SP:
+    case OMX_COLOR_FormatYUV420SemiPlanar:
+    case HAL_PIXEL_FORMAT_YCbCr_422_SP:
+        plane[0].offset = 0;
+        plane[0].row_bytes = hnd->stride;
+        plane[0].vshift = 0;
+        plane[1].offset = chroma;
+        plane[1].row_bytes = 0;
+        plane[1].vshift = 0;
+        return 2;
+    case HAL_PIXEL_FORMAT_YV12:
+    case HAL_PIXEL_FORMAT_YCbCr_420_P:
+    case OMX_COLOR_FormatYUV420Planar:
+        plane[0].offset = 0;
+        plane[0].row_bytes = hnd->stride;
+        plane[0].vshift = 0;
+        plane[1].offset = chroma;
+        plane[1].row_bytes = 0;
+        plane[1].vshift = 0;
+        return 2;
+    default:
+        return -1;
+    }
+}
+
+int gralloc_rect_ranges(private_handle_t const* hnd, const struct gralloc_rect_dirty *dirty,
+                        struct gralloc_range *range)
+{
+    struct rect_plane plane[3];
+    int num_planes;
+    int num = 0;
+    int merged = 0;
+
+    if (dirty->full)
+        return -1;
+    if (dirty->num == 0)
+        return 0;
+
+    num_planes = rect_planes(hnd, plane);
+    if (num_planes <= 0 || hnd->stride <= 0)
+        return -1;
+
+    for (int i = 0; i < dirty->num; i++) {
+        const struct gralloc_rect *r = &dirty->rect[i];
+
+        for (int p = 0; p < num_planes; p++) {
+            int first = r->t >> plane[p].vshift;
+            int last = (r->t + r->h - 1) >> plane[p].vshift;
+            int start = plane[p].offset + first * plane[p].row_bytes;
+            int end = plane[p].offset + (last + 1) * plane[p].row_bytes;
+            int j;
+
+            if (plane[p].row_bytes == 0)
+                end = hnd->size;
+            if (hnd->size < end)
+                end = hnd->size;
+            if (end <= start)
+                continue;
+
+            /* insertion sort on the start offset */
+            for (j = num; 0 < j && start < range[j - 1].offset; j--)
+                range[j] = range[j - 1];
+            range[j].offset = start;
+            range[j].len = end - start;
+            num++;
+        }
+    }
+
+    /* merge the overlapping and adjacent ranges */
+    for (int i = 0; i < num; i++) {
+        if (merged != 0 && range[i].offset <= range[merged - 1].offset + range[merged - 1].len) {
+            int end = range[i].offset + range[i].len;
+            if (range[merged - 1].offset + range[merged - 1].len < end)
+                range[merged - 1].len = end - range[merged - 1].offset;
+        } else {
+            range[merged++] = range[i];
+        }
+    }
+
+    return merged;
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2010 ARM Limited. All rights reserved.
+ *
+ * Portions of this code have been modified from the original.
+ * These modifications are:
+ *    * gralloc_rect_*()
+ *
+ * Copyright (C) 2008 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GRALLOC_RECT_H_
+#define GRALLOC_RECT_H_
+
+#include "gralloc_priv.h"
+
+/*
+ * Rectangles written by the CPU since the last cache maintenance, per
+ * buffer. UMP and ION buffers are keyed by their UMP secure ID, FIMC1
+ * (IOCTL) buffers by their physical address.
+ *
+ * Entries live in an open addressing hash table and keep up to
+ * GRALLOC_RECT_MAX rectangles inline; one more rectangle merges them into
+ * their bounding box. All calls are thread safe.
+ */
+#define GRALLOC_RECT_MAX    (4)
+#define GRALLOC_RANGE_MAX   (GRALLOC_RECT_MAX * 2)   /* luma and chroma */
+
+struct gralloc_rect {
+    int l;
+    int t;
+    int w;
+    int h;
+};
+
+struct gralloc_rect_dirty {
+    int                 full;           /* the whole buffer was written */
+    int                 num;
+    struct gralloc_rect rect[GRALLOC_RECT_MAX];
+};
+
+/* byte range from the start of the buffer */
+struct gralloc_range {
+    int offset;
+    int len;
+};
+
+static inline int gralloc_rect_tracked(private_handle_t const* hnd)
+{
+#ifdef USE_PARTIAL_FLUSH
+    if (hnd->flags & private_handle_t::PRIV_FLAGS_USES_UMP)
+        return 1;
+#endif
+    return (hnd->flags & (private_handle_t::PRIV_FLAGS_USES_ION | private_handle_t::PRIV_FLAGS_USES_IOCTL)) ? 1 : 0;
+}
+
+static inline int gralloc_rect_key(private_handle_t const* hnd)
+{
+    if (hnd->flags & private_handle_t::PRIV_FLAGS_USES_IOCTL)
+        return hnd->paddr;
+    return (int)hnd->ump_id;
+}
+
+/* every add takes a reference on the key, remove drops it */
+int gralloc_rect_add(int key);
+int gralloc_rect_remove(int key);
+/* w or h <= 0 marks the whole buffer */
+int gralloc_rect_mark(int key, int l, int t, int w, int h);
+/* copy the dirty rectangles out and reset them */
+int gralloc_rect_take(int key, struct gralloc_rect_dirty *dirty);
+/*
+ * Whole rows of every plane touched by the dirty rectangles, sorted and
+ * merged. Returns the number of ranges, -1 when the buffer layout is not
+ * known and everything has to be flushed.
+ */
+int gralloc_rect_ranges(private_handle_t const* hnd, const struct gralloc_rect_dirty *dirty,
+                        struct gralloc_range *range);
+
+#endif /* GRALLOC_RECT_H_ */
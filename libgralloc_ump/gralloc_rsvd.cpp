@@ -0,0 +1,328 @@
+/*
+ * Copyright (C) 2010 ARM Limited. All rights reserved.
+ *
+ * Portions of this code have been modified from the original.
+ * These modifications are:
+ *    * rsvd_heap_*()
+ *    * rsvd_mem_map(), rsvd_mem_unmap()
+ *
+ * Copyright (C) 2008 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sys/mman.h>
+
+#include <cutils/log.h>
+
+#include "s5p_fimc.h"
+#include "gralloc_helper.h"
+#include "gralloc_rsvd.h"
+
+#define PFX_NODE_MEM        "/dev/fimg2d"
+
+#define RSVD_REGION_SIZE    (FIMC1_RESERVED_SIZE * 1024)
+#define RSVD_NUM_PAGES      (RSVD_REGION_SIZE / PAGE_SIZE)
+#define RSVD_NUM_CLASSES    (32)
+#define RSVD_NONE           (-1)
+
+/*
+ * Only the first page of a block keeps len/free/prev/next,
+ * only the last page keeps start (the boundary tag of the left neighbour).
+ */
+struct rsvd_page {
+    int len;
+    int start;
+    int prev;
+    int next;
+    int free;
+};
+
+struct rsvd_heap {
+    struct rsvd_page *page;
+    int               head[RSVD_NUM_CLASSES];
+    unsigned int      bitmap;
+    int               used_pages;
+    int               num_allocs;
+    int               num_free_blocks;
+};
+
+static struct rsvd_heap heap;
+static pthread_mutex_t heap_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_mutex_t map_lock = PTHREAD_MUTEX_INITIALIZER;
+static int   map_fd = -1;
+static void *map_base = NULL;
+static int   map_refs = 0;
+
+static inline int size_class(int pages)
+{
+    return 31 - __builtin_clz(pages);
+}
+
+static void heap_insert(int start, int len)
+{
+    int cls = size_class(len);
+    struct rsvd_page *p = &heap.page[start];
+
+    p->len  = len;
+    p->free = 1;
+    p->prev = RSVD_NONE;
+    p->next = heap.head[cls];
+    if (p->next != RSVD_NONE)
+        heap.page[p->next].prev = start;
+    heap.head[cls] = start;
+    heap.bitmap |= (1U << cls);
+    heap.page[start + len - 1].start = start;
+    heap.num_free_blocks++;
+}
+
+static void heap_remove(int start)
+{
+    struct rsvd_page *p = &heap.page[start];
+    int cls = size_class(p->len);
+
+    if (p->prev != RSVD_NONE)
+        heap.page[p->prev].next = p->next;
+    else
+        heap.head[cls] = p->next;
+    if (p->next != RSVD_NONE)
+        heap.page[p->next].prev = p->prev;
+    if (heap.head[cls] == RSVD_NONE)
+        heap.bitmap &= ~(1U << cls);
+    p->free = 0;
+    heap.num_free_blocks--;
+}
+
+static int heap_init_locked(void)
+{
+    if (heap.page != NULL)
+        return 0;
+
+    heap.page = (struct rsvd_page *)calloc(RSVD_NUM_PAGES, sizeof(struct rsvd_page));
+    if (heap.page == NULL) {
+        ALOGE("%s::calloc fail", __func__);
+        return -ENOMEM;
+    }
+
+    for (int i = 0; i < RSVD_NUM_CLASSES; i++)
+        heap.head[i] = RSVD_NONE;
+    heap.bitmap = 0;
+    heap.used_pages = 0;
+    heap.num_allocs = 0;
+    heap.num_free_blocks = 0;
+
+    heap_insert(0, RSVD_NUM_PAGES);
+    return 0;
+}
+
+/* best fit inside the request's class, else any block of a bigger class */
+static int heap_find(int pages)
+{
+    int cls = size_class(pages);
+    int best = RSVD_NONE;
+    unsigned int mask;
+
+    for (int i = heap.head[cls]; i != RSVD_NONE; i = heap.page[i].next) {
+        if (heap.page[i].len < pages)
+            continue;
+        if (best == RSVD_NONE || heap.page[i].len < heap.page[best].len)
+            best = i;
+        if (heap.page[i].len == pages)
+            break;
+    }
+    if (best != RSVD_NONE)
+        return best;
+
+    if (RSVD_NUM_CLASSES <= cls + 1)
+        return RSVD_NONE;
+    mask = heap.bitmap & ~((2U << cls) - 1);
+    if (mask == 0)
+        return RSVD_NONE;
+
+    return heap.head[__builtin_ctz(mask)];
+}
+
+int rsvd_heap_alloc(size_t size, size_t *offset)
+{
+    int pages = round_up_to_page_size(size) / PAGE_SIZE;
+    int start;
+    int ret = 0;
+
+    if (pages <= 0 || RSVD_NUM_PAGES < pages)
+        return -EINVAL;
+
+    pthread_mutex_lock(&heap_lock);
+
+    ret = heap_init_locked();
+    if (ret < 0)
+        goto done;
+
+    start = heap_find(pages);
+    if (start == RSVD_NONE) {
+        ret = -ENOMEM;
+        goto done;
+    }
+
+    heap_remove(start);
+    if (pages < heap.page[start].len)
+        heap_insert(start + pages, heap.page[start].len - pages);
+    heap.page[start].len = pages;
+    heap.page[start + pages - 1].start = start;
+
+    heap.used_pages += pages;
+    heap.num_allocs++;
+    *offset = (size_t)start * PAGE_SIZE;
+
+done:
+    pthread_mutex_unlock(&heap_lock);
+    return ret;
+}
+
+int rsvd_heap_free(size_t offset)
+{
+    int start = offset / PAGE_SIZE;
+    int len;
+
+    pthread_mutex_lock(&heap_lock);
+
+    if (heap.page == NULL || (offset % PAGE_SIZE) != 0 || RSVD_NUM_PAGES <= start ||
+        heap.page[start].len == 0 || heap.page[start].free) {
+        pthread_mutex_unlock(&heap_lock);
+        ALOGE("%s::invalid offset 0x%x", __func__, offset);
+        return -EINVAL;
+    }
+
+    len = heap.page[start].len;
+    heap.used_pages -= len;
+    heap.num_allocs--;
+
+    /* coalesce with the right neighbour */
+    if (start + len < RSVD_NUM_PAGES && heap.page[start + len].free) {
+        int right = start + len;
+        int right_len = heap.page[right].len;
+
+        heap_remove(right);
+        heap.page[right].len = 0;
+        len += right_len;
+    }
+
+    /* coalesce with the left neighbour */
+    if (0 < start) {
+        int left = heap.page[start - 1].start;
+
+        if (heap.page[left].free) {
+            heap_remove(left);
+            heap.page[start].len = 0;
+            len += heap.page[left].len;
+            start = left;
+        }
+    }
+
+    heap_insert(start, len);
+
+    pthread_mutex_unlock(&heap_lock);
+    return 0;
+}
+
+int rsvd_heap_get_stats(struct rsvd_heap_stats *stats)
+{
+    int largest = 0;
+    int free_pages;
+
+    if (stats == NULL)
+        return -EINVAL;
+
+    pthread_mutex_lock(&heap_lock);
+
+    if (heap_init_locked() < 0) {
+        pthread_mutex_unlock(&heap_lock);
+        return -ENOMEM;
+    }
+
+    if (heap.bitmap != 0) {
+        int cls = 31 - __builtin_clz(heap.bitmap);
+        for (int i = heap.head[cls]; i != RSVD_NONE; i = heap.page[i].next) {
+            if (largest < heap.page[i].len)
+                largest = heap.page[i].len;
+        }
+    }
+
+    free_pages = RSVD_NUM_PAGES - heap.used_pages;
+
+    stats->total           = RSVD_REGION_SIZE;
+    stats->used            = (size_t)heap.used_pages * PAGE_SIZE;
+    stats->largest_free    = (size_t)largest * PAGE_SIZE;
+    stats->num_allocs      = heap.num_allocs;
+    stats->num_free_blocks = heap.num_free_blocks;
+    stats->fragmentation   = (free_pages == 0) ? 0 : 100 - (largest * 100) / free_pages;
+
+    pthread_mutex_unlock(&heap_lock);
+    return 0;
+}
+
+void *rsvd_mem_map(unsigned int region_paddr)
+{
+    void *base = NULL;
+
+    pthread_mutex_lock(&map_lock);
+
+    if (map_base == NULL) {
+        if (map_fd < 0) {
+            map_fd = open(PFX_NODE_MEM, O_RDWR);
+            if (map_fd < 0) {
+                ALOGE("%s:: %s exynos-mem open error", __func__, PFX_NODE_MEM);
+                goto done;
+            }
+        }
+
+        base = mmap(0, RSVD_REGION_SIZE, PROT_READ|PROT_WRITE, MAP_SHARED, map_fd, region_paddr);
+        if (base == MAP_FAILED) {
+            ALOGE("%s::Could not mmap %s", __func__, strerror(errno));
+            close(map_fd);
+            map_fd = -1;
+            base = NULL;
+            goto done;
+        }
+        map_base = base;
+    }
+
+    map_refs++;
+    base = map_base;
+
+done:
+    pthread_mutex_unlock(&map_lock);
+    return base;
+}
+
+void rsvd_mem_unmap(void)
+{
+    pthread_mutex_lock(&map_lock);
+
+    if (0 < map_refs && --map_refs == 0) {
+        if (munmap(map_base, RSVD_REGION_SIZE) < 0)
+            ALOGE("%s::Could not unmap %s", __func__, strerror(errno));
+        close(map_fd);
+        map_fd = -1;
+        map_base = NULL;
+    }
+
+    pthread_mutex_unlock(&map_lock);
+}
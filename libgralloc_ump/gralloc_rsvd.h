@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2010 ARM Limited. All rights reserved.
+ *
+ * Portions of this code have been modified from the original.
+ * These modifications are:
+ *    * rsvd_heap_*()
+ *    * rsvd_mem_map(), rsvd_mem_unmap()
+ *
+ * Copyright (C) 2008 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GRALLOC_RSVD_H_
+#define GRALLOC_RSVD_H_
+
+#include <stddef.h>
+
+/*
+ * Allocator for the FIMC1 reserved memory region (GRALLOC_USAGE_HW_FIMC1).
+ *
+ * The region is managed in pages with segregated free lists, one list per
+ * power of two of the block size. A bitmap of the non empty lists finds a
+ * fitting block in O(1), the list of the request's own size class is
+ * searched for the best fit first. Freed blocks are coalesced with their
+ * neighbours through boundary tags.
+ */
+struct rsvd_heap_stats {
+    size_t total;           /* region size in bytes */
+    size_t used;            /* bytes handed out */
+    size_t largest_free;    /* biggest allocation that can succeed now */
+    int    num_allocs;
+    int    num_free_blocks;
+    int    fragmentation;   /* 0..100, share of free bytes outside largest_free */
+};
+
+int  rsvd_heap_alloc(size_t size, size_t *offset);
+int  rsvd_heap_free(size_t offset);
+int  rsvd_heap_get_stats(struct rsvd_heap_stats *stats);
+
+/*
+ * The whole region is mapped once per process, every FIMC1 handle points
+ * into that mapping. Each rsvd_mem_map() takes a reference.
+ */
+void *rsvd_mem_map(unsigned int region_paddr);
+void  rsvd_mem_unmap(void);
+
+#endif /* GRALLOC_RSVD_H_ */
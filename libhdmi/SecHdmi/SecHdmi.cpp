@@ -58,93 +58,15 @@ SecHdmi::CECThread::~CECThread()
     LOGD("%s", __func__);
 #endif
     mFlagRunning = false;
+    CECEngineDestroy(mEngine);
 }
 
 bool SecHdmi::CECThread::threadLoop()
 {
-    unsigned char buffer[CEC_MAX_FRAME_SIZE];
-    int size;
-    unsigned char lsrc, ldst, opcode;
+    // sleeps in poll() until a message arrives or a reply is due
+    if (CECEngineProcess(mEngine, -1) < 0)
+        usleep(100000);
 
-    {
-        Mutex::Autolock lock(mThreadLoopLock);
-        mFlagRunning = true;
-
-        size = CECReceiveMessage(buffer, CEC_MAX_FRAME_SIZE, 100000);
-
-        if (!size) // no data available or ctrl-c
-            return true;
-
-        if (size == 1)
-            return true; // "Polling Message"
-
-        lsrc = buffer[0] >> 4;
-
-        /* ignore messages with src address == mLaddr*/
-        if (lsrc == mLaddr)
-            return true;
-
-        opcode = buffer[1];
-
-        if (CECIgnoreMessage(opcode, lsrc)) {
-            LOGE("### ignore message coming from address 15 (unregistered)\n");
-            return true;
-        }
-
-        if (!CECCheckMessageSize(opcode, size)) {
-            LOGE("### invalid message size: %d(opcode: 0x%x) ###\n", size, opcode);
-            return true;
-        }
-
-        /* check if message broadcasted/directly addressed */
-        if (!CECCheckMessageMode(opcode, (buffer[0] & 0x0F) == CEC_MSG_BROADCAST ? 1 : 0)) {
-            LOGE("### invalid message mode (directly addressed/broadcast) ###\n");
-            return true;
-        }
-
-        ldst = lsrc;
-
-        //TODO: macroses to extract src and dst logical addresses
-        //TODO: macros to extract opcode
-
-        switch (opcode) {
-        case CEC_OPCODE_GIVE_PHYSICAL_ADDRESS:
-            /* responce with "Report Physical Address" */
-            buffer[0] = (mLaddr << 4) | CEC_MSG_BROADCAST;
-            buffer[1] = CEC_OPCODE_REPORT_PHYSICAL_ADDRESS;
-            buffer[2] = (mPaddr >> 8) & 0xFF;
-            buffer[3] = mPaddr & 0xFF;
-            buffer[4] = mDevtype;
-            size = 5;
-            break;
-
-        case CEC_OPCODE_REQUEST_ACTIVE_SOURCE:
-            LOGD("[CEC_OPCODE_REQUEST_ACTIVE_SOURCE]\n");
-            /* responce with "Active Source" */
-            buffer[0] = (mLaddr << 4) | CEC_MSG_BROADCAST;
-            buffer[1] = CEC_OPCODE_ACTIVE_SOURCE;
-            buffer[2] = (mPaddr >> 8) & 0xFF;
-            buffer[3] = mPaddr & 0xFF;
-            size = 4;
-            LOGD("Tx : [CEC_OPCODE_ACTIVE_SOURCE]\n");
-            break;
-
-        case CEC_OPCODE_ABORT:
-        case CEC_OPCODE_FEATURE_ABORT:
-        default:
-            /* send "Feature Abort" */
-            buffer[0] = (mLaddr << 4) | ldst;
-            buffer[1] = CEC_OPCODE_FEATURE_ABORT;
-            buffer[2] = CEC_OPCODE_ABORT;
-            buffer[3] = 0x04; // "refused"
-            size = 4;
-            break;
-        }
-
-        if (CECSendMessage(buffer, size) != size)
-            LOGE("CECSendMessage() failed!!!\n");
-
-    }
     return true;
 }
 
@@ -202,6 +124,16 @@ bool SecHdmi::CECThread::start()
         return false;
     }
 
+    if (mEngine == NULL)
+        mEngine = CECEngineCreate(CECDeviceTransport());
+    if (mEngine == NULL) {
+        LOGE("CECEngineCreate() failed!!!\n");
+        if (!CECClose())
+            LOGE("CECClose() failed!\n");
+        return false;
+    }
+    CECEngineSetAddress(mEngine, mLaddr, mPaddr, mDevtype);
+
 #ifdef DEBUG_HDMI_HW_LEVEL
     LOGD("request to run CECThread");
 #endif
@@ -211,6 +143,7 @@ bool SecHdmi::CECThread::start()
         LOGE("%s fail to run thread", __func__);
         return false;
     }
+    mFlagRunning = true;
     return true;
 }
 
@@ -220,6 +153,9 @@ bool SecHdmi::CECThread::stop()
     LOGD("%s request Exit", __func__);
 #endif
     Mutex::Autolock lock(mThreadControlLock);
+    requestExit();
+    if (mEngine != NULL)
+        CECEngineWakeup(mEngine);
     if (requestExitAndWait() == WOULD_BLOCK) {
         LOGE("mCECThread.requestExitAndWait() == WOULD_BLOCK");
         return false;
@@ -276,16 +212,11 @@ SecHdmi::SecHdmi():
         mFlagLayerEnable[i] = false;
         mFlagHdmiStart[i] = false;
 
-        mSrcWidth      [i] = 0;
-        mSrcHeight     [i] = 0;
-        mSrcColorFormat[i] = 0;
-        mHdmiResolutionWidth  [i] = 0;
-        mHdmiResolutionHeight [i] = 0;
+        mLayerConfig[i].prepared = false;
+        mLayerConfig[i].srcColorFormat = 0;
         mHdmiFd[i] = -1;
         mDstWidth  [i] = 0;
         mDstHeight [i] = 0;
-        mPrevDstWidth  [i] = 0;
-        mPrevDstHeight [i] = 0;
     }
 
     mHdmiPresetId = DEFAULT_HDMI_PRESET_ID;
@@ -507,6 +438,7 @@ bool SecHdmi::destroy(void)
             goto DESTROY_FAIL;
         }
     }
+    m_invalidateLayers();
 
 #if !defined(BOARD_USE_V4L2)
     tvout_deinit();
@@ -779,6 +711,7 @@ bool SecHdmi::disconnect(void)
 #else
     tvout_deinit();
 #endif
+    m_invalidateLayers();
 
     mFlagConnected = false;
 
@@ -853,8 +786,6 @@ bool SecHdmi::flush(int srcW, int srcH, int srcColorFormat,
             hdmi_cal_rect(tempSrcW, tempSrcH, mHdmiDstWidth, mHdmiDstHeight, &rect);
             mDstWidth[hdmiLayer] = rect.width;
             mDstHeight[hdmiLayer] = rect.height;
-            mDstWidth[HDMI_LAYER_VIDEO] = 0;
-            mDstHeight[HDMI_LAYER_VIDEO] = 0;
         } else {
             mDstWidth[hdmiLayer] = mHdmiDstWidth;
             mDstHeight[hdmiLayer] = mHdmiDstHeight;
@@ -863,25 +794,19 @@ bool SecHdmi::flush(int srcW, int srcH, int srcColorFormat,
 #ifdef DEBUG_MSG_ENABLE
     LOGE("m_reset param(%d, %d, %d, %d)",
         mDstWidth[hdmiLayer], mDstHeight[hdmiLayer], \
-        mPrevDstWidth[hdmiLayer], mPrevDstHeight[hdmiLayer]);
+        mLayerConfig[hdmiLayer].dstWidth, mLayerConfig[hdmiLayer].dstHeight);
 #endif
 #endif
 
-    if (srcW != mSrcWidth[hdmiLayer] ||
-        srcH != mSrcHeight[hdmiLayer] ||
-        srcColorFormat != mSrcColorFormat[hdmiLayer] ||
-        mHdmiDstWidth != mHdmiResolutionWidth[hdmiLayer] ||
-        mHdmiDstHeight != mHdmiResolutionHeight[hdmiLayer] ||
-#if defined(BOARD_USE_V4L2)
-        mDstWidth[hdmiLayer] != mPrevDstWidth[hdmiLayer] ||
-        mDstHeight[hdmiLayer] != mPrevDstHeight[hdmiLayer] ||
-#endif
-        mHdmiInfoChange == true) {
+    HdmiLayerConfig config;
+    m_getLayerConfig(srcW, srcH, srcColorFormat, hdmiLayer, num_of_hwc_layer, &config);
+
+    if (mHdmiInfoChange == true || m_layerPrepared(hdmiLayer, &config) == false) {
 #ifdef DEBUG_MSG_ENABLE
         LOGD("m_reset param(%d, %d, %d, %d, %d, %d, %d)",
-            srcW, mSrcWidth[hdmiLayer], \
-            srcH, mSrcHeight[hdmiLayer], \
-            srcColorFormat,mSrcColorFormat[hdmiLayer], \
+            srcW, mLayerConfig[hdmiLayer].srcWidth, \
+            srcH, mLayerConfig[hdmiLayer].srcHeight, \
+            srcColorFormat, mLayerConfig[hdmiLayer].srcColorFormat, \
             hdmiLayer);
 #endif
 
@@ -1247,10 +1172,20 @@ bool SecHdmi::setHdmiResolution(unsigned int hdmiResolutionValue, bool forceRun)
     int h = 0;
 
 #if defined(BOARD_USES_EDID)
-    // find perfect resolutions..
 #if defined(BOARD_USE_V4L2)
     unsigned int preset_id;
-    if (hdmi_resolution_2_preset_id(newHdmiResolutionValue, &w, &h, &preset_id) < 0 ||
+#else
+    v4l2_std_id std_id;
+#endif
+    unsigned int cachedResolutionValue;
+
+    // same sink and same request as before
+    if (EDIDGetCachedMode(hdmiResolutionValue, &cachedResolutionValue)) {
+        newHdmiResolutionValue = cachedResolutionValue;
+    }
+    // find perfect resolutions..
+#if defined(BOARD_USE_V4L2)
+    else if (hdmi_resolution_2_preset_id(newHdmiResolutionValue, &w, &h, &preset_id) < 0 ||
         hdmi_check_resolution(preset_id) < 0) {
         bool flagFoundIndex = false;
         int resolutionValueIndex = m_resolutionValueIndex(newHdmiResolutionValue);
@@ -1273,8 +1208,7 @@ bool SecHdmi::setHdmiResolution(unsigned int hdmiResolutionValue, bool forceRun)
         }
     }
 #else
-    v4l2_std_id std_id;
-    if (hdmi_resolution_2_std_id(newHdmiResolutionValue, &w, &h, &std_id) < 0 ||
+    else if (hdmi_resolution_2_std_id(newHdmiResolutionValue, &w, &h, &std_id) < 0 ||
         hdmi_check_resolution(std_id) < 0) {
         bool flagFoundIndex = false;
         int resolutionValueIndex = m_resolutionValueIndex(newHdmiResolutionValue);
@@ -1302,6 +1236,8 @@ bool SecHdmi::setHdmiResolution(unsigned int hdmiResolutionValue, bool forceRun)
         LOGD("%s::find resolutions(%d) at once\n", __func__, hdmiResolutionValue);
 #endif
     }
+
+    EDIDSetCachedMode(hdmiResolutionValue, newHdmiResolutionValue);
 #endif
 
     if (mHdmiResolutionValue != newHdmiResolutionValue) {
@@ -1384,7 +1320,6 @@ else if(rotVal==90)
     /* G2D rotation */
     if (rotVal != mG2DUIRotVal) {
         mG2DUIRotVal = rotVal;
-        mHdmiInfoChange = true;
 	 mRotateInfoChange=true; //added yqf
     }
 
@@ -1393,7 +1328,6 @@ else if(rotVal==90)
         if (rotVal != mUIRotVal) {
             mSecFimc.setRotVal(rotVal);
             mUIRotVal = rotVal;
-            mHdmiInfoChange = true;
 	     mRotateInfoChange=true; //added yqf	
 	     //LOGI("mUIRotVal:%d,rotVal:%d, mRotateInfoChange:%d\n",mUIRotVal, rotVal,mRotateInfoChange);
 	}
@@ -1402,7 +1336,6 @@ else if(rotVal==90)
         if (rotVal != mUIRotVal) {
             mSecFimc.setRotVal(rotVal);
             mUIRotVal = rotVal;
-            mHdmiInfoChange = true;   
 	     mRotateInfoChange=true; //added yqf	
         }
     }
@@ -1418,6 +1351,53 @@ bool SecHdmi::setDisplaySize(int width, int height)
     return true;
 }
 
+void SecHdmi::m_getLayerConfig(int w, int h, int colorFormat, int hdmiLayer, int hwcLayer,
+                               HdmiLayerConfig *config)
+{
+    config->prepared = true;
+    config->srcWidth = w;
+    config->srcHeight = h;
+    config->srcColorFormat = colorFormat;
+#if defined(BOARD_USE_V4L2)
+    config->dstWidth = mDstWidth[hdmiLayer];
+    config->dstHeight = mDstHeight[hdmiLayer];
+#else
+    config->dstWidth = mHdmiDstWidth;
+    config->dstHeight = mHdmiDstHeight;
+#endif
+    config->resolutionWidth = mHdmiDstWidth;
+    config->resolutionHeight = mHdmiDstHeight;
+    config->hwcMode = (hwcLayer != 0);
+
+    /* FIMC rotates the video layer, G2D the graphic layers */
+    if (hdmiLayer == HDMI_LAYER_VIDEO)
+        config->rotVal = mUIRotVal;
+    else
+        config->rotVal = mG2DUIRotVal;
+}
+
+bool SecHdmi::m_layerPrepared(int hdmiLayer, const HdmiLayerConfig *config)
+{
+    const HdmiLayerConfig *prev = &mLayerConfig[hdmiLayer];
+
+    return prev->prepared == true &&
+           prev->srcWidth == config->srcWidth &&
+           prev->srcHeight == config->srcHeight &&
+           prev->srcColorFormat == config->srcColorFormat &&
+           prev->dstWidth == config->dstWidth &&
+           prev->dstHeight == config->dstHeight &&
+           prev->resolutionWidth == config->resolutionWidth &&
+           prev->resolutionHeight == config->resolutionHeight &&
+           prev->hwcMode == config->hwcMode &&
+           prev->rotVal == config->rotVal;
+}
+
+void SecHdmi::m_invalidateLayers(void)
+{
+    for (int layer = 0; layer < HDMI_LAYER_MAX; layer++)
+        mLayerConfig[layer].prepared = false;
+}
+
 bool SecHdmi::m_reset(int w, int h, int colorFormat, int hdmiLayer, int hwcLayer)
 {
 #ifdef DEBUG_MSG_ENABLE
@@ -1428,60 +1408,42 @@ bool SecHdmi::m_reset(int w, int h, int colorFormat, int hdmiLayer, int hwcLayer
     LOGD("### %s called", __func__);
 #endif
     v4l2_std_id std_id = 0;
-    mFimcCurrentOutBufIndex = 0;
 
     int srcW = w;
     int srcH = h;
 
-#if defined(BOARD_USE_V4L2)
-    if (mFlagHdmiStart[hdmiLayer] == true && m_stopHdmi(hdmiLayer) == false) {
-        LOGE("%s::m_stopHdmi: layer[%d] fail", __func__, hdmiLayer);
-        return false;
-    }
-#else
-    // stop all..
-    for (int layer = HDMI_LAYER_BASE + 1; layer < HDMI_LAYER_MAX; layer++) {
-        if (mFlagHdmiStart[layer] == true && m_stopHdmi(layer) == false) {
-            LOGE("%s::m_stopHdmi: layer[%d] fail", __func__, layer);
+    HdmiLayerConfig config;
+    m_getLayerConfig(w, h, colorFormat, hdmiLayer, hwcLayer, &config);
+
+    /* the output is set up again below, no layer keeps its state */
+    if (mHdmiInfoChange == true)
+        m_invalidateLayers();
+
+    if (m_layerPrepared(hdmiLayer, &config) == false) {
+        mFimcCurrentOutBufIndex = 0;
+
+        /*
+         * only this layer is stopped, the others keep their prepared state
+         * and keep running. stopping them all would restart them with a
+         * configuration that was never set up again.
+         */
+        if (mFlagHdmiStart[hdmiLayer] == true && m_stopHdmi(hdmiLayer) == false) {
+            LOGE("%s::m_stopHdmi: layer[%d] fail", __func__, hdmiLayer);
             return false;
         }
-    }
-#endif
 
 #if defined(BOARD_USE_V4L2)
-    if (hdmi_deinit_layer(hdmiLayer) < 0)
-        LOGE("%s::hdmi_deinit_layer(%d) fail", __func__, hdmiLayer);
+        if (hdmi_deinit_layer(hdmiLayer) < 0)
+            LOGE("%s::hdmi_deinit_layer(%d) fail", __func__, hdmiLayer);
 
-    mHdmiFd[hdmiLayer] = hdmi_init_layer(hdmiLayer);
-    if (mHdmiFd[hdmiLayer] < 0)
-        LOGE("%s::hdmi_init_layer(%d) fail", __func__, hdmiLayer);
+        mHdmiFd[hdmiLayer] = hdmi_init_layer(hdmiLayer);
+        if (mHdmiFd[hdmiLayer] < 0)
+            LOGE("%s::hdmi_init_layer(%d) fail", __func__, hdmiLayer);
 
-    if (tvout_std_v4l2_init(mHdmiFd[hdmiLayer], mHdmiPresetId) < 0)
-        LOGE("%s::tvout_std_v4l2_init fail", __func__);
+        if (tvout_std_v4l2_init(mHdmiFd[hdmiLayer], mHdmiPresetId) < 0)
+            LOGE("%s::tvout_std_v4l2_init fail", __func__);
 #endif
 
-    if (w != mSrcWidth [hdmiLayer] ||
-        h != mSrcHeight [hdmiLayer] ||
-        mHdmiDstWidth != mHdmiResolutionWidth[hdmiLayer] ||
-        mHdmiDstHeight != mHdmiResolutionHeight[hdmiLayer] ||
-#if defined(BOARD_USE_V4L2)
-        mDstWidth[hdmiLayer] != mPrevDstWidth[hdmiLayer] ||
-        mDstHeight[hdmiLayer] != mPrevDstHeight[hdmiLayer] ||
-        mHdmiInfoChange == true ||  //yulu
-#endif
-        colorFormat != mSrcColorFormat[hdmiLayer]) {
-        int preVideoSrcColorFormat = mSrcColorFormat[hdmiLayer];
-        int videoSrcColorFormat = colorFormat;
-
-        if (preVideoSrcColorFormat != HAL_PIXEL_FORMAT_YCbCr_420_SP &&
-            preVideoSrcColorFormat != HAL_PIXEL_FORMAT_YCrCb_420_SP &&
-            preVideoSrcColorFormat != HAL_PIXEL_FORMAT_CUSTOM_YCbCr_420_SP &&
-            preVideoSrcColorFormat != HAL_PIXEL_FORMAT_CUSTOM_YCrCb_420_SP &&
-            preVideoSrcColorFormat != HAL_PIXEL_FORMAT_CUSTOM_YCbCr_420_SP_TILED) {
-                LOGI("%s: Unsupported preVideoSrcColorFormat = 0x%x\n", __func__, preVideoSrcColorFormat);
-                preVideoSrcColorFormat = HAL_PIXEL_FORMAT_CUSTOM_YCbCr_420_SP_TILED;
-        }
-
         if (hdmiLayer == HDMI_LAYER_VIDEO) {
             if (colorFormat != HAL_PIXEL_FORMAT_YCbCr_420_SP &&
                 colorFormat != HAL_PIXEL_FORMAT_YCrCb_420_SP &&
@@ -1542,8 +1504,6 @@ bool SecHdmi::m_reset(int w, int h, int colorFormat, int hdmiLayer, int hwcLayer
                                 0, 0, mHdmiDstWidth, mHdmiDstHeight);
             }
 #endif
-            mPrevDstWidth[hdmiLayer] = mHdmiDstWidth;
-            mPrevDstHeight[hdmiLayer] = mHdmiDstHeight;
         } else {
 #if defined(BOARD_USE_V4L2)
             struct v4l2_rect rect;
@@ -1565,37 +1525,41 @@ bool SecHdmi::m_reset(int w, int h, int colorFormat, int hdmiLayer, int hwcLayer
                                 colorFormat, srcW, srcH,
                                 &mMixerBuffer[hdmiLayer][0],
                                 rect.left, rect.top, rect.width, rect.height);
-                mPrevDstWidth[hdmiLayer] = rect.width;
-                mPrevDstHeight[hdmiLayer] = rect.height;
-                mPrevDstWidth[HDMI_LAYER_VIDEO] = 0;
-                mPrevDstHeight[HDMI_LAYER_VIDEO] = 0;
             } else { /* Video Playback + UI Mode */
                 hdmi_set_g_param(mHdmiFd[hdmiLayer], hdmiLayer,
                                 colorFormat, srcW, srcH,
                                 &mMixerBuffer[hdmiLayer][0],
                                 0, 0, mHdmiDstWidth, mHdmiDstHeight);
-                mPrevDstWidth[hdmiLayer] = mHdmiDstWidth;
-                mPrevDstHeight[hdmiLayer] = mHdmiDstHeight;
             }
 #endif
         }
 
-        if (preVideoSrcColorFormat != videoSrcColorFormat)
-            mHdmiInfoChange = true;
+        /* a new video format sets the output up again, as it always did */
+        if (hdmiLayer == HDMI_LAYER_VIDEO) {
+            int prevColorFormat = mLayerConfig[hdmiLayer].srcColorFormat;
 
-        mSrcWidth[hdmiLayer] = srcW;
-        mSrcHeight[hdmiLayer] = srcH;
-        mSrcColorFormat[hdmiLayer] = colorFormat;
+            if (prevColorFormat != HAL_PIXEL_FORMAT_YCbCr_420_SP &&
+                prevColorFormat != HAL_PIXEL_FORMAT_YCrCb_420_SP &&
+                prevColorFormat != HAL_PIXEL_FORMAT_CUSTOM_YCbCr_420_SP &&
+                prevColorFormat != HAL_PIXEL_FORMAT_CUSTOM_YCrCb_420_SP &&
+                prevColorFormat != HAL_PIXEL_FORMAT_CUSTOM_YCbCr_420_SP_TILED)
+                prevColorFormat = HAL_PIXEL_FORMAT_CUSTOM_YCbCr_420_SP_TILED;
 
-        mHdmiResolutionWidth[hdmiLayer] = mHdmiDstWidth;
-        mHdmiResolutionHeight[hdmiLayer] = mHdmiDstHeight;
+            if (prevColorFormat != colorFormat)
+                mHdmiInfoChange = true;
+        }
+
+        mLayerConfig[hdmiLayer] = config;
+        mRotateInfoChange = false;
+
+#ifdef BOARD_USE_V4L2
+        for (int i = 0; i < HDMI_FIMC_OUTPUT_BUF_NUM; i++)
+            mFimcReservedMem[i] = *(mSecFimc.getMemAddr(i));
+#endif
 
 #ifdef DEBUG_MSG_ENABLE
-        LOGD("m_reset saved param(%d, %d, %d, %d, %d, %d, %d) \n",
-            srcW, mSrcWidth[hdmiLayer], \
-            srcH, mSrcHeight[hdmiLayer], \
-            colorFormat,mSrcColorFormat[hdmiLayer], \
-            hdmiLayer);
+        LOGD("m_reset saved param(%d, %d, %d, %d) \n",
+            srcW, srcH, colorFormat, hdmiLayer);
 #endif
     }
 
@@ -1612,6 +1576,16 @@ bool SecHdmi::m_reset(int w, int h, int colorFormat, int hdmiLayer, int hwcLayer
         }
 #endif
 
+#if !defined(BOARD_USE_V4L2)
+        /* every layer is initialized again below */
+        for (int layer = HDMI_LAYER_BASE + 1; layer < HDMI_LAYER_MAX; layer++) {
+            if (mFlagHdmiStart[layer] == true && m_stopHdmi(layer) == false) {
+                LOGE("%s::m_stopHdmi: layer[%d] fail", __func__, layer);
+                return false;
+            }
+        }
+#endif
+
         if (m_setHdmiOutputMode(mHdmiOutputMode) == false) {
             LOGE("%s::m_setHdmiOutputMode() fail \n", __func__);
             return false;
@@ -1667,17 +1641,16 @@ bool SecHdmi::m_reset(int w, int h, int colorFormat, int hdmiLayer, int hwcLayer
                 LOGE("%s::m_setAudioMode() fail \n", __func__);
         }
 
+        /*
+         * the other layers run on an output that was set up again, they are
+         * prepared again on their next flush. this one was set up above.
+         */
+        for (int layer = 0; layer < HDMI_LAYER_MAX; layer++) {
+            if (layer != hdmiLayer)
+                mLayerConfig[layer].prepared = false;
+        }
+
         mHdmiInfoChange = false;
-	 if(mRotateInfoChange)  //added yqf
-	 	{
-	 	 mRotateInfoChange=false;
-	        //LOGI("mRotateInfoChange:%d\n",mRotateInfoChange);
-	 	}
-	 
-#ifdef BOARD_USE_V4L2
-        for (int i = 0; i < HDMI_FIMC_OUTPUT_BUF_NUM; i++)
-            mFimcReservedMem[i] = *(mSecFimc.getMemAddr(i));
-#endif
     }
 
     return true;
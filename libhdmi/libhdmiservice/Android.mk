@@ -123,5 +123,7 @@ LOCAL_MODULE:= libhdmiclient
 
 include $(BUILD_SHARED_LIBRARY)
 
+include $(call all-makefiles-under,$(LOCAL_PATH))
+
 endif
 endif
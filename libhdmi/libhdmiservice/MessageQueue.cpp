@@ -37,23 +37,84 @@ namespace android {
 
 // ---------------------------------------------------------------------------
 
-void MessageList::insert(const sp<MessageBase>& node) 
+void MessageList::insert(const sp<MessageBase>& node)
 {
-    LIST::iterator cur(mList.begin());
-    LIST::iterator end(mList.end());
-    while (cur != end) {
-        if (*node < **cur) {
-            mList.insert(cur, node);
-            return;
-        }
-        ++cur;
+    node->sequence = mSequence++;
+    node->index = mHeap.add(node);
+    siftUp(node->index);
+}
+
+void MessageList::remove(const sp<MessageBase>& node)
+{
+    size_t index = node->index;
+    size_t last = mHeap.size() - 1;
+
+    if (index != last) {
+        // the last node fills the hole, it may have to go either way
+        sp<MessageBase> moved(mHeap[last]);
+        place(index, moved);
+        mHeap.removeAt(last);
+        siftUp(index);
+        siftDown(moved->index);
+    } else {
+        mHeap.removeAt(last);
+    }
+
+    node->index = -1;
+}
+
+sp<MessageBase> MessageList::pop()
+{
+    sp<MessageBase> result(mHeap[0]);
+    size_t last = mHeap.size() - 1;
+
+    if (last != 0)
+        place(0, mHeap[last]);
+    mHeap.removeAt(last);
+    if (last != 0)
+        siftDown(0);
+
+    result->index = -1;
+    return result;
+}
+
+void MessageList::place(size_t index, const sp<MessageBase>& node)
+{
+    mHeap.editItemAt(index) = node;
+    node->index = index;
+}
+
+void MessageList::siftUp(size_t index)
+{
+    sp<MessageBase> node(mHeap[index]);
+
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (!(*node < *mHeap[parent]))
+            break;
+        place(index, mHeap[parent]);
+        index = parent;
     }
-    mList.insert(++end, node);
+    place(index, node);
 }
 
-void MessageList::remove(MessageList::LIST::iterator pos) 
+void MessageList::siftDown(size_t index)
 {
-    mList.erase(pos);
+    sp<MessageBase> node(mHeap[index]);
+    size_t count = mHeap.size();
+
+    while (true) {
+        size_t child = index * 2 + 1;
+        if (child >= count)
+            break;
+        if (child + 1 < count && *mHeap[child + 1] < *mHeap[child])
+            child++;
+        if (!(*mHeap[child] < *node))
+            break;
+        place(index, mHeap[child]);
+        index = child;
+    }
+    place(index, node);
 }
 
 // ---------------------------------------------------------------------------
@@ -80,19 +141,17 @@ sp<MessageBase> MessageQueue::waitMessage(nsecs_t timeout)
             nsecs_t now = systemTime();
             nsecs_t nextEventTime = -1;
 
-            LIST::iterator cur(mMessages.begin());
-            if (cur != mMessages.end()) {
-                result = *cur;
-            }
-            
-            if (result != 0) {
-                if (result->when <= now) {
+            if (!mMessages.isEmpty()) {
+                const sp<MessageBase>& next(mMessages.top());
+                if (next->when <= now) {
                     // there is a message to deliver
-                    mMessages.remove(cur);
+                    result = mMessages.pop();
+                    ssize_t i = mCoalesced.indexOfKey(result->what);
+                    if (i >= 0 && mCoalesced.valueAt(i) == result)
+                        mCoalesced.removeItemsAt(i);
                     break;
                 }
-                nextEventTime = result->when;
-                result = 0;
+                nextEventTime = next->when;
             }
 
             // see if we have an invalidate message
@@ -166,17 +225,53 @@ status_t MessageQueue::invalidate() {
     return NO_ERROR;
 }
 
+void MessageQueue::removeMessages()
+{
+    Vector< sp<MessageBase> > removed;
+    {
+        Mutex::Autolock _l(mLock);
+        while (!mMessages.isEmpty())
+            removed.add(mMessages.pop());
+        mCoalesced.clear();
+    }
+
+    // none of them will be handled
+    for (size_t i = 0; i < removed.size(); i++)
+        removed[i]->notify();
+}
+
 status_t MessageQueue::queueMessage(
         const sp<MessageBase>& message, nsecs_t relTime, uint32_t flags)
 {
-    Mutex::Autolock _l(mLock);
-    message->when = systemTime() + relTime;
-    mMessages.insert(message);
-    
-    //LOGD("MessageQueue::queueMessage time = %lld ms", message->when);
-    //dumpLocked(message);
+    sp<MessageBase> old;
+    {
+        Mutex::Autolock _l(mLock);
+        message->when = systemTime() + relTime;
+
+        if (flags & COALESCE) {
+            ssize_t i = mCoalesced.indexOfKey(message->what);
+            if (i >= 0 && mCoalesced.valueAt(i)->index >= 0) {
+                // the new message keeps its own time and posting order, it
+                // never overtakes messages posted after the dropped one
+                old = mCoalesced.valueAt(i);
+                mMessages.remove(old);
+            }
+            mCoalesced.replaceValueFor(message->what, message);
+            mMessages.insert(message);
+        } else {
+            mMessages.insert(message);
+        }
+
+        //LOGD("MessageQueue::queueMessage time = %lld ms", message->when);
+        //dumpLocked(message);
+
+        mCondition.signal();
+    }
+
+    // the replaced message will never be handled, release its waiters
+    if (old != 0)
+        old->notify();
 
-    mCondition.signal();
     return NO_ERROR;
 }
 
@@ -188,15 +283,12 @@ void MessageQueue::dump(const sp<MessageBase>& message)
 
 void MessageQueue::dumpLocked(const sp<MessageBase>& message)
 {
-    LIST::const_iterator cur(mMessages.begin());
-    LIST::const_iterator end(mMessages.end());
-    int c = 0;
-    while (cur != end) {
-        const char tick = (*cur == message) ? '>' : ' ';
+    // heap order, not delivery order
+    for (size_t c = 0; c < mMessages.size(); c++) {
+        const sp<MessageBase>& cur(mMessages.itemAt(c));
+        const char tick = (cur == message) ? '>' : ' ';
         LOGD("%c %d: msg{.what=%08x, when=%lld}",
-                tick, c, (*cur)->what, (*cur)->when);
-        ++cur;
-        c++;
+                tick, (int)c, cur->what, cur->when);
     }
 }
 
@@ -23,7 +23,8 @@
 
 #include <utils/threads.h>
 #include <utils/Timers.h>
-#include <utils/List.h>
+#include <utils/Vector.h>
+#include <utils/KeyedVector.h>
 
 #include "Barrier.h"
 
@@ -33,18 +34,26 @@ namespace android {
 
 class MessageBase;
 
-class MessageList 
+// binary min-heap on the delivery time, messages posted for the same time
+// are delivered in posting order
+class MessageList
 {
-    List< sp<MessageBase> > mList;
-    typedef List< sp<MessageBase> > LIST;
+    Vector< sp<MessageBase> > mHeap;
+    uint32_t mSequence;
 public:
-    inline LIST::iterator begin()                { return mList.begin(); }
-    inline LIST::const_iterator begin() const    { return mList.begin(); }
-    inline LIST::iterator end()                  { return mList.end(); }
-    inline LIST::const_iterator end() const      { return mList.end(); }
-    inline bool isEmpty() const { return mList.empty(); }
+    MessageList() : mSequence(0) { }
+    inline bool isEmpty() const { return mHeap.isEmpty(); }
+    inline size_t size() const { return mHeap.size(); }
+    inline const sp<MessageBase>& top() const { return mHeap[0]; }
+    inline const sp<MessageBase>& itemAt(size_t index) const { return mHeap[index]; }
     void insert(const sp<MessageBase>& node);
-    void remove(LIST::iterator pos);
+    void remove(const sp<MessageBase>& node);
+    sp<MessageBase> pop();
+
+private:
+    void place(size_t index, const sp<MessageBase>& node);
+    void siftUp(size_t index);
+    void siftDown(size_t index);
 };
 
 // ============================================================================
@@ -57,9 +66,9 @@ public:
     uint32_t    what;
     int32_t     arg0;    
 
-    MessageBase() : when(0), what(0), arg0(0) { }
+    MessageBase() : when(0), what(0), arg0(0), sequence(0), index(-1) { }
     MessageBase(uint32_t what, int32_t arg0=0)
-        : when(0), what(what), arg0(arg0) { }
+        : when(0), what(what), arg0(arg0), sequence(0), index(-1) { }
     
     // return true if message has a handler
     virtual bool handler() { return false; }
@@ -76,18 +85,24 @@ protected:
 
 private:
     mutable Barrier barrier;
+    uint32_t    sequence;   // posting order, breaks ties on when
+    ssize_t     index;      // position in the MessageList, -1 if not queued
     friend class LightRefBase<MessageBase>;
+    friend class MessageList;
+    friend class MessageQueue;
+    friend bool operator < (const MessageBase& lhs, const MessageBase& rhs);
 };
 
 inline bool operator < (const MessageBase& lhs, const MessageBase& rhs) {
-    return lhs.when < rhs.when;
+    if (lhs.when != rhs.when)
+        return lhs.when < rhs.when;
+    return (int32_t)(lhs.sequence - rhs.sequence) < 0;
 }
 
 // ---------------------------------------------------------------------------
 
 class MessageQueue
 {
-    typedef List< sp<MessageBase> > LIST;
 public:
 
     MessageQueue();
@@ -98,12 +113,24 @@ public:
         INVALIDATE = '_upd'
     };
 
+    // postMessage() flags
+    enum {
+        // drop the pending message of the same what, if any, and queue the
+        // new one as if the dropped one had never been posted. waiters of
+        // the dropped message are released.
+        COALESCE = 0x00000001
+    };
+
     sp<MessageBase> waitMessage(nsecs_t timeout = -1);
     
     status_t postMessage(const sp<MessageBase>& message,
             nsecs_t reltime=0, uint32_t flags = 0);
 
     status_t invalidate();
+
+    // drop every pending message and release its waiters, e.g. when the
+    // thread that calls waitMessage() exits
+    void removeMessages();
     
     void dump(const sp<MessageBase>& message);
 
@@ -115,6 +142,7 @@ private:
     Mutex           mLock;
     Condition       mCondition;
     MessageList     mMessages;
+    KeyedVector< uint32_t, sp<MessageBase> > mCoalesced;
     bool            mInvalidate;
     sp<MessageBase> mInvalidateMessage;
 };
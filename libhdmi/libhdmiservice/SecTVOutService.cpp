@@ -29,6 +29,7 @@
 #include <binder/IInterface.h>
 #include <binder/Parcel.h>
 #include <utils/Log.h>
+#include <utils/String8.h>
 #include "SecTVOutService.h"
 #include <linux/fb.h>
 #include <cutils/properties.h>
@@ -41,7 +42,7 @@ namespace android {
 #define DEFAULT_LCD_WIDTH               1280
 #define DEFAULT_LCD_HEIGHT              800
 
-#define DIRECT_VIDEO_RENDERING          (1)
+#define DIRECT_VIDEO_RENDERING          (0)
 #define DIRECT_UI_RENDERING             (0)
 
 /*yqf, 20120616,  
@@ -72,8 +73,19 @@ static int delay_cnt=0;
         while (!mExitHdmiFlushThread) {
             nsecs_t timeout = -1;
             sp<MessageBase> msg = mHdmiEventQueue.waitMessage(timeout);
+
+            // waitMessage() hands back a message whose handler failed, or
+            // the invalidate message the destructor wakes us with
+            if (msg != 0) {
+                if (msg->what != MessageQueue::INVALIDATE)
+                    LOGE("%s::message 0x%08x failed", __func__, msg->what);
+                msg->notify();
+            }
         }
 
+        // frames still queued will never be shown, release blit2Hdmi()
+        mHdmiEventQueue.removeMessages();
+
         return 0;
     }
 
@@ -97,6 +109,15 @@ static int delay_cnt=0;
         mHwcLayer = 0;
         mExitHdmiFlushThread = false;
 
+        mFramesPosted = 0;
+        mFramesPresented = 0;
+        mFramesDropped = 0;
+        mFramesFailed = 0;
+        mPresentLatencyLast = 0;
+        mPresentLatencyMax = 0;
+        mPresentLatencySum = 0;
+        mUIFlushTime = 0;
+
         setLCDsize();
         if (mSecHdmi.create(mLCD_width, mLCD_height) == false)
             LOGE("%s::mSecHdmi.create() fail", __func__);
@@ -139,11 +160,18 @@ static int delay_cnt=0;
         LOGV ("SecTVOutService destroyed");
 
         if (mHdmiFlushThread != NULL) {
+            {
+                // postHdmiFrame() queues nothing from here on
+                Mutex::Autolock _l(mLock);
+                mExitHdmiFlushThread = true;
+            }
             mHdmiFlushThread->requestExit();
-            mExitHdmiFlushThread = true;
+            mHdmiEventQueue.invalidate();
             mHdmiFlushThread->requestExitAndWait();
             mHdmiFlushThread.clear();
         }
+
+        mHeldFrame.clear();
     }
 
     status_t SecTVOutService::onTransact(uint32_t code, const Parcel & data, Parcel * reply, uint32_t flags)
@@ -275,6 +303,12 @@ static int delay_cnt=0;
     }
 
     void SecTVOutService::setHdmiResolution(uint32_t resolution)
+    {
+        sp<MessageBase> msg = new SecHdmiCtrlMsg(this, SecHdmiCtrlMsg::SET_RESOLUTION, resolution);
+        mHdmiEventQueue.postMessage(msg, 0, MessageQueue::COALESCE);
+    }
+
+    void SecTVOutService::applyHdmiResolution(uint32_t resolution)
     {
         LOGD("%s TV resolution = %d", __func__, resolution);
         Mutex::Autolock _l(mLock);
@@ -297,6 +331,12 @@ static int delay_cnt=0;
     }
 	
     void SecTVOutService::setHdmiRotate(uint32_t rotVal, uint32_t hwcLayer)
+    {
+        sp<MessageBase> msg = new SecHdmiCtrlMsg(this, SecHdmiCtrlMsg::SET_ROTATE, rotVal, hwcLayer);
+        mHdmiEventQueue.postMessage(msg, 0, MessageQueue::COALESCE);
+    }
+
+    void SecTVOutService::applyHdmiRotate(uint32_t rotVal, uint32_t hwcLayer)
     {
 		//codewalker
 		// 1080p is spec out.
@@ -325,6 +365,12 @@ static int delay_cnt=0;
 	
 //added yqf 	
 void SecTVOutService::setHdmiFlip(uint32_t flipVal, uint32_t hwcLayer)
+    {
+        sp<MessageBase> msg = new SecHdmiCtrlMsg(this, SecHdmiCtrlMsg::SET_FLIP, flipVal, hwcLayer);
+        mHdmiEventQueue.postMessage(msg, 0, MessageQueue::COALESCE);
+    }
+
+    void SecTVOutService::applyHdmiFlip(uint32_t flipVal, uint32_t hwcLayer)
 	{
         Mutex::Autolock _l(mLock);
 	        
@@ -358,6 +404,32 @@ void SecTVOutService::saveHdmiRotate(uint32_t rotVal)
                                  uint32_t dstX, uint32_t dstY,
                                  uint32_t hdmiMode,
                                  uint32_t num_of_hwc_layer)
+    {
+        Mutex::Autolock _l(mFrameLock);
+
+        sp<MessageBase> msg = postHdmiFrame(w, h, colorFormat, pPhyYAddr, pPhyCbAddr, pPhyCrAddr,
+                                            dstX, dstY, hdmiMode, num_of_hwc_layer);
+
+        // the frame is only a physical address of a buffer of the caller,
+        // which is held until the next blit2Hdmi() returns: the mixer scans
+        // a zero copy frame until the next one replaces it anyway. so
+        // release the previous frame here. if it is still queued, posting
+        // this frame of the same mode has already dropped it, so only a
+        // frame the flush thread is showing right now is waited for. mLock
+        // is not held here, the flush thread takes it for resolution,
+        // rotate and flip requests.
+        if (mHeldFrame != 0)
+            mHeldFrame->wait();
+
+        // frames of the framebuffer (no address) hold no caller buffer
+        mHeldFrame = (pPhyYAddr != 0) ? msg : 0;
+    }
+
+    sp<MessageBase> SecTVOutService::postHdmiFrame(uint32_t w, uint32_t h, uint32_t colorFormat,
+                                 uint32_t pPhyYAddr, uint32_t pPhyCbAddr, uint32_t pPhyCrAddr,
+                                 uint32_t dstX, uint32_t dstY,
+                                 uint32_t hdmiMode,
+                                 uint32_t num_of_hwc_layer)
     {
         Mutex::Autolock _l(mLock);
 		//LOGI("lt::%s::blit2Hdmi running",__func__);//lt,debug
@@ -373,8 +445,8 @@ if(hdmiMode==HDMI_MODE_VIDEO){
 }
 #endif
 
-        if (hdmiCableInserted() == false)
-            return;
+        if (hdmiCableInserted() == false || mExitHdmiFlushThread == true)
+            return 0;
 		
         int hdmiLayer = SecHdmi::HDMI_LAYER_VIDEO;
 #if defined(CHECK_UI_TIME) || defined(CHECK_VIDEO_TIME)
@@ -430,20 +502,24 @@ if(hdmiMode==HDMI_MODE_VIDEO){
             }
 #else
             {    // LOGE("UI mode \n");  //yqf, test
-                msg = new SecHdmiEventMsg(&mSecHdmi, w, h, colorFormat, pPhyYAddr, pPhyCbAddr, pPhyCrAddr,
+                msg = new SecHdmiEventMsg(this, &mSecHdmi, w, h, colorFormat, pPhyYAddr, pPhyCbAddr, pPhyCrAddr,
                                             dstX, dstY, mUILayerMode, mHwcLayer, HDMI_MODE_UI);
+                frameQueued();
 
 /* post to HdmiEventQueue */
       //yqf, 20120610, view line 46
            if(mSecHdmi.mRotateInfoChange && (delay_cnt<=DELAY_CNT_LIMIT)){   //added yqf, STAR00030984
 			delay_cnt+=1;
-		   	mHdmiEventQueue.postMessage(msg, NS_FOR_DELAY, 0);
+			mUIFlushTime = systemTime() + NS_FOR_DELAY;
 		        //LOGE(" UI mode: deley flush \n");	
            	}else {			
 			delay_cnt=0;
-			mHdmiEventQueue.postMessage(msg, 0, 0);
 	 		//LOGE(" UI mode: now flush \n");
 	    	}
+
+                // a frame that replaces a delayed one is not shown before it was due
+                nsecs_t delay = mUIFlushTime - systemTime();
+                mHdmiEventQueue.postMessage(msg, (delay > 0) ? delay : 0, MessageQueue::COALESCE);
             }
 #endif
             break;
@@ -470,11 +546,12 @@ if(hdmiMode==HDMI_MODE_VIDEO){
             LOGD("[Video] mSecHdmi.flush[end-start] = %ld ms", long(ns2ms(end)) - long(ns2ms(start)));
 #endif
 #else
-            msg = new SecHdmiEventMsg(&mSecHdmi, w, h, colorFormat, pPhyYAddr, pPhyCbAddr, pPhyCrAddr,
+            msg = new SecHdmiEventMsg(this, &mSecHdmi, w, h, colorFormat, pPhyYAddr, pPhyCbAddr, pPhyCrAddr,
                                         dstX, dstY, SecHdmi::HDMI_LAYER_VIDEO, mHwcLayer, HDMI_MODE_VIDEO);
+            frameQueued();
 
             /* post to HdmiEventQueue */
-            mHdmiEventQueue.postMessage(msg, 0, 0);
+            mHdmiEventQueue.postMessage(msg, 0, MessageQueue::COALESCE);
 #endif
             break;
 
@@ -483,7 +560,62 @@ if(hdmiMode==HDMI_MODE_VIDEO){
             break;
         }
 		
-        return;
+        return msg;
+    }
+
+    void SecTVOutService::frameQueued(void)
+    {
+        Mutex::Autolock _l(mFrameStatsLock);
+        mFramesPosted++;
+    }
+
+    void SecTVOutService::framePresented(nsecs_t postTime, bool ok)
+    {
+        nsecs_t latency = systemTime() - postTime;
+        Mutex::Autolock _l(mFrameStatsLock);
+
+        if (ok == false) {
+            mFramesFailed++;
+            return;
+        }
+
+        mFramesPresented++;
+        mPresentLatencyLast = latency;
+        mPresentLatencySum += latency;
+        if (mPresentLatencyMax < latency)
+            mPresentLatencyMax = latency;
+    }
+
+    void SecTVOutService::frameDropped(void)
+    {
+        Mutex::Autolock _l(mFrameStatsLock);
+        mFramesDropped++;
+    }
+
+    status_t SecTVOutService::dump(int fd, const Vector<String16>& args)
+    {
+        const size_t SIZE = 256;
+        char buffer[SIZE];
+        String8 result;
+
+        Mutex::Autolock _l(mFrameStatsLock);
+
+        snprintf(buffer, SIZE, "SecTVOutService:\n");
+        result.append(buffer);
+        snprintf(buffer, SIZE, "\tcable %s, hwc layers %d\n",
+                 mHdmiCableInserted ? "inserted" : "removed", mHwcLayer);
+        result.append(buffer);
+        snprintf(buffer, SIZE, "\tframes posted %u, presented %u, dropped %u, failed %u\n",
+                 mFramesPosted, mFramesPresented, mFramesDropped, mFramesFailed);
+        result.append(buffer);
+        snprintf(buffer, SIZE, "\tpresent latency last %lld us, avg %lld us, max %lld us\n",
+                 ns2us(mPresentLatencyLast),
+                 mFramesPresented ? ns2us(mPresentLatencySum / mFramesPresented) : 0LL,
+                 ns2us(mPresentLatencyMax));
+        result.append(buffer);
+
+        write(fd, result.string(), result.size());
+        return NO_ERROR;
     }
 
     bool SecTVOutService::hdmiCableInserted(void)
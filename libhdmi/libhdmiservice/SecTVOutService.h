@@ -29,6 +29,8 @@
 #include <sys/types.h>
 #include <binder/Parcel.h>
 #include <utils/KeyedVector.h>
+#include <utils/String16.h>
+#include <utils/Vector.h>
 
 #include "ISecTVOut.h"
 #include "SecHdmi.h"
@@ -69,12 +71,24 @@ namespace android {
             sp<HDMIFlushThread>     mHdmiFlushThread;
             int                     HdmiFlushThread();
 
+            // outlive mHdmiEventQueue, frames still queued on destruction
+            // count themselves as dropped
+            mutable Mutex           mFrameStatsLock;
+            uint32_t                mFramesPosted;
+            uint32_t                mFramesPresented;
+            uint32_t                mFramesDropped;
+            uint32_t                mFramesFailed;
+            nsecs_t                 mPresentLatencyLast;
+            nsecs_t                 mPresentLatencyMax;
+            nsecs_t                 mPresentLatencySum;
+
             mutable MessageQueue    mHdmiEventQueue;
             bool                    mExitHdmiFlushThread;
 
             SecTVOutService();
             static int instantiate ();
             virtual status_t onTransact(uint32_t, const Parcel &, Parcel *, uint32_t);
+            virtual status_t dump(int fd, const Vector<String16>& args);
             virtual ~SecTVOutService ();
 
             virtual void                        setHdmiStatus(uint32_t status);
@@ -90,13 +104,30 @@ namespace android {
                                                 uint32_t pPhyYAddr, uint32_t pPhyCbAddr, uint32_t pPhyCrAddr,
                                                 uint32_t dstX, uint32_t dstY,
                                                 uint32_t hdmiMode, uint32_t num_of_hwc_layer);
+            sp<MessageBase>                     postHdmiFrame(uint32_t w, uint32_t h,
+                                                uint32_t colorFormat,
+                                                uint32_t pPhyYAddr, uint32_t pPhyCbAddr, uint32_t pPhyCrAddr,
+                                                uint32_t dstX, uint32_t dstY,
+                                                uint32_t hdmiMode, uint32_t num_of_hwc_layer);
             bool                                hdmiCableInserted(void);
             void                                setLCDsize(void);
 
+            void                                applyHdmiResolution(uint32_t resolution);
+            void                                applyHdmiRotate(uint32_t rotVal, uint32_t hwcLayer);
+            void                                applyHdmiFlip(uint32_t flipVal, uint32_t hwcLayer);
+
+            // frames handed to the HDMI flush thread
+            void                                frameQueued(void);
+            void                                framePresented(nsecs_t postTime, bool ok);
+            void                                frameDropped(void);
+
         private:
             SecHdmi                     mSecHdmi;
             bool                        mHdmiCableInserted;
             int                         mUILayerMode;
+            nsecs_t                     mUIFlushTime;   // UI frames are not shown before, see NS_FOR_DELAY
+            Mutex                       mFrameLock;     // serializes blit2Hdmi()
+            sp<MessageBase>             mHeldFrame;     // last frame with a caller buffer
             uint32_t                    mLCD_width, mLCD_height;
             uint32_t                    mHwcLayer;
 	     uint32_t	              globalRotate;  //added yqf
@@ -108,6 +139,52 @@ namespace android {
             uint32_t 			phyCrAddr;        //yqf, added end
     };
 
+    // resolution, rotate and flip requests. only the latest pending request
+    // of each kind is applied, see MessageQueue::COALESCE.
+    //
+    // setHdmiResolution(), setHdmiRotate() and setHdmiFlip() return once the
+    // request is queued; a failure is only logged, as it was before. Their
+    // only callers, the HWCs in libhwc, have no reply to wait for and call
+    // them before the blit2Hdmi() they apply to, so the FIFO order of the
+    // queue applies them before that frame.
+    class SecHdmiCtrlMsg : public MessageBase {
+        public:
+            enum {
+                SET_RESOLUTION = 'hres',
+                SET_ROTATE     = 'hrot',
+                SET_FLIP       = 'hflp',
+            };
+
+            SecTVOutService *pService;
+            uint32_t    mHwcLayer;
+
+            SecHdmiCtrlMsg(SecTVOutService *service, uint32_t what, uint32_t value, uint32_t hwcLayer = 0)
+                : MessageBase(what, value), pService(service), mHwcLayer(hwcLayer) {
+            }
+
+            virtual bool handler() {
+                switch (what) {
+                case SET_RESOLUTION:
+                    pService->applyHdmiResolution(arg0);
+                    break;
+                case SET_ROTATE:
+                    pService->applyHdmiRotate(arg0, mHwcLayer);
+                    break;
+                case SET_FLIP:
+                    pService->applyHdmiFlip(arg0, mHwcLayer);
+                    break;
+                default:
+                    break;
+                }
+                return true;
+            }
+    };
+
+    // a frame for the HDMI flush thread. frames are posted with
+    // MessageQueue::COALESCE, so a newer frame of the same mode replaces the
+    // one that has not been shown yet and the replaced one counts as dropped.
+    // blit2Hdmi() returns once its frame is queued; the next blit2Hdmi()
+    // waits until this frame has been shown or dropped.
     class SecHdmiEventMsg : public MessageBase {
         public:
             enum {
@@ -116,8 +193,17 @@ namespace android {
                 HDMI_MODE_VIDEO,
             };
 
+            enum {
+                FRAME_UI    = 'hfui',
+                FRAME_VIDEO = 'hfvd',
+            };
+
             mutable     Mutex mBlitLock;
 
+            SecTVOutService *pService;
+            nsecs_t     mPostTime;
+            bool        mDone;
+
             SecHdmi     *pSecHdmi;
             uint32_t    mSrcWidth, mSrcHeight;
             uint32_t    mSrcColorFormat;
@@ -126,10 +212,13 @@ namespace android {
             uint32_t    mHdmiMode;
             uint32_t    mHdmiLayer, mHwcLayer;
 
-            SecHdmiEventMsg(SecHdmi *SecHdmi, uint32_t srcWidth, uint32_t srcHeight, uint32_t srcColorFormat,
+            SecHdmiEventMsg(SecTVOutService *service, SecHdmi *SecHdmi,
+                    uint32_t srcWidth, uint32_t srcHeight, uint32_t srcColorFormat,
                     uint32_t srcYAddr, uint32_t srcCbAddr, uint32_t srcCrAddr,
                     uint32_t dstX, uint32_t dstY, uint32_t hdmiLayer, uint32_t hwcLayer, uint32_t hdmiMode)
-                : pSecHdmi(SecHdmi), mSrcWidth(srcWidth), mSrcHeight(srcHeight), mSrcColorFormat(srcColorFormat),
+                : MessageBase(hdmiMode == HDMI_MODE_VIDEO ? FRAME_VIDEO : FRAME_UI),
+                pService(service), mPostTime(systemTime()), mDone(false),
+                pSecHdmi(SecHdmi), mSrcWidth(srcWidth), mSrcHeight(srcHeight), mSrcColorFormat(srcColorFormat),
                 mSrcYAddr(srcYAddr), mSrcCbAddr(srcCbAddr), mSrcCrAddr(srcCrAddr),
                 mDstX(dstX), mDstY(dstY), mHdmiLayer(hdmiLayer), mHwcLayer(hwcLayer), mHdmiMode(hdmiMode) {
             }
@@ -175,8 +264,18 @@ namespace android {
                     ret = false;
                     break;
                 }
+
+                mDone = true;
+                pService->framePresented(mPostTime, ret);
+
                 return ret;
             }
+
+        protected:
+            virtual ~SecHdmiEventMsg() {
+                if (!mDone)
+                    pService->frameDropped();
+            }
     };
 
 };
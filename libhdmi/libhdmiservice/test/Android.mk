@@ -0,0 +1,24 @@
+# Copyright (C) 2008 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+LOCAL_PATH:= $(call my-dir)
+
+# delivery order and load of the TV-out MessageQueue: message_queue_bench [messages]
+include $(CLEAR_VARS)
+LOCAL_SRC_FILES := message_queue_bench.cpp ../MessageQueue.cpp
+LOCAL_C_INCLUDES := $(LOCAL_PATH)/..
+LOCAL_SHARED_LIBRARIES := libutils libbinder
+LOCAL_MODULE := message_queue_bench
+LOCAL_MODULE_TAGS := tests
+include $(BUILD_EXECUTABLE)
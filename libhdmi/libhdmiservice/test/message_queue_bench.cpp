@@ -0,0 +1,250 @@
+/*
+ * Copyright (C) 2009 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Checks the delivery order of MessageQueue and times it under load:
+ *   fifo      a coalesced message never overtakes messages posted after
+ *             the one it drops
+ *   delay     messages with random delays come out by time, in posting
+ *             order for the same time
+ *   coalesce  1000 rotate and 1000 flip requests between 10 blits, as
+ *             the HWC posts them, reach the handler 12 times
+ *   remove    removeMessages() releases a thread waiting on a message
+ *             that is never handled
+ *   stress    a consumer thread against posts at full rate, plain and
+ *             coalesced: post cost, delivered messages and latency
+ *   heap      post cost with 20000 delayed messages pending
+ *
+ * usage: message_queue_bench [messages]
+ * Returns 1 if the order of any case is wrong.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "MessageQueue.h"
+
+using namespace android;
+
+enum {
+    MSG_BLIT   = 'blit',
+    MSG_ROTATE = 'rot ',
+    MSG_FLIP   = 'flip',
+};
+
+static Vector<int> gDelivered;
+static nsecs_t gLatencySum;
+static int gLatencyCount;
+static volatile bool gStop;
+
+class TestMsg : public MessageBase {
+public:
+    nsecs_t mPostTime;
+
+    TestMsg(uint32_t what, int id)
+        : MessageBase(what, id), mPostTime(systemTime()) { }
+
+    virtual bool handler() {
+        gDelivered.add(arg0);
+        gLatencySum += systemTime() - mPostTime;
+        gLatencyCount++;
+        return true;
+    }
+};
+
+static int gFailed;
+
+static void check(const char *name, bool ok)
+{
+    printf("%-10s %s\n", name, ok ? "ok" : "FAILED");
+    if (!ok)
+        gFailed = 1;
+}
+
+// handle every message that is due
+static void drain(MessageQueue& queue)
+{
+    while (queue.waitMessage(0) != 0)
+        ;
+}
+
+static void reset(void)
+{
+    gDelivered.clear();
+    gLatencySum = 0;
+    gLatencyCount = 0;
+}
+
+static void test_fifo(void)
+{
+    MessageQueue queue;
+
+    reset();
+    queue.postMessage(new TestMsg(MSG_ROTATE, 1), 0, MessageQueue::COALESCE);
+    queue.postMessage(new TestMsg(MSG_BLIT, 2));
+    queue.postMessage(new TestMsg(MSG_ROTATE, 3), 0, MessageQueue::COALESCE);
+    queue.postMessage(new TestMsg(MSG_BLIT, 4));
+    drain(queue);
+
+    // the first rotate is dropped, the second one comes after the first blit
+    check("fifo", gDelivered.size() == 3 &&
+                  gDelivered[0] == 2 && gDelivered[1] == 3 && gDelivered[2] == 4);
+}
+
+static void test_delay(void)
+{
+    MessageQueue queue;
+    nsecs_t delays[200];
+    int inversions = 0;
+
+    reset();
+    srand(1);
+    for (int i = 0; i < 200; i++) {
+        delays[i] = ms2ns(rand() % 5);
+        queue.postMessage(new TestMsg(MSG_BLIT, i), delays[i]);
+    }
+    for (int tries = 0; gDelivered.size() < 200 && tries < 100; tries++)
+        queue.waitMessage(ms2ns(50));
+
+    for (size_t i = 1; i < gDelivered.size(); i++) {
+        int a = gDelivered[i - 1];
+        int b = gDelivered[i];
+        if (delays[a] > delays[b] || (delays[a] == delays[b] && a > b))
+            inversions++;
+    }
+
+    printf("%-10s %d messages, %d out of order\n", "delay", (int)gDelivered.size(), inversions);
+    check("delay", gDelivered.size() == 200 && inversions == 0);
+}
+
+static void test_coalesce(void)
+{
+    MessageQueue queue;
+
+    reset();
+    for (int i = 0; i < 1000; i++) {
+        queue.postMessage(new TestMsg(MSG_ROTATE, i), 0, MessageQueue::COALESCE);
+        queue.postMessage(new TestMsg(MSG_FLIP, 10000 + i), 0, MessageQueue::COALESCE);
+        if (!(i % 100))
+            queue.postMessage(new TestMsg(MSG_BLIT, 20000 + i));
+    }
+    drain(queue);
+
+    printf("%-10s 2010 posted, %d handled\n", "coalesce", (int)gDelivered.size());
+    check("coalesce", gDelivered.size() == 12 &&
+                      gDelivered[10] == 999 && gDelivered[11] == 10999);
+}
+
+static void *waiter(void *arg)
+{
+    MessageBase *msg = (MessageBase *)arg;
+
+    msg->wait();
+    return NULL;
+}
+
+static void test_remove(void)
+{
+    MessageQueue queue;
+    sp<MessageBase> msg = new TestMsg(MSG_BLIT, 1);
+    pthread_t thread;
+
+    reset();
+    queue.postMessage(msg, ms2ns(1000), MessageQueue::COALESCE);
+    queue.postMessage(new TestMsg(MSG_ROTATE, 2), ms2ns(1000));
+    pthread_create(&thread, NULL, waiter, msg.get());
+
+    // as the HDMI flush thread does on exit
+    queue.removeMessages();
+    pthread_join(thread, NULL);
+    drain(queue);
+
+    // the queue is empty and coalescing starts over
+    queue.postMessage(new TestMsg(MSG_BLIT, 3), 0, MessageQueue::COALESCE);
+    drain(queue);
+
+    check("remove", gDelivered.size() == 1 && gDelivered[0] == 3);
+}
+
+static void *consumer(void *arg)
+{
+    MessageQueue *queue = (MessageQueue *)arg;
+
+    while (!gStop)
+        queue->waitMessage(ms2ns(1));
+    return NULL;
+}
+
+static void test_stress(int messages)
+{
+    for (int coalesce = 0; coalesce < 2; coalesce++) {
+        MessageQueue queue;
+        pthread_t thread;
+        nsecs_t start, end;
+
+        reset();
+        gStop = false;
+        pthread_create(&thread, NULL, consumer, &queue);
+
+        start = systemTime();
+        for (int i = 0; i < messages; i++)
+            queue.postMessage(new TestMsg(MSG_ROTATE, i), 0,
+                    coalesce ? MessageQueue::COALESCE : 0);
+        end = systemTime();
+
+        gStop = true;
+        pthread_join(thread, NULL);
+        drain(queue);
+
+        printf("%-10s %-9s post %6.0f ns/msg, handled %d/%d, latency %.1f us\n", "stress",
+                coalesce ? "coalesced" : "plain", double(end - start) / messages,
+                gLatencyCount, messages,
+                gLatencyCount ? ns2us(gLatencySum) / double(gLatencyCount) : 0.0);
+
+        if (gDelivered.isEmpty() || gDelivered.top() != messages - 1)
+            check("stress", false);
+    }
+}
+
+static void test_heap(void)
+{
+    MessageQueue queue;
+    nsecs_t start = systemTime();
+
+    for (int i = 0; i < 20000; i++)
+        queue.postMessage(new TestMsg(MSG_BLIT, i), ms2ns(1000 + rand() % 1000));
+
+    printf("%-10s 20000 delayed posts: %.0f ns/msg\n", "heap",
+            double(systemTime() - start) / 20000);
+}
+
+int main(int argc, char **argv)
+{
+    int messages = (argc > 1) ? atoi(argv[1]) : 200000;
+
+    if (messages <= 0)
+        messages = 200000;
+
+    test_fifo();
+    test_delay();
+    test_coalesce();
+    test_remove();
+    test_stress(messages);
+    test_heap();
+
+    return gFailed;
+}
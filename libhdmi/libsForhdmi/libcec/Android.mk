@@ -21,7 +21,7 @@ LOCAL_MODULE_TAGS := eng
 
 LOCAL_PRELINK_MODULE := false
 LOCAL_SHARED_LIBRARIES := liblog
-LOCAL_SRC_FILES := libcec.c
+LOCAL_SRC_FILES := libcec.c cec_engine.c
 
 LOCAL_C_INCLUDES := \
 	$(LOCAL_PATH) \
@@ -30,4 +30,6 @@ LOCAL_C_INCLUDES := \
 LOCAL_MODULE := libcec
 include $(BUILD_SHARED_LIBRARY)
 
+include $(call all-makefiles-under,$(LOCAL_PATH))
+
 endif
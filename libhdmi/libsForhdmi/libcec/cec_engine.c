@@ -0,0 +1,516 @@
+/*
+ * Copyright@ Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "libcec"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <cutils/log.h>
+
+#include "cec_engine.h"
+
+#ifndef LOGD
+#define LOGE ALOGE
+#define LOGI ALOGI
+#define LOGV ALOGV
+#define LOGD ALOGD
+#define LOGW ALOGW
+#endif
+
+struct CECTxFrame {
+    unsigned char buffer[CEC_MAX_FRAME_SIZE];
+    int size;
+    int retries;
+    /** CLOCK_MONOTONIC ms of the next attempt */
+    long long due;
+};
+
+struct CECEngine {
+    struct CECTransport transport;
+
+    int laddr;
+    int paddr;
+    enum CECDeviceType devtype;
+
+    /** handler of each opcode, NULL answers "Feature Abort" */
+    struct {
+        CECHandler handler;
+        void *priv;
+    } handlers[256];
+
+    /** tx ring, guarded by lock */
+    pthread_mutex_t lock;
+    struct CECTxFrame tx[CEC_TX_QUEUE_SIZE];
+    int txHead;
+    int txCount;
+
+    /** pipe to wake CECEngineProcess() up */
+    int wake[2];
+
+    struct CECEngineStats stats;
+};
+
+static long long CECNow(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ * "Give Physical Address" : broadcast "Report Physical Address".
+ * A reply that does not fit in the tx queue is dropped, not aborted.
+ */
+static int CECHandleGivePhysicalAddress(struct CECEngine *engine,
+                                        const unsigned char *buffer, int size, void *priv)
+{
+    unsigned char reply[5];
+
+    reply[0] = (engine->laddr << 4) | CEC_MSG_BROADCAST;
+    reply[1] = CEC_OPCODE_REPORT_PHYSICAL_ADDRESS;
+    reply[2] = (engine->paddr >> 8) & 0xFF;
+    reply[3] = engine->paddr & 0xFF;
+    reply[4] = engine->devtype;
+
+    CECEngineSend(engine, reply, sizeof(reply));
+    return 1;
+}
+
+/**
+ * "Request Active Source" : broadcast "Active Source".
+ * A reply that does not fit in the tx queue is dropped, not aborted.
+ */
+static int CECHandleRequestActiveSource(struct CECEngine *engine,
+                                        const unsigned char *buffer, int size, void *priv)
+{
+    unsigned char reply[4];
+
+    LOGD("[CEC_OPCODE_REQUEST_ACTIVE_SOURCE]\n");
+
+    reply[0] = (engine->laddr << 4) | CEC_MSG_BROADCAST;
+    reply[1] = CEC_OPCODE_ACTIVE_SOURCE;
+    reply[2] = (engine->paddr >> 8) & 0xFF;
+    reply[3] = engine->paddr & 0xFF;
+
+    LOGD("Tx : [CEC_OPCODE_ACTIVE_SOURCE]\n");
+    CECEngineSend(engine, reply, sizeof(reply));
+    return 1;
+}
+
+/**
+ * "Feature Abort" : never answered.
+ */
+static int CECHandleFeatureAbort(struct CECEngine *engine,
+                                 const unsigned char *buffer, int size, void *priv)
+{
+    return 1;
+}
+
+/**
+ * Create CEC engine on a transport.
+ *
+ * @param transport [in] link to the CEC bus, copied.
+ *
+ * @return new engine, or NULL if an arror occured.
+ */
+struct CECEngine *CECEngineCreate(const struct CECTransport *transport)
+{
+    struct CECEngine *engine;
+    int i;
+
+    engine = (struct CECEngine *)calloc(1, sizeof(*engine));
+    if (engine == NULL) {
+        LOGE("%s::calloc fail\n", __func__);
+        return NULL;
+    }
+
+    if (pipe(engine->wake) < 0) {
+        LOGE("%s::pipe fail (%s)\n", __func__, strerror(errno));
+        free(engine);
+        return NULL;
+    }
+
+    for (i = 0; i < 2; i++)
+        fcntl(engine->wake[i], F_SETFL, fcntl(engine->wake[i], F_GETFL) | O_NONBLOCK);
+
+    pthread_mutex_init(&engine->lock, NULL);
+    engine->transport = *transport;
+    engine->laddr = CEC_LADDR_UNREGISTERED;
+    engine->paddr = CEC_NOT_VALID_PHYSICAL_ADDRESS;
+    engine->devtype = CEC_DEVICE_PLAYER;
+
+    CECEngineRegisterHandler(engine, CEC_OPCODE_GIVE_PHYSICAL_ADDRESS,
+                             CECHandleGivePhysicalAddress, NULL);
+    CECEngineRegisterHandler(engine, CEC_OPCODE_REQUEST_ACTIVE_SOURCE,
+                             CECHandleRequestActiveSource, NULL);
+    CECEngineRegisterHandler(engine, CEC_OPCODE_FEATURE_ABORT,
+                             CECHandleFeatureAbort, NULL);
+
+    return engine;
+}
+
+/**
+ * Destroy CEC engine. Frames still queued are dropped.
+ */
+void CECEngineDestroy(struct CECEngine *engine)
+{
+    if (engine == NULL)
+        return;
+
+    close(engine->wake[0]);
+    close(engine->wake[1]);
+    pthread_mutex_destroy(&engine->lock);
+    free(engine);
+}
+
+/**
+ * Set addresses the engine answers with.
+ */
+void CECEngineSetAddress(struct CECEngine *engine, int laddr, int paddr,
+                         enum CECDeviceType devtype)
+{
+    engine->laddr = laddr;
+    engine->paddr = paddr;
+    engine->devtype = devtype;
+}
+
+/**
+ * Register handler of an opcode, replacing the previous one.
+ *
+ * @param handler [in] NULL to answer the opcode with "Feature Abort".
+ *
+ * @return 1 if success, otherwise, return 0.
+ */
+int CECEngineRegisterHandler(struct CECEngine *engine, unsigned char opcode,
+                             CECHandler handler, void *priv)
+{
+    if (engine == NULL)
+        return 0;
+
+    engine->handlers[opcode].handler = handler;
+    engine->handlers[opcode].priv = priv;
+    return 1;
+}
+
+/**
+ * Queue CEC message for transmission. Does not block on the bus.
+ *
+ * @return 1 if queued, 0 if the queue is full or the frame is invalid.
+ */
+int CECEngineSend(struct CECEngine *engine, const unsigned char *buffer, int size)
+{
+    struct CECTxFrame *frame;
+
+    if (size <= 0 || size > CEC_MAX_FRAME_SIZE) {
+        LOGE("size should not exceed %d\n", CEC_MAX_FRAME_SIZE);
+        return 0;
+    }
+
+    pthread_mutex_lock(&engine->lock);
+
+    if (engine->txCount == CEC_TX_QUEUE_SIZE) {
+        engine->stats.tx_overflow++;
+        pthread_mutex_unlock(&engine->lock);
+        LOGE("%s::tx queue full\n", __func__);
+        return 0;
+    }
+
+    frame = &engine->tx[(engine->txHead + engine->txCount) % CEC_TX_QUEUE_SIZE];
+    memcpy(frame->buffer, buffer, size);
+    frame->size = size;
+    frame->retries = 0;
+    frame->due = 0;
+    engine->txCount++;
+
+    pthread_mutex_unlock(&engine->lock);
+
+    CECEngineWakeup(engine);
+    return 1;
+}
+
+/**
+ * Queue "Feature Abort" for a received message.
+ */
+int CECEngineFeatureAbort(struct CECEngine *engine, const unsigned char *buffer,
+                          unsigned char reason)
+{
+    unsigned char reply[4];
+
+    reply[0] = (engine->laddr << 4) | (buffer[0] >> 4);
+    reply[1] = CEC_OPCODE_FEATURE_ABORT;
+    reply[2] = buffer[1];
+    reply[3] = reason;
+
+    return CECEngineSend(engine, reply, sizeof(reply));
+}
+
+/**
+ * Make a blocked CECEngineProcess() return.
+ */
+void CECEngineWakeup(struct CECEngine *engine)
+{
+    unsigned char c = 0;
+
+    if (write(engine->wake[1], &c, 1) < 0 && errno != EAGAIN)
+        LOGE("%s::write fail (%s)\n", __func__, strerror(errno));
+}
+
+/**
+ * Transmit frames of the queue that are due, in order.
+ *
+ * @return ms until the head frame is due, or -1 if the queue is empty.
+ */
+static int CECEngineTransmit(struct CECEngine *engine)
+{
+    struct CECTxFrame frame;
+    long long now;
+    int ret;
+
+    for (;;) {
+        pthread_mutex_lock(&engine->lock);
+        if (engine->txCount == 0) {
+            pthread_mutex_unlock(&engine->lock);
+            return -1;
+        }
+
+        now = CECNow();
+        if (engine->tx[engine->txHead].due > now) {
+            ret = (int)(engine->tx[engine->txHead].due - now);
+            pthread_mutex_unlock(&engine->lock);
+            return ret;
+        }
+        frame = engine->tx[engine->txHead];
+        pthread_mutex_unlock(&engine->lock);
+
+        // the bus is not touched with the lock held
+        ret = engine->transport.send(engine->transport.priv, frame.buffer, frame.size);
+
+        pthread_mutex_lock(&engine->lock);
+        if (ret == frame.size) {
+            engine->stats.tx++;
+        } else if (frame.retries < CEC_TX_MAX_RETRIES) {
+            struct CECTxFrame *head = &engine->tx[engine->txHead];
+
+            head->due = CECNow() + (CEC_TX_BACKOFF_MS << head->retries);
+            head->retries++;
+            engine->stats.tx_retries++;
+            pthread_mutex_unlock(&engine->lock);
+            continue;
+        } else {
+            engine->stats.tx_failed++;
+            LOGE("CECSendMessage() failed!!! (opcode 0x%x)\n",
+                 frame.size > 1 ? frame.buffer[1] : 0);
+        }
+        engine->txHead = (engine->txHead + 1) % CEC_TX_QUEUE_SIZE;
+        engine->txCount--;
+        pthread_mutex_unlock(&engine->lock);
+    }
+}
+
+/**
+ * Check a received frame and call the handler of its opcode.
+ */
+static void CECEngineDispatch(struct CECEngine *engine, const unsigned char *buffer, int size)
+{
+    unsigned char lsrc, opcode;
+    int broadcast;
+
+    if (size == 1)
+        return; // "Polling Message"
+
+    lsrc = buffer[0] >> 4;
+
+    /* ignore messages with src address == laddr */
+    if (lsrc == engine->laddr)
+        return;
+
+    opcode = buffer[1];
+    broadcast = (buffer[0] & 0x0F) == CEC_MSG_BROADCAST ? 1 : 0;
+
+    if (CECIgnoreMessage(opcode, lsrc)) {
+        LOGE("### ignore message coming from address 15 (unregistered)\n");
+        engine->stats.rx_dropped++;
+        return;
+    }
+
+    if (!CECCheckMessageSize(opcode, size)) {
+        LOGE("### invalid message size: %d(opcode: 0x%x) ###\n", size, opcode);
+        engine->stats.rx_dropped++;
+        return;
+    }
+
+    /* check if message broadcasted/directly addressed */
+    if (!CECCheckMessageMode(opcode, broadcast)) {
+        LOGE("### invalid message mode (directly addressed/broadcast) ###\n");
+        engine->stats.rx_dropped++;
+        return;
+    }
+
+    engine->stats.rx++;
+
+    if (engine->handlers[opcode].handler != NULL &&
+        engine->handlers[opcode].handler(engine, buffer, size, engine->handlers[opcode].priv))
+        return;
+
+    /* broadcast messages are never aborted */
+    if (!broadcast)
+        CECEngineFeatureAbort(engine, buffer, CEC_ABORT_REFUSED);
+}
+
+/**
+ * Wait for received frames or due transmissions and handle them.
+ *
+ * @param timeout [in] ms to wait at most, -1 to wait until something happens.
+ *
+ * @return number of frames received, or -1 if an arror occured.
+ */
+int CECEngineProcess(struct CECEngine *engine, int timeout)
+{
+    unsigned char buffer[CEC_MAX_FRAME_SIZE];
+    struct pollfd fds[2];
+    int due, received = 0;
+
+    due = CECEngineTransmit(engine);
+    if (due >= 0 && (timeout < 0 || due < timeout))
+        timeout = due;
+
+    fds[0].fd = engine->transport.getFd(engine->transport.priv);
+    fds[0].events = POLLIN;
+    fds[1].fd = engine->wake[0];
+    fds[1].events = POLLIN;
+
+    if (poll(fds, 2, timeout) < 0) {
+        if (errno == EINTR)
+            return 0;
+        LOGE("%s::poll fail (%s)\n", __func__, strerror(errno));
+        return -1;
+    }
+
+    if (fds[1].revents & POLLIN) {
+        while (read(engine->wake[0], buffer, sizeof(buffer)) > 0)
+            ;
+    }
+
+    if (fds[0].revents & POLLIN) {
+        int size = engine->transport.receive(engine->transport.priv, buffer, sizeof(buffer));
+
+        if (size > 0) {
+            CECEngineDispatch(engine, buffer, size);
+            received++;
+        }
+    }
+
+    CECEngineTransmit(engine);
+    return received;
+}
+
+/**
+ * Get counters of the engine.
+ */
+void CECEngineGetStats(struct CECEngine *engine, struct CECEngineStats *stats)
+{
+    pthread_mutex_lock(&engine->lock);
+    *stats = engine->stats;
+    pthread_mutex_unlock(&engine->lock);
+}
+
+static int CECDeviceGetFd(void *priv)
+{
+    return CECGetFd();
+}
+
+static int CECDeviceSend(void *priv, const unsigned char *buffer, int size)
+{
+    return CECSendMessage((unsigned char *)buffer, size);
+}
+
+static int CECDeviceReceive(void *priv, unsigned char *buffer, int size)
+{
+    return CECReceiveMessage(buffer, size, 0);
+}
+
+static const struct CECTransport deviceTransport = {
+    CECDeviceGetFd,
+    CECDeviceSend,
+    CECDeviceReceive,
+    NULL,
+};
+
+/**
+ * Transport on /dev/CEC, opened with CECOpen().
+ */
+const struct CECTransport *CECDeviceTransport(void)
+{
+    return &deviceTransport;
+}
+
+static int CECLoopbackGetFd(void *priv)
+{
+    return (int)(long)priv;
+}
+
+static int CECLoopbackSend(void *priv, const unsigned char *buffer, int size)
+{
+    return write((int)(long)priv, buffer, size);
+}
+
+static int CECLoopbackReceive(void *priv, unsigned char *buffer, int size)
+{
+    int bytes = read((int)(long)priv, buffer, size);
+
+    return (bytes < 0) ? 0 : bytes;
+}
+
+/**
+ * Create a transport without a CEC bus. Every frame written to peerFd is
+ * received by the engine, every frame the engine sends is read from peerFd.
+ *
+ * @return 1 if success, otherwise, return 0.
+ */
+int CECLoopbackCreate(struct CECTransport *transport, int *peerFd)
+{
+    int sv[2];
+
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sv) < 0) {
+        LOGE("%s::socketpair fail (%s)\n", __func__, strerror(errno));
+        return 0;
+    }
+
+    fcntl(sv[0], F_SETFL, fcntl(sv[0], F_GETFL) | O_NONBLOCK);
+
+    transport->getFd = CECLoopbackGetFd;
+    transport->send = CECLoopbackSend;
+    transport->receive = CECLoopbackReceive;
+    transport->priv = (void *)(long)sv[0];
+    *peerFd = sv[1];
+    return 1;
+}
+
+/**
+ * Close engine side of a loopback transport.
+ */
+void CECLoopbackDestroy(struct CECTransport *transport)
+{
+    close((int)(long)transport->priv);
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright@ Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _CEC_ENGINE_H_
+#define _CEC_ENGINE_H_
+
+#include "libcec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of frames waiting for transmission */
+#define CEC_TX_QUEUE_SIZE       16
+/** Retransmissions of a frame that was not acknowledged */
+#define CEC_TX_MAX_RETRIES      4
+/** First retransmission delay, doubled for every retry */
+#define CEC_TX_BACKOFF_MS       20
+
+/** CEC version operand of "CEC Version" (1.4) */
+#define CEC_VERSION_1_4         0x05
+
+/** "Feature Abort" reasons */
+#define CEC_ABORT_UNRECOGNIZED  0x00
+#define CEC_ABORT_REFUSED       0x04
+
+/**
+ * @struct CECTransport
+ * Link to the CEC bus. Frames are header, opcode and operands.
+ */
+struct CECTransport {
+    /** Descriptor that becomes readable when a frame arrives */
+    int (*getFd)(void *priv);
+    /** Return number of bytes sent, anything else if the frame was not acknowledged */
+    int (*send)(void *priv, const unsigned char *buffer, int size);
+    /** Return number of bytes received, 0 if none */
+    int (*receive)(void *priv, unsigned char *buffer, int size);
+    void *priv;
+};
+
+struct CECEngine;
+
+/**
+ * Handler of a received opcode.
+ * A handler whose reply cannot be queued still returns 1; the full
+ * queue is counted in tx_overflow and is no reason for "Feature Abort".
+ * @return 1 if handled, 0 to answer with "Feature Abort".
+ */
+typedef int (*CECHandler)(struct CECEngine *engine,
+                          const unsigned char *buffer, int size, void *priv);
+
+/**
+ * @struct CECEngineStats
+ * Counters of a CEC engine
+ */
+struct CECEngineStats {
+    unsigned int rx;
+    unsigned int rx_dropped;
+    unsigned int tx;
+    unsigned int tx_retries;
+    unsigned int tx_failed;
+    unsigned int tx_overflow;
+};
+
+struct CECEngine *CECEngineCreate(const struct CECTransport *transport);
+void CECEngineDestroy(struct CECEngine *engine);
+void CECEngineSetAddress(struct CECEngine *engine, int laddr, int paddr,
+                         enum CECDeviceType devtype);
+int CECEngineRegisterHandler(struct CECEngine *engine, unsigned char opcode,
+                             CECHandler handler, void *priv);
+int CECEngineSend(struct CECEngine *engine, const unsigned char *buffer, int size);
+int CECEngineFeatureAbort(struct CECEngine *engine, const unsigned char *buffer,
+                          unsigned char reason);
+int CECEngineProcess(struct CECEngine *engine, int timeout);
+void CECEngineWakeup(struct CECEngine *engine);
+void CECEngineGetStats(struct CECEngine *engine, struct CECEngineStats *stats);
+
+const struct CECTransport *CECDeviceTransport(void);
+int CECLoopbackCreate(struct CECTransport *transport, int *peerFd);
+void CECLoopbackDestroy(struct CECTransport *transport);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CEC_ENGINE_H_ */
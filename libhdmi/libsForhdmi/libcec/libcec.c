@@ -111,6 +111,16 @@ int CECClose()
     return res;
 }
 
+/**
+ * Get CEC file descriptor, to poll for received messages.
+ *
+ * @return CEC file descriptor, or -1 if the device is not open.
+ */
+int CECGetFd()
+{
+    return fd;
+}
+
 /**
  * Allocate logical address.
  *
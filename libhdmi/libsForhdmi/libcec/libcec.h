@@ -194,6 +194,7 @@ enum CECDeviceType {
 
 int CECOpen();
 int CECClose();
+int CECGetFd();
 int CECAllocLogicalAddress(int paddr, enum CECDeviceType devtype);
 int CECSendMessage(unsigned char *buffer, int size);
 int CECReceiveMessage(unsigned char *buffer, int size, long timeout);
@@ -0,0 +1,39 @@
+# Copyright (C) 2008 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+LOCAL_PATH:= $(call my-dir)
+
+# CEC engine on a loopback transport: cec_engine_test
+include $(CLEAR_VARS)
+LOCAL_SRC_FILES := cec_engine_test.c ../libcec.c ../cec_engine.c
+LOCAL_C_INCLUDES := \
+	$(LOCAL_PATH)/.. \
+	$(LOCAL_PATH)/../../../../include
+LOCAL_STATIC_LIBRARIES := liblog
+LOCAL_LDLIBS := -lpthread
+LOCAL_MODULE := cec_engine_test
+LOCAL_MODULE_TAGS := tests
+include $(BUILD_HOST_EXECUTABLE)
+
+# frames per second through the CEC engine: cec_engine_bench [iterations]
+include $(CLEAR_VARS)
+LOCAL_SRC_FILES := cec_engine_bench.c ../libcec.c ../cec_engine.c
+LOCAL_C_INCLUDES := \
+	$(LOCAL_PATH)/.. \
+	$(LOCAL_PATH)/../../../../include
+LOCAL_STATIC_LIBRARIES := liblog
+LOCAL_LDLIBS := -lpthread
+LOCAL_MODULE := cec_engine_bench
+LOCAL_MODULE_TAGS := tests
+include $(BUILD_HOST_EXECUTABLE)
@@ -0,0 +1,119 @@
+/*
+ * Copyright@ Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Times frames through CECEngineProcess() on a loopback transport:
+ * "reply" is "Give Physical Address" answered by the built-in handler,
+ * "abort" is an unhandled opcode answered with "Feature Abort" and
+ * "handled" is an opcode of a registered handler that sends nothing.
+ * The bus itself is not timed, a CEC frame takes 20 to 100 ms on the wire.
+ *
+ * usage: cec_engine_bench [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cec_engine.h"
+
+struct bench_frame {
+    const char    *name;
+    unsigned char buffer[3];
+    int           size;
+    /** 1 if the engine answers */
+    int           reply;
+};
+
+static long long now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int count_handler(struct CECEngine *engine, const unsigned char *buffer,
+                         int size, void *priv)
+{
+    (*(int *)priv)++;
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    static const struct bench_frame frames[] = {
+        { "reply",   { 0x04, CEC_OPCODE_GIVE_PHYSICAL_ADDRESS },  2, 1 },
+        { "abort",   { 0x04, CEC_OPCODE_MENU_REQUEST, 0x00 },     3, 1 },
+        { "handled", { 0x04, CEC_OPCODE_GIVE_DECK_STATUS, 0x01 }, 3, 0 },
+    };
+    int iterations = (argc > 1) ? atoi(argv[1]) : 100000;
+    unsigned char reply[CEC_MAX_FRAME_SIZE];
+    struct CECTransport transport;
+    struct CECEngine *engine;
+    int peer, handled = 0, ret = 0;
+
+    if (iterations <= 0)
+        iterations = 100000;
+
+    if (!CECLoopbackCreate(&transport, &peer)) {
+        fprintf(stderr, "cannot create loopback transport\n");
+        return 1;
+    }
+
+    engine = CECEngineCreate(&transport);
+    if (engine == NULL) {
+        fprintf(stderr, "cannot create engine\n");
+        return 1;
+    }
+    CECEngineSetAddress(engine, 4, 0x1000, CEC_DEVICE_PLAYER);
+    CECEngineRegisterHandler(engine, CEC_OPCODE_GIVE_DECK_STATUS, count_handler, &handled);
+
+    printf("%-8s %10s | %9s %12s\n", "frame", "frames", "us/frame", "frames/s");
+
+    for (size_t f = 0; f < sizeof(frames) / sizeof(frames[0]); f++) {
+        const struct bench_frame *frame = &frames[f];
+        long long ns;
+        int lost = 0;
+
+        ns = now_ns();
+        for (int i = 0; i < iterations; i++) {
+            write(peer, frame->buffer, frame->size);
+            if (CECEngineProcess(engine, 100) != 1)
+                lost++;
+            if (frame->reply && read(peer, reply, sizeof(reply)) <= 0)
+                lost++;
+        }
+        ns = now_ns() - ns;
+
+        printf("%-8s %10d | %9.2f %12.0f", frame->name, iterations,
+               ns / 1e3 / iterations, iterations / (ns / 1e9));
+        if (lost) {
+            printf(" (%d frames lost)", lost);
+            ret = 1;
+        }
+        printf("\n");
+    }
+
+    if (handled != iterations)
+        ret = 1;
+
+    CECEngineDestroy(engine);
+    CECLoopbackDestroy(&transport);
+    close(peer);
+    return ret;
+}
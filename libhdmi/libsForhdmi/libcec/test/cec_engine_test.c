@@ -0,0 +1,271 @@
+/*
+ * Copyright@ Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Runs cec_engine.c on a loopback transport, the test plays the TV
+ * (logical address 0) and the engine a player at 4:
+ *   - built-in handlers of the handler table
+ *   - "Feature Abort" of unhandled and refused messages, none for broadcasts
+ *   - a full tx queue is not answered with "Feature Abort"
+ *   - retransmission with backoff of frames that were not acknowledged
+ *
+ * usage: cec_engine_test
+ * Returns 1 if any case fails.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "cec_engine.h"
+
+#define TEST_LADDR      4
+#define TEST_PADDR      0x1000
+
+/* loopback transport that does not acknowledge the next fail frames */
+struct test_link {
+    struct CECTransport loopback;
+    int peer;
+    /** frames not acknowledged, -1 for all */
+    int fail;
+};
+
+static int failed;
+
+static long long now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static int test_get_fd(void *priv)
+{
+    struct test_link *link = (struct test_link *)priv;
+
+    return link->loopback.getFd(link->loopback.priv);
+}
+
+static int test_send(void *priv, const unsigned char *buffer, int size)
+{
+    struct test_link *link = (struct test_link *)priv;
+
+    if (link->fail) {
+        if (link->fail > 0)
+            link->fail--;
+        return 0;
+    }
+    return link->loopback.send(link->loopback.priv, buffer, size);
+}
+
+static int test_receive(void *priv, unsigned char *buffer, int size)
+{
+    struct test_link *link = (struct test_link *)priv;
+
+    return link->loopback.receive(link->loopback.priv, buffer, size);
+}
+
+static struct CECEngine *open_engine(struct test_link *link)
+{
+    struct CECTransport transport;
+    struct CECEngine *engine;
+
+    memset(link, 0, sizeof(*link));
+    if (!CECLoopbackCreate(&link->loopback, &link->peer))
+        return NULL;
+
+    transport.getFd = test_get_fd;
+    transport.send = test_send;
+    transport.receive = test_receive;
+    transport.priv = link;
+
+    engine = CECEngineCreate(&transport);
+    if (engine != NULL)
+        CECEngineSetAddress(engine, TEST_LADDR, TEST_PADDR, CEC_DEVICE_PLAYER);
+    return engine;
+}
+
+static void close_engine(struct CECEngine *engine, struct test_link *link)
+{
+    CECEngineDestroy(engine);
+    CECLoopbackDestroy(&link->loopback);
+    close(link->peer);
+}
+
+static void check(const char *name, int ok)
+{
+    printf("%-48s %s\n", name, ok ? "ok" : "FAILED");
+    if (!ok)
+        failed = 1;
+}
+
+/* send a frame of the TV to the engine and let the engine handle it */
+static void tv_send(struct CECEngine *engine, struct test_link *link,
+                    const unsigned char *buffer, int size)
+{
+    write(link->peer, buffer, size);
+    CECEngineProcess(engine, 100);
+}
+
+/* 1 if the engine sent exactly the expected frame, or nothing if size is 0 */
+static int tv_expect(struct test_link *link, const unsigned char *buffer, int size)
+{
+    unsigned char frame[CEC_MAX_FRAME_SIZE];
+    int bytes = recv(link->peer, frame, sizeof(frame), MSG_DONTWAIT);
+
+    if (size == 0)
+        return bytes < 0;
+    return bytes == size && !memcmp(frame, buffer, size);
+}
+
+static int count_handler(struct CECEngine *engine, const unsigned char *buffer,
+                         int size, void *priv)
+{
+    (*(int *)priv)++;
+    return 1;
+}
+
+static int refuse_handler(struct CECEngine *engine, const unsigned char *buffer,
+                          int size, void *priv)
+{
+    return 0;
+}
+
+static void test_dispatch(void)
+{
+    static const unsigned char give[] = { 0x04, CEC_OPCODE_GIVE_PHYSICAL_ADDRESS };
+    static const unsigned char report[] = { 0x4F, CEC_OPCODE_REPORT_PHYSICAL_ADDRESS,
+                                            0x10, 0x00, CEC_DEVICE_PLAYER };
+    static const unsigned char menu[] = { 0x04, CEC_OPCODE_MENU_REQUEST, 0x00 };
+    static const unsigned char abort_refused[] = { 0x40, CEC_OPCODE_FEATURE_ABORT,
+                                                   CEC_OPCODE_MENU_REQUEST, CEC_ABORT_REFUSED };
+    static const unsigned char standby[] = { 0x0F, CEC_OPCODE_STANDBY };
+    static const unsigned char own[] = { 0x40, CEC_OPCODE_MENU_REQUEST, 0x00 };
+    struct test_link link;
+    struct CECEngine *engine = open_engine(&link);
+    int count = 0;
+
+    if (engine == NULL) {
+        check("dispatch: open engine", 0);
+        return;
+    }
+
+    tv_send(engine, &link, give, sizeof(give));
+    check("dispatch: Give Physical Address is reported", tv_expect(&link, report, sizeof(report)));
+
+    tv_send(engine, &link, menu, sizeof(menu));
+    check("dispatch: unhandled opcode is aborted",
+          tv_expect(&link, abort_refused, sizeof(abort_refused)));
+
+    tv_send(engine, &link, standby, sizeof(standby));
+    check("dispatch: unhandled broadcast is not aborted", tv_expect(&link, NULL, 0));
+
+    tv_send(engine, &link, own, sizeof(own));
+    check("dispatch: own frames are ignored", tv_expect(&link, NULL, 0));
+
+    CECEngineRegisterHandler(engine, CEC_OPCODE_MENU_REQUEST, count_handler, &count);
+    tv_send(engine, &link, menu, sizeof(menu));
+    check("dispatch: registered handler is called",
+          count == 1 && tv_expect(&link, NULL, 0));
+
+    CECEngineRegisterHandler(engine, CEC_OPCODE_MENU_REQUEST, refuse_handler, NULL);
+    tv_send(engine, &link, menu, sizeof(menu));
+    check("dispatch: refused message is aborted",
+          tv_expect(&link, abort_refused, sizeof(abort_refused)));
+
+    close_engine(engine, &link);
+}
+
+static void test_queue_full(void)
+{
+    static const unsigned char give[] = { 0x04, CEC_OPCODE_GIVE_PHYSICAL_ADDRESS };
+    static const unsigned char polling[] = { 0x40 };
+    struct CECEngineStats stats;
+    struct test_link link;
+    struct CECEngine *engine = open_engine(&link);
+    int i;
+
+    if (engine == NULL) {
+        check("queue full: open engine", 0);
+        return;
+    }
+
+    // the TV stops acknowledging, the queued frames stay queued
+    link.fail = -1;
+    for (i = 0; i < CEC_TX_QUEUE_SIZE; i++)
+        CECEngineSend(engine, polling, sizeof(polling));
+    CECEngineProcess(engine, 0);
+
+    tv_send(engine, &link, give, sizeof(give));
+    CECEngineGetStats(engine, &stats);
+
+    // the reply overflows, a "Feature Abort" would overflow a second time
+    check("queue full: reply dropped, not aborted", stats.rx == 1 && stats.tx_overflow == 1);
+
+    close_engine(engine, &link);
+}
+
+/* send one frame the TV does not acknowledge fail times, -1 for never */
+static void run_retry(const char *name, int fail, int retries, int sent, int failures)
+{
+    static const unsigned char menu[] = { 0x40, CEC_OPCODE_MENU_REQUEST, 0x00 };
+    struct CECEngineStats stats;
+    struct test_link link;
+    struct CECEngine *engine = open_engine(&link);
+    long long start, elapsed, backoff = 0;
+    int i;
+
+    if (engine == NULL) {
+        check(name, 0);
+        return;
+    }
+
+    for (i = 0; i < retries; i++)
+        backoff += CEC_TX_BACKOFF_MS << i;
+
+    link.fail = fail;
+    start = now_ms();
+    CECEngineSend(engine, menu, sizeof(menu));
+    do {
+        CECEngineProcess(engine, 1000);
+        CECEngineGetStats(engine, &stats);
+    } while (stats.tx + stats.tx_failed == 0 && now_ms() - start < 2000);
+    elapsed = now_ms() - start;
+
+    printf("%-48s %u retries, %lld ms (backoff %lld ms)\n", name, stats.tx_retries,
+           elapsed, backoff);
+    check(name, stats.tx_retries == (unsigned int)retries &&
+                stats.tx == (unsigned int)sent &&
+                stats.tx_failed == (unsigned int)failures &&
+                elapsed >= backoff &&
+                tv_expect(&link, sent ? menu : NULL, sent ? sizeof(menu) : 0));
+
+    close_engine(engine, &link);
+}
+
+int main(void)
+{
+    test_dispatch();
+    test_queue_full();
+    run_retry("retry: acknowledged on the 4th attempt", 3, 3, 1, 0);
+    run_retry("retry: never acknowledged",
+              -1, CEC_TX_MAX_RETRIES, 0, 1);
+
+    return failed;
+}
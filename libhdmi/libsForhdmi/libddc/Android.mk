@@ -50,4 +50,6 @@ endif
 LOCAL_MODULE := libddc
 include $(BUILD_SHARED_LIBRARY)
 
+include $(call all-makefiles-under,$(LOCAL_PATH))
+
 endif
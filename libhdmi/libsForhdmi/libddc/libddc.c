@@ -25,7 +25,12 @@
 
 #include <linux/i2c.h>
 #include <cutils/log.h>
+#ifdef DDC_HOST_BUILD
+/* the i2c-dev.h of this tree is a kernel header, host tests use the sysroot one */
+#include <linux/i2c-dev.h>
+#else
 #include "i2c-dev.h"
+#endif
 
 #include "libddc.h"
 
@@ -75,15 +80,56 @@ static int ddc_fd = -1;
  */
 static unsigned int ref_cnt = 0;
 
+/**
+ * Run a combined transfer on the DDC device node
+ */
+static int DDCDeviceTransfer(void *priv, struct i2c_msg *msgs, int nmsgs)
+{
+    struct i2c_rdwr_ioctl_data msgset;
+
+    msgset.msgs  = msgs;
+    msgset.nmsgs = nmsgs;
+
+    if (ioctl(ddc_fd, I2C_RDWR, &msgset) < 0) {
+#if DDC_DEBUG
+        LOGE("%s: ioctl(I2C_RDWR) failed!!!", __func__);
+#endif
+        return 0;
+    }
+    return 1;
+}
+
+static const struct DDCAdapter device_adapter = {
+    DDCDeviceTransfer,
+    NULL,
+};
+
+/**
+ * Adapter all transfers go to
+ */
+static const struct DDCAdapter *adapter = &device_adapter;
+
 /**
  * Check if DDC file is already opened or not
  * @return  If DDC file is already opened, return 1; Otherwise, return 0.
  */
 static int DDCFileAvailable()
 {
+    if (adapter != &device_adapter)
+        return (ref_cnt > 0) ? 1 : 0;
     return (ddc_fd < 0) ? 0 : 1;
 }
 
+/**
+ * Route DDC transfers to another I2C adapter, e.g. a simulated one.
+ * Must be called while the library is closed.
+ * @param   newAdapter  [in]    Adapter to use, NULL for the DDC device
+ */
+void DDCSetAdapter(const struct DDCAdapter *newAdapter)
+{
+    adapter = newAdapter ? newAdapter : &device_adapter;
+}
+
 /**
  * Initialze DDC library. Open DDC device
  * @return  If succeed in opening DDC device or it is already opened, return 1;@n
@@ -99,6 +145,12 @@ int DDCOpen()
         return 1;
     }
 
+    // nothing to open for other adapters
+    if (adapter != &device_adapter) {
+        ref_cnt++;
+        return 1;
+    }
+
     // open
     if ((ddc_fd = open(DEV_NAME,O_RDWR)) < 0) {
         LOGE("%s: Cannot open I2C_DDC : %s",__func__, DEV_NAME);
@@ -126,7 +178,7 @@ int DDCClose()
     }
 
     // close
-    if (ref_cnt > 1) {
+    if (ref_cnt > 1 || adapter != &device_adapter) {
         ref_cnt--;
         return 1;
     }
@@ -155,9 +207,7 @@ int DDCClose()
 int DDCRead(unsigned char addr, unsigned char offset,
             unsigned int size, unsigned char* buffer)
 {
-    struct i2c_rdwr_ioctl_data msgset;
     struct i2c_msg msgs[2];
-    int ret = 1;
 
     if (!DDCFileAvailable()) {
 #if DDC_DEBUG
@@ -178,17 +228,8 @@ int DDCRead(unsigned char addr, unsigned char offset,
     msgs[1].len = size;
     msgs[1].buf = buffer;
 
-    // set rdwr ioctl data
-    msgset.nmsgs = 2;
-    msgset.msgs = msgs;
-
     // i2c fast read
-    if ((ret = ioctl(ddc_fd, I2C_RDWR, &msgset)) < 0) {
-        perror("ddc error:");
-        ret = 0;
-    }
-
-    return ret;
+    return adapter->transfer(adapter->priv, msgs, 2);
 }
 
 /**
@@ -205,9 +246,7 @@ int DDCRead(unsigned char addr, unsigned char offset,
 int EDDCRead(unsigned char segpointer, unsigned char segment, unsigned char addr,
   unsigned char offset, unsigned int size, unsigned char* buffer)
 {
-    struct i2c_rdwr_ioctl_data msgset;
     struct i2c_msg msgs[3];
-    int ret = 1;
 
     if (!DDCFileAvailable()) {
 #if DDC_DEBUG
@@ -239,17 +278,86 @@ int EDDCRead(unsigned char segpointer, unsigned char segment, unsigned char addr
     msgs[2].len   = size;
     msgs[2].buf   = buffer;
 
-    msgset.nmsgs = 3;
-    msgset.msgs  = msgs;
-
     // eddc read
-    if (ioctl(ddc_fd, I2C_RDWR, &msgset) < 0) {
+    return adapter->transfer(adapter->priv, msgs, 3);
+}
+
+/**
+ * Read a byte range of the E-DDC address space, segment * 256 + offset.
+ * Every segment the range touches takes three messages: segment pointer,
+ * offset and read. They are sent as few combined transfers as
+ * I2C_RDRW_IOCTL_MAX_MSGS allows, one for any EDID up to 14 segments.
+ * @param   segpointer  [in]    Segment pointer
+ * @param   addr        [in]    Device address
+ * @param   start       [in]    First byte, segment * 256 + offset
+ * @param   size        [in]    Sizes of data
+ * @param   buffer      [out]   Pointer to buffer to store data
+ * @return  If succeed in reading, return 1; Otherwise, return 0.
+ */
+int EDDCReadRange(unsigned char segpointer, unsigned char addr,
+  unsigned int start, unsigned int size, unsigned char* buffer)
+{
+    struct i2c_msg msgs[I2C_RDRW_IOCTL_MAX_MSGS];
+    unsigned char segment[I2C_RDRW_IOCTL_MAX_MSGS / 3];
+    unsigned char offset[I2C_RDRW_IOCTL_MAX_MSGS / 3];
+
+    if (!DDCFileAvailable()) {
 #if DDC_DEBUG
-        LOGE("%s: ioctl(I2C_RDWR) failed!!!", __func__);
+        LOGE("%s: I2C_DDC is not available!!!!", __func__);
 #endif
-        ret = 0;
+        return 0;
     }
-    return ret;
+
+    if (start + size > 128 * 256) {
+        LOGE("%s: range 0x%x + %u is out of E-DDC address space", __func__, start, size);
+        return 0;
+    }
+
+    while (size > 0) {
+        int nmsgs = 0;
+        int group = 0;
+
+        while (size > 0 && nmsgs + 3 <= I2C_RDRW_IOCTL_MAX_MSGS) {
+            unsigned int len = 256 - (start & 0xFF);
+
+            if (len > size)
+                len = size;
+
+            segment[group] = start >> 8;
+            offset[group]  = start & 0xFF;
+
+            // set segment pointer, ignore ack only if segment is "0"
+            msgs[nmsgs].addr  = segpointer>>1;
+            msgs[nmsgs].flags = segment[group] ? 0 : I2C_M_IGNORE_NAK;
+            msgs[nmsgs].len   = 1;
+            msgs[nmsgs].buf   = &segment[group];
+            nmsgs++;
+
+            // set offset
+            msgs[nmsgs].addr  = addr>>1;
+            msgs[nmsgs].flags = 0;
+            msgs[nmsgs].len   = 1;
+            msgs[nmsgs].buf   = &offset[group];
+            nmsgs++;
+
+            // read data up to the end of the segment
+            msgs[nmsgs].addr  = addr>>1;
+            msgs[nmsgs].flags = I2C_M_RD;
+            msgs[nmsgs].len   = len;
+            msgs[nmsgs].buf   = buffer;
+            nmsgs++;
+
+            group++;
+            start  += len;
+            size   -= len;
+            buffer += len;
+        }
+
+        if (!adapter->transfer(adapter->priv, msgs, nmsgs))
+            return 0;
+    }
+
+    return 1;
 }
 
 /**
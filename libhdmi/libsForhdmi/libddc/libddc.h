@@ -21,12 +21,28 @@
 extern "C" {
 #endif
 
+struct i2c_msg;
+
+/**
+ * @struct DDCAdapter
+ * I2C bus the DDC library talks to. The default is the DDC device node.
+ */
+struct DDCAdapter {
+    /** Run the messages as one combined transfer (one STOP only).
+     *  Return 1 if succeed; Otherwise, return 0. */
+    int (*transfer)(void *priv, struct i2c_msg *msgs, int nmsgs);
+    void *priv;
+};
+
 int DDCOpen();
 int DDCRead(unsigned char addr, unsigned char offset, unsigned int size, unsigned char* buffer);
 int DDCWrite(unsigned char addr, unsigned char offset, unsigned int size, unsigned char* buffer);
 int EDDCRead(unsigned char segpointer, unsigned char segment, unsigned char addr,
   unsigned char offset, unsigned int size, unsigned char* buffer);
+int EDDCReadRange(unsigned char segpointer, unsigned char addr,
+  unsigned int start, unsigned int size, unsigned char* buffer);
 int DDCClose();
+void DDCSetAdapter(const struct DDCAdapter *adapter);
 
 #ifdef __cplusplus
 }
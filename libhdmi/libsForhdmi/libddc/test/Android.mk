@@ -0,0 +1,28 @@
+# Copyright (C) 2008 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+LOCAL_PATH:= $(call my-dir)
+
+# DDC bus traffic of an EDID read on a simulated sink: ddc_edid_bench
+include $(CLEAR_VARS)
+LOCAL_SRC_FILES := ddc_edid_bench.c ddc_sim.c ../libddc.c
+LOCAL_C_INCLUDES := \
+	$(LOCAL_PATH)/.. \
+	$(LOCAL_PATH)/../../../../include
+# any channel, the simulated sink never opens the device node
+LOCAL_CFLAGS := -DDDC_CH_I2C_1 -DDDC_HOST_BUILD
+LOCAL_STATIC_LIBRARIES := liblog
+LOCAL_MODULE := ddc_edid_bench
+LOCAL_MODULE_TAGS := tests
+include $(BUILD_HOST_EXECUTABLE)
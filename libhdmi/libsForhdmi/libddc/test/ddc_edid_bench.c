@@ -0,0 +1,140 @@
+/*
+* Copyright@ Samsung Electronics Co. LTD
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/*
+ * Counts the DDC bus traffic of an EDID read through the simulated sink of
+ * ddc_sim.c (100 kHz, 200 us per combined transfer). "block" reads every
+ * EDID block with its own EDDCRead(), as libedid did before
+ * EDDCReadRange(). "range" reads block 0 alone, since it holds the
+ * extension count, and all extension blocks with one EDDCReadRange(), as
+ * libedid does now. Both reads are checked against the EDID image.
+ *
+ * usage: ddc_edid_bench
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "libddc.h"
+#include "ddc_sim.h"
+
+#define EDID_ADDR               (0xA0)
+#define EDID_SEGMENT_POINTER    (0x60)
+#define SIZEOFEDIDBLOCK         (0x80)
+#define EDID_EXTENSION_NUMBER   (0x7E)
+
+#define SIM_KHZ                 (100)
+#define SIM_TRANSFER_US         (200)
+
+#define MAX_BLOCKS              (8)
+
+/* blocks with valid checksums, block 0 holding the extension count */
+static void make_edid(unsigned char *edid, unsigned int blocks)
+{
+    unsigned int i, j;
+
+    for (i = 0; i < blocks; i++) {
+        unsigned char *block = edid + i * SIZEOFEDIDBLOCK;
+        unsigned char sum = 0;
+
+        for (j = 0; j < SIZEOFEDIDBLOCK - 1; j++)
+            block[j] = (unsigned char)(i * 31 + j * 7);
+        if (i == 0)
+            block[EDID_EXTENSION_NUMBER] = blocks - 1;
+        for (j = 0; j < SIZEOFEDIDBLOCK - 1; j++)
+            sum += block[j];
+        block[SIZEOFEDIDBLOCK - 1] = (unsigned char)(0x100 - sum);
+    }
+}
+
+static int read_blocks(unsigned char *buf)
+{
+    unsigned int blocks, i;
+
+    if (!EDDCRead(EDID_SEGMENT_POINTER, 0, EDID_ADDR, 0, SIZEOFEDIDBLOCK, buf))
+        return 0;
+
+    blocks = buf[EDID_EXTENSION_NUMBER] + 1;
+    for (i = 1; i < blocks && i < MAX_BLOCKS; i++) {
+        if (!EDDCRead(EDID_SEGMENT_POINTER, i / 2, EDID_ADDR, (i % 2) * SIZEOFEDIDBLOCK,
+                      SIZEOFEDIDBLOCK, buf + i * SIZEOFEDIDBLOCK))
+            return 0;
+    }
+    return 1;
+}
+
+static int read_range(unsigned char *buf)
+{
+    unsigned int blocks;
+
+    if (!EDDCRead(EDID_SEGMENT_POINTER, 0, EDID_ADDR, 0, SIZEOFEDIDBLOCK, buf))
+        return 0;
+
+    blocks = buf[EDID_EXTENSION_NUMBER] + 1;
+    if (blocks > MAX_BLOCKS)
+        blocks = MAX_BLOCKS;
+    if (blocks == 1)
+        return 1;
+
+    return EDDCReadRange(EDID_SEGMENT_POINTER, EDID_ADDR, SIZEOFEDIDBLOCK,
+                         (blocks - 1) * SIZEOFEDIDBLOCK, buf + SIZEOFEDIDBLOCK);
+}
+
+static int run(const char *name, int (*read)(unsigned char *), unsigned int blocks)
+{
+    unsigned char edid[MAX_BLOCKS * SIZEOFEDIDBLOCK];
+    unsigned char buf[MAX_BLOCKS * SIZEOFEDIDBLOCK];
+    struct DDCAdapter sim;
+    struct DDCSimStats stats;
+    int ok;
+
+    make_edid(edid, blocks);
+    memset(buf, 0, sizeof(buf));
+
+    if (!DDCSimCreate(&sim, edid, blocks * SIZEOFEDIDBLOCK, SIM_KHZ, SIM_TRANSFER_US)) {
+        printf("DDCSimCreate failed\n");
+        return 0;
+    }
+    DDCSetAdapter(&sim);
+
+    ok = DDCOpen() && read(buf) && !memcmp(buf, edid, blocks * SIZEOFEDIDBLOCK);
+    DDCClose();
+
+    DDCSimGetStats(&sim, &stats);
+    DDCSetAdapter(NULL);
+    DDCSimDestroy(&sim);
+
+    printf("%u-block EDID %-5s: %2u transfers, %2u msgs, %4u B, %6llu us%s\n",
+            blocks, name, stats.transfers, stats.messages, stats.bytes, stats.bus_us,
+            ok ? "" : "  READ FAILED");
+    return ok;
+}
+
+int main(void)
+{
+    static const unsigned int sizes[] = { 1, 2, 4, 8 };
+    int ret = 0;
+    unsigned int i;
+
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        if (!run("block", read_blocks, sizes[i]))
+            ret = 1;
+        if (!run("range", read_range, sizes[i]))
+            ret = 1;
+    }
+
+    return ret;
+}
@@ -0,0 +1,155 @@
+/*
+* Copyright@ Samsung Electronics Co. LTD
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <linux/i2c.h>
+
+#include "libddc.h"
+#include "ddc_sim.h"
+
+/**
+ * @brief Simulated E-DDC sink.
+ * Serves data at segment * 256 + offset through the segment pointer (0x30)
+ * and the EDID address (0x50), and counts the bus traffic. A sink whose
+ * data fits in one segment NAKs the segment pointer like a DDC-only sink.
+ * Bus time is modelled as 9 clocks per byte plus START and STOP, so no
+ * real time passes.
+ */
+
+#define DDC_SIM_SEGPOINTER  (0x30)
+#define DDC_SIM_ADDR        (0x50)
+
+struct ddc_sim {
+    unsigned char *data;
+    unsigned int size;
+    unsigned int khz;
+    unsigned int transfer_us;
+    struct DDCSimStats stats;
+};
+
+static int DDCSimTransfer(void *priv, struct i2c_msg *msgs, int nmsgs)
+{
+    struct ddc_sim *sim = (struct ddc_sim *)priv;
+    unsigned int segment = 0;
+    unsigned int offset = 0;
+    unsigned int clocks = 1;    // STOP
+    int ret = 1;
+    int i;
+
+    sim->stats.transfers++;
+
+    for (i = 0; i < nmsgs && ret; i++) {
+        struct i2c_msg *msg = &msgs[i];
+        unsigned int j;
+
+        sim->stats.messages++;
+        sim->stats.bytes += 1 + msg->len;
+        clocks += 1 + (1 + msg->len) * 9;   // (repeated) START, address, data
+
+        if (msg->addr == DDC_SIM_SEGPOINTER && !(msg->flags & I2C_M_RD) && msg->len == 1) {
+            if (sim->size <= 256) {
+                // DDC-only sink
+                if (!(msg->flags & I2C_M_IGNORE_NAK))
+                    ret = 0;
+                continue;
+            }
+            segment = msg->buf[0];
+        } else if (msg->addr == DDC_SIM_ADDR && !(msg->flags & I2C_M_RD) && msg->len == 1) {
+            offset = msg->buf[0];
+        } else if (msg->addr == DDC_SIM_ADDR && (msg->flags & I2C_M_RD)) {
+            for (j = 0; j < msg->len; j++) {
+                unsigned int pos = segment * 256 + offset;
+
+                // a sink without the addressed block reads as 0xFF
+                msg->buf[j] = (pos < sim->size) ? sim->data[pos] : 0xFF;
+                offset = (offset + 1) & 0xFF;
+            }
+        } else {
+            ret = 0;
+        }
+    }
+
+    // the segment pointer goes back to 0 on STOP
+    sim->stats.bus_us += sim->transfer_us + (clocks * 1000ULL) / sim->khz;
+    return ret;
+}
+
+/**
+ * Create a simulated E-DDC adapter, see DDCSetAdapter().
+ * @param   adapter     [out]   Adapter to fill in
+ * @param   data        [in]    Contents of the E-DDC address space, e.g. an EDID
+ * @param   size        [in]    Size of data
+ * @param   khz         [in]    Modelled bus clock
+ * @param   transfer_us [in]    Modelled fixed cost of one combined transfer
+ * @return  If succeed, return 1; Otherwise, return 0.
+ */
+int DDCSimCreate(struct DDCAdapter *adapter, const unsigned char *data, unsigned int size,
+  unsigned int khz, unsigned int transfer_us)
+{
+    struct ddc_sim *sim;
+
+    if (adapter == NULL || data == NULL || khz == 0)
+        return 0;
+
+    sim = (struct ddc_sim *)calloc(1, sizeof(*sim));
+    if (sim == NULL)
+        return 0;
+
+    sim->data = (unsigned char *)malloc(size);
+    if (sim->data == NULL) {
+        free(sim);
+        return 0;
+    }
+    memcpy(sim->data, data, size);
+    sim->size = size;
+    sim->khz = khz;
+    sim->transfer_us = transfer_us;
+
+    adapter->transfer = DDCSimTransfer;
+    adapter->priv = sim;
+    return 1;
+}
+
+/**
+ * Get the bus usage counted since DDCSimCreate().
+ * @param   adapter [in]    Simulated adapter
+ * @param   stats   [out]   Counters
+ */
+void DDCSimGetStats(const struct DDCAdapter *adapter, struct DDCSimStats *stats)
+{
+    struct ddc_sim *sim = (struct ddc_sim *)adapter->priv;
+
+    *stats = sim->stats;
+}
+
+/**
+ * Destroy a simulated adapter.
+ * @param   adapter [in]    Simulated adapter
+ */
+void DDCSimDestroy(struct DDCAdapter *adapter)
+{
+    struct ddc_sim *sim = (struct ddc_sim *)adapter->priv;
+
+    if (sim == NULL)
+        return;
+
+    free(sim->data);
+    free(sim);
+    adapter->transfer = NULL;
+    adapter->priv = NULL;
+}
@@ -0,0 +1,50 @@
+/*
+* Copyright@ Samsung Electronics Co. LTD
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef _DDC_SIM_H_
+#define _DDC_SIM_H_
+
+#include "libddc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @struct DDCSimStats
+ * Bus usage counted by the simulated adapter
+ */
+struct DDCSimStats {
+    /** combined transfers, one per I2C_RDWR */
+    unsigned int transfers;
+    /** I2C messages */
+    unsigned int messages;
+    /** bytes on the bus, address bytes included */
+    unsigned int bytes;
+    /** modelled bus time in us */
+    unsigned long long bus_us;
+};
+
+int DDCSimCreate(struct DDCAdapter *adapter, const unsigned char *data, unsigned int size,
+  unsigned int khz, unsigned int transfer_us);
+void DDCSimGetStats(const struct DDCAdapter *adapter, struct DDCSimStats *stats);
+void DDCSimDestroy(struct DDCAdapter *adapter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _DDC_SIM_H_ */
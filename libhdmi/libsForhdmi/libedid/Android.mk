@@ -24,6 +24,12 @@ LOCAL_MODULE_PATH := $(TARGET_OUT_SHARED_LIBRARIES)
 LOCAL_SHARED_LIBRARIES := liblog libddc
 LOCAL_SRC_FILES := libedid.c
 
+ifneq ($(BOARD_EDID_CACHE_DIR),)
+LOCAL_CFLAGS += -DEDID_CACHE_DIR=\"$(BOARD_EDID_CACHE_DIR)\"
+else
+LOCAL_REQUIRED_MODULES := init.edid.rc
+endif
+
 LOCAL_C_INCLUDES := \
 	$(LOCAL_PATH) \
 	$(LOCAL_PATH)/../../../include
@@ -31,4 +37,20 @@ LOCAL_C_INCLUDES := \
 LOCAL_MODULE := libedid
 include $(BUILD_SHARED_LIBRARY)
 
+# creates the default EDID_CACHE_DIR, boards setting BOARD_EDID_CACHE_DIR
+# have to create theirs in their own init.<board>.rc
+ifeq ($(BOARD_EDID_CACHE_DIR),)
+include $(CLEAR_VARS)
+
+LOCAL_MODULE_TAGS := eng
+LOCAL_MODULE_CLASS := ETC
+LOCAL_MODULE_PATH := $(TARGET_ROOT_OUT)
+LOCAL_SRC_FILES := init.edid.rc
+
+LOCAL_MODULE := init.edid.rc
+include $(BUILD_PREBUILT)
+endif
+
+include $(call all-makefiles-under,$(LOCAL_PATH))
+
 endif
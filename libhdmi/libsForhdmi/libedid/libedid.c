@@ -17,6 +17,10 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/stat.h>
 
 #include <cutils/log.h>
 
@@ -34,6 +38,17 @@
 
 #define NUM_OF_VIC_FOR_3D           16
 
+#define EDID_MAX_DTD                32
+#define EDID_MAX_SAD                32
+#define EDID_MAX_HDMI_VIC           8
+#define EDID_MAX_3D_EXT             16
+
+#ifndef EDID_CACHE_DIR
+#define EDID_CACHE_DIR              "/data/misc/edid"
+#endif
+#define EDID_CACHE_MAGIC            0x31434445  /* "EDC1" */
+#define EDID_CACHE_PATH_LEN         64
+
 /**
  * @var gEdidData
  * Pointer to EDID data
@@ -46,12 +61,36 @@ static unsigned char* gEdidData;
  */
 static int gExtensions;
 
+//! Header of the EDID cache file, followed by all EDID blocks
+struct edid_cache_header {
+    unsigned int magic;
+    unsigned int extensions;
+    /** 1 if requested/chosen are set */
+    unsigned int mode_valid;
+    /** mode asked by the caller */
+    unsigned int requested;
+    /** mode the caller ended up with on this sink */
+    unsigned int chosen;
+};
+
+/**
+ * @var gCache
+ * Cache header of the current sink
+ */
+static struct edid_cache_header gCache;
+
+/**
+ * @var gCachePath
+ * Cache file of the current sink, empty if none
+ */
+static char gCachePath[EDID_CACHE_PATH_LEN];
 
 /**
- * @var aVIC
- * This contains first 16 VIC in EDID
+ * @var gCacheErrorLogged
+ * 1 once a cache failure has been logged
  */
-static unsigned char aVIC[NUM_OF_VIC_FOR_3D];
+static int gCacheErrorLogged;
+
 
 //! Structure for parsing video timing parameter in EDID
 static const struct edid_params {
@@ -181,10 +220,11 @@ static int CalcChecksum(const unsigned char* const buffer, const int size)
 }
 
 /**
- * Read EDID Block(128 bytes)
+ * Read consecutive EDID Blocks(128 bytes each) in as few DDC transfers as possible
  *
- * @param   blockNum    [in]    Number of block to read @n
+ * @param   blockNum    [in]    Number of first block to read @n
  *                  For example, EDID block = 0, EDID first Extension = 1, and so on.
+ * @param   numBlocks   [in]    Number of blocks to read
  * @param   outBuffer   [out]   Pointer to buffer to store EDID data
  *
  * @return  If fail to read, return 0; Otherwise, return 1.
@@ -200,9 +240,13 @@ static int CalcChecksum(const unsigned char* const buffer, const int size)
   *     	SAMSUNG LS26A33W                            DVI
   */
 
-static int ReadEDIDBlock(const unsigned int blockNum, unsigned char* const outBuffer)
+static int ReadEDIDBlock(const unsigned int blockNum, const unsigned int numBlocks,
+                         unsigned char* const outBuffer)
 {
-    int segNum, offset, dataPtr;
+    unsigned int block;
+#ifdef EDID_DEBUG
+    unsigned int offset;
+#endif
 
     // check parameter
     if (outBuffer == NULL) {
@@ -210,20 +254,18 @@ static int ReadEDIDBlock(const unsigned int blockNum, unsigned char* const outBu
         return 0;
     }
 
-    // calculate
-    segNum = blockNum / 2;
-    offset = (blockNum % 2) * SIZEOFEDIDBLOCK;
-    dataPtr = (blockNum) * SIZEOFEDIDBLOCK;
-
-    // read block
-    if (!EDDCRead(EDID_SEGMENT_POINTER, segNum, EDID_ADDR, offset, SIZEOFEDIDBLOCK, outBuffer)) {
-        DPRINTF("Fail to Read %dth EDID Block\n", blockNum);
+    // read blocks
+    if (!EDDCReadRange(EDID_SEGMENT_POINTER, EDID_ADDR, blockNum * SIZEOFEDIDBLOCK,
+                       numBlocks * SIZEOFEDIDBLOCK, outBuffer)) {
+        DPRINTF("Fail to Read %dth~%dth EDID Block\n", blockNum, blockNum + numBlocks - 1);
         return 0;
     }
 
-    if (!CalcChecksum(outBuffer, SIZEOFEDIDBLOCK)) {
-        DPRINTF("CheckSum fail : %dth EDID Block\n", blockNum);
-        return 0;
+    for (block = 0; block < numBlocks; block++) {
+        if (!CalcChecksum(outBuffer + block * SIZEOFEDIDBLOCK, SIZEOFEDIDBLOCK)) {
+            DPRINTF("CheckSum fail : %dth EDID Block\n", blockNum + block);
+            return 0;
+        }
     }
 
     // print data
@@ -235,12 +277,13 @@ static int ReadEDIDBlock(const unsigned int blockNum, unsigned char* const outBu
             ALOGI(" ");
         else
             ALOGI("\n");
-    } while (SIZEOFEDIDBLOCK > offset);
+    } while (numBlocks * SIZEOFEDIDBLOCK > offset);
 #endif // EDID_DEBUG
     return 1;
 }
 #else
-static int ReadEDIDBlock(const unsigned int blockNum, unsigned char* const outBuffer)
+static int ReadEDIDBlock(const unsigned int blockNum, const unsigned int numBlocks,
+                         unsigned char* const outBuffer)
 {
     int segNum, offset, dataPtr;
 #define MAX_DEV  (2)
@@ -311,12 +354,96 @@ static int ReadEDIDBlock(const unsigned int blockNum, unsigned char* const outBu
         return 0;
     }
 
-    memcpy(outBuffer, EDIDPreset[LS_B2230][blockNum], SIZEOFEDIDBLOCK);
+    for (segNum = 0; segNum < (int)numBlocks; segNum++)
+        memcpy(outBuffer + segNum * SIZEOFEDIDBLOCK, EDIDPreset[LS_B2230][blockNum + segNum], SIZEOFEDIDBLOCK);
     return 1;
 }
 
 #endif
 
+
+#define NUM_OF_VIDEO_PARAMS         (int)(sizeof(aVideoParams)/sizeof(struct edid_params))
+
+//! Detailed Timing Descriptor
+struct edid_dtd {
+    unsigned int hblank;
+    unsigned int hactive;
+    unsigned int vblank;
+    unsigned int vactive;
+    unsigned int interlaced;
+    /** in 10KHz */
+    unsigned int pixelclock;
+};
+
+//! Short Audio Descriptor, as stored in EDID
+struct edid_sad {
+    /** format code, still shifted as in EDID_SAD_CODE_MASK */
+    unsigned char format;
+    /** number of channels - 1 */
+    unsigned char channels;
+    unsigned char freq;
+    unsigned char wordlen;
+};
+
+//! HDMI 3D extra data (2D_VIC_order_X, 3D_Structure_X)
+struct edid_3d_ext {
+    unsigned char vic_order;
+    unsigned char structure;
+};
+
+//! Sink capabilities, parsed once from gEdidData by EDIDParse()
+static struct edid_caps {
+    /** 1 if any extension has a HDMI VSDB */
+    int hdmi;
+
+    /** 640x480p@60Hz in Established Timings */
+    int et640x480;
+
+    /** VICs of the SVDs of timing extensions, one bit per VIC */
+    unsigned int vic[4];
+
+    /** first 16 VICs, in EDID order */
+    unsigned char first_vic[NUM_OF_VIC_FOR_3D];
+    int num_first_vic;
+
+    /** DTDs of block 0 and timing extensions */
+    struct edid_dtd dtd[EDID_MAX_DTD];
+    int num_dtd;
+
+    /** resolution[format][1 if 16:9] : 1 if the sink supports it */
+    unsigned char resolution[NUM_OF_VIDEO_PARAMS][2];
+
+    /** YCbCr444/422 bits of timing extensions */
+    unsigned int color_space;
+
+    /** -1 if there is no extended colorimetry block */
+    int colorimetry;
+    int metadata;
+
+    /** Short Audio Descriptors of timing extensions */
+    struct edid_sad sad[EDID_MAX_SAD];
+    int num_sad;
+
+    /** VSDB of the first timing extension that has one */
+    int vsdb;
+    int cec_addr;
+    /** -1 if the VSDB is too short */
+    int deep_color;
+    /** in 5MHz, 0 if not available */
+    unsigned int max_tmds;
+
+    /** HDMI_Video_present and what follows is available */
+    int hdmi_ext;
+    unsigned char hdmi_vic[EDID_MAX_HDMI_VIC];
+    int num_hdmi_vic;
+    int present_3d;
+    unsigned int multi_present_3d;
+    unsigned int structure_3d;
+    unsigned int mask_3d;
+    struct edid_3d_ext ext_3d[EDID_MAX_3D_EXT];
+    int num_ext_3d;
+} gEdidCaps;
+
 /**
  * Check if EDID data is valid or not.
  *
@@ -347,6 +474,8 @@ static int GetVSDBOffset(const int extension)
     }
 
     DTDOffset = gEdidData[BlockOffset + EDID_DETAILED_TIMING_OFFSET_POS];
+    if (DTDOffset > SIZEOFEDIDBLOCK - 4)
+        DTDOffset = SIZEOFEDIDBLOCK - 4;
 
     // check if there is HDMI VSDB
     while (offset < BlockOffset + DTDOffset) {
@@ -373,28 +502,9 @@ static int GetVSDBOffset(const int extension)
     return 0;
 }
 
-/**
- * Check if Sink supports the HDMI mode.
- * @return  If Sink supports HDMI mode, return 1; Otherwise, return 0.
- */
-static int CheckHDMIMode(void)
-{
-    int i;
-
-    // read EDID
-    if (!EDIDRead())
-        return 0;
-
-    // find VSDB
-    for (i = 1; i <= gExtensions; i++)
-        if (GetVSDBOffset(i) > 0) // if there is a VSDB, it means RX support HDMI mode
-            return 1;
-
-    return 0;
-}
-
 /**
  * Check if EDID extension block is timing extension block or not.
+ * gEdidCaps.hdmi must be already set.
  * @param   extension   [in] The number of EDID extension block to check
  * @return  If the block is timing extension, return 1; Otherwise, return 0.
  */
@@ -412,7 +522,7 @@ static int IsTimingExtension(const int extension)
         if (gEdidData[extension*SIZEOFEDIDBLOCK + EDID_TIMING_EXT_REV_NUMBER_POS] == 3)
             ret = 1;
         // revison num != 3 && DVI mode
-        else if (!CheckHDMIMode() &&
+        else if (!gEdidCaps.hdmi &&
                 gEdidData[extension*SIZEOFEDIDBLOCK + EDID_TIMING_EXT_REV_NUMBER_POS] != 2)
             ret = 1;
     }
@@ -420,193 +530,357 @@ static int IsTimingExtension(const int extension)
 }
 
 /**
- * Check if the video format is contained in - @n
- * Detailed Timing Descriptor(DTD) of EDID extension block.
- * @param   extension   [in]    Number of EDID extension block to check
- * @param   videoFormat [in]    Video format to check
- * @return  If the video format is contained in DTD of EDID extension block, -@n
- *        return 1; Otherwise, return 0.
+ * Parse a Detailed Timing Descriptor(DTD).
+ * @param   data    [in]    Pointer to 18 bytes of DTD
+ * @param   dtd     [out]   Parsed DTD
+ * @return  If the descriptor is a timing, return 1; Otherwise, return 0.
  */
-static int IsContainVideoDTD(const int extension,const enum VideoFormat videoFormat)
+static int ParseDTD(const unsigned char* const data, struct edid_dtd* const dtd)
 {
-    int i, StartOffset, EndOffset;
+    // get pixel clock
+    dtd->pixelclock = (data[EDID_DTD_PIXELCLOCK_POS2] << SIZEOFBYTE);
+    dtd->pixelclock |= data[EDID_DTD_PIXELCLOCK_POS1];
 
-    if (!EDIDValid() || (extension > gExtensions)) {
-        DPRINTF("EDID Data is not available\n");
+    if (!dtd->pixelclock)
         return 0;
-    }
 
-    // if edid block( 0th block )
-    if (extension == 0) {
-        StartOffset = EDID_DTD_START_ADDR;
-        EndOffset = StartOffset + EDID_DTD_TOTAL_LENGTH;
-    } else { // if edid extension block
-        StartOffset = extension*SIZEOFEDIDBLOCK + gEdidData[extension*SIZEOFEDIDBLOCK + EDID_DETAILED_TIMING_OFFSET_POS];
-        EndOffset = (extension+1)*SIZEOFEDIDBLOCK;
-    }
+    // get HBLANK value in pixels
+    dtd->hblank = data[EDID_DTD_HBLANK_POS2] & EDID_DTD_HBLANK_POS2_MASK;
+    dtd->hblank <<= SIZEOFBYTE; // lower 4 bits
+    dtd->hblank |= data[EDID_DTD_HBLANK_POS1];
 
-    // check DTD(Detailed Timing Description)
-    for (i = StartOffset; i < EndOffset; i+= EDID_DTD_BYTE_LENGTH) {
-        unsigned int hblank = 0, hactive = 0, vblank = 0, vactive = 0, interlaced = 0, pixelclock = 0;
-        unsigned int vHActive = 0, vVActive = 0, vVBlank = 0;
+    // get HACTIVE value in pixels
+    dtd->hactive = data[EDID_DTD_HACTIVE_POS2] & EDID_DTD_HACTIVE_POS2_MASK;
+    dtd->hactive <<= (SIZEOFBYTE/2); // upper 4 bits
+    dtd->hactive |= data[EDID_DTD_HACTIVE_POS1];
 
-        // get pixel clock
-        pixelclock = (gEdidData[i+EDID_DTD_PIXELCLOCK_POS2] << SIZEOFBYTE);
-        pixelclock |= gEdidData[i+EDID_DTD_PIXELCLOCK_POS1];
+    // get VBLANK value in pixels
+    dtd->vblank = data[EDID_DTD_VBLANK_POS2] & EDID_DTD_VBLANK_POS2_MASK;
+    dtd->vblank <<= SIZEOFBYTE; // lower 4 bits
+    dtd->vblank |= data[EDID_DTD_VBLANK_POS1];
 
-        if (!pixelclock)
-            continue;
+    // get VACTIVE value in pixels
+    dtd->vactive = data[EDID_DTD_VACTIVE_POS2] & EDID_DTD_VACTIVE_POS2_MASK;
+    dtd->vactive <<= (SIZEOFBYTE/2); // upper 4 bits
+    dtd->vactive |= data[EDID_DTD_VACTIVE_POS1];
 
-        // get HBLANK value in pixels
-        hblank = gEdidData[i+EDID_DTD_HBLANK_POS2] & EDID_DTD_HBLANK_POS2_MASK;
-        hblank <<= SIZEOFBYTE; // lower 4 bits
-        hblank |= gEdidData[i+EDID_DTD_HBLANK_POS1];
-
-        // get HACTIVE value in pixels
-        hactive = gEdidData[i+EDID_DTD_HACTIVE_POS2] & EDID_DTD_HACTIVE_POS2_MASK;
-        hactive <<= (SIZEOFBYTE/2); // upper 4 bits
-        hactive |= gEdidData[i+EDID_DTD_HACTIVE_POS1];
-
-        // get VBLANK value in pixels
-        vblank = gEdidData[i+EDID_DTD_VBLANK_POS2] & EDID_DTD_VBLANK_POS2_MASK;
-        vblank <<= SIZEOFBYTE; // lower 4 bits
-        vblank |= gEdidData[i+EDID_DTD_VBLANK_POS1];
-
-        // get VACTIVE value in pixels
-        vactive = gEdidData[i+EDID_DTD_VACTIVE_POS2] & EDID_DTD_VACTIVE_POS2_MASK;
-        vactive <<= (SIZEOFBYTE/2); // upper 4 bits
-        vactive |= gEdidData[i+EDID_DTD_VACTIVE_POS1];
-
-        vHActive = aVideoParams[videoFormat].HTotal - aVideoParams[videoFormat].HBlank;
-        if (aVideoParams[videoFormat].interlaced == 1) {
-            if (aVideoParams[videoFormat].VIC == v1920x1080i_50Hz_1250) { // VTOP and VBOT are same
-                vVActive = (aVideoParams[videoFormat].VTotal - aVideoParams[videoFormat].VBlank*2)/2;
-                vVBlank = aVideoParams[videoFormat].VBlank;
-            } else {
-                vVActive = (aVideoParams[videoFormat].VTotal - aVideoParams[videoFormat].VBlank*2 - 1)/2;
-                vVBlank = aVideoParams[videoFormat].VBlank;
-            }
-        } else {
-            vVActive = aVideoParams[videoFormat].VTotal - aVideoParams[videoFormat].VBlank;
-            vVBlank = aVideoParams[videoFormat].VBlank;
-        }
+    // get Interlaced Mode Value
+    dtd->interlaced = (data[EDID_DTD_INTERLACE_POS] & EDID_DTD_INTERLACE_MASK) ? 1 : 0;
 
-        // get Interlaced Mode Value
-        interlaced = (int)(gEdidData[i+EDID_DTD_INTERLACE_POS] & EDID_DTD_INTERLACE_MASK);
-        if (interlaced)
-            interlaced = 1;
+    DPRINTF("EDID: hblank = %d,vblank = %d, hactive = %d, vactive = %d\n"
+                        ,dtd->hblank,dtd->vblank,dtd->hactive,dtd->vactive);
+    return 1;
+}
 
-        DPRINTF("EDID: hblank = %d,vblank = %d, hactive = %d, vactive = %d\n"
-                            ,hblank,vblank,hactive,vactive);
-        DPRINTF("REQ: hblank = %d,vblank = %d, hactive = %d, vactive = %d\n"
-                            ,aVideoParams[videoFormat].HBlank
-                            ,vVBlank,vHActive,vVActive);
+/**
+ * Check if a DTD describes the video format.
+ * @param   dtd         [in]    DTD to check
+ * @param   videoFormat [in]    Video format to check
+ * @return  If the DTD matches the video format, return 1; Otherwise, return 0.
+ */
+static int IsDTDVideoFormat(const struct edid_dtd* const dtd, const int videoFormat)
+{
+    const struct edid_params* const param = &aVideoParams[videoFormat];
+    unsigned int vHActive, vVActive, vVBlank;
 
-        if (hblank == aVideoParams[videoFormat].HBlank && vblank == vVBlank // blank
-            && hactive == vHActive && vactive == vVActive) { //line
-            unsigned int EDIDpixelclock = aVideoParams[videoFormat].PixelClock;
-            EDIDpixelclock /= 100; pixelclock /= 100;
+    vHActive = param->HTotal - param->HBlank;
+    if (param->interlaced == 1) {
+        if (videoFormat == v1920x1080i_50Hz_1250) // VTOP and VBOT are same
+            vVActive = (param->VTotal - param->VBlank*2)/2;
+        else
+            vVActive = (param->VTotal - param->VBlank*2 - 1)/2;
+    } else {
+        vVActive = param->VTotal - param->VBlank;
+    }
+    vVBlank = param->VBlank;
 
-            if (pixelclock == EDIDpixelclock) {
-                DPRINTF("Sink Support the Video mode\n");
-                return 1;
-            }
-        }
+    if (dtd->hblank == param->HBlank && dtd->vblank == vVBlank // blank
+        && dtd->hactive == vHActive && dtd->vactive == vVActive) { //line
+        unsigned int EDIDpixelclock = param->PixelClock;
+        EDIDpixelclock /= 100;
+
+        if (dtd->pixelclock/100 == EDIDpixelclock)
+            return 1;
     }
     return 0;
 }
 
 /**
- * Check if a VIC(Video Identification Code) is contained in -@n
- * EDID extension block.
- * @param   extension   [in]    Number of EDID extension block to check
- * @param   VIC      [in]   VIC to check
- * @return  If the VIC is contained in contained in EDID extension block, -@n
- *        return 1; Otherwise, return 0.
+ * Store DTDs in EDID block.
+ * @param   StartAddr   [in]    Offset of the first DTD in gEdidData
+ * @param   EndAddr     [in]    Offset where DTDs of the block end
+ */
+static void ParseDTDs(unsigned int StartAddr, const unsigned int EndAddr)
+{
+    for (; StartAddr + EDID_DTD_BYTE_LENGTH <= EndAddr; StartAddr += EDID_DTD_BYTE_LENGTH) {
+        if (gEdidCaps.num_dtd == EDID_MAX_DTD)
+            return;
+        if (ParseDTD(gEdidData + StartAddr, &gEdidCaps.dtd[gEdidCaps.num_dtd]))
+            gEdidCaps.num_dtd++;
+    }
+}
+
+/**
+ * Parse HDMI VSDB of EDID extension block.
+ * @param   StartAddr   [in]    Offset of the VSDB in gEdidData
+ */
+static void ParseVSDB(unsigned int StartAddr)
+{
+    unsigned int blockLength = gEdidData[StartAddr] & EDID_DATA_BLOCK_SIZE_MASK;
+    unsigned int EndAddr = StartAddr + blockLength + 1;
+    unsigned int latency_offset, HDMIVICLen, HDMI3DLen, addr, i;
+
+    DPRINTF("VSDB Block length[0x%x] = 0x%x\r\n",StartAddr,blockLength);
+
+    gEdidCaps.vsdb = 1;
+    gEdidCaps.cec_addr = gEdidData[StartAddr + EDID_CEC_PHYICAL_ADDR] << 8;
+    gEdidCaps.cec_addr |= gEdidData[StartAddr + EDID_CEC_PHYICAL_ADDR+1];
+
+    if (blockLength >= EDID_DC_POS)
+        gEdidCaps.deep_color = gEdidData[StartAddr + EDID_DC_POS] & EDID_DC_MASK;
+    if (blockLength >= EDID_MAX_TMDS_POS)
+        gEdidCaps.max_tmds = gEdidData[StartAddr + EDID_MAX_TMDS_POS];
+
+    // data related to 3D format is not available
+    if (blockLength < EDID_HDMI_EXT_POS)
+        return;
+    gEdidCaps.hdmi_ext = 1;
+
+    // check if latency field is available
+    latency_offset = (gEdidData[StartAddr + EDID_HDMI_EXT_POS]
+                                                & EDID_HDMI_LATENCY_MASK) >> EDID_HDMI_LATENCY_POS;
+    if (latency_offset == 0)
+        latency_offset = 4;
+    else if (latency_offset == 3)
+        latency_offset = 0;
+    else
+        latency_offset = 2;
+
+    StartAddr -= latency_offset;
+
+    // check 3D_Present bit
+    if (blockLength >= (EDID_HDMI_3D_PRESENT_POS - latency_offset)) {
+        gEdidCaps.present_3d = gEdidData[StartAddr + EDID_HDMI_3D_PRESENT_POS]
+                        & EDID_HDMI_3D_PRESENT_MASK;
+        gEdidCaps.multi_present_3d = gEdidData[StartAddr + EDID_HDMI_3D_PRESENT_POS]
+                        & EDID_HDMI_3D_MULTI_PRESENT_MASK;
+    }
+
+    // check block length if HDMI_VIC or HDMI Multi available
+    if (blockLength < (EDID_HDMI_EXT_LENGTH_POS - latency_offset))
+        return;
+
+    // HDMI_VIC_LEN, HDMI_3D_LEN
+    HDMIVICLen = (gEdidData[StartAddr + EDID_HDMI_EXT_LENGTH_POS]
+            & EDID_HDMI_VSDB_VIC_LEN_MASK) >> EDID_HDMI_VSDB_VIC_LEN_BIT;
+    HDMI3DLen = gEdidData[StartAddr + EDID_HDMI_EXT_LENGTH_POS]
+                & EDID_HDMI_VSDB_3D_LEN_MASK;
+
+    DPRINTF("HDMI VIC LENGTH = %x, HDMI 3D LENGTH = %x\r\n", HDMIVICLen, HDMI3DLen);
+
+    // HDMI_VIC
+    addr = StartAddr + EDID_HDMI_EXT_LENGTH_POS + 1;
+    for (i = 0; i < HDMIVICLen && addr < EndAddr; i++, addr++)
+        gEdidCaps.hdmi_vic[gEdidCaps.num_hdmi_vic++] = gEdidData[addr];
+
+    // 3D_Structure_ALL and 3D_MASK
+    if (HDMI3DLen > (unsigned int)(EndAddr - addr))
+        HDMI3DLen = EndAddr - addr;
+    EndAddr = addr + HDMI3DLen;
+
+    if (gEdidCaps.multi_present_3d == EDID_3D_STRUCTURE_ONLY_EXIST ||
+        gEdidCaps.multi_present_3d == EDID_3D_STRUCTURE_MASK_EXIST) {
+        if (addr + 2 > EndAddr)
+            return;
+        gEdidCaps.structure_3d = (gEdidData[addr] << 8) | gEdidData[addr + 1];
+        gEdidCaps.mask_3d = 0xFFFF;
+        addr += 2;
+        DPRINTF("VSDB 3D Structure!!! = [0x%02x]\r\n",gEdidCaps.structure_3d);
+    }
+
+    if (gEdidCaps.multi_present_3d == EDID_3D_STRUCTURE_MASK_EXIST) {
+        if (addr + 2 > EndAddr)
+            return;
+        gEdidCaps.mask_3d = (gEdidData[addr] << 8) | gEdidData[addr + 1];
+        addr += 2;
+        DPRINTF("VSDB 3D Mask!!! = [0x%02x]\r\n",gEdidCaps.mask_3d);
+    }
+
+    // 2D_VIC_order_X and 3D_Structure_X, 3D_Detail_X follows for Side-by-Side(Half)
+    //TODO: check 3D_Detail in case of SSH
+    while (addr < EndAddr && gEdidCaps.num_ext_3d < EDID_MAX_3D_EXT) {
+        struct edid_3d_ext* const ext = &gEdidCaps.ext_3d[gEdidCaps.num_ext_3d++];
+
+        ext->vic_order = (gEdidData[addr] & EDID_HDMI_2D_VIC_ORDER_MASK) >> 4;
+        ext->structure = gEdidData[addr] & EDID_HDMI_3D_STRUCTURE_MASK;
+        addr += (ext->structure >= EDID_3D_STRUCTURE_SSH) ? 2 : 1;
+    }
+}
+
+/**
+ * Parse data blocks and DTDs of EDID timing extension block.
+ * @param   extension   [in]    Number of EDID extension block to parse
  */
-static int IsContainVIC(const int extension, const int VIC)
+static void ParseTimingExtension(const int extension)
 {
     unsigned int StartAddr = extension*SIZEOFEDIDBLOCK;
     unsigned int ExtAddr = StartAddr + EDID_DATA_BLOCK_START_POS;
-    unsigned int tag,blockLen;
     unsigned int DTDStartAddr = gEdidData[StartAddr + EDID_DETAILED_TIMING_OFFSET_POS];
+    unsigned int EndAddr, tag, blockLen, i;
 
-    if (!EDIDValid() || (extension > gExtensions)) {
-        DPRINTF("EDID Data is not available\n");
-        return 0;
-    }
+    // read Color Space
+    gEdidCaps.color_space |= gEdidData[StartAddr + EDID_COLOR_SPACE_POS];
+
+    if (DTDStartAddr < EDID_DATA_BLOCK_START_POS || DTDStartAddr > SIZEOFEDIDBLOCK - 1)
+        return;
 
-    // while
-    while (ExtAddr < StartAddr + DTDStartAddr) {
+    EndAddr = StartAddr + DTDStartAddr;
+    while (ExtAddr < EndAddr) {
         // find the block tag and length
         // tag
         tag = gEdidData[ExtAddr] & EDID_TAG_CODE_MASK;
         // block len
         blockLen = (gEdidData[ExtAddr] & EDID_DATA_BLOCK_SIZE_MASK) + 1;
+        if (ExtAddr + blockLen > EndAddr)
+            break;
+
         DPRINTF("tag = %d\n",tag);
         DPRINTF("blockLen = %d\n",blockLen-1);
 
-        // check if it is short video description
-        if (tag == EDID_SHORT_VID_DEC_TAG_VAL) {
-            // if so, check SVD
-            unsigned int i;
+        switch (tag) {
+        case EDID_SHORT_VID_DEC_TAG_VAL:
             for (i = 1; i < blockLen; i++) {
-                DPRINTF("EDIDVIC = %d\n",gEdidData[ExtAddr+i] & EDID_SVD_VIC_MASK);
-                DPRINTF("VIC = %d\n",VIC);
+                unsigned int vic = gEdidData[ExtAddr+i] & EDID_SVD_VIC_MASK;
 
-                // check VIC with SVDB
-                if (VIC == (gEdidData[ExtAddr+i] & EDID_SVD_VIC_MASK)) {
-                    DPRINTF("Sink Device supports requested video mode\n");
-                    return 1;
-                }
+                DPRINTF("EDIDVIC = %d\n",vic);
+                gEdidCaps.vic[vic / 32] |= 1U << (vic % 32);
+                if (gEdidCaps.num_first_vic < NUM_OF_VIC_FOR_3D)
+                    gEdidCaps.first_vic[gEdidCaps.num_first_vic++] = vic;
             }
+            break;
+        case EDID_SHORT_AUD_DEC_TAG_VAL:
+            for (i = 1; i + 2 < blockLen && gEdidCaps.num_sad < EDID_MAX_SAD; i += 3) {
+                struct edid_sad* const sad = &gEdidCaps.sad[gEdidCaps.num_sad++];
+
+                sad->format = gEdidData[ExtAddr+i] & EDID_SAD_CODE_MASK;
+                sad->channels = gEdidData[ExtAddr+i] & EDID_SAD_CHANNEL_MASK;
+                sad->freq = gEdidData[ExtAddr+i+1];
+                sad->wordlen = gEdidData[ExtAddr+i+2];
+            }
+            break;
+        case EDID_EXTENDED_TAG_VAL:
+            // check if it is colorimetry block
+            if (gEdidCaps.colorimetry < 0 &&
+                gEdidData[ExtAddr+1] == EDID_EXTENDED_COLORIMETRY_VAL && // colorimetry block
+                (blockLen-1) == EDID_EXTENDED_COLORIMETRY_BLOCK_LEN) { // check length
+                gEdidCaps.colorimetry = gEdidData[ExtAddr + 2];
+                gEdidCaps.metadata = gEdidData[ExtAddr + 3];
+
+                DPRINTF("EDID extened colorimetry = %x\n",gEdidCaps.colorimetry);
+                DPRINTF("EDID gamut metadata profile = %x\n",gEdidCaps.metadata);
+            }
+            break;
+        default:
+            break;
         }
         // else find next block
         ExtAddr += blockLen;
     }
 
-    return 0;
+    // check DTD(Detailed Timing Description)
+    ParseDTDs(EndAddr, (extension+1)*SIZEOFEDIDBLOCK - 1);
 }
 
 /**
- * Check if EDID contains the video format.
- * @param   videoFormat [in]    Video format to check
- * @param   pixelRatio  [in]    Pixel aspect ratio of video format to check
- * @return  if EDID contains the video format, return 1; Otherwise, return 0.
+ * Parse EDID data into gEdidCaps.
+ * Every query afterwards looks only at gEdidCaps.
  */
-static int CheckResolution(const enum VideoFormat videoFormat,
-                            const enum PixelAspectRatio pixelRatio)
+static void EDIDParse(void)
 {
-    int i, vic;
+    int i, fmt;
 
-    // read EDID
-    if (!EDIDRead())
-        return 0;
+    memset(&gEdidCaps, 0, sizeof(gEdidCaps));
+    gEdidCaps.colorimetry = -1;
+    gEdidCaps.deep_color = -1;
 
     // check ET(Established Timings) for 640x480p@60Hz
-    if (videoFormat == v640x480p_60Hz // if it's 640x480p@60Hz
-        && (gEdidData[EDID_ET_POS] & EDID_ET_640x480p_VAL)) // it support
-         return 1;
+    gEdidCaps.et640x480 = (gEdidData[EDID_ET_POS] & EDID_ET_640x480p_VAL) ? 1 : 0;
 
     // check STI(Standard Timing Identification)
     // do not need
 
     // check DTD(Detailed Timing Description) of EDID block(0th)
-    if (IsContainVideoDTD(0,videoFormat))
-        return 1;
+    ParseDTDs(EDID_DTD_START_ADDR, EDID_DTD_START_ADDR + EDID_DTD_TOTAL_LENGTH);
 
-    // check EDID Extension
-    vic = (pixelRatio == HDMI_PIXEL_RATIO_16_9) ?
-            aVideoParams[videoFormat].VIC16_9 : aVideoParams[videoFormat].VIC;
+    // if there is a VSDB, it means RX support HDMI mode
+    for (i = 1; i <= gExtensions && !gEdidCaps.hdmi; i++)
+        if (GetVSDBOffset(i) > 0)
+            gEdidCaps.hdmi = 1;
 
-    // find VSDB
     for (i = 1; i <= gExtensions; i++) {
-        if (IsTimingExtension(i)) // if it's timing block
-            if (IsContainVIC(i, vic) || IsContainVideoDTD(i, videoFormat))
-                return 1;
+        unsigned int StartAddr;
+
+        if (!IsTimingExtension(i))
+            continue;
+
+        ParseTimingExtension(i);
+
+        // the VSDB has to end inside its block
+        if (!gEdidCaps.vsdb && (StartAddr = GetVSDBOffset(i)) > 0 &&
+            StartAddr + (gEdidData[StartAddr] & EDID_DATA_BLOCK_SIZE_MASK) < (unsigned int)((i+1)*SIZEOFEDIDBLOCK - 1))
+            ParseVSDB(StartAddr);
     }
 
-    return 0;
+    // check resolutions of every video format once
+    for (fmt = 0; fmt < NUM_OF_VIDEO_PARAMS; fmt++) {
+        int supported = (fmt == v640x480p_60Hz && gEdidCaps.et640x480);
+        unsigned int vic;
+
+        for (i = 0; i < gEdidCaps.num_dtd && !supported; i++)
+            supported = IsDTDVideoFormat(&gEdidCaps.dtd[i], fmt);
+
+        vic = aVideoParams[fmt].VIC;
+        gEdidCaps.resolution[fmt][0] = supported ||
+                (gEdidCaps.vic[vic / 32] & (1U << (vic % 32)));
+        vic = aVideoParams[fmt].VIC16_9;
+        gEdidCaps.resolution[fmt][1] = supported ||
+                (gEdidCaps.vic[vic / 32] & (1U << (vic % 32)));
+    }
+
+    DPRINTF("EDID: hdmi = %d, %d DTDs, %d SADs, max TMDS = %d\n",
+            gEdidCaps.hdmi, gEdidCaps.num_dtd, gEdidCaps.num_sad, gEdidCaps.max_tmds*5);
+}
+
+/**
+ * Check if Sink supports the HDMI mode.
+ * @return  If Sink supports HDMI mode, return 1; Otherwise, return 0.
+ */
+static int CheckHDMIMode(void)
+{
+    // read EDID
+    if (!EDIDRead())
+        return 0;
+
+    return gEdidCaps.hdmi;
+}
+
+/**
+ * Check if EDID contains the video format.
+ * @param   videoFormat [in]    Video format to check
+ * @param   pixelRatio  [in]    Pixel aspect ratio of video format to check
+ * @return  if EDID contains the video format, return 1; Otherwise, return 0.
+ */
+static int CheckResolution(const enum VideoFormat videoFormat,
+                            const enum PixelAspectRatio pixelRatio)
+{
+    // read EDID
+    if (!EDIDRead())
+        return 0;
+
+    if (videoFormat < 0 || videoFormat >= NUM_OF_VIDEO_PARAMS)
+        return 0;
+
+    return gEdidCaps.resolution[videoFormat][pixelRatio == HDMI_PIXEL_RATIO_16_9];
 }
 
 /**
@@ -617,8 +891,7 @@ static int CheckResolution(const enum VideoFormat videoFormat,
  */
 static int CheckColorDepth(const enum ColorDepth depth,const enum ColorSpace space)
 {
-    int i;
-    unsigned int StartAddr;
+    int deepColor;
 
     // if color depth == 24 bit, no need to check
     if (depth == HDMI_CD_24)
@@ -629,45 +902,30 @@ static int CheckColorDepth(const enum ColorDepth depth,const enum ColorSpace spa
     if (!EDIDRead())
         return 0;
 
-    // find VSDB
-    for (i = 1; i <= gExtensions; i++) {
-        if (IsTimingExtension(i) // if it's timing block
-            && ((StartAddr = GetVSDBOffset(i)) > 0)) { // check block
-            int blockLength = gEdidData[StartAddr] & EDID_DATA_BLOCK_SIZE_MASK;
-            if (blockLength >= EDID_DC_POS) {
-                // get supported DC value
-                int deepColor = gEdidData[StartAddr + EDID_DC_POS] & EDID_DC_MASK;
-                DPRINTF("EDID deepColor = %x\n",deepColor);
-                // check supported DeepColor
-                // if YCBCR444
-                if (space == HDMI_CS_YCBCR444) {
-                    if ( !(deepColor & EDID_DC_YCBCR_VAL))
-                        return 0;
-                }
+    // get supported DC value
+    deepColor = gEdidCaps.deep_color;
+    if (deepColor < 0)
+        return 0;
 
-                // check colorDepth
-                switch (depth) {
-                case HDMI_CD_36:
-                    deepColor &= EDID_DC_36_VAL;
-                    break;
-                case HDMI_CD_30:
-                    deepColor &= EDID_DC_30_VAL;
-                    break;
-                case HDMI_CD_24:
-                    deepColor = 1;
-                    break;
-                default :
-                    deepColor = 0;
-                }
-                if (deepColor)
-                    return 1;
-                else
-                    return 0;
-            }
-        }
+    // check supported DeepColor
+    // if YCBCR444
+    if (space == HDMI_CS_YCBCR444) {
+        if ( !(deepColor & EDID_DC_YCBCR_VAL))
+            return 0;
     }
 
-    return 0;
+    // check colorDepth
+    switch (depth) {
+    case HDMI_CD_36:
+        deepColor &= EDID_DC_36_VAL;
+        break;
+    case HDMI_CD_30:
+        deepColor &= EDID_DC_30_VAL;
+        break;
+    default :
+        deepColor = 0;
+    }
+    return deepColor ? 1 : 0;
 }
 
 /**
@@ -677,8 +935,6 @@ static int CheckColorDepth(const enum ColorDepth depth,const enum ColorSpace spa
  */
 static int CheckColorSpace(const enum ColorSpace space)
 {
-    int i;
-
     // RGB is default
     if (space == HDMI_CS_RGB)
         return 1;
@@ -688,17 +944,10 @@ static int CheckColorSpace(const enum ColorSpace space)
     if (!EDIDRead())
         return 0;
 
-    // find VSDB
-    for (i = 1; i <= gExtensions; i++) {
-        if (IsTimingExtension(i)) { // if it's timing block
-            // read Color Space
-            int CS = gEdidData[i*SIZEOFEDIDBLOCK + EDID_COLOR_SPACE_POS];
+    if ((space == HDMI_CS_YCBCR444 && (gEdidCaps.color_space & EDID_YCBCR444_CS_MASK)) || // YCBCR444
+            (space == HDMI_CS_YCBCR422 && (gEdidCaps.color_space & EDID_YCBCR422_CS_MASK))) // YCBCR422
+        return 1;
 
-            if ((space == HDMI_CS_YCBCR444 && (CS & EDID_YCBCR444_CS_MASK)) || // YCBCR444
-                    (space == HDMI_CS_YCBCR422 && (CS & EDID_YCBCR422_CS_MASK))) // YCBCR422
-                return 1;
-        }
-    }
     return 0;
 }
 
@@ -709,8 +958,6 @@ static int CheckColorSpace(const enum ColorSpace space)
  */
 static int CheckColorimetry(const enum HDMIColorimetry color)
 {
-    int i;
-
     // do not need to parse if not extended colorimetry
     if (color == HDMI_COLORIMETRY_NO_DATA ||
             color == HDMI_COLORIMETRY_ITU601 ||
@@ -721,292 +968,243 @@ static int CheckColorimetry(const enum HDMIColorimetry color)
     if (!EDIDRead())
        return 0;
 
-    // find VSDB
-    for (i = 1; i <= gExtensions; i++) {
-        if (IsTimingExtension(i)) { // if it's timing block
-            // check address
-            unsigned int ExtAddr = i*SIZEOFEDIDBLOCK + EDID_DATA_BLOCK_START_POS;
-            unsigned int EndAddr = i*SIZEOFEDIDBLOCK + gEdidData[i*SIZEOFEDIDBLOCK + EDID_DETAILED_TIMING_OFFSET_POS];
-            unsigned int tag,blockLen;
-
-            while (ExtAddr < EndAddr) {
-                // find the block tag and length
-                // tag
-                tag = gEdidData[ExtAddr] & EDID_TAG_CODE_MASK;
-                // block len
-                blockLen = (gEdidData[ExtAddr] & EDID_DATA_BLOCK_SIZE_MASK) + 1;
-
-                // check if it is colorimetry block
-                if (tag == EDID_EXTENDED_TAG_VAL && // extended tag
-                    gEdidData[ExtAddr+1] == EDID_EXTENDED_COLORIMETRY_VAL && // colorimetry block
-                    (blockLen-1) == EDID_EXTENDED_COLORIMETRY_BLOCK_LEN) { // check length
-                    // get supported DC value
-                    int colorimetry = (gEdidData[ExtAddr + 2]);
-                    int metadata = (gEdidData[ExtAddr + 3]);
-
-                    DPRINTF("EDID extened colorimetry = %x\n",colorimetry);
-                    DPRINTF("EDID gamut metadata profile = %x\n",metadata);
-
-                    // check colorDepth
-                    switch (color) {
-                    case HDMI_COLORIMETRY_EXTENDED_xvYCC601:
-                        if (colorimetry & EDID_XVYCC601_MASK && metadata)
-                            return 1;
-                        break;
-                    case HDMI_COLORIMETRY_EXTENDED_xvYCC709:
-                        if (colorimetry & EDID_XVYCC709_MASK && metadata)
-                            return 1;
-                        break;
-                    default:
-                        break;
-                    }
-                    return 0;
-                }
-                // else find next block
-                ExtAddr += blockLen;
-            }
-        }
+    if (gEdidCaps.colorimetry < 0)
+        return 0;
+
+    switch (color) {
+    case HDMI_COLORIMETRY_EXTENDED_xvYCC601:
+        if (gEdidCaps.colorimetry & EDID_XVYCC601_MASK && gEdidCaps.metadata)
+            return 1;
+        break;
+    case HDMI_COLORIMETRY_EXTENDED_xvYCC709:
+        if (gEdidCaps.colorimetry & EDID_XVYCC709_MASK && gEdidCaps.metadata)
+            return 1;
+        break;
+    default:
+        break;
     }
 
     return 0;
 }
 
 /**
- * Get Max TMDS clock that HDMI Rx can receive.
- * @return  If available, return MaxTMDS clock; Otherwise, return 0.
+ * Check if Rx supports requested 3D format.
+ * @param   pVideo [in]   HDMI Video Parameter
+ * @return  If Rx supports requested 3D format, return 1; Otherwise, return 0.
  */
-static unsigned int GetMaxTMDS(void)
+static int EDID3DFormatSupport(const struct HDMIVideoParameter * const pVideo)
 {
+    unsigned int vic;
     int i;
-    unsigned int StartAddr;
 
-    // find VSDB
-    for (i = 1; i <= gExtensions; i++) {
-        if (IsTimingExtension(i) // if it's timing block
-            && ((StartAddr = GetVSDBOffset(i)) > 0)) { // check block
-            int blockLength = gEdidData[StartAddr] & EDID_DATA_BLOCK_SIZE_MASK;
-            if (blockLength >= EDID_MAX_TMDS_POS) {
-                // get supported DC value
-                return gEdidData[StartAddr + EDID_MAX_TMDS_POS];
+    // if format == 2D, no need to check
+    if (pVideo->hdmi_3d_format == HDMI_2D_VIDEO_FORMAT)
+        return 1;
+
+    // check EDID data is valid or not
+    if (!EDIDRead())
+        return 0;
+
+    // data related to 3D format is not available
+    if (!gEdidCaps.hdmi_ext)
+        return 0;
+
+    vic = (pVideo->pixelAspectRatio == HDMI_PIXEL_RATIO_16_9) ?
+            aVideoParams[pVideo->resolution].VIC16_9 : aVideoParams[pVideo->resolution].VIC;
+
+    if (pVideo->hdmi_3d_format == HDMI_VIC_FORMAT) {
+        for (i = 0; i < gEdidCaps.num_hdmi_vic; i++) {
+            if (vic == gEdidCaps.hdmi_vic[i])
+                return 1;
+        }
+        return 0;
+    }
+
+    if (gEdidCaps.present_3d) {
+        DPRINTF("VSDB 3D Present!!!\r\n");
+        // check with 3D madatory format
+        if (CheckResolution(pVideo->resolution, pVideo->pixelAspectRatio)) {
+            int size = sizeof(edid_3d)/sizeof(struct edid_3d_mandatory);
+            for (i = 0; i < size; i++) {
+                if (edid_3d[i].resolution == pVideo->resolution &&
+                    edid_3d[i].hdmi_3d_format == pVideo->hdmi_3d_format )
+                    return 1;
+            }
+        }
+    }
+
+    // check 3D Structure and Mask against first 16 VIC
+    if (gEdidCaps.structure_3d & (1<<pVideo->hdmi_3d_format)) {
+        DPRINTF("VSDB 3D Structure Contains Current Video Structure!!!\r\n");
+        for (i = 0; i < gEdidCaps.num_first_vic; i++) {
+            if ((gEdidCaps.mask_3d & (1<<i)) && vic == gEdidCaps.first_vic[i]) {
+                DPRINTF("VSDB 3D Mask Contains Current Video format!!!\r\n");
+                return 1;
             }
         }
     }
 
+    // check HDMI 3D Extra Data
+    for (i = 0; i < gEdidCaps.num_ext_3d; i++) {
+        const struct edid_3d_ext* const ext = &gEdidCaps.ext_3d[i];
+
+        if (ext->structure == (unsigned int)pVideo->hdmi_3d_format &&
+            ext->vic_order < gEdidCaps.num_first_vic &&
+            vic == gEdidCaps.first_vic[ext->vic_order])
+            return 1;
+    }
+
     return 0;
 }
 
 /**
- * Save first 16 VIC of EDID
+ * Log the first failure to use the EDID cache. A missing or read-only
+ * EDID_CACHE_DIR fails on every hotplug, so later failures are not logged.
+ * @param   what    [in]    operation that failed
+ * @param   path    [in]    file or directory of the operation
+ * @param   err     [in]    errno of the failure
  */
-static void SaveVIC(void)
+static void LogEDIDCacheError(const char* what, const char* path, int err)
 {
-    int extension;
-    int vic_count = 0;
-    for (extension = 1; extension <= gExtensions && vic_count < NUM_OF_VIC_FOR_3D; extension++) {
-        unsigned int StartAddr = extension*SIZEOFEDIDBLOCK;
-        unsigned int ExtAddr = StartAddr + EDID_DATA_BLOCK_START_POS;
-        unsigned int tag,blockLen;
-        unsigned int DTDStartAddr = gEdidData[StartAddr + EDID_DETAILED_TIMING_OFFSET_POS];
-
-        while (ExtAddr < StartAddr + DTDStartAddr) {
-            // find the block tag and length
-            // tag
-            tag = gEdidData[ExtAddr] & EDID_TAG_CODE_MASK;
-            // block len
-            blockLen = (gEdidData[ExtAddr] & EDID_DATA_BLOCK_SIZE_MASK) + 1;
-
-            // check if it is short video description
-            if (tag == EDID_SHORT_VID_DEC_TAG_VAL) {
-                // if so, check SVD
-                unsigned int edid_index;
-                for (edid_index = 1; edid_index < blockLen && vic_count < NUM_OF_VIC_FOR_3D; edid_index++) {
-                    DPRINTF("EDIDVIC = %d\r\n", gEdidData[ExtAddr+edid_index] & EDID_SVD_VIC_MASK);
-
-                    // check VIC with SVDB
-                    aVIC[vic_count++] = (gEdidData[ExtAddr+edid_index] & EDID_SVD_VIC_MASK);
-                }
-            }
-            // else find next block
-            ExtAddr += blockLen;
+    if (gCacheErrorLogged)
+        return;
+
+    gCacheErrorLogged = 1;
+    ALOGE("EDID cache disabled: cannot %s %s (%s)\n", what, path, strerror(err));
+}
+
+/**
+ * Compare the CEC physical address of every HDMI VSDB in gEdidData with the sink.
+ * The address depends on the port the sink is plugged in, and only
+ * the extension holding it changes, so block 0 does not tell it apart.
+ * @return  If every address matches the sink, return 1; Otherwise, return 0.
+ */
+static int CheckVSDBPhysicalAddress(void)
+{
+    unsigned char addr[2];
+    int i, offset;
+
+    for (i = 1; i <= gExtensions; i++) {
+        if ((offset = GetVSDBOffset(i)) <= 0)
+            continue;
+
+        offset += EDID_CEC_PHYICAL_ADDR;
+        if (!EDDCReadRange(EDID_SEGMENT_POINTER, EDID_ADDR, offset, sizeof(addr), addr)) {
+            DPRINTF("Fail to Read CEC physical address of %dth EDID Block\n", i);
+            return 0;
         }
+        if (memcmp(addr, gEdidData + offset, sizeof(addr)) != 0)
+            return 0;
     }
+
+    return 1;
 }
 
 /**
- * Check if Rx supports requested 3D format.
- * @param   pVideo [in]   HDMI Video Parameter
- * @return  If Rx supports requested 3D format, return 1; Otherwise, return 0.
+ * Look up the cache file of the sink described by EDID block 0.
+ * The file is named after manufacturer ID, product code and serial number.
+ * On a hit, EDID extensions are copied to gEdidData. A cache of the same
+ * sink on another port is a miss.
+ * @param   block0  [in]    EDID block 0, checksum already verified
+ * @return  If cached EDID extensions are available, return 1; Otherwise, return 0.
  */
-static int EDID3DFormatSupport(const struct HDMIVideoParameter * const pVideo)
+static int LoadEDIDCache(const unsigned char* const block0)
 {
-    int edid_index;
-    unsigned int StartAddr;
-    unsigned int vic;
-    vic = (pVideo->pixelAspectRatio == HDMI_PIXEL_RATIO_16_9) ?
-            aVideoParams[pVideo->resolution].VIC16_9 : aVideoParams[pVideo->resolution].VIC;
+    struct edid_cache_header header;
+    unsigned char cached[SIZEOFEDIDBLOCK];
+    int fd, block, ret = 0;
+    size_t size;
+
+    memset(&gCache, 0, sizeof(gCache));
+    snprintf(gCachePath, sizeof(gCachePath), "%s/%02x%02x%02x%02x%02x%02x%02x%02x", EDID_CACHE_DIR,
+             block0[8], block0[9], block0[10], block0[11],
+             block0[12], block0[13], block0[14], block0[15]);
+
+    fd = open(gCachePath, O_RDONLY);
+    if (fd < 0) {
+        if (errno != ENOENT)
+            LogEDIDCacheError("open", gCachePath, errno);
+        DPRINTF("no EDID cache %s\n", gCachePath);
+        return 0;
+    }
 
-    // if format == 2D, no need to check
-    if (pVideo->hdmi_3d_format == HDMI_2D_VIDEO_FORMAT)
-        return 1;
+    // block 0 has to be same, byte by byte
+    if (read(fd, &header, sizeof(header)) != sizeof(header) ||
+        header.magic != EDID_CACHE_MAGIC ||
+        header.extensions != (unsigned int)gExtensions ||
+        read(fd, cached, SIZEOFEDIDBLOCK) != SIZEOFEDIDBLOCK ||
+        memcmp(cached, block0, SIZEOFEDIDBLOCK) != 0) {
+        DPRINTF("stale EDID cache %s\n", gCachePath);
+        goto done;
+    }
 
-    // check EDID data is valid or not
-    if (!EDIDRead())
-        return 0;
+    size = gExtensions*SIZEOFEDIDBLOCK;
+    if (read(fd, gEdidData + SIZEOFEDIDBLOCK, size) != (ssize_t)size)
+        goto done;
 
-    // save first 16 VIC to check
-    SaveVIC();
-
-    // find VSDB
-    for (edid_index = 1; edid_index <= gExtensions; edid_index++) {
-        if (IsTimingExtension(edid_index) // if it's timing block
-            && ((StartAddr = GetVSDBOffset(edid_index)) > 0)) { // check block
-            unsigned int blockLength = gEdidData[StartAddr] & EDID_DATA_BLOCK_SIZE_MASK;
-            unsigned int VSDBHdmiVideoPre = 0;
-            unsigned int VSDB3DPresent = 0;
-            unsigned int VSDB3DMultiPresent = 0;
-            unsigned int HDMIVICLen;
-            unsigned int HDMI3DLen;
-            int Hdmi3DStructure = 0;
-            unsigned int Hdmi3DMask = 0xFFFF;
-            unsigned int latency_offset = 0;
-
-            DPRINTF("VSDB Block length[0x%x] = 0x%x\r\n",StartAddr,blockLength);
-
-            // get HDMI Video Present  value
-            if (blockLength >= EDID_HDMI_EXT_POS) {
-                VSDBHdmiVideoPre = gEdidData[StartAddr + EDID_HDMI_EXT_POS]
-                            & EDID_HDMI_VIDEO_PRESENT_MASK;
-                DPRINTF("EDID HDMI Video Present = 0x%x\n",VSDBHdmiVideoPre);
-            } else { // data related to 3D format is not available
-                return 0;
-            }
+    for (block = 1; block <= gExtensions; block++) {
+        if (!CalcChecksum(gEdidData + block*SIZEOFEDIDBLOCK, SIZEOFEDIDBLOCK)) {
+            DPRINTF("CheckSum fail : %dth cached EDID Block\n", block);
+            goto done;
+        }
+    }
 
-            // check if latency field is available
-            latency_offset = (gEdidData[StartAddr + EDID_HDMI_EXT_POS]
-                                                        & EDID_HDMI_LATENCY_MASK) >> EDID_HDMI_LATENCY_POS;
-            if (latency_offset == 0)
-                latency_offset = 4;
-            else if (latency_offset == 3)
-                latency_offset = 0;
-            else
-                latency_offset = 2;
-
-            StartAddr -= latency_offset;
-
-            // HDMI_VIC_LEN
-            HDMIVICLen = (gEdidData[StartAddr + EDID_HDMI_EXT_LENGTH_POS]
-                    & EDID_HDMI_VSDB_VIC_LEN_MASK) >> EDID_HDMI_VSDB_VIC_LEN_BIT;
-
-            if (pVideo->hdmi_3d_format == HDMI_VIC_FORMAT) {
-                if (HDMIVICLen) {
-                    for (edid_index = 0; edid_index < (int)HDMIVICLen; edid_index++) {
-                        if (vic == gEdidData[StartAddr + EDID_HDMI_EXT_LENGTH_POS + edid_index])
-                            return 1;
-                    }
-                    return 0;
-                } else {
-                    return 0;
-                }
-            }
+    if (!CheckVSDBPhysicalAddress()) {
+        DPRINTF("EDID cache %s is for another port\n", gCachePath);
+        goto done;
+    }
 
-            // HDMI_3D_LEN
-            HDMI3DLen = gEdidData[StartAddr + EDID_HDMI_EXT_LENGTH_POS]
-                        & EDID_HDMI_VSDB_3D_LEN_MASK;
-
-            DPRINTF("HDMI VIC LENGTH[%x] = %x\r\n",
-                                    StartAddr + EDID_HDMI_EXT_LENGTH_POS, HDMIVICLen);
-            DPRINTF("HDMI 3D LENGTH[%x] = %x\r\n",
-                                    StartAddr + EDID_HDMI_EXT_LENGTH_POS, HDMI3DLen);
-
-            // check 3D_Present bit
-            if (blockLength >= (EDID_HDMI_3D_PRESENT_POS - latency_offset)) {
-                VSDB3DPresent = gEdidData[StartAddr + EDID_HDMI_3D_PRESENT_POS]
-                                & EDID_HDMI_3D_PRESENT_MASK;
-                VSDB3DMultiPresent = gEdidData[StartAddr + EDID_HDMI_3D_PRESENT_POS]
-                                & EDID_HDMI_3D_MULTI_PRESENT_MASK;
-            }
+    gCache = header;
+    ret = 1;
+    DPRINTF("EDID extensions from %s\n", gCachePath);
 
-            if (VSDB3DPresent) {
-                DPRINTF("VSDB 3D Present!!!\r\n");
-                // check with 3D madatory format
-                if (CheckResolution(pVideo->resolution, pVideo->pixelAspectRatio)) {
-                    int size = sizeof(edid_3d)/sizeof(struct edid_3d_mandatory);
-                    for (edid_index = 0; edid_index < size; edid_index++) {
-                        if (edid_3d[edid_index].resolution == pVideo->resolution &&
-                            edid_3d[edid_index].hdmi_3d_format == pVideo->hdmi_3d_format )
-                            return 1;
-                    }
-                }
-            }
+done:
+    close(fd);
+    return ret;
+}
 
-            // check 3D_Multi_Present bit
-            if (VSDB3DMultiPresent) {
-                DPRINTF("VSDB 3D Multi Present!!! = 0x%02x\r\n",VSDB3DMultiPresent);
-                // 3D Structure only
-                if (VSDB3DMultiPresent == EDID_3D_STRUCTURE_ONLY_EXIST) {
-                    // 3D Structure All
-                    Hdmi3DStructure = (gEdidData[StartAddr + EDID_HDMI_EXT_LENGTH_POS + HDMIVICLen + 1] << 8);
-                    Hdmi3DStructure |= gEdidData[StartAddr + EDID_HDMI_EXT_LENGTH_POS + HDMIVICLen + 2];
-                    DPRINTF("VSDB 3D Structure!!! = [0x%02x]\r\n",Hdmi3DStructure);
-                }
+/**
+ * Write gEdidData and gCache to the cache file of the current sink.
+ */
+static void SaveEDIDCache(void)
+{
+    char tmpPath[EDID_CACHE_PATH_LEN + 4];
+    size_t size = (gExtensions+1)*SIZEOFEDIDBLOCK;
+    int fd, err = 0;
 
-                // 3D Structure and Mask
-                if (VSDB3DMultiPresent == EDID_3D_STRUCTURE_MASK_EXIST) {
-                    // 3D Structure All
-                    Hdmi3DStructure = (gEdidData[StartAddr + EDID_HDMI_EXT_LENGTH_POS + HDMIVICLen + 1] << 8);
-                    Hdmi3DStructure |= gEdidData[StartAddr + EDID_HDMI_EXT_LENGTH_POS + HDMIVICLen + 2];
-                    // 3D Structure Mask
-                    Hdmi3DMask |= (gEdidData[StartAddr + EDID_HDMI_EXT_LENGTH_POS + HDMIVICLen + 3] << 8);
-                    Hdmi3DMask |= gEdidData[StartAddr + EDID_HDMI_EXT_LENGTH_POS + HDMIVICLen + 4];
-                    DPRINTF("VSDB 3D Structure!!! = [0x%02x]\r\n",Hdmi3DStructure);
-                    DPRINTF("VSDB 3D Mask!!! = [0x%02x]\r\n",Hdmi3DMask);
-                    DPRINTF("Current 3D Video format!!! = [%d]\r\n",pVideo->hdmi_3d_format);
-                    DPRINTF("Current 3D Video format!!! = [0x%02x]\r\n",1<<pVideo->hdmi_3d_format);
-                }
+    if (!EDIDValid() || gCachePath[0] == '\0')
+        return;
 
-                // check 3D Structure and Mask
-                if (Hdmi3DStructure & (1<<pVideo->hdmi_3d_format)) {
-                    DPRINTF("VSDB 3D Structure Contains Current Video Structure!!!\r\n");
-                    // check first 16 EDID
-                    for (edid_index = 0; edid_index < NUM_OF_VIC_FOR_3D; edid_index++) {
-                        DPRINTF("VIC = %d, EDID Vic = %d!!!\r\n",vic,aVIC[edid_index]);
-                        if (Hdmi3DMask & (1<<edid_index)) {
-                            if (vic == aVIC[edid_index]) {
-                                DPRINTF("VSDB 3D Mask Contains Current Video format!!!\r\n");
-                                return 1;
-                            }
-                        }
-                    }
-                }
-            }
+    gCache.magic = EDID_CACHE_MAGIC;
+    gCache.extensions = gExtensions;
 
-            // check block length if HDMI_VIC or HDMI Multi available
-            if (blockLength >= (EDID_HDMI_EXT_LENGTH_POS - latency_offset)) {
-                unsigned int HDMI3DExtLen = HDMI3DLen - (VSDB3DMultiPresent>>EDID_HDMI_3D_MULTI_PRESENT_BIT)*2;
-                unsigned int VICOrder;
-
-                // check if there is 3D extra data ?
-                //TODO: check 3D_Detail in case of SSH
-                if (HDMI3DExtLen) {
-                    // check HDMI 3D Extra Data
-                    for (edid_index = 0; edid_index < (int)(HDMI3DExtLen / 2); edid_index++) {
-                        VICOrder = gEdidData[StartAddr + EDID_HDMI_EXT_LENGTH_POS + HDMIVICLen +
-                                          (VSDB3DMultiPresent>>EDID_HDMI_3D_MULTI_PRESENT_BIT) * 2 + edid_index * 2]
-                                                    & EDID_HDMI_2D_VIC_ORDER_MASK;
-                        VICOrder = (1<<VICOrder);
-                        Hdmi3DStructure = gEdidData[StartAddr + EDID_HDMI_EXT_LENGTH_POS + HDMIVICLen +
-                                                 (VSDB3DMultiPresent>>EDID_HDMI_3D_MULTI_PRESENT_BIT) * 2 + edid_index * 2]
-                                                 & EDID_HDMI_3D_STRUCTURE_MASK;
-                        Hdmi3DStructure = (1<<Hdmi3DStructure);
-                        if (Hdmi3DStructure == pVideo->hdmi_3d_format && vic == aVIC[VICOrder])
-                            return 1;
-                    }
-                }
-            }
-        }
+    if (mkdir(EDID_CACHE_DIR, 0700) < 0 && errno != EEXIST) {
+        LogEDIDCacheError("create", EDID_CACHE_DIR, errno);
+        return;
     }
 
-    return 0;
+    // write a new file and rename it, a sink is never left with a torn cache
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", gCachePath);
+    fd = open(tmpPath, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        LogEDIDCacheError("create", tmpPath, errno);
+        return;
+    }
+
+    // a short write leaves errno alone, report it as a full disk
+    errno = 0;
+    if (write(fd, &gCache, sizeof(gCache)) != sizeof(gCache) ||
+        write(fd, gEdidData, size) != (ssize_t)size)
+        err = errno ? errno : ENOSPC;
+    close(fd);
+
+    if (!err && rename(tmpPath, gCachePath) < 0)
+        err = errno;
+
+    if (err) {
+        LogEDIDCacheError("write", gCachePath, err);
+        unlink(tmpPath);
+    }
 }
 
 /**
@@ -1038,7 +1236,7 @@ int EDIDClose(void)
  */
 int EDIDRead(void)
 {
-    int block,dataPtr;
+    int cached;
     unsigned char temp[SIZEOFEDIDBLOCK];
 
     // if already read??
@@ -1047,7 +1245,7 @@ int EDIDRead(void)
 
     // read EDID Extension Number
     // read EDID
-    if (!ReadEDIDBlock(0,temp))
+    if (!ReadEDIDBlock(0,1,temp))
         return 0;
 
     // get extension
@@ -1061,14 +1259,14 @@ int EDIDRead(void)
     // copy EDID Block 0
     memcpy(gEdidData,temp,SIZEOFEDIDBLOCK);
 
-    // read EDID Extension
-    for (block = 1,dataPtr = SIZEOFEDIDBLOCK; block <= gExtensions; block++,dataPtr+=SIZEOFEDIDBLOCK) {
-        // read extension 1~gExtensions
-        if (!ReadEDIDBlock(block, gEdidData+dataPtr)) {
-            // reset buffer
-            EDIDReset();
-            return 0;
-        }
+    // same sink on the same port as before? then only block 0 and the CEC address go over DDC
+    cached = LoadEDIDCache(temp);
+
+    // read EDID Extension 1~gExtensions at once
+    if (!cached && gExtensions > 0 && !ReadEDIDBlock(1, gExtensions, gEdidData+SIZEOFEDIDBLOCK)) {
+        // reset buffer
+        EDIDReset();
+        return 0;
     }
 
     // check if extension is more than 1, and first extension block is not block map.
@@ -1079,6 +1277,12 @@ int EDIDRead(void)
         return 0;
     }
 
+    // parse once, queries use gEdidCaps only
+    EDIDParse();
+
+    if (!cached)
+        SaveEDIDCache();
+
     return 1;
 }
 
@@ -1092,6 +1296,46 @@ void EDIDReset(void)
         gEdidData = NULL;
         DPRINTF("\t\t\t\tEDID is reset!!!\n");
     }
+    memset(&gEdidCaps, 0, sizeof(gEdidCaps));
+    memset(&gCache, 0, sizeof(gCache));
+    gCachePath[0] = '\0';
+}
+
+/**
+ * Get the mode chosen last time the caller asked for the same mode on this sink.
+ * @param   requested   [in]    Mode the caller asks for
+ * @param   outChosen   [out]   Mode the caller ended up with
+ * @return  If there is a cached mode, return 1; Otherwise, return 0.
+ */
+int EDIDGetCachedMode(const unsigned int requested, unsigned int* const outChosen)
+{
+    if (!EDIDValid() || !gCache.mode_valid || gCache.requested != requested)
+        return 0;
+
+    *outChosen = gCache.chosen;
+    return 1;
+}
+
+/**
+ * Remember the mode chosen for a requested mode on this sink.
+ * @param   requested   [in]    Mode the caller asked for
+ * @param   chosen      [in]    Mode the caller ended up with
+ * @return  If success, return 1; Otherwise, return 0.
+ */
+int EDIDSetCachedMode(const unsigned int requested, const unsigned int chosen)
+{
+    if (!EDIDValid())
+        return 0;
+
+    if (gCache.mode_valid && gCache.requested == requested && gCache.chosen == chosen)
+        return 1;
+
+    gCache.mode_valid = 1;
+    gCache.requested = requested;
+    gCache.chosen = chosen;
+    SaveEDIDCache();
+
+    return 1;
 }
 
 /**
@@ -1101,32 +1345,19 @@ void EDIDReset(void)
  */
 int EDIDGetCECPhysicalAddress(int* const outAddr)
 {
-    int i;
-    unsigned int StartAddr;
-
     // check EDID data is valid or not
     // read EDID
     if (!EDIDRead())
         return 0;
 
-    // find VSDB
-    for (i = 1; i <= gExtensions; i++) {
-        if (IsTimingExtension(i) // if it's timing block
-            && (StartAddr = GetVSDBOffset(i)) > 0) { // check block
-            // get supported DC value
-            // int tempDC1 = (int)(gEdidData[tempAddr+EDID_DC_POS]);
-            int phyAddr = gEdidData[StartAddr + EDID_CEC_PHYICAL_ADDR] << 8;
-            phyAddr |= gEdidData[StartAddr + EDID_CEC_PHYICAL_ADDR+1];
-
-            DPRINTF("phyAddr = %x\n",phyAddr);
+    if (!gEdidCaps.vsdb)
+        return 0;
 
-            *outAddr = phyAddr;
+    DPRINTF("phyAddr = %x\n",gEdidCaps.cec_addr);
 
-            return 1;
-        }
-    }
+    *outAddr = gEdidCaps.cec_addr;
 
-    return 0;
+    return 1;
 }
 
 /**
@@ -1169,7 +1400,7 @@ int EDIDVideoResolutionSupport(struct HDMIVideoParameter * const video)
     }
 
     // get max tmds
-    MaxTMDS = GetMaxTMDS()*5;
+    MaxTMDS = gEdidCaps.max_tmds*5;
 
     // Check MAX TMDS
     TMDSClock = aVideoParams[video->resolution].PixelClock/100;
@@ -1279,73 +1510,40 @@ int EDIDAudioModeSupport(struct HDMIAudioParameter * const audio)
         return 0;
     }
 
-    // check EDID Extension
-    // find timing block
-    for (i = 1; i <= gExtensions; i++) {
-        if (IsTimingExtension(i)) { // if it's timing block
-            // find Short Audio Description
-            unsigned int StartAddr = i*SIZEOFEDIDBLOCK;
-            unsigned int ExtAddr = StartAddr + EDID_DATA_BLOCK_START_POS;
-            unsigned int tag,blockLen;
-            unsigned int DTDStartAddr = gEdidData[StartAddr + EDID_DETAILED_TIMING_OFFSET_POS];
-
-            while (ExtAddr < StartAddr + DTDStartAddr) {
-                // find the block tag and length
-                // tag
-                tag = gEdidData[ExtAddr] & EDID_TAG_CODE_MASK;
-                // block len
-                blockLen = (gEdidData[ExtAddr] & EDID_DATA_BLOCK_SIZE_MASK) + 1;
-
-                DPRINTF("tag = %d\n",tag);
-                DPRINTF("blockLen = %d\n",blockLen-1);
-
-                // check if it is short video description
-                if (tag == EDID_SHORT_AUD_DEC_TAG_VAL) {
-                    // if so, check SAD
-                    unsigned int j, channelNum;
-                    int audioFormat,sampleFreq,wordLen;
-                    for (j = 1; j < blockLen; j += 3) {
-                        audioFormat = gEdidData[ExtAddr+j] & EDID_SAD_CODE_MASK;
-                        channelNum = gEdidData[ExtAddr+j] & EDID_SAD_CHANNEL_MASK;
-                        sampleFreq = gEdidData[ExtAddr+j+1];
-                        wordLen = gEdidData[ExtAddr+j+2];
-
-                        DPRINTF("request = %d, EDIDAudioFormatCode = %d\n",(audio->formatCode)<<3, audioFormat);
-                        DPRINTF("request = %d, EDIDChannelNumber= %d\n",(audio->channelNum)-1, channelNum);
-                        DPRINTF("request = %d, EDIDSampleFreq= %d\n",1<<(audio->sampleFreq), sampleFreq);
-                        DPRINTF("request = %d, EDIDWordLeng= %d\n",1<<(audio->wordLength), wordLen);
-
-                        // check parameter
-                        // check audioFormat
-                        if (audioFormat & ( (audio->formatCode) << 3) &&  // format code
-                                channelNum >= ( (audio->channelNum) -1) &&  // channel number
-                                (sampleFreq & (1<<(audio->sampleFreq)))) { // sample frequency
-                            if (audioFormat == LPCM_FORMAT) { // check wordLen
-                                int ret = 0;
-                                switch (audio->wordLength) {
-                                case WORD_16:
-                                case WORD_17:
-                                case WORD_18:
-                                case WORD_19:
-                                case WORD_20:
-                                    ret = wordLen & (1<<1);
-                                    break;
-                                case WORD_21:
-                                case WORD_22:
-                                case WORD_23:
-                                case WORD_24:
-                                    ret = wordLen & (1<<2);
-                                    break;
-                                }
-                                return ret;
-                            }
-                            return 1; // if not LPCM
-                        }
-                    }
+    // check Short Audio Descriptors of timing extensions
+    for (i = 0; i < gEdidCaps.num_sad; i++) {
+        const struct edid_sad* const sad = &gEdidCaps.sad[i];
+
+        DPRINTF("request = %d, EDIDAudioFormatCode = %d\n",(audio->formatCode)<<3, sad->format);
+        DPRINTF("request = %d, EDIDChannelNumber= %d\n",(audio->channelNum)-1, sad->channels);
+        DPRINTF("request = %d, EDIDSampleFreq= %d\n",1<<(audio->sampleFreq), sad->freq);
+        DPRINTF("request = %d, EDIDWordLeng= %d\n",1<<(audio->wordLength), sad->wordlen);
+
+        // check parameter
+        // check audioFormat
+        if (sad->format & ( (audio->formatCode) << 3) &&  // format code
+                sad->channels >= ( (audio->channelNum) -1) &&  // channel number
+                (sad->freq & (1<<(audio->sampleFreq)))) { // sample frequency
+            if (sad->format == LPCM_FORMAT) { // check wordLen
+                int ret = 0;
+                switch (audio->wordLength) {
+                case WORD_16:
+                case WORD_17:
+                case WORD_18:
+                case WORD_19:
+                case WORD_20:
+                    ret = sad->wordlen & (1<<1);
+                    break;
+                case WORD_21:
+                case WORD_22:
+                case WORD_23:
+                case WORD_24:
+                    ret = sad->wordlen & (1<<2);
+                    break;
                 }
-                // else find next block
-                ExtAddr += blockLen;
+                return ret;
             }
+            return 1; // if not LPCM
         }
     }
 
@@ -34,6 +34,8 @@ int EDIDColorSpaceSupport(struct HDMIVideoParameter *video);
 int EDIDColorimetrySupport(struct HDMIVideoParameter *video);
 int EDIDAudioModeSupport(struct HDMIAudioParameter *audio);
 int EDIDGetCECPhysicalAddress(int* outAddr);
+int EDIDGetCachedMode(unsigned int requested, unsigned int* outChosen);
+int EDIDSetCachedMode(unsigned int requested, unsigned int chosen);
 int EDIDClose(void);
 
 #ifdef __cplusplus
@@ -0,0 +1,42 @@
+# Copyright (C) 2008 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+LOCAL_PATH:= $(call my-dir)
+
+# old and new EDID parser on the corpus: edid_compare $(LOCAL_PATH)/edid/*.bin
+include $(CLEAR_VARS)
+LOCAL_SRC_FILES := edid_compare.c libedid_ref.c ../libedid.c
+LOCAL_C_INCLUDES := \
+	$(LOCAL_PATH) \
+	$(LOCAL_PATH)/.. \
+	$(LOCAL_PATH)/../../../../include
+# no cache file can be created there, every dump is read through the stub
+LOCAL_CFLAGS += -DEDID_CACHE_DIR=\"/dev/null/edid\"
+LOCAL_STATIC_LIBRARIES := liblog
+LOCAL_MODULE := edid_compare
+LOCAL_MODULE_TAGS := tests
+include $(BUILD_HOST_EXECUTABLE)
+
+# EDID cache across a port switch: edid_cache_test $(LOCAL_PATH)/edid/samsung_un46d7000.bin
+include $(CLEAR_VARS)
+LOCAL_SRC_FILES := edid_cache_test.c ../libedid.c
+LOCAL_C_INCLUDES := \
+	$(LOCAL_PATH) \
+	$(LOCAL_PATH)/.. \
+	$(LOCAL_PATH)/../../../../include
+LOCAL_CFLAGS += -DEDID_CACHE_DIR=\"/tmp/edid_cache_test\"
+LOCAL_STATIC_LIBRARIES := liblog
+LOCAL_MODULE := edid_cache_test
+LOCAL_MODULE_TAGS := tests
+include $(BUILD_HOST_EXECUTABLE)
@@ -0,0 +1,162 @@
+/*
+ * Copyright@ Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Reads an HDMI EDID dump through a stubbed DDC with the EDID cache on:
+ *   - first read fills the cache,
+ *   - second read of the same sink on the same port reads block 0 and the
+ *     CEC physical address only,
+ *   - third read of the same sink on another port, with only the VSDB
+ *     physical address and the checksum changed, reports the new address.
+ *
+ * usage: edid_cache_test dump
+ * The dump needs an HDMI VSDB. Returns 1 on failure.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "libedid.h"
+#include "../libddc/libddc.h"
+
+#define MAX_BLOCKS          (8)
+#define SIZEOFEDIDBLOCK     (128)
+#define CEC_ADDR_POS        (4)
+
+static unsigned char edid[MAX_BLOCKS * SIZEOFEDIDBLOCK];
+static unsigned int edid_size;
+static unsigned int read_bytes;
+
+/* the stubbed sink: segment n holds blocks 2n and 2n+1 */
+int DDCOpen()
+{
+    return 1;
+}
+
+int DDCClose()
+{
+    return 1;
+}
+
+int EDDCRead(unsigned char segpointer, unsigned char segment, unsigned char addr,
+             unsigned char offset, unsigned int size, unsigned char* buffer)
+{
+    return EDDCReadRange(segpointer, addr, segment * 256 + offset, size, buffer);
+}
+
+int EDDCReadRange(unsigned char segpointer, unsigned char addr,
+                  unsigned int start, unsigned int size, unsigned char* buffer)
+{
+    if (edid_size < start + size)
+        return 0;
+
+    memcpy(buffer, edid + start, size);
+    read_bytes += size;
+    return 1;
+}
+
+/* offset of the physical address in the first HDMI VSDB, 0 if none */
+static unsigned int find_cec_addr(void)
+{
+    unsigned int block, offset, end, len;
+
+    for (block = 1; block < edid_size / SIZEOFEDIDBLOCK; block++) {
+        unsigned char *ext = edid + block * SIZEOFEDIDBLOCK;
+
+        if (ext[0] != 0x02)
+            continue;
+        end = ext[2];
+        for (offset = 4; offset < end; offset += len) {
+            len = (ext[offset] & 0x1F) + 1;
+            if ((ext[offset] >> 5) == 3 && ext[offset + 1] == 0x03 &&
+                ext[offset + 2] == 0x0C && ext[offset + 3] == 0x00)
+                return block * SIZEOFEDIDBLOCK + offset + CEC_ADDR_POS;
+        }
+    }
+
+    return 0;
+}
+
+static void set_cec_addr(unsigned int pos, int addr)
+{
+    unsigned char *block = edid + (pos / SIZEOFEDIDBLOCK) * SIZEOFEDIDBLOCK;
+    unsigned char sum = 0;
+    int i;
+
+    edid[pos] = addr >> 8;
+    edid[pos + 1] = addr & 0xFF;
+    for (i = 0; i < SIZEOFEDIDBLOCK - 1; i++)
+        sum += block[i];
+    block[SIZEOFEDIDBLOCK - 1] = (unsigned char)(0x100 - sum);
+}
+
+static int check(const char *step, int expect_addr, unsigned int max_bytes)
+{
+    int addr = -1;
+    int ok;
+
+    read_bytes = 0;
+    ok = EDIDRead() && EDIDGetCECPhysicalAddress(&addr) && addr == expect_addr &&
+         read_bytes <= max_bytes;
+    EDIDReset();
+
+    printf("%-10s cec addr 0x%04x (want 0x%04x), %4u bytes over DDC%s\n",
+           step, addr, expect_addr, read_bytes, ok ? "" : "  <-- FAILED");
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned int pos, cached_bytes;
+    FILE *fp;
+    int ret = 0;
+
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s dump\n", argv[0]);
+        return 2;
+    }
+
+    fp = fopen(argv[1], "rb");
+    if (fp == NULL) {
+        perror(argv[1]);
+        return 1;
+    }
+    edid_size = fread(edid, 1, sizeof(edid), fp);
+    fclose(fp);
+
+    pos = find_cec_addr();
+    if (pos == 0) {
+        fprintf(stderr, "%s: no HDMI VSDB\n", argv[1]);
+        return 1;
+    }
+
+    /* block 0 and at most one physical address per extension */
+    cached_bytes = SIZEOFEDIDBLOCK + 2 * (edid_size / SIZEOFEDIDBLOCK - 1);
+
+    set_cec_addr(pos, 0x1000);
+    if (!check("first", 0x1000, edid_size))
+        ret = 1;
+    if (!check("same port", 0x1000, cached_bytes))
+        ret = 1;
+
+    set_cec_addr(pos, 0x2000);
+    if (!check("new port", 0x2000, edid_size + cached_bytes))
+        ret = 1;
+    if (!check("same port", 0x2000, cached_bytes))
+        ret = 1;
+
+    return ret;
+}
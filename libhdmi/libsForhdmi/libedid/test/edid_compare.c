@@ -0,0 +1,234 @@
+/*
+ * Copyright@ Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Feeds EDID dumps to libedid.c and to the parser it replaced
+ * (libedid_ref.c) through a stubbed DDC, and compares every query:
+ * HDMI mode, CEC address, each 2D resolution up to 720x480i@240Hz per
+ * aspect ratio and colour depth, colour depth/space, colorimetry and the audio modes.
+ *
+ * 3D queries are not compared; libedid.c reads the 3D fields of the VSDB
+ * as HDMI 1.4 lays them out, which the old parser did not.
+ *
+ * The corpus in edid/ is:
+ *   samsung_un46d7000.bin  TV preset of ReadEDIDBlock()
+ *   samsung_ls_b2230.bin   monitor preset of ReadEDIDBlock(), block 0
+ *                          checksum fixed
+ *   dvi_no_extension.bin   the monitor without its CEA extension
+ *   block_map.bin          block map and three extensions
+ *   hdmi_3d.bin            VSDB with HDMI_VIC, 3D structure and mask
+ *   deep_color.bin         the TV with deep colour and Y444 in the VSDB
+ *
+ * usage: edid_compare dump...
+ * Returns 1 if any query differs.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "video.h"
+#include "audio.h"
+#include "libedid.h"
+#include "libedid_ref.h"
+#include "../libddc/libddc.h"
+
+#define MAX_BLOCKS          (8)
+#define SIZEOFEDIDBLOCK     (128)
+#define MAX_RESULTS         (4096)
+
+//! One parser under test
+struct edid_parser {
+    const char *name;
+    int (*read)(void);
+    void (*reset)(void);
+    int (*hdmi_mode)(struct HDMIVideoParameter *video);
+    int (*resolution)(struct HDMIVideoParameter *video);
+    int (*color_depth)(struct HDMIVideoParameter *video);
+    int (*color_space)(struct HDMIVideoParameter *video);
+    int (*colorimetry)(struct HDMIVideoParameter *video);
+    int (*audio)(struct HDMIAudioParameter *audio);
+    int (*cec)(int *outAddr);
+};
+
+//! Query results of one parser, with a label per result
+struct edid_results {
+    int         num;
+    int         value[MAX_RESULTS];
+    char        label[MAX_RESULTS][32];
+};
+
+static const struct edid_parser ref_parser = {
+    "ref", RefEDIDRead, RefEDIDReset, RefEDIDHDMIModeSupport,
+    RefEDIDVideoResolutionSupport, RefEDIDColorDepthSupport, RefEDIDColorSpaceSupport,
+    RefEDIDColorimetrySupport, RefEDIDAudioModeSupport, RefEDIDGetCECPhysicalAddress,
+};
+
+static const struct edid_parser new_parser = {
+    "new", EDIDRead, EDIDReset, EDIDHDMIModeSupport,
+    EDIDVideoResolutionSupport, EDIDColorDepthSupport, EDIDColorSpaceSupport,
+    EDIDColorimetrySupport, EDIDAudioModeSupport, EDIDGetCECPhysicalAddress,
+};
+
+static unsigned char edid[MAX_BLOCKS * SIZEOFEDIDBLOCK];
+static unsigned int edid_size;
+
+/* the stubbed sink: segment n holds blocks 2n and 2n+1 */
+int DDCOpen()
+{
+    return 1;
+}
+
+int DDCClose()
+{
+    return 1;
+}
+
+int EDDCRead(unsigned char segpointer, unsigned char segment, unsigned char addr,
+             unsigned char offset, unsigned int size, unsigned char* buffer)
+{
+    return EDDCReadRange(segpointer, addr, segment * 256 + offset, size, buffer);
+}
+
+int EDDCReadRange(unsigned char segpointer, unsigned char addr,
+                  unsigned int start, unsigned int size, unsigned char* buffer)
+{
+    if (edid_size < start + size)
+        return 0;
+
+    memcpy(buffer, edid + start, size);
+    return 1;
+}
+
+static void add(struct edid_results *res, int value, const char *fmt, int a, int b, int c, int d)
+{
+    if (res->num == MAX_RESULTS)
+        return;
+
+    snprintf(res->label[res->num], sizeof(res->label[0]), fmt, a, b, c, d);
+    res->value[res->num++] = value;
+}
+
+static void query(const struct edid_parser *p, struct edid_results *res)
+{
+    struct HDMIVideoParameter video;
+    struct HDMIAudioParameter audio;
+    int r, a, c, s, w, addr;
+
+    res->num = 0;
+
+    add(res, p->read(), "read", 0, 0, 0, 0);
+
+    addr = -1;
+    r = p->cec(&addr);
+    add(res, r, "cec", 0, 0, 0, 0);
+    add(res, r ? addr : -1, "cec addr", 0, 0, 0, 0);
+
+    memset(&video, 0, sizeof(video));
+    video.mode = HDMI;
+    add(res, p->hdmi_mode(&video), "hdmi mode", 0, 0, 0, 0);
+
+    video.hdmi_3d_format = HDMI_2D_VIDEO_FORMAT;
+    /* the old parser indexes aVideoParams[] with the format, which ends at 480i 240Hz */
+    for (r = v640x480p_60Hz; r <= v720x480i_240Hz; r++) {
+        for (a = HDMI_PIXEL_RATIO_AS_PICTURE; a <= HDMI_PIXEL_RATIO_16_9; a++) {
+            for (c = HDMI_CD_36; c <= HDMI_CD_24; c++) {
+                video.resolution = (enum VideoFormat)r;
+                video.pixelAspectRatio = (enum PixelAspectRatio)a;
+                video.colorDepth = (enum ColorDepth)c;
+                add(res, p->resolution(&video), "res %d aspect %d depth %d", r, a, c, 0);
+            }
+        }
+    }
+
+    for (c = HDMI_CD_36; c <= HDMI_CD_24; c++) {
+        for (s = HDMI_CS_RGB; s <= HDMI_CS_YCBCR422; s++) {
+            video.colorDepth = (enum ColorDepth)c;
+            video.colorSpace = (enum ColorSpace)s;
+            add(res, p->color_depth(&video), "depth %d space %d", c, s, 0, 0);
+            add(res, p->color_space(&video), "space %d", s, 0, 0, 0);
+        }
+    }
+
+    for (c = HDMI_COLORIMETRY_NO_DATA; c <= HDMI_COLORIMETRY_EXTENDED_xvYCC709; c++) {
+        video.colorimetry = (enum HDMIColorimetry)c;
+        add(res, p->colorimetry(&video), "colorimetry %d", c, 0, 0, 0);
+    }
+
+    memset(&audio, 0, sizeof(audio));
+    for (a = LPCM_FORMAT; a <= DST_FORMAT; a++) {
+        for (c = CH_2; c <= CH_8; c++) {
+            for (s = SF_32KHZ; s <= SF_192KHZ; s++) {
+                for (w = WORD_16; w <= WORD_24; w += WORD_20 - WORD_16) {
+                    audio.formatCode = (enum AudioFormat)a;
+                    audio.channelNum = (enum ChannelNum)c;
+                    audio.sampleFreq = (enum SamplingFreq)s;
+                    audio.wordLength = (enum LPCM_WordLen)w;
+                    add(res, p->audio(&audio), "audio %d ch %d freq %d word %d", a, c, s, w);
+                }
+            }
+        }
+    }
+
+    p->reset();
+}
+
+static int compare(const char *path)
+{
+    static struct edid_results ref, cur;
+    FILE *fp = fopen(path, "rb");
+    int diffs = 0;
+    int i;
+
+    if (fp == NULL) {
+        perror(path);
+        return -1;
+    }
+    edid_size = fread(edid, 1, sizeof(edid), fp);
+    fclose(fp);
+
+    query(&ref_parser, &ref);
+    query(&new_parser, &cur);
+
+    for (i = 0; i < ref.num; i++) {
+        if (ref.value[i] == cur.value[i])
+            continue;
+        if (diffs++ < 8)
+            printf("%s: %s: ref %d, new %d\n", path, ref.label[i], ref.value[i], cur.value[i]);
+    }
+
+    printf("%-48s %d blocks, %d queries, %d differ%s\n", path, edid_size / SIZEOFEDIDBLOCK,
+           ref.num, diffs, diffs ? "  <-- FAILED" : "");
+
+    return diffs;
+}
+
+int main(int argc, char **argv)
+{
+    int ret = 0;
+    int i;
+
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s dump...\n", argv[0]);
+        return 2;
+    }
+
+    for (i = 1; i < argc; i++) {
+        if (compare(argv[i]) != 0)
+            ret = 1;
+    }
+
+    return ret;
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright@ Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LIBEDID_REF_H_
+#define _LIBEDID_REF_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "video.h"
+#include "audio.h"
+
+/* reference parser of libedid_ref.c, same behaviour as libedid.h */
+int RefEDIDOpen(void);
+int RefEDIDRead(void);
+void RefEDIDReset(void);
+int RefEDIDHDMIModeSupport(struct HDMIVideoParameter *video);
+int RefEDIDVideoResolutionSupport(struct HDMIVideoParameter *video);
+int RefEDIDColorDepthSupport(struct HDMIVideoParameter *video);
+int RefEDIDColorSpaceSupport(struct HDMIVideoParameter *video);
+int RefEDIDColorimetrySupport(struct HDMIVideoParameter *video);
+int RefEDIDAudioModeSupport(struct HDMIAudioParameter *audio);
+int RefEDIDGetCECPhysicalAddress(int* outAddr);
+int RefEDIDClose(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _LIBEDID_REF_H_ */
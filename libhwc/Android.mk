@@ -31,7 +31,7 @@ LOCAL_C_INCLUDES := \
 	$(LOCAL_PATH)/../include \
 	$(LOCAL_PATH)/../libexynosutils 
 
-LOCAL_SRC_FILES := SecHWCLog.cpp SecHWCUtils.cpp hwc.cpp
+LOCAL_SRC_FILES := SecHWCLog.cpp SecHWCUtils.cpp SecHWCCopy.cpp SecHWCCost.cpp hwc.cpp
 
 LOCAL_C_INCLUDES += $(LOCAL_PATH)/../libfimg
 
@@ -83,10 +83,20 @@ ifeq ($(BOARD_USE_V4L2_ION),true)
 LOCAL_CFLAGS += -DBOARD_USE_V4L2_ION
 endif
 
+ifneq ($(BOARD_HWC_COPY_THREADS),)
+LOCAL_CFLAGS += -DHWC_COPY_NUM_WORKERS=$(BOARD_HWC_COPY_THREADS)
+endif
+
 ifeq ($(BOARD_NO_OVERLAY),true)
 LOCAL_CFLAGS += -DBOARD_NO_OVERLAY
 endif
 
+ifeq ($(BOARD_USES_HWC_OVERLAY),true)
+LOCAL_CFLAGS += -DBOARD_USES_HWC_OVERLAY
+endif
+
 LOCAL_MODULE := hwcomposer.$(TARGET_BOARD_PLATFORM)
 LOCAL_MODULE_TAGS := optional
 include $(BUILD_SHARED_LIBRARY)
+
+include $(call all-makefiles-under,$(LOCAL_PATH))
@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2010 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Stride aware plane copy for the software copy fallback of HWC.
+ * Rows are copied with NEON and source prefetch, and large planes are
+ * split in bands over a small pool of worker threads.
+ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __ARM_NEON__
+#include <arm_neon.h>
+#endif
+
+#include "SecHWCUtils.h"
+
+#define HWC_COPY_MAX_WORKERS    (3)
+#ifndef HWC_COPY_NUM_WORKERS
+#define HWC_COPY_NUM_WORKERS    (1)     /* worker threads besides the caller */
+#endif
+#define HWC_COPY_MIN_BAND_SIZE  (128 * 1024)
+#define HWC_COPY_PREFETCH       (256)
+
+struct hwc_copy_band {
+    unsigned char       *dst;
+    const unsigned char *src;
+    int                  dst_stride;
+    int                  src_stride;
+    int                  width;
+    int                  height;
+};
+
+struct hwc_copy_pool {
+    pthread_mutex_t      submit_lock;
+    pthread_mutex_t      lock;
+    pthread_cond_t       work_cond;
+    pthread_cond_t       done_cond;
+    int                  num_workers;
+    int                  pending;
+    unsigned int         generation;
+    struct hwc_copy_band band[HWC_COPY_MAX_WORKERS];
+};
+
+static struct hwc_copy_pool copy_pool = {
+    PTHREAD_MUTEX_INITIALIZER,
+    PTHREAD_MUTEX_INITIALIZER,
+    PTHREAD_COND_INITIALIZER,
+    PTHREAD_COND_INITIALIZER,
+    0, 0, 0,
+};
+static pthread_once_t copy_pool_once = PTHREAD_ONCE_INIT;
+
+static void copy_row(unsigned char *dst, const unsigned char *src, int width)
+{
+#ifdef __ARM_NEON__
+    while (width >= 64) {
+        __builtin_prefetch(src + HWC_COPY_PREFETCH);
+        uint8x16_t v0 = vld1q_u8(src);
+        uint8x16_t v1 = vld1q_u8(src + 16);
+        uint8x16_t v2 = vld1q_u8(src + 32);
+        uint8x16_t v3 = vld1q_u8(src + 48);
+        vst1q_u8(dst,      v0);
+        vst1q_u8(dst + 16, v1);
+        vst1q_u8(dst + 32, v2);
+        vst1q_u8(dst + 48, v3);
+        src   += 64;
+        dst   += 64;
+        width -= 64;
+    }
+    while (width >= 16) {
+        vst1q_u8(dst, vld1q_u8(src));
+        src   += 16;
+        dst   += 16;
+        width -= 16;
+    }
+    if (width >= 8) {
+        vst1_u8(dst, vld1_u8(src));
+        src   += 8;
+        dst   += 8;
+        width -= 8;
+    }
+#endif
+    if (width > 0)
+        memcpy(dst, src, width);
+}
+
+static void copy_band(const struct hwc_copy_band *band)
+{
+    const unsigned char *src = band->src;
+    unsigned char *dst = band->dst;
+
+    /* no padding on both sides, one linear copy */
+    if ((band->dst_stride == band->width) && (band->src_stride == band->width)) {
+        memcpy(dst, src, band->width * band->height);
+        return;
+    }
+
+    for (int i = 0; i < band->height; i++) {
+        copy_row(dst, src, band->width);
+        dst += band->dst_stride;
+        src += band->src_stride;
+    }
+}
+
+static void *copy_worker(void *data)
+{
+    int index = (int)(intptr_t)data;
+    unsigned int generation = 0;
+    struct hwc_copy_band band;
+
+    while (true) {
+        pthread_mutex_lock(&copy_pool.lock);
+        while (copy_pool.generation == generation)
+            pthread_cond_wait(&copy_pool.work_cond, &copy_pool.lock);
+        generation = copy_pool.generation;
+        band = copy_pool.band[index];
+        pthread_mutex_unlock(&copy_pool.lock);
+
+        if (band.height > 0)
+            copy_band(&band);
+
+        pthread_mutex_lock(&copy_pool.lock);
+        if (--copy_pool.pending == 0)
+            pthread_cond_signal(&copy_pool.done_cond);
+        pthread_mutex_unlock(&copy_pool.lock);
+    }
+
+    return NULL;
+}
+
+static void copy_pool_init(void)
+{
+    pthread_attr_t attr;
+    pthread_t thread;
+    int num = SEC_MIN(HWC_COPY_NUM_WORKERS, HWC_COPY_MAX_WORKERS);
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+    for (int i = 0; i < num; i++) {
+        if (pthread_create(&thread, &attr, copy_worker, (void *)(intptr_t)i) != 0) {
+            SEC_HWC_Log(HWC_LOG_WARNING, "%s::copy worker %d is not created", __func__, i);
+            break;
+        }
+        copy_pool.num_workers++;
+    }
+
+    pthread_attr_destroy(&attr);
+}
+
+int hwc_copy_plane(void *dst, int dst_stride, const void *src, int src_stride,
+        int width, int height)
+{
+    struct hwc_copy_band band;
+    int num_bands;
+    int rows;
+
+    if ((dst == NULL) || (src == NULL) || (width <= 0) || (height <= 0) ||
+        (dst_stride < width) || (src_stride < width))
+        return -1;
+
+    band.dst        = (unsigned char *)dst;
+    band.src        = (const unsigned char *)src;
+    band.dst_stride = dst_stride;
+    band.src_stride = src_stride;
+    band.width      = width;
+    band.height     = height;
+
+    pthread_once(&copy_pool_once, copy_pool_init);
+
+    num_bands = SEC_MIN(copy_pool.num_workers + 1, (width * height) / HWC_COPY_MIN_BAND_SIZE);
+    if (num_bands <= 1) {
+        copy_band(&band);
+        return 0;
+    }
+
+    pthread_mutex_lock(&copy_pool.submit_lock);
+
+    rows = (height + num_bands - 1) / num_bands;
+
+    pthread_mutex_lock(&copy_pool.lock);
+    for (int i = 0; i < copy_pool.num_workers; i++) {
+        struct hwc_copy_band *worker_band = &copy_pool.band[i];
+        int start = rows * (i + 1);
+
+        *worker_band = band;
+        if (start >= height) {
+            worker_band->height = 0;
+            continue;
+        }
+        worker_band->dst    += start * dst_stride;
+        worker_band->src    += start * src_stride;
+        worker_band->height  = SEC_MIN(rows, height - start);
+    }
+    copy_pool.pending = copy_pool.num_workers;
+    copy_pool.generation++;
+    pthread_cond_broadcast(&copy_pool.work_cond);
+    pthread_mutex_unlock(&copy_pool.lock);
+
+    /* the caller takes the first band */
+    band.height = rows;
+    copy_band(&band);
+
+    pthread_mutex_lock(&copy_pool.lock);
+    while (copy_pool.pending > 0)
+        pthread_cond_wait(&copy_pool.done_cond, &copy_pool.lock);
+    pthread_mutex_unlock(&copy_pool.lock);
+
+    pthread_mutex_unlock(&copy_pool.submit_lock);
+
+    return 0;
+}
@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2010 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * GPU composition reads the source and writes the framebuffer region (and
+ * reads it back when blending); formats the GPU can not sample need a
+ * conversion to RGB first. Overlay composition costs the FIMC read of the
+ * source, the FIMC write and FIMD scan-out of the window, and the clear of
+ * the framebuffer under the window.
+ */
+
+#include <system/graphics.h>
+
+#include "sec_format.h"
+#include "SecHWCCost.h"
+
+static int get_format_bits(int format)
+{
+    switch (format) {
+    case HAL_PIXEL_FORMAT_RGBA_8888:
+    case HAL_PIXEL_FORMAT_RGBX_8888:
+    case HAL_PIXEL_FORMAT_BGRA_8888:
+        return 32;
+    case HAL_PIXEL_FORMAT_RGB_888:
+        return 24;
+    case HAL_PIXEL_FORMAT_RGB_565:
+    case HAL_PIXEL_FORMAT_CUSTOM_YCbCr_422_SP:
+    case HAL_PIXEL_FORMAT_CUSTOM_YCrCb_422_SP:
+    case HAL_PIXEL_FORMAT_CUSTOM_YCbCr_422_I:
+    case HAL_PIXEL_FORMAT_CUSTOM_YCrCb_422_I:
+    case HAL_PIXEL_FORMAT_CUSTOM_CbYCrY_422_I:
+    case HAL_PIXEL_FORMAT_CUSTOM_CrYCbY_422_I:
+        return 16;
+    case HAL_PIXEL_FORMAT_YV12:
+    case HAL_PIXEL_FORMAT_YCbCr_420_P:
+    case HAL_PIXEL_FORMAT_YCrCb_420_SP:
+    case HAL_PIXEL_FORMAT_YCbCr_420_SP:
+    case HAL_PIXEL_FORMAT_CUSTOM_YCbCr_420_SP:
+    case HAL_PIXEL_FORMAT_CUSTOM_YCrCb_420_SP:
+    case HAL_PIXEL_FORMAT_CUSTOM_YCbCr_420_SP_TILED:
+        return 12;
+    default:
+        return 32;
+    }
+}
+
+static bool is_gpu_native_format(int format)
+{
+    switch (format) {
+    case HAL_PIXEL_FORMAT_RGBA_8888:
+    case HAL_PIXEL_FORMAT_RGBX_8888:
+    case HAL_PIXEL_FORMAT_BGRA_8888:
+    case HAL_PIXEL_FORMAT_RGB_888:
+    case HAL_PIXEL_FORMAT_RGB_565:
+        return true;
+    default:
+        return false;
+    }
+}
+
+int64_t hwc_cost_gpu(const struct hwc_cost_layer *layer, int fb_bits)
+{
+    int64_t src_area = (int64_t)layer->src_w * layer->src_h;
+    int64_t dst_area = (int64_t)layer->win_w * layer->win_h;
+    int64_t cost;
+
+    cost = src_area * get_format_bits(layer->format) / 8;
+    cost += dst_area * fb_bits / 8;
+    if (layer->blended)
+        cost += dst_area * fb_bits / 8;
+    if (!is_gpu_native_format(layer->format))
+        cost += src_area * 32 / 8 * 2;
+
+    return cost;
+}
+
+int64_t hwc_cost_overlay(const struct hwc_cost_layer *layer, int win_bits, int fb_bits)
+{
+    int64_t src_area = (int64_t)layer->src_w * layer->src_h;
+    int64_t dst_area = (int64_t)layer->win_w * layer->win_h;
+    int64_t src_cost;
+
+    src_cost = src_area * get_format_bits(layer->format) / 8;
+    /* rotated read breaks burst access of FIMC */
+    if (layer->rotated)
+        src_cost = src_cost * 5 / 4;
+    /* FIMC reads every source line when down scaling more than 2x vertically */
+    if ((layer->win_h > 0) && (layer->src_h > layer->win_h * 2))
+        src_cost = src_cost * 5 / 4;
+
+    return src_cost +
+           (dst_area * win_bits / 8) * 2 +
+           (dst_area * fb_bits / 8);
+}
+
+/* bus load of a frame composing overlay_layer[] by windows, the rest by GPU */
+int64_t hwc_cost_frame(const struct hwc_cost_layer *layer, size_t num_layers,
+        const size_t *overlay_layer, int num_overlay, int win_bits, int fb_bits)
+{
+    int64_t cost = 0;
+    int next = 0;
+
+    for (size_t i = 0; i < num_layers; i++) {
+        if ((next < num_overlay) && (overlay_layer[next] == i)) {
+            cost += hwc_cost_overlay(&layer[i], win_bits, fb_bits);
+            next++;
+        } else {
+            cost += hwc_cost_gpu(&layer[i], fb_bits);
+        }
+    }
+
+    return cost;
+}
+
+/*
+ * Pick the layers to compose by FIMC and FIMD windows. The saving of every
+ * candidate is independent, so taking the largest positive savings up to the
+ * window limit minimises the total bus load. Selected layers are returned
+ * in layer order.
+ */
+int hwc_cost_select(const struct hwc_cost_layer *layer, size_t num_layers,
+        int max_win, int win_bits, int fb_bits, size_t *overlay_layer)
+{
+    int64_t saving[HWC_COST_MAX_WIN];
+    int num = 0;
+
+    if (max_win > HWC_COST_MAX_WIN)
+        max_win = HWC_COST_MAX_WIN;
+    if (max_win <= 0)
+        return 0;
+
+    for (size_t i = 0; i < num_layers; i++) {
+        int64_t cur_saving;
+        int pos;
+
+        if (!layer[i].overlay)
+            continue;
+
+        cur_saving = hwc_cost_gpu(&layer[i], fb_bits) -
+                     hwc_cost_overlay(&layer[i], win_bits, fb_bits);
+        if (cur_saving <= 0)
+            continue;
+
+        /* keep saving[] sorted in descending order */
+        if (num == max_win) {
+            if (cur_saving <= saving[num - 1])
+                continue;
+            num--;
+        }
+        for (pos = num; (pos > 0) && (saving[pos - 1] < cur_saving); pos--) {
+            saving[pos] = saving[pos - 1];
+            overlay_layer[pos] = overlay_layer[pos - 1];
+        }
+        saving[pos] = cur_saving;
+        overlay_layer[pos] = i;
+        num++;
+    }
+
+    /* windows are assigned in layer order */
+    for (int i = 1; i < num; i++) {
+        size_t idx = overlay_layer[i];
+        int pos;
+
+        for (pos = i; (pos > 0) && (overlay_layer[pos - 1] > idx); pos--)
+            overlay_layer[pos] = overlay_layer[pos - 1];
+        overlay_layer[pos] = idx;
+    }
+
+    return num;
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2010 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Cost model of overlay assignment, in bytes moved on the memory bus per
+ * frame. It only depends on the layer geometry, so the host side simulator
+ * in test/ replays dumped layer lists through the same code as hwc.cpp.
+ */
+
+#ifndef ANDROID_SEC_HWC_COST_H_
+#define ANDROID_SEC_HWC_COST_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define HWC_COST_MAX_WIN    (5)     /* FIMD windows */
+
+struct hwc_cost_layer {
+    int         format;
+    int         src_w;      /* source crop */
+    int         src_h;
+    int         win_w;      /* display frame clipped to the panel */
+    int         win_h;
+    int         rotated;    /* 90 or 270 degrees */
+    int         blended;
+    int         overlay;    /* FIMC and FIMD can take the layer */
+};
+
+int64_t hwc_cost_gpu(const struct hwc_cost_layer *layer, int fb_bits);
+int64_t hwc_cost_overlay(const struct hwc_cost_layer *layer, int win_bits, int fb_bits);
+int64_t hwc_cost_frame(const struct hwc_cost_layer *layer, size_t num_layers,
+        const size_t *overlay_layer, int num_overlay, int win_bits, int fb_bits);
+int hwc_cost_select(const struct hwc_cost_layer *layer, size_t num_layers,
+        int max_win, int win_bits, int fb_bits, size_t *overlay_layer);
+
+#endif /* ANDROID_SEC_HWC_COST_H_ */
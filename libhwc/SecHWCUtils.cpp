@@ -335,19 +335,34 @@ int window_get_global_lcd_info(int fd, struct fb_var_screeninfo *lcd_info)
     return 0;
 }
 
-int fimc_v4l2_set_src(int fd, unsigned int hw_ver, s5p_fimc_img_info *src)
+static int fimc_v4l2_req_buf(int fd, enum v4l2_buf_type type)
 {
-    struct v4l2_format  fmt;
-    struct v4l2_cropcap cropcap;
-    struct v4l2_crop    crop;
     struct v4l2_requestbuffers req;
 
 #ifdef BOARD_USE_V4L2_ION
     /* You MUST initialize structure for v4l2 */
-    memset(&fmt, 0, sizeof(fmt));
-    memset(&cropcap, 0, sizeof(cropcap));
-    memset(&crop, 0, sizeof(crop));
     memset(&req, 0, sizeof(req));
+#endif
+
+    req.count       = 1;
+    req.memory      = V4L2_MEMORY_USERPTR;
+    req.type        = type;
+
+    if (ioctl(fd, VIDIOC_REQBUFS, &req) < 0) {
+        SEC_HWC_Log(HWC_LOG_ERROR, "%s::Error in VIDIOC_REQBUFS", __func__);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int fimc_v4l2_set_src_fmt(int fd, s5p_fimc_img_info *src)
+{
+    struct v4l2_format  fmt;
+
+#ifdef BOARD_USE_V4L2_ION
+    /* You MUST initialize structure for v4l2 */
+    memset(&fmt, 0, sizeof(fmt));
 
     /*  To set size & format for source image (DMA-INPUT) */
     fmt.fmt.pix_mp.num_planes  = src->planes;
@@ -369,6 +384,18 @@ int fimc_v4l2_set_src(int fd, unsigned int hw_ver, s5p_fimc_img_info *src)
         return -1;
     }
 
+    return 0;
+}
+
+static int fimc_v4l2_set_src_crop(int fd, unsigned int hw_ver, s5p_fimc_img_info *src)
+{
+    struct v4l2_crop    crop;
+
+#ifdef BOARD_USE_V4L2_ION
+    /* You MUST initialize structure for v4l2 */
+    memset(&crop, 0, sizeof(crop));
+#endif
+
     /* crop input size */
     crop.type = V4L2_BUF_TYPE_OUTPUT;
     crop.c.width  = src->width;
@@ -394,38 +421,29 @@ int fimc_v4l2_set_src(int fd, unsigned int hw_ver, s5p_fimc_img_info *src)
         return -1;
     }
 
-    /* input buffer type */
-    req.count       = 1;
-    req.memory      = V4L2_MEMORY_USERPTR;
-    req.type        = V4L2_BUF_TYPE_OUTPUT;
+    return 0;
+}
 
-    if (ioctl(fd, VIDIOC_REQBUFS, &req) < 0) {
-        SEC_HWC_Log(HWC_LOG_ERROR, "%s::Error in VIDIOC_REQBUFS", __func__);
+int fimc_v4l2_set_src(int fd, unsigned int hw_ver, s5p_fimc_img_info *src)
+{
+    if (fimc_v4l2_set_src_fmt(fd, src) < 0)
         return -1;
-    }
 
-    return 0;
+    if (fimc_v4l2_set_src_crop(fd, hw_ver, src) < 0)
+        return -1;
+
+    /* input buffer type */
+    return fimc_v4l2_req_buf(fd, V4L2_BUF_TYPE_OUTPUT);
 }
 
-int fimc_v4l2_set_dst(int fd, s5p_fimc_img_info *dst,
-        int rotation, int hflip, int vflip, unsigned int addr)
+static int fimc_v4l2_set_rotation(int fd, int rotation, int hflip, int vflip)
 {
-    struct v4l2_format      sFormat;
     struct v4l2_control     vc;
-    struct v4l2_framebuffer fbuf;
-#ifdef BOARD_USE_V4L2_ION
-    struct v4l2_crop    crop;
-    struct v4l2_requestbuffers req;
-#endif
     int ret;
 
 #ifdef BOARD_USE_V4L2_ION
     /* You MUST initialize structure for v4l2 */
-    memset(&sFormat, 0, sizeof(sFormat));
     memset(&vc, 0, sizeof(vc));
-    memset(&fbuf, 0, sizeof(fbuf));
-    memset(&crop, 0, sizeof(crop));
-    memset(&req, 0, sizeof(req));
 #endif
 
     /* set rotation configuration */
@@ -466,7 +484,50 @@ int fimc_v4l2_set_dst(int fd, s5p_fimc_img_info *dst,
         return -1;
     }
 
+    return 0;
+}
+
+#ifndef BOARD_USE_V4L2_ION
+/* size, format & address for destination image (DMA-OUTPUT) */
+static int fimc_v4l2_set_dst_addr(int fd, s5p_fimc_img_info *dst, unsigned int addr)
+{
+    struct v4l2_framebuffer fbuf;
+    int ret;
+
+    ret = ioctl(fd, VIDIOC_G_FBUF, &fbuf);
+    if (ret < 0) {
+        SEC_HWC_Log(HWC_LOG_ERROR, "%s::Error in video VIDIOC_G_FBUF (%d)", __func__, ret);
+        return -1;
+    }
+
+    fbuf.base            = (void *)addr;
+    fbuf.fmt.width       = dst->full_width;
+    fbuf.fmt.height      = dst->full_height;
+    fbuf.fmt.pixelformat = dst->color_space;
+
+    ret = ioctl(fd, VIDIOC_S_FBUF, &fbuf);
+    if (ret < 0) {
+        SEC_HWC_Log(HWC_LOG_ERROR, "%s::Error in video VIDIOC_S_FBUF (%d)", __func__, ret);
+        return -1;
+    }
+
+    return 0;
+}
+#endif
+
+static int fimc_v4l2_set_dst_fmt(int fd, s5p_fimc_img_info *dst, unsigned int addr)
+{
+    struct v4l2_format      sFormat;
 #ifdef BOARD_USE_V4L2_ION
+    struct v4l2_crop    crop;
+#endif
+    int ret;
+
+#ifdef BOARD_USE_V4L2_ION
+    /* You MUST initialize structure for v4l2 */
+    memset(&sFormat, 0, sizeof(sFormat));
+    memset(&crop, 0, sizeof(crop));
+
     /* set destination */
     sFormat.type             = V4L2_BUF_TYPE_CAPTURE;
     sFormat.fmt.pix_mp.width         = dst->full_width;
@@ -493,35 +554,9 @@ int fimc_v4l2_set_dst(int fd, s5p_fimc_img_info *dst,
         SEC_HWC_Log(HWC_LOG_ERROR, "%s::Error in video VIDIOC_S_CROP (%d)", __func__, ret);
         return -1;
     }
-
-    /*  input buffer type */
-    req.count       = 1;
-    req.type        = V4L2_BUF_TYPE_CAPTURE;
-    req.memory      = V4L2_MEMORY_USERPTR;
-
-    ret = ioctl (fd, VIDIOC_REQBUFS, &req);
-    if (ret < 0) {
-        SEC_HWC_Log(HWC_LOG_ERROR, "%s::Error in VIDIOC_REQBUFS (%d)", __func__, ret);
-        return -1;
-    }
 #else
-    /* set size, format & address for destination image (DMA-OUTPUT) */
-    ret = ioctl(fd, VIDIOC_G_FBUF, &fbuf);
-    if (ret < 0) {
-        SEC_HWC_Log(HWC_LOG_ERROR, "%s::Error in video VIDIOC_G_FBUF (%d)", __func__, ret);
-        return -1;
-    }
-
-    fbuf.base            = (void *)addr;
-    fbuf.fmt.width       = dst->full_width;
-    fbuf.fmt.height      = dst->full_height;
-    fbuf.fmt.pixelformat = dst->color_space;
-
-    ret = ioctl(fd, VIDIOC_S_FBUF, &fbuf);
-    if (ret < 0) {
-        SEC_HWC_Log(HWC_LOG_ERROR, "%s::Error in video VIDIOC_S_FBUF (%d)", __func__, ret);
+    if (fimc_v4l2_set_dst_addr(fd, dst, addr) < 0)
         return -1;
-    }
 
     /* set destination window */
     sFormat.type             = V4L2_BUF_TYPE_VIDEO_OVERLAY;
@@ -540,6 +575,24 @@ int fimc_v4l2_set_dst(int fd, s5p_fimc_img_info *dst,
     return 0;
 }
 
+int fimc_v4l2_set_dst(int fd, s5p_fimc_img_info *dst,
+        int rotation, int hflip, int vflip, unsigned int addr)
+{
+    if (fimc_v4l2_set_rotation(fd, rotation, hflip, vflip) < 0)
+        return -1;
+
+    if (fimc_v4l2_set_dst_fmt(fd, dst, addr) < 0)
+        return -1;
+
+#ifdef BOARD_USE_V4L2_ION
+    /*  input buffer type */
+    if (fimc_v4l2_req_buf(fd, V4L2_BUF_TYPE_CAPTURE) < 0)
+        return -1;
+#endif
+
+    return 0;
+}
+
 int fimc_v4l2_stream_on(int fd, enum v4l2_buf_type type)
 {
     if (-1 == ioctl(fd, VIDIOC_STREAMON, &type)) {
@@ -651,43 +704,211 @@ int fimc_v4l2_S_ctrl(int fd)
     return 0;
 }
 
-int fimc_handle_oneshot(int fd, struct fimc_buf *fimc_src_buf, struct fimc_buf *fimc_dst_buf)
+static bool is_fimc_fmt_equal(const s5p_fimc_img_info *a, const s5p_fimc_img_info *b)
+{
+    return (a->full_width  == b->full_width)  &&
+           (a->full_height == b->full_height) &&
+#ifdef BOARD_USE_V4L2_ION
+           (a->planes      == b->planes)      &&
+#endif
+           (a->color_space == b->color_space);
+}
+
+static bool is_fimc_crop_equal(const s5p_fimc_img_info *a, const s5p_fimc_img_info *b)
+{
+    return (a->start_x == b->start_x) &&
+           (a->start_y == b->start_y) &&
+           (a->width   == b->width)   &&
+           (a->height  == b->height);
+}
+
+static int fimc_stream_off(int fd, struct hwc_fimc_state *state)
+{
+    int ret = 0;
+
+    if (!state->streaming)
+        return 0;
+    state->streaming = 0;
+
+    if (fimc_v4l2_stream_off(fd, V4L2_BUF_TYPE_OUTPUT) < 0) {
+        SEC_HWC_Log(HWC_LOG_ERROR, "Fail : SRC  v4l2_stream_off()");
+        ret = -1;
+    }
+#ifdef BOARD_USE_V4L2_ION
+    if (fimc_v4l2_stream_off(fd, V4L2_BUF_TYPE_CAPTURE) < 0) {
+        SEC_HWC_Log(HWC_LOG_ERROR, "Fail : DST  v4l2_stream_off()");
+        ret = -1;
+    }
+#endif
+    return ret;
+}
+
+/*
+ * Program the changed part of the configuration only. The formats can not
+ * be changed while buffers are requested, so any change stops the stream
+ * and releases the buffers first. A new destination address alone, as the
+ * HWC rotates its window buffers every frame, is only a S_FBUF.
+ */
+static int fimc_set_config(s5p_fimc_t *fimc, struct hwc_fimc_state *state,
+        int rotation, int hflip, int vflip, unsigned int dst_addr)
+{
+    s5p_fimc_params_t *params = &fimc->params;
+    int fd = fimc->dev_fd;
+    bool rot_changed;
+    bool dst_changed;
+    bool addr_changed;
+    bool src_fmt_changed;
+    bool src_crop_changed;
+
+#ifdef BOARD_USE_V4L2_ION
+    /* destination is queued as a capture buffer, not set by S_FBUF */
+    dst_addr = 0;
+#endif
+
+    if (!state->valid) {
+        if (fimc_v4l2_set_dst(fd, &params->dst, rotation, hflip, vflip, dst_addr) < 0) {
+            SEC_HWC_Log(HWC_LOG_ERROR, "fimc_v4l2_set_dst is failed\n");
+            goto err;
+        }
+        if (fimc_v4l2_set_src(fd, fimc->hw_ver, &params->src) < 0) {
+            SEC_HWC_Log(HWC_LOG_ERROR, "fimc_v4l2_set_src is failed\n");
+            goto err;
+        }
+    } else {
+        rot_changed      = (state->rotation != rotation) ||
+                           (state->hflip != hflip) || (state->vflip != vflip);
+        dst_changed      = !is_fimc_fmt_equal(&state->dst, &params->dst) ||
+                           !is_fimc_crop_equal(&state->dst, &params->dst);
+        src_fmt_changed  = !is_fimc_fmt_equal(&state->src, &params->src);
+        src_crop_changed = !is_fimc_crop_equal(&state->src, &params->src);
+
+        addr_changed     = (state->dst_addr != dst_addr);
+
+        if (!rot_changed && !dst_changed && !src_fmt_changed && !src_crop_changed) {
+#ifndef BOARD_USE_V4L2_ION
+            /* if the running stream refuses the address, reprogram it all */
+            if (addr_changed && fimc_v4l2_set_dst_addr(fd, &params->dst, dst_addr) < 0)
+                dst_changed = true;
+            else
+#endif
+            {
+                state->dst_addr = dst_addr;
+                state->fast_frames++;
+                return 0;
+            }
+        }
+
+        fimc_stream_off(fd, state);
+        fimc_v4l2_clr_buf(fd, V4L2_BUF_TYPE_OUTPUT);
+#ifdef BOARD_USE_V4L2_ION
+        fimc_v4l2_clr_buf(fd, V4L2_BUF_TYPE_CAPTURE);
+#endif
+        state->valid = 0;
+
+        if (rot_changed &&
+            fimc_v4l2_set_rotation(fd, rotation, hflip, vflip) < 0)
+            goto err;
+
+        /* destination window is checked against the rotation */
+        if ((rot_changed || dst_changed || addr_changed) &&
+            fimc_v4l2_set_dst_fmt(fd, &params->dst, dst_addr) < 0)
+            goto err;
+
+        /* S_FMT resets the crop */
+        if (src_fmt_changed &&
+            fimc_v4l2_set_src_fmt(fd, &params->src) < 0)
+            goto err;
+
+        if ((src_fmt_changed || src_crop_changed) &&
+            fimc_v4l2_set_src_crop(fd, fimc->hw_ver, &params->src) < 0)
+            goto err;
+
+        if (fimc_v4l2_req_buf(fd, V4L2_BUF_TYPE_OUTPUT) < 0)
+            goto err;
+#ifdef BOARD_USE_V4L2_ION
+        if (fimc_v4l2_req_buf(fd, V4L2_BUF_TYPE_CAPTURE) < 0)
+            goto err;
+#endif
+    }
+
+    state->src      = params->src;
+    state->dst      = params->dst;
+    state->rotation = rotation;
+    state->hflip    = hflip;
+    state->vflip    = vflip;
+    state->dst_addr = dst_addr;
+    state->valid    = 1;
+    state->reconfigs++;
+
+    return 0;
+
+err:
+    fimc_v4l2_clr_buf(fd, V4L2_BUF_TYPE_OUTPUT);
+#ifdef BOARD_USE_V4L2_ION
+    fimc_v4l2_clr_buf(fd, V4L2_BUF_TYPE_CAPTURE);
+#endif
+    state->valid = 0;
+
+    return -1;
+}
+
+/*
+ * Stream stays on between frames, a frame is queue => dequeue only.
+ * The first frame after a configuration starts the stream.
+ */
+static int fimc_handle_stream(int fd, struct hwc_fimc_state *state,
+        struct fimc_buf *fimc_src_buf, struct fimc_buf *fimc_dst_buf)
 {
 #ifdef CHECK_FPS
     check_fps();
 #endif
 
+    if (state->streaming) {
+        if (fimc_v4l2_queue(fd, fimc_src_buf, V4L2_BUF_TYPE_OUTPUT, 0) < 0) {
+            SEC_HWC_Log(HWC_LOG_ERROR, "Fail : SRC v4l2_queue()");
+            return -1;
+        }
+#ifdef BOARD_USE_V4L2_ION
+        if (fimc_v4l2_queue(fd, fimc_dst_buf, V4L2_BUF_TYPE_CAPTURE, 0) < 0) {
+            SEC_HWC_Log(HWC_LOG_ERROR, "Fail : DST v4l2_queue()");
+            return -2;
+        }
+#endif
+    } else {
+        state->streaming = 1;
 #ifdef BOARD_USE_V4L2_ION
-    if (fimc_v4l2_queue(fd, fimc_src_buf, V4L2_BUF_TYPE_OUTPUT, 0) < 0) {
-         SEC_HWC_Log(HWC_LOG_ERROR, "Fail : SRC v4l2_queue()");
-         return -1;
-     }
+        if (fimc_v4l2_queue(fd, fimc_src_buf, V4L2_BUF_TYPE_OUTPUT, 0) < 0) {
+            SEC_HWC_Log(HWC_LOG_ERROR, "Fail : SRC v4l2_queue()");
+            return -1;
+        }
 
-    if (fimc_v4l2_queue(fd, fimc_dst_buf, V4L2_BUF_TYPE_CAPTURE, 0) < 0) {
-        SEC_HWC_Log(HWC_LOG_ERROR, "Fail : DST v4l2_queue()");
-        return -2;
-    }
+        if (fimc_v4l2_queue(fd, fimc_dst_buf, V4L2_BUF_TYPE_CAPTURE, 0) < 0) {
+            SEC_HWC_Log(HWC_LOG_ERROR, "Fail : DST v4l2_queue()");
+            return -2;
+        }
 
-    if (fimc_v4l2_stream_on(fd, V4L2_BUF_TYPE_OUTPUT) < 0) {
-        SEC_HWC_Log(HWC_LOG_ERROR, "Fail : SRC v4l2_stream_on()");
-        return -3;
-    }
+        if (fimc_v4l2_stream_on(fd, V4L2_BUF_TYPE_OUTPUT) < 0) {
+            SEC_HWC_Log(HWC_LOG_ERROR, "Fail : SRC v4l2_stream_on()");
+            return -3;
+        }
 
-    if (fimc_v4l2_stream_on(fd, V4L2_BUF_TYPE_CAPTURE) < 0) {
-        SEC_HWC_Log(HWC_LOG_ERROR, "Fail : DST v4l2_stream_on()");
-        return -4;
-    }
+        if (fimc_v4l2_stream_on(fd, V4L2_BUF_TYPE_CAPTURE) < 0) {
+            SEC_HWC_Log(HWC_LOG_ERROR, "Fail : DST v4l2_stream_on()");
+            return -4;
+        }
 #else
-    if (fimc_v4l2_stream_on(fd, V4L2_BUF_TYPE_OUTPUT) < 0) {
-        SEC_HWC_Log(HWC_LOG_ERROR, "Fail : SRC v4l2_stream_on()");
-        return -5;
-    }
+        if (fimc_v4l2_stream_on(fd, V4L2_BUF_TYPE_OUTPUT) < 0) {
+            SEC_HWC_Log(HWC_LOG_ERROR, "Fail : SRC v4l2_stream_on()");
+            return -5;
+        }
 
-    if (fimc_v4l2_queue(fd, fimc_src_buf, V4L2_BUF_TYPE_OUTPUT, 0) < 0) {
-        SEC_HWC_Log(HWC_LOG_ERROR, "Fail : SRC v4l2_queue()");
-        goto STREAM_OFF;
-    }
+        if (fimc_v4l2_queue(fd, fimc_src_buf, V4L2_BUF_TYPE_OUTPUT, 0) < 0) {
+            SEC_HWC_Log(HWC_LOG_ERROR, "Fail : SRC v4l2_queue()");
+            return -1;
+        }
 #endif
+    }
+
     if (fimc_v4l2_dequeue(fd, fimc_src_buf, V4L2_BUF_TYPE_OUTPUT) < 0) {
         SEC_HWC_Log(HWC_LOG_ERROR, "Fail : SRC v4l2_dequeue()");
         return -6;
@@ -697,27 +918,6 @@ int fimc_handle_oneshot(int fd, struct fimc_buf *fimc_src_buf, struct fimc_buf *
         SEC_HWC_Log(HWC_LOG_ERROR, "Fail : DST v4l2_dequeue()");
         return -7;
     }
-#endif
-STREAM_OFF:
-    if (fimc_v4l2_stream_off(fd, V4L2_BUF_TYPE_OUTPUT) < 0) {
-        SEC_HWC_Log(HWC_LOG_ERROR, "Fail : SRC  v4l2_stream_off()");
-        return -8;
-    }
-#ifdef BOARD_USE_V4L2_ION 
-    if (fimc_v4l2_stream_off(fd, V4L2_BUF_TYPE_CAPTURE) < 0) {
-        SEC_HWC_Log(HWC_LOG_ERROR, "Fail : DST  v4l2_stream_off()");
-        return -9;
-    }
-#endif
-    if (fimc_v4l2_clr_buf(fd, V4L2_BUF_TYPE_OUTPUT) < 0) {
-        SEC_HWC_Log(HWC_LOG_ERROR, "Fail : SRC v4l2_clr_buf()");
-        return -10;
-    }
-#ifdef BOARD_USE_V4L2_ION
-    if (fimc_v4l2_clr_buf(fd, V4L2_BUF_TYPE_CAPTURE)< 0) {
-        SEC_HWC_Log(HWC_LOG_ERROR, "Fail : DST v4l2_clr_buf()");
-        return -11;
-    }
 #endif
     return 0;
 }
@@ -732,7 +932,6 @@ static int memcpy_rect(void *dst, void *src, int fullW, int fullH, int realW, in
     int cbFullW, cbRealW, cbFullH, cbRealH;
     int ySrcFW, ySrcFH, ySrcRW, ySrcRH;
     int planes;
-    int i;
 
     SEC_HWC_Log(HWC_LOG_DEBUG,
             "++memcpy_rect()::"
@@ -802,16 +1001,12 @@ static int memcpy_rect(void *dst, void *src, int fullW, int fullH, int realW, in
     struct timeval start, end;
     gettimeofday(&start, NULL);
 #endif
-    for (i = 0; i < realH; i++)
-        memcpy(dstY + fullW * i, srcY + ySrcFW * i, ySrcRW);
+    hwc_copy_plane(dstY, fullW, srcY, ySrcFW, ySrcRW, realH);
     if (planes == 2) {
-        for (i = 0; i < cbRealH; i++)
-            memcpy(dstCb + ySrcFW * i, srcCb + ySrcFW * i, ySrcRW);
+        hwc_copy_plane(dstCb, ySrcFW, srcCb, ySrcFW, ySrcRW, cbRealH);
     } else if (planes == 3) {
-        for (i = 0; i < cbRealH; i++)
-            memcpy(dstCb + cbFullW * i, srcCb + cbFullW * i, cbRealW);
-        for (i = 0; i < cbRealH; i++)
-            memcpy(dstCr + cbFullW * i, srcCr + cbFullW * i, cbRealW);
+        hwc_copy_plane(dstCb, cbFullW, srcCb, cbFullW, cbRealW, cbRealH);
+        hwc_copy_plane(dstCr, cbFullW, srcCr, cbFullW, cbRealW, cbRealH);
     }
 #ifdef CHECK_PERF
     gettimeofday(&end, NULL);
@@ -1110,6 +1305,7 @@ static int runFimcCore(struct exynos4_hwc_composer_device_1_t *ctx,
 {
     s5p_fimc_t        * fimc = &ctx->fimc;
     s5p_fimc_params_t * params = &(fimc->params);
+    struct hwc_fimc_state *state = &ctx->fimc_state;
 
     struct fimc_buf fimc_src_buf;
     int src_bpp, src_planes;
@@ -1121,6 +1317,7 @@ static int runFimcCore(struct exynos4_hwc_composer_device_1_t *ctx,
     unsigned int dst_frame_size = 0;
 #endif
     unsigned int    frame_size = 0;
+    int ret;
 
     bool src_cbcr_order = true;
     int rotate_value = rotateValueHAL2PP(transform);
@@ -1264,11 +1461,7 @@ static int runFimcCore(struct exynos4_hwc_composer_device_1_t *ctx,
         return -1;
     }
 
-   /* 3. Set configuration related to destination (DMA-OUT)
-     *   - set input format & size
-     *   - crop input size
-     *   - set input buffer
-     *   - set buffer type (V4L2_MEMORY_USERPTR)
+   /* 3. Set output dma address and size
      */
 #ifdef BOARD_USE_V4L2_ION
     switch (dst_img->format) {
@@ -1300,25 +1493,7 @@ static int runFimcCore(struct exynos4_hwc_composer_device_1_t *ctx,
     }
 #endif
 
-    if (fimc_v4l2_set_dst(fimc->dev_fd, &params->dst, rotate_value, hflip, vflip, dst_phys_addr) < 0) {
-        SEC_HWC_Log(HWC_LOG_ERROR, "fimc_v4l2_set_dst is failed\n");
-        return -1;
-    }
-
-   /* 4. Set configuration related to source (DMA-INPUT)
-     *   - set input format & size
-     *   - crop input size
-     *   - set input buffer
-     *   - set buffer type (V4L2_MEMORY_USERPTR)
-     */
-#ifndef BOARD_USE_V4L2_ION
-    if (fimc_v4l2_set_src(fimc->dev_fd, fimc->hw_ver, &params->src) < 0) {
-        SEC_HWC_Log(HWC_LOG_ERROR, "fimc_v4l2_set_src is failed\n");
-        return -1;
-    }
-#endif
-
-    /* 5. Set input dma address (Y/RGB, Cb, Cr)
+    /* 4. Set input dma address (Y/RGB, Cb, Cr)
      *    - zero copy : mfc, camera
      */
     switch (src_img->format) {
@@ -1383,39 +1558,34 @@ static int runFimcCore(struct exynos4_hwc_composer_device_1_t *ctx,
         }
     }
 
-    /* 6. Run FIMC
-     *    - stream on => queue => dequeue => stream off => clear buf
-     */
 #ifdef BOARD_USE_V4L2_ION
-    int ret = 0;
     params->src.planes = src_planes;
-
-    if (fimc_v4l2_set_src(fimc->dev_fd, fimc->hw_ver, &params->src) < 0) {
-        SEC_HWC_Log(HWC_LOG_ERROR, "fimc_v4l2_set_src is failed\n");
-        return -1;
-    }
-
     fimc_src_buf.planes = src_planes;
     fimc_dst_buf.planes = dst_planes;
+#endif
 
-    ret = fimc_handle_oneshot(fimc->dev_fd, &fimc_src_buf, &fimc_dst_buf);
+    /* 5. Set configuration of source (DMA-INPUT) and destination (DMA-OUT)
+     *    - only the part which differs from the previous frame
+     */
+    if (fimc_set_config(fimc, state, rotate_value, hflip, vflip, dst_phys_addr) < 0) {
+        stopFimc(ctx);
+        return -1;
+    }
 
+    /* 6. Run FIMC
+     *    - (stream on) => queue => dequeue
+     */
+#ifdef BOARD_USE_V4L2_ION
+    ret = fimc_handle_stream(fimc->dev_fd, state, &fimc_src_buf, &fimc_dst_buf);
+#else
+    ret = fimc_handle_stream(fimc->dev_fd, state, &fimc_src_buf, NULL);
+#endif
     if (ret < 0) {
-        SEC_HWC_Log(HWC_LOG_ERROR,"fimc_handle_oneshot = %d\n",ret);
-        if (ret == -2) {
-            fimc_v4l2_clr_buf(fimc->dev_fd, V4L2_BUF_TYPE_OUTPUT);
-        } else if (ret == -3) {
-            fimc_v4l2_clr_buf(fimc->dev_fd, V4L2_BUF_TYPE_OUTPUT);
-            fimc_v4l2_clr_buf(fimc->dev_fd, V4L2_BUF_TYPE_CAPTURE);
-        }
+        SEC_HWC_Log(HWC_LOG_ERROR, "fimc_handle_stream = %d\n", ret);
+        stopFimc(ctx);
         return ret;
     }
-#else
-    if (fimc_handle_oneshot(fimc->dev_fd, &fimc_src_buf, NULL) < 0) {
-        fimc_v4l2_clr_buf(fimc->dev_fd, V4L2_BUF_TYPE_OUTPUT);
-        return -1;
-    }
-#endif
+    state->frames++;
 
     return 0;
 }
@@ -1498,6 +1668,22 @@ int destroyFimc(s5p_fimc_t *fimc)
     return 0;
 }
 
+void stopFimc(struct exynos4_hwc_composer_device_1_t *ctx)
+{
+    s5p_fimc_t *fimc = &ctx->fimc;
+    struct hwc_fimc_state *state = &ctx->fimc_state;
+
+    if ((0 < fimc->dev_fd) && state->valid) {
+        fimc_stream_off(fimc->dev_fd, state);
+        fimc_v4l2_clr_buf(fimc->dev_fd, V4L2_BUF_TYPE_OUTPUT);
+#ifdef BOARD_USE_V4L2_ION
+        fimc_v4l2_clr_buf(fimc->dev_fd, V4L2_BUF_TYPE_CAPTURE);
+#endif
+    }
+    state->streaming = 0;
+    state->valid = 0;
+}
+
 int runFimc(struct exynos4_hwc_composer_device_1_t *ctx,
             struct sec_img *src_img, struct sec_rect *src_rect,
             struct sec_img *dst_img, struct sec_rect *dst_rect,
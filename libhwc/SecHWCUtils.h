@@ -52,6 +52,7 @@
 
 #include "s3c_lcd.h"
 #include "sec_format.h"
+#include "SecHWCCost.h"
 
 #define HWC_DEBUG
 #if defined(BOARD_USES_FIMGAPI)
@@ -161,6 +162,98 @@ struct hwc_ui_lay_info{
 };
 #endif
 
+/*
+ * Composition plan of the last prepare(). When the layer list has the same
+ * geometry, the plan is replayed instead of deciding window assignment again,
+ * and FIMC parameters are reused with only buffer addresses updated.
+ */
+#define HWC_PLAN_MAX_LAYERS (32)
+
+struct hwc_plan_layer_key {
+    int32_t    composition_target;
+    uint32_t   flags;
+    uint32_t   transform;
+    int32_t    blending;
+    hwc_rect_t source_crop;
+    hwc_rect_t display_frame;
+    int        format;
+    int        usage;
+    int        width;
+    int        height;
+};
+
+struct hwc_compos_plan {
+    int                       valid;
+    uint32_t                  hash;
+    size_t                    num_layers;
+    int                       force_gpu;
+    struct hwc_plan_layer_key key[HWC_PLAN_MAX_LAYERS];
+    int32_t                   composition_type[HWC_PLAN_MAX_LAYERS];
+    uint32_t                  hints[HWC_PLAN_MAX_LAYERS];
+
+    int                       num_of_fb_layer;
+    int                       num_of_hwc_layer;
+    int                       num_2d_blit_layer;
+    int                       win_layer_index[NUM_OF_WIN];
+    int                       win_status[NUM_OF_WIN];
+
+    /* fimc parameters per window, only buffer addresses change per frame */
+    int                       fimc_valid[NUM_OF_WIN];
+    struct sec_img            src_img[NUM_OF_WIN];
+    struct sec_img            dst_img[NUM_OF_WIN];
+    struct sec_rect           src_rect[NUM_OF_WIN];
+    struct sec_rect           dst_rect[NUM_OF_WIN];
+};
+
+/*
+ * Per layer damage of the current frame. A layer is damaged when its buffer,
+ * crop, position, transform or blending changed since the previous frame.
+ */
+struct hwc_layer_damage {
+    buffer_handle_t handle;
+    hwc_rect_t      source_crop;
+    hwc_rect_t      display_frame;
+    uint32_t        transform;
+    int32_t         blending;
+    hwc_rect_t      damage;     /* display coordinates, empty if unchanged */
+};
+
+struct hwc_damage_tracker {
+    size_t                  num_layers;
+    struct hwc_layer_damage layer[HWC_PLAN_MAX_LAYERS];
+    buffer_handle_t         fb_target;  /* last posted framebuffer target */
+    uint64_t                skipped_fimc;
+    uint64_t                skipped_fb_post;
+};
+
+struct hwc_prepare_stat {
+    uint64_t   frames;
+    uint64_t   plan_hits;
+    uint64_t   plan_misses;
+    int64_t    last_ns;
+    int64_t    max_ns;
+    int64_t    total_ns;
+};
+
+/*
+ * Last configuration programmed into the FIMC node. Buffer addresses are not
+ * part of it, a frame which only changes addresses is queued to the running
+ * stream without any reconfiguration.
+ */
+struct hwc_fimc_state {
+    int                 valid;
+    int                 streaming;
+    s5p_fimc_img_info   src;
+    s5p_fimc_img_info   dst;
+    int                 rotation;
+    int                 hflip;
+    int                 vflip;
+    unsigned int        dst_addr;   /* destination base set by S_FBUF */
+    uint64_t            frames;
+    uint64_t            fast_frames;
+    uint64_t            reconfigs;
+};
+
 struct exynos4_hwc_composer_device_1_t {
     hwc_composer_device_1_t base;
 
@@ -194,12 +287,19 @@ struct exynos4_hwc_composer_device_1_t {
 #endif
     struct fb_var_screeninfo  lcd_info; //overlay window var info
     s5p_fimc_t         fimc;    //for overlay
+    struct hwc_fimc_state     fimc_state;
     int                       num_of_fb_layer;
     int                       num_of_hwc_layer;
     int                       num_of_fb_layer_prev;
     int            num_2d_blit_layer;
     uint32_t                  layer_prev_buf[NUM_OF_WIN];
 
+    struct hwc_compos_plan    plan;
+    struct hwc_prepare_stat   prepare_stat;
+    struct hwc_damage_tracker damage;
+    struct hwc_cost_layer     cost_layer[HWC_PLAN_MAX_LAYERS];  /* last assigned layer list */
+    size_t                    num_cost_layer;
+
     /*
     exynos4_fimc_data_t      fimc[NUM_FIMC_UNITS];
 
@@ -305,8 +405,12 @@ int window_show       (struct hwc_win_info_t *win);
 int window_hide       (struct hwc_win_info_t *win);
 int window_get_global_lcd_info(int fd, struct fb_var_screeninfo *lcd_info);
 
+int hwc_copy_plane(void *dst, int dst_stride, const void *src, int src_stride,
+        int width, int height);
+
 int createFimc (s5p_fimc_t *fimc);
 int destroyFimc(s5p_fimc_t *fimc);
+void stopFimc(struct exynos4_hwc_composer_device_1_t *ctx);
 int runFimc(struct exynos4_hwc_composer_device_1_t *ctx,
             struct sec_img *src_img, struct sec_rect *src_rect,
             struct sec_img *dst_img, struct sec_rect *dst_rect,
@@ -45,6 +45,7 @@
 #include <hardware/hwcomposer.h>
 #include <hardware_legacy/uevent.h>
 #include <utils/String8.h>
+#include <utils/Timers.h>
 #include <utils/Vector.h>
 
 #include <sync/sync.h>
@@ -332,9 +333,69 @@ static int set_src_dst_img_rect(hwc_layer_1_t *cur,
     return 0;
 }
 
+static void update_src_dst_img_addr(hwc_layer_1_t *cur,
+        struct hwc_win_info_t *win,
+        struct sec_img *src_img,
+        struct sec_img *dst_img)
+{
+    private_handle_t *prev_handle = (private_handle_t *)(cur->handle);
+
+    src_img->base    = (uint32_t)prev_handle->base;
+    src_img->offset  = prev_handle->offset;
+    src_img->mem_id  = prev_handle->fd;
+    src_img->paddr   = prev_handle->paddr;
+    src_img->usage   = prev_handle->usage;
+    src_img->uoffset = prev_handle->uoffset;
+    src_img->voffset = prev_handle->voffset;
+
+    dst_img->base    = win->addr[win->buf_index];
+}
+
+/*
+ * Reuse the fimc parameters of the window while the plan is unchanged,
+ * only the buffer addresses are taken from the new handle.
+ */
+static int get_src_dst_img_rect(exynos4_hwc_composer_device_1_t *pdev,
+        hwc_layer_1_t *cur,
+        struct hwc_win_info_t *win,
+        struct sec_img *src_img,
+        struct sec_img *dst_img,
+        struct sec_rect *src_rect,
+        struct sec_rect *dst_rect,
+        int win_idx)
+{
+    struct hwc_compos_plan *plan = &pdev->plan;
+    private_handle_t *prev_handle = (private_handle_t *)(cur->handle);
+
+    if (plan->fimc_valid[win_idx] &&
+        (plan->src_img[win_idx].format == (uint32_t)prev_handle->format) &&
+        (plan->src_img[win_idx].w == (uint32_t)prev_handle->width) &&
+        (plan->src_img[win_idx].h == (uint32_t)prev_handle->height)) {
+        *src_img  = plan->src_img[win_idx];
+        *dst_img  = plan->dst_img[win_idx];
+        *src_rect = plan->src_rect[win_idx];
+        *dst_rect = plan->dst_rect[win_idx];
+        update_src_dst_img_addr(cur, win, src_img, dst_img);
+        return 0;
+    }
+
+    set_src_dst_img_rect(cur, win, src_img, dst_img, src_rect, dst_rect, win_idx);
+
+    plan->src_img[win_idx]    = *src_img;
+    plan->dst_img[win_idx]    = *dst_img;
+    plan->src_rect[win_idx]   = *src_rect;
+    plan->dst_rect[win_idx]   = *dst_rect;
+    plan->fimc_valid[win_idx] = 1;
+
+    return 0;
+}
+
 static int get_hwc_compos_decision(hwc_layer_1_t *cur, int iter, int win_cnt)
 {
-  return HWC_FRAMEBUFFER;
+    /* FIMC/FIMD overlays are opt-in, see BOARD_USES_HWC_OVERLAY */
+#if !defined(BOARD_USES_HWC_OVERLAY) || defined(BOARD_NO_OVERLAY)
+    return HWC_FRAMEBUFFER;
+#endif
     if(cur->flags & HWC_SKIP_LAYER  || !cur->handle) {
         ALOGV("%s::is_skip_layer  %d  cur->handle %x ",  __func__, cur->flags & HWC_SKIP_LAYER, cur->handle);
         return HWC_FRAMEBUFFER;
@@ -393,6 +454,59 @@ static int get_hwc_compos_decision(hwc_layer_1_t *cur, int iter, int win_cnt)
     return  compositionType;
 }
 
+static void get_cost_layer(exynos4_hwc_composer_device_1_t *pdev, hwc_layer_1_t *cur,
+        struct hwc_cost_layer *layer)
+{
+    sec_rect rect;
+
+    memset(layer, 0, sizeof(*layer));
+    layer->overlay = (get_hwc_compos_decision(cur, 0, 0) == HWC_OVERLAY);
+    if (!layer->overlay && (!cur->handle || (cur->flags & HWC_SKIP_LAYER)))
+        return;
+
+    calculate_rect(&pdev->win[0], cur, &rect);
+
+    layer->format  = ((private_handle_t *)(cur->handle))->format;
+    layer->src_w   = WIDTH(cur->sourceCrop);
+    layer->src_h   = HEIGHT(cur->sourceCrop);
+    layer->win_w   = rect.w;
+    layer->win_h   = rect.h;
+    layer->rotated = (cur->transform & HAL_TRANSFORM_ROT_90) ? 1 : 0;
+    layer->blended = (cur->blending != HWC_BLENDING_NONE) ? 1 : 0;
+}
+
+/*
+ * Pick the layers to compose by FIMC and FIMD windows with the bus load
+ * model of SecHWCCost.cpp. The layer list is kept for exynos4_dump so that
+ * test/hwc_cost_sim can replay it.
+ */
+static int select_overlay_layers(exynos4_hwc_composer_device_1_t *pdev,
+        hwc_display_contents_1_t *contents, bool force_fb,
+        size_t *overlay_layer)
+{
+    struct hwc_cost_layer *layer = pdev->cost_layer;
+    int fb_bits = pdev->lcd_info.bits_per_pixel ? pdev->lcd_info.bits_per_pixel : 32;
+    int win_bits = pdev->win[0].lcd_info.bits_per_pixel ? pdev->win[0].lcd_info.bits_per_pixel : 32;
+    size_t num_layers = SEC_MIN(contents->numHwLayers, HWC_PLAN_MAX_LAYERS);
+
+    for (size_t i = 0; i < num_layers; i++) {
+        hwc_layer_1_t *cur = &contents->hwLayers[i];
+
+        if ((cur->compositionType == HWC_FRAMEBUFFER_TARGET) ||
+            (cur->compositionType == HWC_BACKGROUND)) {
+            memset(&layer[i], 0, sizeof(layer[i]));
+            continue;
+        }
+        get_cost_layer(pdev, cur, &layer[i]);
+    }
+    pdev->num_cost_layer = num_layers;
+
+    if (force_fb)
+        return 0;
+
+    return hwc_cost_select(layer, num_layers, NUM_OF_WIN, win_bits, fb_bits, overlay_layer);
+}
+
 static void reset_win_rect_info(hwc_win_info_t *win)
 {
     win->rect_info.x = 0;
@@ -449,6 +563,219 @@ static int assign_overlay_window(exynos4_hwc_composer_device_1_t *ctx, hwc_layer
     return 0;
 }
 
+static void get_plan_layer_key(hwc_layer_1_t *cur, struct hwc_plan_layer_key *key)
+{
+    memset(key, 0, sizeof(*key));
+
+    key->composition_target = (cur->compositionType == HWC_FRAMEBUFFER_TARGET);
+    key->flags              = cur->flags;
+    key->transform          = cur->transform;
+    key->blending           = cur->blending;
+    key->source_crop        = cur->sourceCrop;
+    key->display_frame      = cur->displayFrame;
+
+    if (cur->handle && !(cur->flags & HWC_SKIP_LAYER)) {
+        private_handle_t *prev_handle = (private_handle_t *)(cur->handle);
+
+        key->format = prev_handle->format;
+        key->usage  = prev_handle->usage;
+        key->width  = prev_handle->width;
+        key->height = prev_handle->height;
+    }
+}
+
+/* FNV-1a over the layer keys */
+static uint32_t get_plan_hash(const struct hwc_plan_layer_key *key, size_t num_layers,
+        int force_gpu)
+{
+    const uint8_t *data = (const uint8_t *)key;
+    uint32_t hash = 2166136261u;
+
+    for (size_t i = 0; i < num_layers * sizeof(*key); i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    hash ^= (uint32_t)force_gpu;
+    hash *= 16777619u;
+
+    return hash;
+}
+
+static void invalidate_compos_plan(exynos4_hwc_composer_device_1_t *pdev)
+{
+    pdev->plan.valid = 0;
+    for (int i = 0; i < NUM_OF_WIN; i++)
+        pdev->plan.fimc_valid[i] = 0;
+}
+
+static int replay_compos_plan(exynos4_hwc_composer_device_1_t *pdev,
+        hwc_display_contents_1_t *contents,
+        const struct hwc_plan_layer_key *key, uint32_t hash)
+{
+    struct hwc_compos_plan *plan = &pdev->plan;
+
+    if (!plan->valid ||
+        (plan->hash != hash) ||
+        (plan->num_layers != contents->numHwLayers) ||
+        (plan->force_gpu != pdev->force_gpu) ||
+        memcmp(plan->key, key, sizeof(*key) * contents->numHwLayers))
+        return -1;
+
+    for (size_t i = 0; i < contents->numHwLayers; i++) {
+        hwc_layer_1_t *layer = &contents->hwLayers[i];
+
+        if (layer->compositionType == HWC_FRAMEBUFFER_TARGET)
+            continue;
+
+        layer->compositionType = plan->composition_type[i];
+        layer->hints = plan->hints[i];
+    }
+
+    for (int i = 0; i < NUM_OF_WIN; i++) {
+        pdev->win[i].status = plan->win_status[i];
+        pdev->win[i].layer_index = plan->win_layer_index[i];
+    }
+
+    pdev->num_of_fb_layer = plan->num_of_fb_layer;
+    pdev->num_of_hwc_layer = plan->num_of_hwc_layer;
+    pdev->num_2d_blit_layer = plan->num_2d_blit_layer;
+
+    return 0;
+}
+
+static void save_compos_plan(exynos4_hwc_composer_device_1_t *pdev,
+        hwc_display_contents_1_t *contents,
+        const struct hwc_plan_layer_key *key, uint32_t hash)
+{
+    struct hwc_compos_plan *plan = &pdev->plan;
+
+    plan->hash = hash;
+    plan->num_layers = contents->numHwLayers;
+    plan->force_gpu = pdev->force_gpu;
+    memcpy(plan->key, key, sizeof(*key) * contents->numHwLayers);
+
+    for (size_t i = 0; i < contents->numHwLayers; i++) {
+        plan->composition_type[i] = contents->hwLayers[i].compositionType;
+        plan->hints[i] = contents->hwLayers[i].hints;
+    }
+
+    for (int i = 0; i < NUM_OF_WIN; i++) {
+        plan->win_status[i] = pdev->win[i].status;
+        plan->win_layer_index[i] = pdev->win[i].layer_index;
+    }
+
+    plan->num_of_fb_layer = pdev->num_of_fb_layer;
+    plan->num_of_hwc_layer = pdev->num_of_hwc_layer;
+    plan->num_2d_blit_layer = pdev->num_2d_blit_layer;
+    plan->valid = 1;
+}
+
+/*
+ * Side effects of a composition plan, run for a new plan and for a replayed
+ * one alike: the HDMI path and the free windows may have changed since the
+ * plan was saved.
+ */
+static void apply_compos_plan(exynos4_hwc_composer_device_1_t *pdev, int overlay_win_cnt)
+{
+    #if defined(BOARD_USES_HDMI)
+    android::SecHdmiClient *mHdmiClient = android::SecHdmiClient::getInstance();
+    mHdmiClient->setHdmiHwcLayer(pdev->num_of_hwc_layer);
+    #endif
+
+    if (overlay_win_cnt < NUM_OF_WIN) {
+        //turn off the free windows
+        for (int i = overlay_win_cnt; i < NUM_OF_WIN; i++) {
+            window_hide(&pdev->win[i]);
+            reset_win_rect_info(&pdev->win[i]);
+        }
+    }
+
+    // fimc stream is kept on between frames, release it when unused
+    if (overlay_win_cnt == 0)
+        stopFimc(pdev);
+}
+
+static inline bool is_rect_empty(const hwc_rect_t &rect)
+{
+    return (rect.right <= rect.left) || (rect.bottom <= rect.top);
+}
+
+static inline bool is_rect_equal(const hwc_rect_t &a, const hwc_rect_t &b)
+{
+    return (a.left == b.left) && (a.top == b.top) &&
+           (a.right == b.right) && (a.bottom == b.bottom);
+}
+
+static hwc_rect_t get_rect_union(const hwc_rect_t &a, const hwc_rect_t &b)
+{
+    hwc_rect_t rect;
+
+    if (is_rect_empty(a))
+        return b;
+    if (is_rect_empty(b))
+        return a;
+
+    rect.left   = SEC_MIN(a.left, b.left);
+    rect.top    = SEC_MIN(a.top, b.top);
+    rect.right  = SEC_MAX(a.right, b.right);
+    rect.bottom = SEC_MAX(a.bottom, b.bottom);
+
+    return rect;
+}
+
+/* record the changed region of every layer against the previous frame */
+static void update_layer_damage(exynos4_hwc_composer_device_1_t *pdev,
+        hwc_display_contents_1_t *contents)
+{
+    struct hwc_damage_tracker *tracker = &pdev->damage;
+    size_t num_layers = SEC_MIN(contents->numHwLayers, HWC_PLAN_MAX_LAYERS);
+
+    for (size_t i = 0; i < num_layers; i++) {
+        hwc_layer_1_t *cur = &contents->hwLayers[i];
+        struct hwc_layer_damage *prev = &tracker->layer[i];
+
+        if (i >= tracker->num_layers) {
+            prev->damage = cur->displayFrame;
+        } else if (!is_rect_equal(prev->display_frame, cur->displayFrame) ||
+                   !is_rect_equal(prev->source_crop, cur->sourceCrop) ||
+                   (prev->transform != cur->transform) ||
+                   (prev->blending != cur->blending)) {
+            prev->damage = get_rect_union(prev->display_frame, cur->displayFrame);
+        } else if (prev->handle != cur->handle) {
+            prev->damage = cur->displayFrame;
+        } else {
+            memset(&prev->damage, 0, sizeof(prev->damage));
+        }
+
+        prev->handle        = cur->handle;
+        prev->source_crop   = cur->sourceCrop;
+        prev->display_frame = cur->displayFrame;
+        prev->transform     = cur->transform;
+        prev->blending      = cur->blending;
+    }
+
+    tracker->num_layers = num_layers;
+}
+
+/*
+ * Forget the previous frame: every layer is damaged and the framebuffer
+ * target is posted again, e.g. after the panel lost its contents.
+ */
+static void reset_layer_damage(exynos4_hwc_composer_device_1_t *pdev)
+{
+    pdev->damage.num_layers = 0;
+    pdev->damage.fb_target = NULL;
+}
+
+static bool is_layer_damaged(exynos4_hwc_composer_device_1_t *pdev, int layer_idx)
+{
+    /* layers beyond the tracker are always considered damaged */
+    if ((layer_idx < 0) || ((size_t)layer_idx >= pdev->damage.num_layers))
+        return true;
+
+    return !is_rect_empty(pdev->damage.layer[layer_idx].damage);
+}
+
 #ifdef SKIP_DUMMY_UI_LAY_DRAWING
 static void get_hwc_ui_lay_skipdraw_decision(exynos4_hwc_composer_device_1_t *ctx,
                                hwc_display_contents_1_t* list)
@@ -475,7 +802,8 @@ static void get_hwc_ui_lay_skipdraw_decision(exynos4_hwc_composer_device_1_t *ct
     if (ctx->fb_lay_skip_initialized) {
         for (int cnt = 0; cnt < fb_lay_tot; cnt++) {
             cur = &list->hwLayers[ctx->win_virt[cnt].layer_index];
-            if (ctx->win_virt[cnt].layer_prev_buf == (uint32_t)cur->handle)
+            if ((ctx->win_virt[cnt].layer_prev_buf == (uint32_t)cur->handle) &&
+                !is_layer_damaged(ctx, ctx->win_virt[cnt].layer_index))
                 num_of_fb_lay_skip++;
         }
 #ifdef GL_WA_OVLY_ALL
@@ -554,6 +882,15 @@ static int exynos4_prepare_fimd(exynos4_hwc_composer_device_1_t *pdev,
     int overlay_win_cnt = 0;
     int compositionType = 0;
     int ret;
+    struct hwc_plan_layer_key key[HWC_PLAN_MAX_LAYERS];
+    bool cacheable = false;
+    uint32_t hash = 0;
+    size_t overlay_layer[NUM_OF_WIN];
+    int num_of_overlay = 0;
+    int next_overlay = 0;
+
+    if (contents)
+        update_layer_damage(pdev, contents);
 
 #ifdef SKIP_DUMMY_UI_LAY_DRAWING
     if ((contents && (!(contents->flags & HWC_GEOMETRY_CHANGED))) &&
@@ -578,6 +915,24 @@ static int exynos4_prepare_fimd(exynos4_hwc_composer_device_1_t *pdev,
     if (!contents || (!(contents->flags & HWC_GEOMETRY_CHANGED)))
         return 0;
 
+    // geometry changed flag is often set for an identical layer list
+    if (contents->numHwLayers <= HWC_PLAN_MAX_LAYERS) {
+        cacheable = true;
+        for (size_t i = 0; i < contents->numHwLayers; i++)
+            get_plan_layer_key(&contents->hwLayers[i], &key[i]);
+        hash = get_plan_hash(key, contents->numHwLayers, pdev->force_gpu);
+
+        if (replay_compos_plan(pdev, contents, key, hash) == 0) {
+            pdev->prepare_stat.plan_hits++;
+            apply_compos_plan(pdev, pdev->num_of_hwc_layer);
+            return 0;
+        }
+    }
+    pdev->prepare_stat.plan_misses++;
+    invalidate_compos_plan(pdev);
+    // the framebuffer target is reconfigured with the windows
+    pdev->damage.fb_target = NULL;
+
     //all the windows are free here....
     for (int i = 0 ; i < NUM_OF_WIN; i++) {
         pdev->win[i].status = HWC_WIN_FREE;
@@ -589,6 +944,8 @@ static int exynos4_prepare_fimd(exynos4_hwc_composer_device_1_t *pdev,
     pdev->num_2d_blit_layer = 0;
 
 
+    num_of_overlay = select_overlay_layers(pdev, contents, force_fb, overlay_layer);
+
     // find unsupported overlays
     for (size_t i = 0; i < contents->numHwLayers; i++) {
         hwc_layer_1_t *layer = &contents->hwLayers[i];
@@ -607,7 +964,11 @@ static int exynos4_prepare_fimd(exynos4_hwc_composer_device_1_t *pdev,
         }
         
         if (overlay_win_cnt < NUM_OF_WIN) {
-            compositionType = get_hwc_compos_decision(layer, 0, overlay_win_cnt);
+            compositionType = HWC_FRAMEBUFFER;
+            if ((next_overlay < num_of_overlay) && (overlay_layer[next_overlay] == i)) {
+                compositionType = HWC_OVERLAY;
+                next_overlay++;
+            }
 
             if (compositionType == HWC_FRAMEBUFFER) {
                 layer->compositionType = HWC_FRAMEBUFFER;
@@ -636,23 +997,15 @@ static int exynos4_prepare_fimd(exynos4_hwc_composer_device_1_t *pdev,
 
 
 
-    #if defined(BOARD_USES_HDMI)
-    android::SecHdmiClient *mHdmiClient = android::SecHdmiClient::getInstance();
-    mHdmiClient->setHdmiHwcLayer(pdev->num_of_hwc_layer);
-    #endif
-
     if (contents->numHwLayers < (pdev->num_of_fb_layer + pdev->num_of_hwc_layer))
         ALOGD("%s:: numHwLayers %d num_of_fb_layer %d num_of_hwc_layer %d ",
                 __func__, contents->numHwLayers, pdev->num_of_fb_layer,
                 pdev->num_of_hwc_layer);
 
-    if (overlay_win_cnt < NUM_OF_WIN) {
-        //turn off the free windows
-        for (int i = overlay_win_cnt; i < NUM_OF_WIN; i++) {
-            window_hide(&pdev->win[i]);
-            reset_win_rect_info(&pdev->win[i]);
-        }
-    }
+    apply_compos_plan(pdev, overlay_win_cnt);
+
+    if (cacheable)
+        save_compos_plan(pdev, contents, key, hash);
 
     return 0;
 }
@@ -667,14 +1020,20 @@ static int exynos4_prepare(hwc_composer_device_1_t *dev,
             (exynos4_hwc_composer_device_1_t *)dev;
     hwc_display_contents_1_t *fimd_contents = displays[HWC_DISPLAY_PRIMARY];
     hwc_display_contents_1_t *hdmi_contents = displays[HWC_DISPLAY_EXTERNAL];
+    nsecs_t start = systemTime(SYSTEM_TIME_MONOTONIC);
+    int err = 0;
 
-    if (fimd_contents) {
-        int err = exynos4_prepare_fimd(pdev, fimd_contents);
-        if (err)
-            return err;
-    }
+    if (fimd_contents)
+        err = exynos4_prepare_fimd(pdev, fimd_contents);
 
-    return 0;
+    struct hwc_prepare_stat *stat = &pdev->prepare_stat;
+    stat->last_ns = systemTime(SYSTEM_TIME_MONOTONIC) - start;
+    stat->total_ns += stat->last_ns;
+    if (stat->last_ns > stat->max_ns)
+        stat->max_ns = stat->last_ns;
+    stat->frames++;
+
+    return err;
 }
 
 static int exynos4_post_fimd(exynos4_hwc_composer_device_1_t *pdev,
@@ -709,6 +1068,9 @@ static int exynos4_post_fimd(exynos4_hwc_composer_device_1_t *pdev,
             pdev->win[i].status = HWC_WIN_FREE;
         }
         pdev->num_of_hwc_layer = 0;
+        invalidate_compos_plan(pdev);
+        reset_layer_damage(pdev);
+        stopFimc(pdev);
         ALOGE("%s: NULL contents!", __func__);
         return -1;
     }
@@ -729,7 +1091,13 @@ static int exynos4_post_fimd(exynos4_hwc_composer_device_1_t *pdev,
             ALOGV("framebuffer target buffer:");
             dump_layer(fb_layer);
             
-            pdev->fb_device->post(pdev->fb_device, fb_layer->handle);
+            if (fb_layer->handle != pdev->damage.fb_target) {
+                pdev->fb_device->post(pdev->fb_device, fb_layer->handle);
+                pdev->damage.fb_target = fb_layer->handle;
+            } else {
+                // nothing was composed into the framebuffer since last post
+                pdev->damage.skipped_fb_post++;
+            }
         }
     }
 
@@ -743,13 +1111,16 @@ static int exynos4_post_fimd(exynos4_hwc_composer_device_1_t *pdev,
             cur = &contents->hwLayers[win->layer_index];
 
             if (cur->compositionType == HWC_OVERLAY) {
-                if (pdev->layer_prev_buf[i] == (uint32_t)cur->handle) {
+                if ((pdev->layer_prev_buf[i] == (uint32_t)cur->handle) &&
+                    !is_layer_damaged(pdev, win->layer_index)) {
                     /*
                      * In android platform, all the graphic buffer are at least
                      * double buffered (2 or more) this buffer is already rendered.
                      * It is the redundant src buffer for FIMC rendering.
+                     * A crop or transform change of the same buffer is damage.
                      */
                     ALOGV("%s:: Same buffer, no need to pan display!", __func__);
+                    pdev->damage.skipped_fimc++;
                     #if defined(BOARD_USES_HDMI)
                     skip_hdmi_rendering = 1;
                     #endif
@@ -757,7 +1128,7 @@ static int exynos4_post_fimd(exynos4_hwc_composer_device_1_t *pdev,
                 }
                 pdev->layer_prev_buf[i] = (uint32_t)cur->handle;
                 // initialize the src & dist context for fimc
-                set_src_dst_img_rect(cur, win, &src_img, &dst_img,
+                get_src_dst_img_rect(pdev, cur, win, &src_img, &dst_img,
                                 &src_work_rect, &dst_work_rect, i);
 
                 ALOGV("%s:: Overlay runFimc!", __func__);
@@ -799,6 +1170,8 @@ static int exynos4_post_fimd(exynos4_hwc_composer_device_1_t *pdev,
                 reset_win_rect_info(&pdev->win[i]);
             }
         }
+        // window position is lost, next geometry change must assign again
+        invalidate_compos_plan(pdev);
     }
 
 #if defined(BOARD_USES_HDMI)
@@ -1069,6 +1442,8 @@ static int exynos4_blank(struct hwc_composer_device_1 *dev, int disp, int blank)
                         strerror(errno));
             return -errno;
         }
+        // the panel does not keep the last frame over blank
+        reset_layer_damage(pdev);
         break;
     }
 
@@ -1123,6 +1498,37 @@ static void exynos4_dump(hwc_composer_device_1* dev, char *buff, int buff_len)
         result.append("\n");
     }
     */
+
+    struct hwc_prepare_stat *stat = &pdev->prepare_stat;
+    result.appendFormat("  prepare: frames %llu, last %lld us, avg %lld us, max %lld us\n",
+            (unsigned long long)stat->frames,
+            (long long)ns2us(stat->last_ns),
+            (long long)(stat->frames ? ns2us(stat->total_ns / (int64_t)stat->frames) : 0),
+            (long long)ns2us(stat->max_ns));
+    result.appendFormat("  composition plan: hit %llu, miss %llu\n",
+            (unsigned long long)stat->plan_hits,
+            (unsigned long long)stat->plan_misses);
+    result.appendFormat("  damage: skipped fimc %llu, skipped fb post %llu\n",
+            (unsigned long long)pdev->damage.skipped_fimc,
+            (unsigned long long)pdev->damage.skipped_fb_post);
+    result.appendFormat("  fimc: frames %llu, fast %llu, reconfig %llu\n",
+            (unsigned long long)pdev->fimc_state.frames,
+            (unsigned long long)pdev->fimc_state.fast_frames,
+            (unsigned long long)pdev->fimc_state.reconfigs);
+
+    // replayable by test/hwc_cost_sim
+    result.appendFormat("  cost-list win_bits=%d fb_bits=%d windows=%d\n",
+            pdev->win[0].lcd_info.bits_per_pixel ? pdev->win[0].lcd_info.bits_per_pixel : 32,
+            pdev->lcd_info.bits_per_pixel ? pdev->lcd_info.bits_per_pixel : 32,
+            NUM_OF_WIN);
+    for (size_t i = 0; i < pdev->num_cost_layer; i++) {
+        struct hwc_cost_layer *layer = &pdev->cost_layer[i];
+
+        result.appendFormat("    cost-layer fmt=0x%x src=%dx%d win=%dx%d rot=%d blend=%d ovl=%d\n",
+                layer->format, layer->src_w, layer->src_h, layer->win_w, layer->win_h,
+                layer->rotated, layer->blended, layer->overlay);
+    }
+
     strlcpy(buff, result.string(), buff_len);
 }
 
@@ -1375,6 +1781,7 @@ static int exynos4_close(hw_device_t *device)
     pthread_join(dev->vsync_thread, NULL);
     int i;
 
+    stopFimc(dev);
     if (destroyFimc(&dev->fimc) < 0) {
         ALOGE("%s::destroyFimc fail", __func__);
     }
@@ -0,0 +1,74 @@
+# Copyright (C) 2008 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+LOCAL_PATH:= $(call my-dir)
+
+# overlay cost model replay: hwc_cost_sim $(LOCAL_PATH)/layers.txt
+include $(CLEAR_VARS)
+LOCAL_SRC_FILES := hwc_cost_sim.cpp ../SecHWCCost.cpp
+LOCAL_C_INCLUDES := \
+	$(LOCAL_PATH)/.. \
+	$(LOCAL_PATH)/../../include
+LOCAL_MODULE := hwc_cost_sim
+LOCAL_MODULE_TAGS := tests
+include $(BUILD_HOST_EXECUTABLE)
+
+# plane copy of memcpy_rect(): hwc_copy_bench [iterations]
+include $(CLEAR_VARS)
+LOCAL_SRC_FILES := hwc_copy_bench.cpp ../SecHWCCopy.cpp ../SecHWCLog.cpp
+LOCAL_C_INCLUDES := \
+	$(LOCAL_PATH)/.. \
+	$(LOCAL_PATH)/../../include \
+	$(LOCAL_PATH)/../../libexynosutils \
+	$(LOCAL_PATH)/../../libfimg
+LOCAL_SHARED_LIBRARIES := liblog libcutils libhardware libutils
+ifeq ($(TARGET_SOC),exynos4210)
+LOCAL_CFLAGS += -DSAMSUNG_EXYNOS4210
+endif
+ifeq ($(TARGET_SOC),exynos4x12)
+LOCAL_CFLAGS += -DSAMSUNG_EXYNOS4x12
+endif
+ifneq ($(BOARD_HWC_COPY_THREADS),)
+LOCAL_CFLAGS += -DHWC_COPY_NUM_WORKERS=$(BOARD_HWC_COPY_THREADS)
+endif
+LOCAL_MODULE := hwc_copy_bench
+LOCAL_MODULE_TAGS := tests
+include $(BUILD_EXECUTABLE)
+
+# V4L2 ioctls per video frame of runFimc() against a stubbed FIMC node
+include $(CLEAR_VARS)
+LOCAL_SRC_FILES := hwc_fimc_bench.cpp \
+	../SecHWCUtils.cpp ../SecHWCLog.cpp ../SecHWCCopy.cpp ../SecHWCCost.cpp
+LOCAL_C_INCLUDES := \
+	$(LOCAL_PATH)/.. \
+	$(LOCAL_PATH)/../../include \
+	$(LOCAL_PATH)/../../libexynosutils \
+	$(LOCAL_PATH)/../../libfimg
+LOCAL_SHARED_LIBRARIES := liblog libcutils libhardware libutils libion
+LOCAL_LDFLAGS := -Wl,--wrap=ioctl
+ifeq ($(TARGET_SOC),exynos4210)
+LOCAL_CFLAGS += -DSAMSUNG_EXYNOS4210
+endif
+ifeq ($(TARGET_SOC),exynos4x12)
+LOCAL_CFLAGS += -DSAMSUNG_EXYNOS4x12
+endif
+ifeq ($(BOARD_USE_V4L2),true)
+LOCAL_CFLAGS += -DBOARD_USE_V4L2
+endif
+ifeq ($(BOARD_USE_V4L2_ION),true)
+LOCAL_CFLAGS += -DBOARD_USE_V4L2_ION
+endif
+LOCAL_MODULE := hwc_fimc_bench
+LOCAL_MODULE_TAGS := tests
+include $(BUILD_EXECUTABLE)
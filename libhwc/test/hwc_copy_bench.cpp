@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2010 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Times the YV12 plane copies of memcpy_rect() at common video sizes:
+ * "rows" is the former row by row memcpy, "plane" is hwc_copy_plane().
+ * The real width is cropped below the stride, so the linear fast path of
+ * hwc_copy_plane() is not taken. Every result is checked against "rows".
+ *
+ * usage: hwc_copy_bench [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "SecHWCUtils.h"
+
+struct copy_size {
+    const char *name;
+    int        full_w;
+    int        full_h;
+    int        real_w;
+    int        real_h;
+};
+
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void copy_rows(unsigned char *dst, int dst_stride, const unsigned char *src,
+        int src_stride, int width, int height)
+{
+    for (int i = 0; i < height; i++)
+        memcpy(dst + i * dst_stride, src + i * src_stride, width);
+}
+
+/* Y, Cr and Cb planes of one frame, laid out as memcpy_rect() does */
+static void copy_frame(bool plane, unsigned char *dst, const unsigned char *src,
+        const struct copy_size *size)
+{
+    int cb_full_w = size->full_w >> 1;
+    int cb_full_h = size->full_h >> 1;
+    int cb_real_w = size->real_w >> 1;
+    int cb_real_h = size->real_h >> 1;
+    const unsigned char *src_c = src + size->full_w * size->full_h;
+    unsigned char *dst_c = dst + size->full_w * size->full_h;
+
+    if (plane) {
+        hwc_copy_plane(dst, size->full_w, src, size->full_w, size->real_w, size->real_h);
+        for (int i = 0; i < 2; i++)
+            hwc_copy_plane(dst_c + i * cb_full_w * cb_full_h, cb_full_w,
+                    src_c + i * cb_full_w * cb_full_h, cb_full_w, cb_real_w, cb_real_h);
+    } else {
+        copy_rows(dst, size->full_w, src, size->full_w, size->real_w, size->real_h);
+        for (int i = 0; i < 2; i++)
+            copy_rows(dst_c + i * cb_full_w * cb_full_h, cb_full_w,
+                    src_c + i * cb_full_w * cb_full_h, cb_full_w, cb_real_w, cb_real_h);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    static const struct copy_size sizes[] = {
+        { "QCIF",  192,  144,  176,  144  },
+        { "VGA",   672,  480,  640,  480  },
+        { "WVGA",  832,  480,  800,  480  },
+        { "720p",  1280, 736,  1272, 720  },
+        { "1080p", 1920, 1088, 1912, 1080 },
+    };
+    int iterations = (argc > 1) ? atoi(argv[1]) : 100;
+    int ret = 0;
+
+    if (iterations <= 0)
+        iterations = 100;
+
+    printf("%-6s %11s | %9s %9s | %9s %9s | %s\n", "size", "real", "rows ms", "MB/s",
+            "plane ms", "MB/s", "speedup");
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        const struct copy_size *size = &sizes[s];
+        size_t frame_size = size->full_w * size->full_h * 3 / 2;
+        double bytes = (double)size->real_w * size->real_h * 3 / 2;
+        unsigned char *src = (unsigned char *)malloc(frame_size);
+        unsigned char *ref = (unsigned char *)calloc(1, frame_size);
+        unsigned char *dst = (unsigned char *)calloc(1, frame_size);
+        int64_t rows_ns, plane_ns;
+
+        if ((src == NULL) || (ref == NULL) || (dst == NULL)) {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+        for (size_t i = 0; i < frame_size; i++)
+            src[i] = (unsigned char)(i * 7 + (i >> 11));
+
+        copy_frame(false, ref, src, size);
+        copy_frame(true, dst, src, size);
+        if (memcmp(ref, dst, frame_size)) {
+            printf("%-6s mismatch between rows and plane copy\n", size->name);
+            ret = 1;
+        }
+
+        rows_ns = now_ns();
+        for (int i = 0; i < iterations; i++)
+            copy_frame(false, dst, src, size);
+        rows_ns = now_ns() - rows_ns;
+
+        plane_ns = now_ns();
+        for (int i = 0; i < iterations; i++)
+            copy_frame(true, dst, src, size);
+        plane_ns = now_ns() - plane_ns;
+
+        printf("%-6s %5dx%-5d | %9.3f %9.1f | %9.3f %9.1f | %.2fx\n",
+                size->name, size->real_w, size->real_h,
+                rows_ns / 1e6 / iterations, bytes * iterations / (rows_ns / 1e3),
+                plane_ns / 1e6 / iterations, bytes * iterations / (plane_ns / 1e3),
+                (double)rows_ns / plane_ns);
+
+        free(src);
+        free(ref);
+        free(dst);
+    }
+
+    return ret;
+}
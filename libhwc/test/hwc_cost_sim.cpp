@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2010 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Replays layer lists dumped by exynos4_dump ("dumpsys SurfaceFlinger")
+ * through the overlay cost model and compares the assignment strategies:
+ *
+ *   gpu    every layer composed by GPU
+ *   order  first eligible layers in layer order, the former assignment
+ *   cost   hwc_cost_select(), the current assignment
+ *   best   exhaustive search over every window set
+ *
+ * usage: hwc_cost_sim [-w windows] dump...
+ * Returns 1 if "cost" is ever worse than "best".
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "SecHWCCost.h"
+
+#define MAX_LAYERS  (32)
+
+struct cost_list {
+    int                   win_bits;
+    int                   fb_bits;
+    int                   windows;
+    size_t                num_layers;
+    struct hwc_cost_layer layer[MAX_LAYERS];
+};
+
+struct cost_total {
+    int64_t gpu;
+    int64_t order;
+    int64_t cost;
+    int64_t best;
+};
+
+static int select_in_order(const struct cost_list *list, size_t *overlay_layer)
+{
+    int num = 0;
+
+    for (size_t i = 0; (i < list->num_layers) && (num < list->windows); i++) {
+        if (list->layer[i].overlay)
+            overlay_layer[num++] = i;
+    }
+
+    return num;
+}
+
+/* try every window set of up to list->windows eligible layers, in layer order */
+static void search_best(const struct cost_list *list, size_t first, size_t *overlay_layer,
+        int num, int64_t *best)
+{
+    int64_t cost = hwc_cost_frame(list->layer, list->num_layers, overlay_layer, num,
+            list->win_bits, list->fb_bits);
+
+    if ((*best < 0) || (cost < *best))
+        *best = cost;
+    if (num == list->windows)
+        return;
+
+    for (size_t i = first; i < list->num_layers; i++) {
+        if (!list->layer[i].overlay)
+            continue;
+        overlay_layer[num] = i;
+        search_best(list, i + 1, overlay_layer, num + 1, best);
+    }
+}
+
+static int64_t best_cost(const struct cost_list *list)
+{
+    size_t overlay_layer[HWC_COST_MAX_WIN];
+    int64_t best = -1;
+
+    search_best(list, 0, overlay_layer, 0, &best);
+    return best;
+}
+
+static int replay(const struct cost_list *list, int index, struct cost_total *total)
+{
+    size_t overlay_layer[MAX_LAYERS];
+    int64_t gpu, order, cost, best;
+    int num;
+
+    gpu = hwc_cost_frame(list->layer, list->num_layers, NULL, 0,
+            list->win_bits, list->fb_bits);
+
+    num = select_in_order(list, overlay_layer);
+    order = hwc_cost_frame(list->layer, list->num_layers, overlay_layer, num,
+            list->win_bits, list->fb_bits);
+
+    num = hwc_cost_select(list->layer, list->num_layers, list->windows,
+            list->win_bits, list->fb_bits, overlay_layer);
+    cost = hwc_cost_frame(list->layer, list->num_layers, overlay_layer, num,
+            list->win_bits, list->fb_bits);
+
+    best = best_cost(list);
+
+    printf("list %3d: %2u layers, %d windows | gpu %9lld | order %9lld | cost %9lld | best %9lld%s\n",
+            index, (unsigned)list->num_layers, list->windows,
+            (long long)gpu, (long long)order, (long long)cost, (long long)best,
+            (cost > best) ? "  <-- not optimal" : "");
+
+    total->gpu   += gpu;
+    total->order += order;
+    total->cost  += cost;
+    total->best  += best;
+
+    return (cost > best) ? -1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    struct cost_list list;
+    struct cost_total total;
+    int windows = 0;
+    int num_lists = 0;
+    int ret = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "w:")) != -1) {
+        switch (opt) {
+        case 'w':
+            windows = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-w windows] dump...\n", argv[0]);
+            return 2;
+        }
+    }
+    if (optind >= argc) {
+        fprintf(stderr, "usage: %s [-w windows] dump...\n", argv[0]);
+        return 2;
+    }
+    if (windows > HWC_COST_MAX_WIN)
+        windows = HWC_COST_MAX_WIN;
+
+    memset(&list, 0, sizeof(list));
+    memset(&total, 0, sizeof(total));
+
+    for (int f = optind; f < argc; f++) {
+        FILE *fp = fopen(argv[f], "r");
+        char line[256];
+        int in_list = 0;
+
+        if (fp == NULL) {
+            perror(argv[f]);
+            return 2;
+        }
+
+        while (1) {
+            char *eof = fgets(line, sizeof(line), fp);
+            struct hwc_cost_layer *layer = &list.layer[list.num_layers];
+            const char *p = eof ? line + strspn(line, " \t") : "";
+
+            if (in_list && eof && !strncmp(p, "cost-layer ", 11) &&
+                (list.num_layers < MAX_LAYERS)) {
+                memset(layer, 0, sizeof(*layer));
+                if (sscanf(p, "cost-layer fmt=%x src=%dx%d win=%dx%d rot=%d blend=%d ovl=%d",
+                           (unsigned int *)&layer->format, &layer->src_w, &layer->src_h,
+                           &layer->win_w, &layer->win_h, &layer->rotated,
+                           &layer->blended, &layer->overlay) == 8) {
+                    list.num_layers++;
+                    continue;
+                }
+            }
+
+            // any other line ends the list
+            if (in_list) {
+                if (replay(&list, num_lists++, &total) < 0)
+                    ret = 1;
+                in_list = 0;
+            }
+            if (!eof)
+                break;
+
+            memset(&list, 0, sizeof(list));
+            if (sscanf(p, "cost-list win_bits=%d fb_bits=%d windows=%d",
+                       &list.win_bits, &list.fb_bits, &list.windows) == 3) {
+                if (windows > 0)
+                    list.windows = windows;
+                if (list.windows > HWC_COST_MAX_WIN)
+                    list.windows = HWC_COST_MAX_WIN;
+                in_list = 1;
+            }
+        }
+
+        fclose(fp);
+    }
+
+    if (num_lists == 0) {
+        fprintf(stderr, "no cost-list found\n");
+        return 2;
+    }
+
+    printf("total (%d lists): gpu %lld, order %lld, cost %lld, best %lld bytes/frame\n",
+            num_lists, (long long)total.gpu, (long long)total.order,
+            (long long)total.cost, (long long)total.best);
+
+    return ret;
+}
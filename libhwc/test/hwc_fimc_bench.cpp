@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2010 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Counts the V4L2 ioctls runFimc() issues per video frame against a stubbed
+ * FIMC node. The module is linked with -Wl,--wrap=ioctl, so every ioctl of
+ * SecHWCUtils.cpp lands in __wrap_ioctl() below and no device is opened.
+ *
+ * Each scenario runs twice: "delta" is runFimc() as is, "full" stops FIMC
+ * before every frame, which reprograms the whole configuration per frame
+ * as runFimcCore() did before the configuration was kept.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "SecHWCUtils.h"
+
+#define STUB_FIMC_FD    (1000)
+#define NUM_SRC_BUF     (3)
+#define DST_BUF_SIZE    (800 * 480 * 4)
+
+struct ioctl_count {
+    unsigned long request;
+    const char    *name;
+    unsigned int  count;
+};
+
+static struct ioctl_count ioctl_counts[] = {
+    { VIDIOC_S_FMT,     "S_FMT",     0 },
+    { VIDIOC_S_CROP,    "S_CROP",    0 },
+    { VIDIOC_S_CTRL,    "S_CTRL",    0 },
+    { VIDIOC_G_FBUF,    "G_FBUF",    0 },
+    { VIDIOC_S_FBUF,    "S_FBUF",    0 },
+    { VIDIOC_REQBUFS,   "REQBUFS",   0 },
+    { VIDIOC_STREAMON,  "STREAMON",  0 },
+    { VIDIOC_STREAMOFF, "STREAMOFF", 0 },
+    { VIDIOC_QBUF,      "QBUF",      0 },
+    { VIDIOC_DQBUF,     "DQBUF",     0 },
+};
+#define NUM_IOCTL_COUNTS    (sizeof(ioctl_counts) / sizeof(ioctl_counts[0]))
+
+static unsigned int other_ioctls;
+
+extern "C" int __wrap_ioctl(int fd, unsigned long request, ...)
+{
+    unsigned int req = (unsigned int)request;
+    size_t i;
+    va_list ap;
+    void *arg;
+
+    va_start(ap, request);
+    arg = va_arg(ap, void *);
+    va_end(ap);
+
+    if (fd != STUB_FIMC_FD) {
+        other_ioctls++;
+        return 0;
+    }
+
+    for (i = 0; i < NUM_IOCTL_COUNTS; i++) {
+        if ((unsigned int)ioctl_counts[i].request == req) {
+            ioctl_counts[i].count++;
+            break;
+        }
+    }
+    if (i == NUM_IOCTL_COUNTS)
+        other_ioctls++;
+
+    if (req == (unsigned int)VIDIOC_DQBUF)
+        ((struct v4l2_buffer *)arg)->index = 0;
+
+    return 0;
+}
+
+static unsigned int total_ioctls(void)
+{
+    unsigned int total = other_ioctls;
+
+    for (size_t i = 0; i < NUM_IOCTL_COUNTS; i++)
+        total += ioctl_counts[i].count;
+
+    return total;
+}
+
+static void reset_counts(void)
+{
+    for (size_t i = 0; i < NUM_IOCTL_COUNTS; i++)
+        ioctl_counts[i].count = 0;
+    other_ioctls = 0;
+}
+
+/* physical addresses of the decoded frames, as MFC hands them over */
+static ADDRS src_addrs[NUM_SRC_BUF];
+
+struct scenario {
+    const char *name;
+    int        frames;
+    int        rotate_every;    /* toggle 0/90 degrees, 0 for never */
+    int        crop_every;      /* change the source crop, 0 for never */
+};
+
+static void run(struct exynos4_hwc_composer_device_1_t *ctx, const struct scenario *sc,
+        bool full)
+{
+    struct sec_img src_img;
+    struct sec_img dst_img;
+    struct sec_rect src_rect;
+    struct sec_rect dst_rect;
+    uint32_t transform = 0;
+    int failed = 0;
+
+    memset(&ctx->fimc_state, 0, sizeof(ctx->fimc_state));
+    reset_counts();
+
+    memset(&src_img, 0, sizeof(src_img));
+    src_img.f_w      = 1280;
+    src_img.f_h      = 720;
+    src_img.w        = 1280;
+    src_img.h        = 720;
+    src_img.format   = HAL_PIXEL_FORMAT_CUSTOM_YCbCr_420_SP;
+    src_img.mem_type = HWC_VIRT_MEM_TYPE;
+
+    memset(&dst_img, 0, sizeof(dst_img));
+    dst_img.f_w      = 800;
+    dst_img.f_h      = 480;
+    dst_img.w        = 800;
+    dst_img.h        = 480;
+    dst_img.format   = HAL_PIXEL_FORMAT_RGBX_8888;
+
+    src_rect.x = 0;
+    src_rect.y = 0;
+    src_rect.w = 1280;
+    src_rect.h = 720;
+
+    dst_rect.x = 0;
+    dst_rect.y = 15;
+    dst_rect.w = 800;
+    dst_rect.h = 450;
+
+    for (int i = 0; i < sc->frames; i++) {
+        if (sc->rotate_every && i && !(i % sc->rotate_every))
+            transform = transform ? 0 : HAL_TRANSFORM_ROT_90;
+        if (sc->crop_every && i && !(i % sc->crop_every))
+            src_rect.h = (src_rect.h == 720) ? 704 : 720;
+
+        src_img.base = (uint32_t)(uintptr_t)&src_addrs[i % NUM_SRC_BUF];
+        /* the window buffer rotates every frame, as win->buf_index in hwc.cpp */
+        dst_img.base = 0x60000000 + (i % NUM_OF_WIN_BUF) * DST_BUF_SIZE;
+
+        if (full)
+            stopFimc(ctx);
+        if (runFimc(ctx, &src_img, &src_rect, &dst_img, &dst_rect, transform) < 0)
+            failed++;
+    }
+    stopFimc(ctx);
+
+    printf("%-8s %-5s %4d frames: %5u ioctls, %5.2f/frame |",
+            sc->name, full ? "full" : "delta", sc->frames, total_ioctls(),
+            (double)total_ioctls() / sc->frames);
+    for (size_t i = 0; i < NUM_IOCTL_COUNTS; i++) {
+        if (ioctl_counts[i].count)
+            printf(" %s %u", ioctl_counts[i].name, ioctl_counts[i].count);
+    }
+    if (failed)
+        printf(" (%d frames failed)", failed);
+    printf("\n");
+}
+
+int main(void)
+{
+    static struct exynos4_hwc_composer_device_1_t ctx;
+    static const struct scenario scenarios[] = {
+        { "steady", 300, 0,  0  },
+        { "rotate", 300, 60, 0  },
+        { "crop",   300, 0,  30 },
+    };
+
+    for (int i = 0; i < NUM_SRC_BUF; i++) {
+        src_addrs[i].addr_y    = 0x50000000 + i * 0x200000;
+        src_addrs[i].addr_cbcr = src_addrs[i].addr_y + 1280 * 720;
+        src_addrs[i].buf_idx   = i;
+    }
+
+    ctx.fimc.dev_fd = STUB_FIMC_FD;
+    ctx.fimc.hw_ver = 0x50;
+
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        run(&ctx, &scenarios[i], true);
+        run(&ctx, &scenarios[i], false);
+    }
+
+    return 0;
+}
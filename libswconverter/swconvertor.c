@@ -30,8 +30,12 @@
 
 #include "stdio.h"
 #include "stdlib.h"
+#include "string.h"
 #include "swconverter.h"
 
+#define NV12T_TILE_WIDTH    64
+#define NV12T_TILE_HEIGHT   32
+
 /*
  * Get tiled address of position(x,y)
  *
@@ -91,6 +95,48 @@ static int tile_4x2_read(int x_size, int y_size, int x_pos, int y_pos)
     return trans_addr;
 }
 
+/*
+ * Get offset of 64x32 tile(x_index, y_index) in NV12T plane
+ *
+ * @param x_index
+ *   horizontal tile index[in]
+ *
+ * @param y_index
+ *   vertical tile index[in]
+ *
+ * @param width
+ *   width of plane[in]
+ *
+ * @param height
+ *   Y: height of plane, UV: height/2 of plane[in]
+ *
+ * @return
+ *   byte offset of the tile
+ */
+static unsigned int tile_64x32_offset(
+    unsigned int x_index,
+    unsigned int y_index,
+    unsigned int width,
+    unsigned int height)
+{
+    unsigned int x_block_num = ((width + 127) >> 7) << 1;
+    unsigned int aligned_height = ((height + 31) >> 5) << 5;
+    unsigned int tiled_offset;
+
+    if (y_index & 0x1) {
+        /* odd fomula: 2+x+(x>>2)<<2+x_block_num*(y-1) */
+        tiled_offset = x_index + 2 + ((x_index >> 2) << 2) + x_block_num * (y_index - 1);
+    } else if (((y_index << 5) + 32) < aligned_height) {
+        /* even1 fomula: x+((x+2)>>2)<<2+x_block_num*y */
+        tiled_offset = x_index + (((x_index + 2) >> 2) << 2) + x_block_num * y_index;
+    } else {
+        /* even2 fomula: x+x_block_num*y */
+        tiled_offset = x_index + x_block_num * y_index;
+    }
+
+    return tiled_offset << 11;
+}
+
 /*
  * De-interleaves src to dest1, dest2
  *
@@ -1978,3 +2024,318 @@ void csc_RGBA8888_to_YUV420SP(
 }
 
 
+
+/*
+ * Converts RGB8888 to NV12T in a single pass
+ * Y and UV are written directly to 64x32 tiles
+ *
+ * @param y_dst
+ *   Y plane address of NV12T[out]
+ *
+ * @param uv_dst
+ *   UV plane address of NV12T[out]
+ *
+ * @param rgb_src
+ *   Address of RGB8888[in]
+ *
+ * @param width
+ *   Width of RGB8888[in]
+ *   it should be even
+ *
+ * @param height
+ *   Height of RGB8888[in]
+ *   it should be even
+ *
+ * @param r_shift
+ *   Bit position of R in a pixel word[in]
+ *
+ * @param b_shift
+ *   Bit position of B in a pixel word[in]
+ */
+static void csc_RGB8888_to_NV12T(
+    unsigned char *y_dst,
+    unsigned char *uv_dst,
+    unsigned char *rgb_src,
+    unsigned int width,
+    unsigned int height,
+    unsigned int r_shift,
+    unsigned int b_shift)
+{
+    unsigned int i, j, k, l;
+    unsigned int tmp;
+    unsigned int span;
+    int R, G, B;
+    int U, V;
+
+    unsigned int *pSrc = (unsigned int *)rgb_src;
+    unsigned int *pSrcLine;
+    unsigned char *pDstY;
+    unsigned char *pDstUV;
+
+    for (j = 0; j < height; j += 2) {
+        for (i = 0; i < width; i += NV12T_TILE_WIDTH) {
+            span = width - i;
+            if (span > NV12T_TILE_WIDTH)
+                span = NV12T_TILE_WIDTH;
+
+            pDstUV = uv_dst
+                   + tile_64x32_offset(i >> 6, (j >> 1) >> 5, width, height >> 1)
+                   + NV12T_TILE_WIDTH * ((j >> 1) & 0x1F);
+
+            for (l = 0; l < 2; l++) {
+                pSrcLine = pSrc + (j + l) * width + i;
+                pDstY = y_dst
+                      + tile_64x32_offset(i >> 6, (j + l) >> 5, width, height)
+                      + NV12T_TILE_WIDTH * ((j + l) & 0x1F);
+
+                for (k = 0; k < span; k++) {
+                    tmp = pSrcLine[k];
+
+                    R = (tmp >> r_shift) & 0xFF;
+                    G = (tmp >> 8) & 0xFF;
+                    B = (tmp >> b_shift) & 0xFF;
+
+                    pDstY[k] = (unsigned char)((((66 * R) + (129 * G) + (25 * B) + 128) >> 8) + 16);
+
+                    if ((l == 0) && ((k % 2) == 0)) {
+                        U = ((-38 * R) - (74 * G) + (112 * B) + 128) >> 8;
+                        V = ((112 * R) - (94 * G) - (18 * B) + 128) >> 8;
+
+                        pDstUV[k]     = (unsigned char)(U + 128);
+                        pDstUV[k + 1] = (unsigned char)(V + 128);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/*
+ * Copies linear rows of one tile row band into NV12T
+ *
+ * @param nv12t_dest
+ *   Y or UV plane address of NV12T[out]
+ *
+ * @param band_src
+ *   Linear rows of the band[in]
+ *
+ * @param width
+ *   Width of plane[in]
+ *
+ * @param height
+ *   Y: Height of plane, UV: Height/2 of plane[in]
+ *
+ * @param band_y
+ *   First row of the band[in]
+ *
+ * @param band_rows
+ *   Number of rows in the band. it should not cross a tile row[in]
+ */
+static void csc_linear_band_to_tiled(
+    unsigned char *nv12t_dest,
+    unsigned char *band_src,
+    unsigned int width,
+    unsigned int height,
+    unsigned int band_y,
+    unsigned int band_rows)
+{
+    unsigned int i, j;
+    unsigned int span;
+    unsigned char *pDst;
+    unsigned char *pSrc;
+
+    for (i = 0; i < width; i += NV12T_TILE_WIDTH) {
+        span = width - i;
+        if (span > NV12T_TILE_WIDTH)
+            span = NV12T_TILE_WIDTH;
+
+        pDst = nv12t_dest
+             + tile_64x32_offset(i >> 6, band_y >> 5, width, height)
+             + NV12T_TILE_WIDTH * (band_y & 0x1F);
+        pSrc = band_src + i;
+        for (j = 0; j < band_rows; j++) {
+            memcpy(pDst, pSrc, span);
+            pDst += NV12T_TILE_WIDTH;
+            pSrc += width;
+        }
+    }
+}
+
+/*
+ * Converts RGB8888 to NV12T by 32 line bands with NEON
+ * Each band is converted to linear YUV420SP in a cache resident
+ * scratch and tiled from there, so the linear frame never reaches memory.
+ *
+ * @param y_dst
+ *   Y plane address of NV12T[out]
+ *
+ * @param uv_dst
+ *   UV plane address of NV12T[out]
+ *
+ * @param rgb_src
+ *   Address of RGB8888[in]
+ *
+ * @param width
+ *   Width of RGB8888[in]
+ *   it should be even
+ *
+ * @param height
+ *   Height of RGB8888[in]
+ *   it should be even
+ *
+ * @param band_convert
+ *   NEON RGB8888 to YUV420SP kernel[in]
+ *
+ * @return
+ *   0 on success, -1 if the band scratch can not be allocated
+ */
+static int csc_RGB8888_to_NV12T_band(
+    unsigned char *y_dst,
+    unsigned char *uv_dst,
+    unsigned char *rgb_src,
+    unsigned int width,
+    unsigned int height,
+    void (*band_convert)(unsigned char *, unsigned char *, unsigned char *,
+                         unsigned int, unsigned int))
+{
+    unsigned int j;
+    unsigned int band_rows;
+    unsigned char *pBandY;
+    unsigned char *pBandUV;
+
+    pBandY = (unsigned char *)malloc(width * (NV12T_TILE_HEIGHT + (NV12T_TILE_HEIGHT >> 1)));
+    if (pBandY == NULL)
+        return -1;
+    pBandUV = pBandY + width * NV12T_TILE_HEIGHT;
+
+    for (j = 0; j < height; j += NV12T_TILE_HEIGHT) {
+        band_rows = height - j;
+        if (band_rows > NV12T_TILE_HEIGHT)
+            band_rows = NV12T_TILE_HEIGHT;
+
+        band_convert(pBandY, pBandUV, rgb_src + (j * width * 4), width, band_rows);
+
+        csc_linear_band_to_tiled(y_dst, pBandY, width, height, j, band_rows);
+        csc_linear_band_to_tiled(uv_dst, pBandUV, width, height >> 1, j >> 1, band_rows >> 1);
+    }
+
+    free(pBandY);
+
+    return 0;
+}
+
+/*
+ * Converts ARGB8888 to NV12T
+ *
+ * @param y_dst
+ *   Y plane address of NV12T[out]
+ *
+ * @param uv_dst
+ *   UV plane address of NV12T[out]
+ *
+ * @param rgb_src
+ *   Address of ARGB8888[in]
+ *
+ * @param width
+ *   Width of ARGB8888[in]
+ *
+ * @param height
+ *   Height of ARGB8888[in]
+ */
+void csc_ARGB8888_to_NV12T(
+    unsigned char *y_dst,
+    unsigned char *uv_dst,
+    unsigned char *rgb_src,
+    unsigned int width,
+    unsigned int height)
+{
+    csc_RGB8888_to_NV12T(y_dst, uv_dst, rgb_src, width, height, 16, 0);
+}
+
+/*
+ * Converts RGBA8888 to NV12T
+ *
+ * @param y_dst
+ *   Y plane address of NV12T[out]
+ *
+ * @param uv_dst
+ *   UV plane address of NV12T[out]
+ *
+ * @param rgb_src
+ *   Address of RGBA8888[in]
+ *
+ * @param width
+ *   Width of RGBA8888[in]
+ *
+ * @param height
+ *   Height of RGBA8888[in]
+ */
+void csc_RGBA8888_to_NV12T(
+    unsigned char *y_dst,
+    unsigned char *uv_dst,
+    unsigned char *rgb_src,
+    unsigned int width,
+    unsigned int height)
+{
+    csc_RGB8888_to_NV12T(y_dst, uv_dst, rgb_src, width, height, 0, 16);
+}
+
+/*
+ * Converts ARGB8888 to NV12T with NEON
+ *
+ * @param y_dst
+ *   Y plane address of NV12T[out]
+ *
+ * @param uv_dst
+ *   UV plane address of NV12T[out]
+ *
+ * @param rgb_src
+ *   Address of ARGB8888[in]
+ *
+ * @param width
+ *   Width of ARGB8888[in]
+ *
+ * @param height
+ *   Height of ARGB8888[in]
+ */
+void csc_ARGB8888_to_NV12T_NEON(
+    unsigned char *y_dst,
+    unsigned char *uv_dst,
+    unsigned char *rgb_src,
+    unsigned int width,
+    unsigned int height)
+{
+    if (csc_RGB8888_to_NV12T_band(y_dst, uv_dst, rgb_src, width, height,
+                                  csc_ARGB8888_to_YUV420SP_NEON) != 0)
+        csc_ARGB8888_to_NV12T(y_dst, uv_dst, rgb_src, width, height);
+}
+
+/*
+ * Converts RGBA8888 to NV12T with NEON
+ *
+ * @param y_dst
+ *   Y plane address of NV12T[out]
+ *
+ * @param uv_dst
+ *   UV plane address of NV12T[out]
+ *
+ * @param rgb_src
+ *   Address of RGBA8888[in]
+ *
+ * @param width
+ *   Width of RGBA8888[in]
+ *
+ * @param height
+ *   Height of RGBA8888[in]
+ */
+void csc_RGBA8888_to_NV12T_NEON(
+    unsigned char *y_dst,
+    unsigned char *uv_dst,
+    unsigned char *rgb_src,
+    unsigned int width,
+    unsigned int height)
+{
+    if (csc_RGB8888_to_NV12T_band(y_dst, uv_dst, rgb_src, width, height,
+                                  csc_RGBA8888_to_YUV420SP_NEON) != 0)
+        csc_RGBA8888_to_NV12T(y_dst, uv_dst, rgb_src, width, height);
+}
@@ -21,6 +21,7 @@ include $(SEC_OMX_COMPONENT)/video/dec/vc1/Android.mk
 include $(SEC_OMX_COMPONENT)/video/enc/Android.mk
 include $(SEC_OMX_COMPONENT)/video/enc/h264/Android.mk
 include $(SEC_OMX_COMPONENT)/video/enc/mpeg4/Android.mk
+include $(SEC_OMX_COMPONENT)/video/enc/test/Android.mk
 
 ifeq ($(filter-out exynos5,$(TARGET_BOARD_PLATFORM)),)
 include $(SEC_OMX_COMPONENT)/video/dec/vp8/Android.mk
@@ -33,6 +33,10 @@ LOCAL_MODULE := libSEC_OMX_Resourcemanager
 
 LOCAL_CFLAGS :=
 
+ifneq ($(BOARD_OMX_MFC_MB_PER_SEC),)
+LOCAL_CFLAGS += -DMAX_RESOURCE_VIDEO_MB_PER_SEC=$(BOARD_OMX_MFC_MB_PER_SEC)
+endif
+
 LOCAL_STATIC_LIBRARIES := libsecosal
 LOCAL_SHARED_LIBRARIES := libcutils libutils
 
@@ -1306,6 +1306,17 @@ OMX_ERRORTYPE SEC_OMX_SetConfig(
     }
 
     switch (nIndex) {
+    case OMX_IndexConfigBufferBatch:
+    {
+        SEC_OMX_CONFIG_BUFFERBATCHTYPE *pBufferBatch = (SEC_OMX_CONFIG_BUFFERBATCHTYPE *)pComponentConfigStructure;
+
+        ret = SEC_OMX_Check_SizeVersion(pBufferBatch, sizeof(SEC_OMX_CONFIG_BUFFERBATCHTYPE));
+        if (ret != OMX_ErrorNone) {
+            goto EXIT;
+        }
+        ret = SEC_OMX_BufferBatchProcess(pOMXComponent, pBufferBatch);
+    }
+        break;
     default:
         ret = OMX_ErrorUnsupportedIndex;
         break;
@@ -1353,6 +1364,12 @@ OMX_ERRORTYPE SEC_OMX_GetExtensionIndex(
         goto EXIT;
     }
 
+    if (SEC_OSAL_Strcmp(cParameterName, SEC_INDEX_CONFIG_BUFFER_BATCH) == 0) {
+        *pIndexType = (OMX_INDEXTYPE)OMX_IndexConfigBufferBatch;
+        ret = OMX_ErrorNone;
+        goto EXIT;
+    }
+
     ret = OMX_ErrorBadParameter;
 
 EXIT:
@@ -142,6 +142,8 @@ typedef struct _SEC_OMX_BASECOMPONENT
     OMX_ERRORTYPE (*sec_FreeTunnelBuffer)(SEC_OMX_BASEPORT *pOMXBasePort, OMX_U32 nPortIndex);
     OMX_ERRORTYPE (*sec_BufferProcess)(OMX_HANDLETYPE hComponent);
     OMX_ERRORTYPE (*sec_BufferReset)(OMX_COMPONENTTYPE *pOMXComponent, OMX_U32 nPortIndex);
+    /* optional, resets codec state that must not survive a port flush */
+    OMX_ERRORTYPE (*sec_FlushReset)(OMX_COMPONENTTYPE *pOMXComponent, OMX_U32 nPortIndex);
     OMX_ERRORTYPE (*sec_InputBufferReturn)(OMX_COMPONENTTYPE *pOMXComponent);
     OMX_ERRORTYPE (*sec_OutputBufferReturn)(OMX_COMPONENTTYPE *pOMXComponent);
 
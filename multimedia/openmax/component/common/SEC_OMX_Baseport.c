@@ -132,6 +132,9 @@ OMX_ERRORTYPE SEC_OMX_FlushPort(OMX_COMPONENTTYPE *pOMXComponent, OMX_S32 portIn
     pSECComponent->processData[portIndex].timeStamp     = 0;
     pSECComponent->processData[portIndex].usedDataLen   = 0;
 
+    if (pSECComponent->sec_FlushReset != NULL)
+        pSECComponent->sec_FlushReset(pOMXComponent, portIndex);
+
 EXIT:
     FunctionOut();
 
@@ -588,12 +591,10 @@ OMX_ERRORTYPE SEC_OMX_EmptyThisBuffer(
         goto EXIT;
     }
 
-    for (i = 0; i < pSECPort->portDefinition.nBufferCountActual; i++) {
-        if (pBuffer == pSECPort->bufferHeader[i]) {
-            findBuffer = OMX_TRUE;
-            break;
-        }
-    }
+    i = GET_BUFFER_HEADER_INDEX(pBuffer, INPUT_PORT_INDEX);
+    if ((i < pSECPort->portDefinition.nBufferCountActual) &&
+        (pBuffer == pSECPort->bufferHeader[i]))
+        findBuffer = OMX_TRUE;
 
     if (findBuffer == OMX_FALSE) {
         ret = OMX_ErrorBadParameter;
@@ -689,12 +690,10 @@ OMX_ERRORTYPE SEC_OMX_FillThisBuffer(
         goto EXIT;
     }
 
-    for (i = 0; i < pSECPort->portDefinition.nBufferCountActual; i++) {
-        if (pBuffer == pSECPort->bufferHeader[i]) {
-            findBuffer = OMX_TRUE;
-            break;
-        }
-    }
+    i = GET_BUFFER_HEADER_INDEX(pBuffer, OUTPUT_PORT_INDEX);
+    if ((i < pSECPort->portDefinition.nBufferCountActual) &&
+        (pBuffer == pSECPort->bufferHeader[i]))
+        findBuffer = OMX_TRUE;
 
     if (findBuffer == OMX_FALSE) {
         ret = OMX_ErrorBadParameter;
@@ -726,6 +725,116 @@ EXIT:
     return ret;
 }
 
+OMX_ERRORTYPE SEC_OMX_BufferBatchProcess(
+    OMX_COMPONENTTYPE              *pOMXComponent,
+    SEC_OMX_CONFIG_BUFFERBATCHTYPE *pBufferBatch)
+{
+    OMX_ERRORTYPE          ret = OMX_ErrorNone;
+    SEC_OMX_BASECOMPONENT *pSECComponent = NULL;
+    SEC_OMX_BASEPORT      *pSECPort = NULL;
+    OMX_BUFFERHEADERTYPE  *pBuffer = NULL;
+    SEC_OMX_MESSAGE       *message[MAX_QUEUE_ELEMENTS];
+    OMX_U32                nPortIndex = 0;
+    OMX_U32                bufferIndex = 0;
+    OMX_U32                i = 0;
+
+    FunctionIn();
+
+    SEC_OSAL_Memset(message, 0, sizeof(message));
+
+    if ((pOMXComponent == NULL) || (pOMXComponent->pComponentPrivate == NULL) || (pBufferBatch == NULL)) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+    pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+
+    nPortIndex = pBufferBatch->nPortIndex;
+    if (nPortIndex >= pSECComponent->portParam.nPorts) {
+        ret = OMX_ErrorBadPortIndex;
+        goto EXIT;
+    }
+    if ((pBufferBatch->nBufferCount == 0) || (pBufferBatch->nBufferCount > MAX_QUEUE_ELEMENTS) ||
+        (pBufferBatch->ppBufferHeader == NULL)) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+
+    if ((pSECComponent->currentState != OMX_StateIdle) &&
+        (pSECComponent->currentState != OMX_StateExecuting) &&
+        (pSECComponent->currentState != OMX_StatePause)) {
+        ret = OMX_ErrorIncorrectStateOperation;
+        goto EXIT;
+    }
+
+    pSECPort = &pSECComponent->pSECPort[nPortIndex];
+    if ((!CHECK_PORT_ENABLED(pSECPort)) ||
+        ((CHECK_PORT_BEING_FLUSHED(pSECPort) || CHECK_PORT_BEING_DISABLED(pSECPort)) &&
+        (!CHECK_PORT_TUNNELED(pSECPort) || !CHECK_PORT_BUFFER_SUPPLIER(pSECPort))) ||
+        ((pSECComponent->transientState == SEC_OMX_TransStateExecutingToIdle) &&
+        (CHECK_PORT_TUNNELED(pSECPort) && !CHECK_PORT_BUFFER_SUPPLIER(pSECPort)))) {
+        ret = OMX_ErrorIncorrectStateOperation;
+        goto EXIT;
+    }
+
+    /* validate the whole batch first, nothing is queued on error */
+    for (i = 0; i < pBufferBatch->nBufferCount; i++) {
+        pBuffer = pBufferBatch->ppBufferHeader[i];
+        if (pBuffer == NULL) {
+            ret = OMX_ErrorBadParameter;
+            goto EXIT;
+        }
+        if (((nPortIndex == INPUT_PORT_INDEX) && (pBuffer->nInputPortIndex != INPUT_PORT_INDEX)) ||
+            ((nPortIndex == OUTPUT_PORT_INDEX) && (pBuffer->nOutputPortIndex != OUTPUT_PORT_INDEX))) {
+            ret = OMX_ErrorBadPortIndex;
+            goto EXIT;
+        }
+        ret = SEC_OMX_Check_SizeVersion(pBuffer, sizeof(OMX_BUFFERHEADERTYPE));
+        if (ret != OMX_ErrorNone) {
+            goto EXIT;
+        }
+        bufferIndex = GET_BUFFER_HEADER_INDEX(pBuffer, nPortIndex);
+        if ((bufferIndex >= pSECPort->portDefinition.nBufferCountActual) ||
+            (pBuffer != pSECPort->bufferHeader[bufferIndex])) {
+            ret = OMX_ErrorBadParameter;
+            goto EXIT;
+        }
+
+        message[i] = SEC_OSAL_Malloc(sizeof(SEC_OMX_MESSAGE));
+        if (message[i] == NULL) {
+            ret = OMX_ErrorInsufficientResources;
+            goto EXIT;
+        }
+        if (nPortIndex == INPUT_PORT_INDEX)
+            message[i]->messageType = SEC_OMX_CommandEmptyBuffer;
+        else
+            message[i]->messageType = SEC_OMX_CommandFillBuffer;
+        message[i]->messageParam = bufferIndex;
+        message[i]->pCmdData = (OMX_PTR)pBuffer;
+    }
+
+    if (SEC_OSAL_QueueBatch(&pSECPort->bufferQ, (void **)message, pBufferBatch->nBufferCount) != 0) {
+        ret = OMX_ErrorUndefined;
+        goto EXIT;
+    }
+
+    /* messages belong to the queue now */
+    for (i = 0; i < pBufferBatch->nBufferCount; i++) {
+        message[i] = NULL;
+        SEC_OSAL_SemaphorePost(pSECPort->bufferSemID);
+    }
+    ret = OMX_ErrorNone;
+
+EXIT:
+    for (i = 0; i < MAX_QUEUE_ELEMENTS; i++) {
+        if (message[i] != NULL)
+            SEC_OSAL_Free(message[i]);
+    }
+
+    FunctionOut();
+
+    return ret;
+}
+
 OMX_ERRORTYPE SEC_OMX_Port_Constructor(OMX_HANDLETYPE hComponent)
 {
     OMX_ERRORTYPE          ret = OMX_ErrorNone;
@@ -46,6 +46,18 @@
 #define ALL_PORT_INDEX     -1
 #define ALL_PORT_NUM        2
 
+/* index of a header in bufferHeader[], kept in the private field of our own port */
+#define SET_BUFFER_HEADER_INDEX(pBufferHeader, nPortIndex, index)         \
+    do {                                                                  \
+        if ((nPortIndex) == INPUT_PORT_INDEX)                             \
+            (pBufferHeader)->pInputPortPrivate = (OMX_PTR)(index);        \
+        else                                                              \
+            (pBufferHeader)->pOutputPortPrivate = (OMX_PTR)(index);       \
+    } while (0)
+#define GET_BUFFER_HEADER_INDEX(pBufferHeader, nPortIndex)                \
+    ((OMX_U32)(((nPortIndex) == INPUT_PORT_INDEX) ?                       \
+        (pBufferHeader)->pInputPortPrivate : (pBufferHeader)->pOutputPortPrivate))
+
 typedef struct _SEC_OMX_BASEPORT
 {
     OMX_BUFFERHEADERTYPE         **bufferHeader;
@@ -84,6 +96,7 @@ OMX_ERRORTYPE SEC_OMX_PortEnableProcess(OMX_COMPONENTTYPE *pOMXComponent, OMX_S3
 OMX_ERRORTYPE SEC_OMX_PortDisableProcess(OMX_COMPONENTTYPE *pOMXComponent, OMX_S32 nPortIndex);
 OMX_ERRORTYPE SEC_OMX_BufferFlushProcess(OMX_COMPONENTTYPE *pOMXComponent, OMX_S32 nPortIndex);
 OMX_ERRORTYPE SEC_OMX_BufferFlushProcessNoEvent(OMX_COMPONENTTYPE *pOMXComponent, OMX_S32 nPortIndex);
+OMX_ERRORTYPE SEC_OMX_BufferBatchProcess(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_CONFIG_BUFFERBATCHTYPE *pBufferBatch);
 OMX_ERRORTYPE SEC_OMX_Port_Constructor(OMX_HANDLETYPE hComponent);
 OMX_ERRORTYPE SEC_OMX_Port_Destructor(OMX_HANDLETYPE hComponent);
 
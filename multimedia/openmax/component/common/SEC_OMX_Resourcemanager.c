@@ -27,6 +27,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/time.h>
 
 #include "SEC_OMX_Resourcemanager.h"
 #include "SEC_OMX_Basecomponent.h"
@@ -39,17 +40,86 @@
 #include "SEC_OSAL_Log.h"
 
 
-#define MAX_RESOURCE_VIDEO_DEC 3 /* for Android */
-#define MAX_RESOURCE_VIDEO_ENC 1 /* for Android */
+/*
+ * Admission is based on MFC load, not on the number of instances.
+ * Load of a component is macroblocks per second of its port definition.
+ * Default budget is 1080p 60fps, which covers one 1080p 30fps stream
+ * plus a 720p stream or several small ones.
+ */
+#ifndef MAX_RESOURCE_VIDEO_MB_PER_SEC
+#define MAX_RESOURCE_VIDEO_MB_PER_SEC ((1920 / 16) * (1088 / 16) * 60)
+#endif
+#define DEFAULT_RESOURCE_VIDEO_FRAMERATE 30
+
+/*
+ * Waiting components are served by group priority, but each
+ * RM_WAITING_AGING_PERIOD of waiting is worth one priority level,
+ * so low priority components can not be starved forever.
+ */
+#define RM_WAITING_AGING_PERIOD   1000000 /* usec */
+#define RM_WAITING_HEAP_INIT_SIZE 4
 
 /* Max allowable video scheduler component instance */
 static SEC_OMX_RM_COMPONENT_LIST *gpVideoDecRMComponentList = NULL;
-static SEC_OMX_RM_COMPONENT_LIST *gpVideoDecRMWaitingList = NULL;
 static SEC_OMX_RM_COMPONENT_LIST *gpVideoEncRMComponentList = NULL;
-static SEC_OMX_RM_COMPONENT_LIST *gpVideoEncRMWaitingList = NULL;
+static SEC_OMX_RM_WAITING_HEAP     gVideoDecRMWaitingHeap = {NULL, 0, 0};
+static SEC_OMX_RM_WAITING_HEAP     gVideoEncRMWaitingHeap = {NULL, 0, 0};
 static OMX_HANDLETYPE ghVideoRMComponentListMutex = NULL;
 
 
+OMX_U32 getComponentLoad(OMX_COMPONENTTYPE *pOMXComponent)
+{
+    SEC_OMX_BASECOMPONENT *pSECComponent = NULL;
+    OMX_U32                width = 0, height = 0;
+    OMX_U32                framerate = 0;
+    OMX_U32                i = 0;
+
+    pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    if (pSECComponent->pSECPort == NULL)
+        return 0;
+
+    for (i = 0; i < ALL_PORT_NUM; i++) {
+        OMX_VIDEO_PORTDEFINITIONTYPE *pVideoDef = &pSECComponent->pSECPort[i].portDefinition.format.video;
+
+        if (pVideoDef->nFrameWidth > width)
+            width = pVideoDef->nFrameWidth;
+        if (pVideoDef->nFrameHeight > height)
+            height = pVideoDef->nFrameHeight;
+        if ((pVideoDef->xFramerate >> 16) > framerate)
+            framerate = pVideoDef->xFramerate >> 16;
+    }
+
+    if (framerate == 0)
+        framerate = DEFAULT_RESOURCE_VIDEO_FRAMERATE;
+
+    return ((width + 15) / 16) * ((height + 15) / 16) * framerate;
+}
+
+OMX_U32 getListLoad(SEC_OMX_RM_COMPONENT_LIST *pList)
+{
+    OMX_U32 nLoad = 0;
+
+    while (pList != NULL) {
+        nLoad += pList->nLoad;
+        pList = pList->pNext;
+    }
+
+    return nLoad;
+}
+
+OMX_U32 getLowPriorityLoad(SEC_OMX_RM_COMPONENT_LIST *pList, OMX_U32 inComp_priority)
+{
+    OMX_U32 nLoad = 0;
+
+    while (pList != NULL) {
+        if (pList->groupPriority > inComp_priority)
+            nLoad += pList->nLoad;
+        pList = pList->pNext;
+    }
+
+    return nLoad;
+}
+
 OMX_ERRORTYPE addElementList(SEC_OMX_RM_COMPONENT_LIST **ppList, OMX_COMPONENTTYPE *pOMXComponent)
 {
     OMX_ERRORTYPE              ret = OMX_ErrorNone;
@@ -70,6 +140,7 @@ OMX_ERRORTYPE addElementList(SEC_OMX_RM_COMPONENT_LIST **ppList, OMX_COMPONENTTY
         ((SEC_OMX_RM_COMPONENT_LIST *)(pTempComp->pNext))->pNext = NULL;
         ((SEC_OMX_RM_COMPONENT_LIST *)(pTempComp->pNext))->pOMXStandComp = pOMXComponent;
         ((SEC_OMX_RM_COMPONENT_LIST *)(pTempComp->pNext))->groupPriority = pSECComponent->compPriority.nGroupPriority;
+        ((SEC_OMX_RM_COMPONENT_LIST *)(pTempComp->pNext))->nLoad = getComponentLoad(pOMXComponent);
         goto EXIT;
     } else {
         *ppList = (SEC_OMX_RM_COMPONENT_LIST *)SEC_OSAL_Malloc(sizeof(SEC_OMX_RM_COMPONENT_LIST));
@@ -81,12 +152,12 @@ OMX_ERRORTYPE addElementList(SEC_OMX_RM_COMPONENT_LIST **ppList, OMX_COMPONENTTY
         pTempComp->pNext = NULL;
         pTempComp->pOMXStandComp = pOMXComponent;
         pTempComp->groupPriority = pSECComponent->compPriority.nGroupPriority;
+        pTempComp->nLoad = getComponentLoad(pOMXComponent);
     }
 
 EXIT:
     return ret;
 }
-
 OMX_ERRORTYPE removeElementList(SEC_OMX_RM_COMPONENT_LIST **ppList, OMX_COMPONENTTYPE *pOMXComponent)
 {
     OMX_ERRORTYPE              ret = OMX_ErrorNone;
@@ -189,6 +260,219 @@ EXIT:
 }
 
 
+static OMX_U64 getTimeUs()
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return ((OMX_U64)tv.tv_sec * 1000000) + tv.tv_usec;
+}
+
+static void swapWaitingElement(SEC_OMX_RM_WAITING_HEAP *pHeap, OMX_U32 a, OMX_U32 b)
+{
+    SEC_OMX_RM_WAITING_ELEMENT temp;
+
+    temp = pHeap->pElement[a];
+    pHeap->pElement[a] = pHeap->pElement[b];
+    pHeap->pElement[b] = temp;
+}
+
+static OMX_BOOL isWaitingElementLess(SEC_OMX_RM_WAITING_ELEMENT *pA, SEC_OMX_RM_WAITING_ELEMENT *pB)
+{
+    if (pA->key != pB->key)
+        return (pA->key < pB->key) ? OMX_TRUE : OMX_FALSE;
+    return (pA->waitStartTime < pB->waitStartTime) ? OMX_TRUE : OMX_FALSE;
+}
+
+static void siftUpWaitingHeap(SEC_OMX_RM_WAITING_HEAP *pHeap, OMX_U32 index)
+{
+    OMX_U32 parent = 0;
+
+    while (index > 0) {
+        parent = (index - 1) / 2;
+        if (isWaitingElementLess(&pHeap->pElement[index], &pHeap->pElement[parent]) != OMX_TRUE)
+            break;
+        swapWaitingElement(pHeap, index, parent);
+        index = parent;
+    }
+}
+
+static void siftDownWaitingHeap(SEC_OMX_RM_WAITING_HEAP *pHeap, OMX_U32 index)
+{
+    OMX_U32 child = 0;
+
+    while ((child = (index * 2) + 1) < pHeap->nElement) {
+        if ((child + 1 < pHeap->nElement) &&
+            (isWaitingElementLess(&pHeap->pElement[child + 1], &pHeap->pElement[child]) == OMX_TRUE))
+            child++;
+        if (isWaitingElementLess(&pHeap->pElement[child], &pHeap->pElement[index]) != OMX_TRUE)
+            break;
+        swapWaitingElement(pHeap, index, child);
+        index = child;
+    }
+}
+
+OMX_ERRORTYPE pushWaitingHeap(SEC_OMX_RM_WAITING_HEAP *pHeap, OMX_COMPONENTTYPE *pOMXComponent)
+{
+    OMX_ERRORTYPE               ret = OMX_ErrorNone;
+    SEC_OMX_BASECOMPONENT      *pSECComponent = NULL;
+    SEC_OMX_RM_WAITING_ELEMENT *pNewElement = NULL;
+    SEC_OMX_RM_WAITING_ELEMENT *pElement = NULL;
+    OMX_U32                     nNewAlloc = 0;
+
+    pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+
+    if (pHeap->nElement >= pHeap->nAlloc) {
+        nNewAlloc = (pHeap->nAlloc == 0) ? RM_WAITING_HEAP_INIT_SIZE : (pHeap->nAlloc * 2);
+        pNewElement = (SEC_OMX_RM_WAITING_ELEMENT *)SEC_OSAL_Malloc(sizeof(SEC_OMX_RM_WAITING_ELEMENT) * nNewAlloc);
+        if (pNewElement == NULL) {
+            ret = OMX_ErrorInsufficientResources;
+            goto EXIT;
+        }
+        if (pHeap->pElement != NULL) {
+            SEC_OSAL_Memcpy(pNewElement, pHeap->pElement, sizeof(SEC_OMX_RM_WAITING_ELEMENT) * pHeap->nElement);
+            SEC_OSAL_Free(pHeap->pElement);
+        }
+        pHeap->pElement = pNewElement;
+        pHeap->nAlloc = nNewAlloc;
+    }
+
+    pElement = &pHeap->pElement[pHeap->nElement];
+    pElement->pOMXStandComp = pOMXComponent;
+    pElement->groupPriority = pSECComponent->compPriority.nGroupPriority;
+    pElement->nLoad = getComponentLoad(pOMXComponent);
+    pElement->waitStartTime = getTimeUs();
+    pElement->key = ((OMX_U64)pElement->groupPriority * RM_WAITING_AGING_PERIOD) + pElement->waitStartTime;
+
+    pHeap->nElement++;
+    siftUpWaitingHeap(pHeap, pHeap->nElement - 1);
+
+EXIT:
+    return ret;
+}
+
+OMX_ERRORTYPE removeWaitingHeap(SEC_OMX_RM_WAITING_HEAP *pHeap, OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_RM_WAITING_ELEMENT *pOutElement)
+{
+    OMX_ERRORTYPE ret = OMX_ErrorNone;
+    OMX_U32       i = 0;
+
+    for (i = 0; i < pHeap->nElement; i++) {
+        if (pHeap->pElement[i].pOMXStandComp == pOMXComponent)
+            break;
+    }
+    if (i >= pHeap->nElement) {
+        ret = OMX_ErrorComponentNotFound;
+        goto EXIT;
+    }
+
+    if (pOutElement != NULL)
+        *pOutElement = pHeap->pElement[i];
+
+    pHeap->nElement--;
+    if (i < pHeap->nElement) {
+        pHeap->pElement[i] = pHeap->pElement[pHeap->nElement];
+        siftUpWaitingHeap(pHeap, i);
+        siftDownWaitingHeap(pHeap, i);
+    }
+
+EXIT:
+    return ret;
+}
+
+void freeWaitingHeap(SEC_OMX_RM_WAITING_HEAP *pHeap)
+{
+    if (pHeap->pElement != NULL)
+        SEC_OSAL_Free(pHeap->pElement);
+    pHeap->pElement = NULL;
+    pHeap->nElement = 0;
+    pHeap->nAlloc = 0;
+}
+
+static int compareWaitingElement(const void *pA, const void *pB)
+{
+    SEC_OMX_RM_WAITING_ELEMENT *pElementA = (SEC_OMX_RM_WAITING_ELEMENT *)pA;
+    SEC_OMX_RM_WAITING_ELEMENT *pElementB = (SEC_OMX_RM_WAITING_ELEMENT *)pB;
+
+    if (isWaitingElementLess(pElementA, pElementB) == OMX_TRUE)
+        return -1;
+    if (isWaitingElementLess(pElementB, pElementA) == OMX_TRUE)
+        return 1;
+    return 0;
+}
+
+/*
+ * Wake up waiting components of both heaps in key order.
+ * A waiter that does not fit in the free MFC load is skipped and keeps
+ * its place, so it does not block smaller waiters behind it.
+ * A waiter leaves its heap only once its Idle command is queued.
+ */
+OMX_ERRORTYPE wakeWaitingComponents()
+{
+    OMX_ERRORTYPE               ret = OMX_ErrorNone;
+    SEC_OMX_BASECOMPONENT      *pSECComponent = NULL;
+    SEC_OMX_RM_WAITING_HEAP    *pHeap = NULL;
+    SEC_OMX_RM_COMPONENT_LIST **ppComponentList = NULL;
+    SEC_OMX_RM_WAITING_ELEMENT *pWaiting = NULL;
+    OMX_U32                     nWaiting = 0;
+    OMX_U32                     nTotalLoad = 0;
+    OMX_U32                     i = 0;
+
+    nWaiting = gVideoDecRMWaitingHeap.nElement + gVideoEncRMWaitingHeap.nElement;
+    if (nWaiting == 0)
+        goto EXIT;
+
+    pWaiting = (SEC_OMX_RM_WAITING_ELEMENT *)SEC_OSAL_Malloc(sizeof(SEC_OMX_RM_WAITING_ELEMENT) * nWaiting);
+    if (pWaiting == NULL) {
+        ret = OMX_ErrorInsufficientResources;
+        goto EXIT;
+    }
+    if (gVideoDecRMWaitingHeap.nElement > 0)
+        SEC_OSAL_Memcpy(pWaiting, gVideoDecRMWaitingHeap.pElement,
+                        sizeof(SEC_OMX_RM_WAITING_ELEMENT) * gVideoDecRMWaitingHeap.nElement);
+    if (gVideoEncRMWaitingHeap.nElement > 0)
+        SEC_OSAL_Memcpy(pWaiting + gVideoDecRMWaitingHeap.nElement, gVideoEncRMWaitingHeap.pElement,
+                        sizeof(SEC_OMX_RM_WAITING_ELEMENT) * gVideoEncRMWaitingHeap.nElement);
+    qsort(pWaiting, nWaiting, sizeof(SEC_OMX_RM_WAITING_ELEMENT), compareWaitingElement);
+
+    nTotalLoad = getListLoad(gpVideoDecRMComponentList) + getListLoad(gpVideoEncRMComponentList);
+
+    for (i = 0; i < nWaiting; i++) {
+        pSECComponent = (SEC_OMX_BASECOMPONENT *)pWaiting[i].pOMXStandComp->pComponentPrivate;
+        if (pSECComponent->codecType == HW_VIDEO_DEC_CODEC) {
+            pHeap = &gVideoDecRMWaitingHeap;
+            ppComponentList = &gpVideoDecRMComponentList;
+        } else {
+            pHeap = &gVideoEncRMWaitingHeap;
+            ppComponentList = &gpVideoEncRMComponentList;
+        }
+
+        /* port definition may have changed while waiting */
+        pWaiting[i].nLoad = getComponentLoad(pWaiting[i].pOMXStandComp);
+        if (nTotalLoad + pWaiting[i].nLoad > MAX_RESOURCE_VIDEO_MB_PER_SEC)
+            continue;
+
+        /* admit on behalf of the woken component, WaitForResources to Idle does not ask again */
+        if (addElementList(ppComponentList, pWaiting[i].pOMXStandComp) != OMX_ErrorNone)
+            continue;
+
+        if (OMX_SendCommand(pWaiting[i].pOMXStandComp, OMX_CommandStateSet, OMX_StateIdle, NULL) != OMX_ErrorNone) {
+            SEC_OSAL_Log(SEC_LOG_ERROR, "%s: can not wake up %s, keep it waiting",
+                         __FUNCTION__, pSECComponent->componentName);
+            removeElementList(ppComponentList, pWaiting[i].pOMXStandComp);
+            continue;
+        }
+
+        nTotalLoad += pWaiting[i].nLoad;
+        removeWaitingHeap(pHeap, pWaiting[i].pOMXStandComp, NULL);
+    }
+
+    SEC_OSAL_Free(pWaiting);
+
+EXIT:
+    return ret;
+}
+
+
 OMX_ERRORTYPE SEC_OMX_ResourceManager_Init()
 {
     OMX_ERRORTYPE ret = OMX_ErrorNone;
@@ -219,15 +503,7 @@ OMX_ERRORTYPE SEC_OMX_ResourceManager_Deinit()
         }
         gpVideoDecRMComponentList = NULL;
     }
-    if (gpVideoDecRMWaitingList) {
-        pCurrComponent = gpVideoDecRMWaitingList;
-        while (pCurrComponent != NULL) {
-            pNextComponent = pCurrComponent->pNext;
-            SEC_OSAL_Free(pCurrComponent);
-            pCurrComponent = pNextComponent;
-        }
-        gpVideoDecRMWaitingList = NULL;
-    }
+    freeWaitingHeap(&gVideoDecRMWaitingHeap);
 
     if (gpVideoEncRMComponentList) {
         pCurrComponent = gpVideoEncRMComponentList;
@@ -238,15 +514,7 @@ OMX_ERRORTYPE SEC_OMX_ResourceManager_Deinit()
         }
         gpVideoEncRMComponentList = NULL;
     }
-    if (gpVideoEncRMWaitingList) {
-        pCurrComponent = gpVideoEncRMWaitingList;
-        while (pCurrComponent != NULL) {
-            pNextComponent = pCurrComponent->pNext;
-            SEC_OSAL_Free(pCurrComponent);
-            pCurrComponent = pNextComponent;
-        }
-        gpVideoEncRMWaitingList = NULL;
-    }
+    freeWaitingHeap(&gVideoEncRMWaitingHeap);
 
     SEC_OSAL_MutexUnlock(ghVideoRMComponentListMutex);
 
@@ -264,10 +532,14 @@ OMX_ERRORTYPE SEC_OMX_Get_Resource(OMX_COMPONENTTYPE *pOMXComponent)
 {
     OMX_ERRORTYPE              ret = OMX_ErrorNone;
     SEC_OMX_BASECOMPONENT     *pSECComponent = NULL;
-    SEC_OMX_RM_COMPONENT_LIST *pComponentTemp = NULL;
+    SEC_OMX_RM_COMPONENT_LIST **ppComponentList = NULL;
+    SEC_OMX_RM_COMPONENT_LIST *pDecCandidate = NULL;
+    SEC_OMX_RM_COMPONENT_LIST *pEncCandidate = NULL;
     SEC_OMX_RM_COMPONENT_LIST *pComponentCandidate = NULL;
-    int numElem = 0;
-    int lowCompDetect = 0;
+    OMX_U32 nLoad = 0;
+    OMX_U32 nTotalLoad = 0;
+    OMX_U32 nPreemptableLoad = 0;
+    OMX_U32 nPriority = 0;
 
     FunctionIn();
 
@@ -275,79 +547,62 @@ OMX_ERRORTYPE SEC_OMX_Get_Resource(OMX_COMPONENTTYPE *pOMXComponent)
 
     pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
 
-    if (pSECComponent->codecType == HW_VIDEO_DEC_CODEC) {
-        pComponentTemp = gpVideoDecRMComponentList;
-        if (pComponentTemp != NULL) {
-            while (pComponentTemp) {
-                numElem++;
-                pComponentTemp = pComponentTemp->pNext;
-            }
-        } else {
-            numElem = 0;
+    if (pSECComponent->codecType == HW_VIDEO_DEC_CODEC)
+        ppComponentList = &gpVideoDecRMComponentList;
+    else if (pSECComponent->codecType == HW_VIDEO_ENC_CODEC)
+        ppComponentList = &gpVideoEncRMComponentList;
+    else
+        goto EXIT;
+
+    /* decoders and encoders share one MFC */
+    nPriority = pSECComponent->compPriority.nGroupPriority;
+    nLoad = getComponentLoad(pOMXComponent);
+    nTotalLoad = getListLoad(gpVideoDecRMComponentList) + getListLoad(gpVideoEncRMComponentList);
+
+    SEC_OSAL_Log(SEC_LOG_TRACE, "request load: %d MB/s, current load: %d MB/s, budget: %d MB/s",
+                 nLoad, nTotalLoad, MAX_RESOURCE_VIDEO_MB_PER_SEC);
+
+    if (nTotalLoad + nLoad > MAX_RESOURCE_VIDEO_MB_PER_SEC) {
+        /* do not preempt anyone unless the request fits afterwards */
+        nPreemptableLoad = getLowPriorityLoad(gpVideoDecRMComponentList, nPriority) +
+                           getLowPriorityLoad(gpVideoEncRMComponentList, nPriority);
+        if (nTotalLoad - nPreemptableLoad + nLoad > MAX_RESOURCE_VIDEO_MB_PER_SEC) {
+            ret = OMX_ErrorInsufficientResources;
+            goto EXIT;
         }
-        if (numElem >= MAX_RESOURCE_VIDEO_DEC) {
-            lowCompDetect = searchLowPriority(gpVideoDecRMComponentList, pSECComponent->compPriority.nGroupPriority, &pComponentCandidate);
-            if (lowCompDetect <= 0) {
-                ret = OMX_ErrorInsufficientResources;
-                goto EXIT;
+
+        while (nTotalLoad + nLoad > MAX_RESOURCE_VIDEO_MB_PER_SEC) {
+            SEC_OMX_RM_COMPONENT_LIST **ppCandidateList = NULL;
+
+            searchLowPriority(gpVideoDecRMComponentList, nPriority, &pDecCandidate);
+            searchLowPriority(gpVideoEncRMComponentList, nPriority, &pEncCandidate);
+            if ((pDecCandidate != NULL) &&
+                ((pEncCandidate == NULL) || (pDecCandidate->groupPriority >= pEncCandidate->groupPriority))) {
+                pComponentCandidate = pDecCandidate;
+                ppCandidateList = &gpVideoDecRMComponentList;
+            } else if (pEncCandidate != NULL) {
+                pComponentCandidate = pEncCandidate;
+                ppCandidateList = &gpVideoEncRMComponentList;
             } else {
-                ret = removeComponent(pComponentCandidate->pOMXStandComp);
-                if (ret != OMX_ErrorNone) {
-                    ret = OMX_ErrorInsufficientResources;
-                    goto EXIT;
-                } else {
-                    ret = removeElementList(&gpVideoDecRMComponentList, pComponentCandidate->pOMXStandComp);
-                    ret = addElementList(&gpVideoDecRMComponentList, pOMXComponent);
-                    if (ret != OMX_ErrorNone) {
-                        ret = OMX_ErrorInsufficientResources;
-                        goto EXIT;
-                    }
-                }
-            }
-        } else {
-            ret = addElementList(&gpVideoDecRMComponentList, pOMXComponent);
-            if (ret != OMX_ErrorNone) {
-                ret = OMX_ErrorInsufficientResources;
-                goto EXIT;
-            }
-        }
-    } else if (pSECComponent->codecType == HW_VIDEO_ENC_CODEC) {
-        pComponentTemp = gpVideoEncRMComponentList;
-        if (pComponentTemp != NULL) {
-            while (pComponentTemp) {
-                numElem++;
-                pComponentTemp = pComponentTemp->pNext;
-            }
-        } else {
-            numElem = 0;
-        }
-        if (numElem >= MAX_RESOURCE_VIDEO_ENC) {
-            lowCompDetect = searchLowPriority(gpVideoEncRMComponentList, pSECComponent->compPriority.nGroupPriority, &pComponentCandidate);
-            if (lowCompDetect <= 0) {
                 ret = OMX_ErrorInsufficientResources;
                 goto EXIT;
-            } else {
-                ret = removeComponent(pComponentCandidate->pOMXStandComp);
-                if (ret != OMX_ErrorNone) {
-                    ret = OMX_ErrorInsufficientResources;
-                    goto EXIT;
-                } else {
-                    ret = removeElementList(&gpVideoEncRMComponentList, pComponentCandidate->pOMXStandComp);
-                    ret = addElementList(&gpVideoEncRMComponentList, pOMXComponent);
-                    if (ret != OMX_ErrorNone) {
-                        ret = OMX_ErrorInsufficientResources;
-                        goto EXIT;
-                    }
-                }
             }
-        } else {
-            ret = addElementList(&gpVideoEncRMComponentList, pOMXComponent);
+
+            ret = removeComponent(pComponentCandidate->pOMXStandComp);
             if (ret != OMX_ErrorNone) {
                 ret = OMX_ErrorInsufficientResources;
                 goto EXIT;
             }
+            nTotalLoad -= pComponentCandidate->nLoad;
+            removeElementList(ppCandidateList, pComponentCandidate->pOMXStandComp);
         }
     }
+
+    ret = addElementList(ppComponentList, pOMXComponent);
+    if (ret != OMX_ErrorNone) {
+        ret = OMX_ErrorInsufficientResources;
+        goto EXIT;
+    }
     ret = OMX_ErrorNone;
 
 EXIT:
@@ -363,66 +618,35 @@ OMX_ERRORTYPE SEC_OMX_Release_Resource(OMX_COMPONENTTYPE *pOMXComponent)
 {
     OMX_ERRORTYPE              ret = OMX_ErrorNone;
     SEC_OMX_BASECOMPONENT     *pSECComponent = NULL;
-    SEC_OMX_RM_COMPONENT_LIST *pComponentTemp = NULL;
-    OMX_COMPONENTTYPE         *pOMXWaitComponent = NULL;
-    int numElem = 0;
+    SEC_OMX_RM_COMPONENT_LIST **ppComponentList = NULL;
 
     FunctionIn();
 
     SEC_OSAL_MutexLock(ghVideoRMComponentListMutex);
 
     pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
-    
-    if (pSECComponent->codecType == HW_VIDEO_DEC_CODEC) {
-        pComponentTemp = gpVideoDecRMWaitingList;
-        if (gpVideoDecRMComponentList == NULL) {
-            ret = OMX_ErrorUndefined;
-            goto EXIT;
-        }
 
-        ret = removeElementList(&gpVideoDecRMComponentList, pOMXComponent);
-        if (ret != OMX_ErrorNone) {
-            ret = OMX_ErrorUndefined;
-            goto EXIT;
-        }
-        while (pComponentTemp) {
-            numElem++;
-            pComponentTemp = pComponentTemp->pNext;
-        }
-        if (numElem > 0) {
-            pOMXWaitComponent = gpVideoDecRMWaitingList->pOMXStandComp;
-            removeElementList(&gpVideoDecRMWaitingList, pOMXWaitComponent);
-            ret = OMX_SendCommand(pOMXWaitComponent, OMX_CommandStateSet, OMX_StateIdle, NULL);
-            if (ret != OMX_ErrorNone) {
-                goto EXIT;
-            }
-        }
-    } else if (pSECComponent->codecType == HW_VIDEO_ENC_CODEC) {
-        pComponentTemp = gpVideoEncRMWaitingList;
-        if (gpVideoEncRMComponentList == NULL) {
-            ret = OMX_ErrorUndefined;
-            goto EXIT;
-        }
+    if (pSECComponent->codecType == HW_VIDEO_DEC_CODEC)
+        ppComponentList = &gpVideoDecRMComponentList;
+    else if (pSECComponent->codecType == HW_VIDEO_ENC_CODEC)
+        ppComponentList = &gpVideoEncRMComponentList;
+    else
+        goto EXIT;
 
-        ret = removeElementList(&gpVideoEncRMComponentList, pOMXComponent);
-        if (ret != OMX_ErrorNone) {
-            ret = OMX_ErrorUndefined;
-            goto EXIT;
-        }
-        while (pComponentTemp) {
-            numElem++;
-            pComponentTemp = pComponentTemp->pNext;
-        }
-        if (numElem > 0) {
-            pOMXWaitComponent = gpVideoEncRMWaitingList->pOMXStandComp;
-            removeElementList(&gpVideoEncRMWaitingList, pOMXWaitComponent);
-            ret = OMX_SendCommand(pOMXWaitComponent, OMX_CommandStateSet, OMX_StateIdle, NULL);
-            if (ret != OMX_ErrorNone) {
-                goto EXIT;
-            }
-        }
+    if (*ppComponentList == NULL) {
+        ret = OMX_ErrorUndefined;
+        goto EXIT;
     }
 
+    ret = removeElementList(ppComponentList, pOMXComponent);
+    if (ret != OMX_ErrorNone) {
+        ret = OMX_ErrorUndefined;
+        goto EXIT;
+    }
+
+    /* decoders and encoders share one MFC, serve both waiting heaps */
+    ret = wakeWaitingComponents();
+
 EXIT:
 
     SEC_OSAL_MutexUnlock(ghVideoRMComponentListMutex);
@@ -443,9 +667,9 @@ OMX_ERRORTYPE SEC_OMX_In_WaitForResource(OMX_COMPONENTTYPE *pOMXComponent)
 
     pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
     if (pSECComponent->codecType == HW_VIDEO_DEC_CODEC)
-        ret = addElementList(&gpVideoDecRMWaitingList, pOMXComponent);
+        ret = pushWaitingHeap(&gVideoDecRMWaitingHeap, pOMXComponent);
     else if (pSECComponent->codecType == HW_VIDEO_ENC_CODEC)
-        ret = addElementList(&gpVideoEncRMWaitingList, pOMXComponent);
+        ret = pushWaitingHeap(&gVideoEncRMWaitingHeap, pOMXComponent);
 
     SEC_OSAL_MutexUnlock(ghVideoRMComponentListMutex);
 
@@ -456,18 +680,39 @@ OMX_ERRORTYPE SEC_OMX_In_WaitForResource(OMX_COMPONENTTYPE *pOMXComponent)
 
 OMX_ERRORTYPE SEC_OMX_Out_WaitForResource(OMX_COMPONENTTYPE *pOMXComponent)
 {
-    OMX_ERRORTYPE          ret = OMX_ErrorNone;
-    SEC_OMX_BASECOMPONENT *pSECComponent = NULL;
+    OMX_ERRORTYPE               ret = OMX_ErrorNone;
+    SEC_OMX_BASECOMPONENT      *pSECComponent = NULL;
+    SEC_OMX_RM_WAITING_HEAP    *pHeap = NULL;
+    SEC_OMX_RM_COMPONENT_LIST **ppComponentList = NULL;
 
     FunctionIn();
 
     SEC_OSAL_MutexLock(ghVideoRMComponentListMutex);
 
     pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
-    if (pSECComponent->codecType == HW_VIDEO_DEC_CODEC)
-        ret = removeElementList(&gpVideoDecRMWaitingList, pOMXComponent);
-    else if (pSECComponent->codecType == HW_VIDEO_ENC_CODEC)
-        ret = removeElementList(&gpVideoEncRMWaitingList, pOMXComponent);
+    if (pSECComponent->codecType == HW_VIDEO_DEC_CODEC) {
+        pHeap = &gVideoDecRMWaitingHeap;
+        ppComponentList = &gpVideoDecRMComponentList;
+    } else if (pSECComponent->codecType == HW_VIDEO_ENC_CODEC) {
+        pHeap = &gVideoEncRMWaitingHeap;
+        ppComponentList = &gpVideoEncRMComponentList;
+    } else {
+        goto EXIT;
+    }
+
+    ret = removeWaitingHeap(pHeap, pOMXComponent, NULL);
+    if (ret == OMX_ErrorNone)
+        goto EXIT;
+
+    /* already woken and admitted, but left for Loaded before its Idle command ran */
+    ret = removeElementList(ppComponentList, pOMXComponent);
+    if (ret != OMX_ErrorNone) {
+        ret = OMX_ErrorNone;
+        goto EXIT;
+    }
+    ret = wakeWaitingComponents();
+
+EXIT:
 
     SEC_OSAL_MutexUnlock(ghVideoRMComponentListMutex);
 
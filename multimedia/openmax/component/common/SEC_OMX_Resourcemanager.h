@@ -37,9 +37,27 @@ typedef struct _SEC_OMX_RM_COMPONENT_LIST
 {
     OMX_COMPONENTTYPE         *pOMXStandComp;
     OMX_U32                    groupPriority;
+    OMX_U32                    nLoad;          /* macroblocks per second */
     struct _SEC_OMX_RM_COMPONENT_LIST *pNext;
 } SEC_OMX_RM_COMPONENT_LIST;
 
+typedef struct _SEC_OMX_RM_WAITING_ELEMENT
+{
+    OMX_COMPONENTTYPE *pOMXStandComp;
+    OMX_U32            groupPriority;
+    OMX_U32            nLoad;          /* macroblocks per second */
+    OMX_U64            waitStartTime;  /* usec */
+    OMX_U64            key;            /* ordering key, smaller is served first */
+} SEC_OMX_RM_WAITING_ELEMENT;
+
+/* binary min heap of components waiting for resource */
+typedef struct _SEC_OMX_RM_WAITING_HEAP
+{
+    SEC_OMX_RM_WAITING_ELEMENT *pElement;
+    OMX_U32                     nElement;
+    OMX_U32                     nAlloc;
+} SEC_OMX_RM_WAITING_HEAP;
+
 
 #ifdef __cplusplus
 extern "C" {
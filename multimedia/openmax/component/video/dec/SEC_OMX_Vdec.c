@@ -163,6 +163,7 @@ OMX_ERRORTYPE SEC_OMX_UseBuffer(
                 temp_bufferHeader->nInputPortIndex = INPUT_PORT_INDEX;
             else
                 temp_bufferHeader->nOutputPortIndex = OUTPUT_PORT_INDEX;
+            SET_BUFFER_HEADER_INDEX(temp_bufferHeader, nPortIndex, i);
 
             pSECPort->assignedBufferNum++;
             if (pSECPort->assignedBufferNum == pSECPort->portDefinition.nBufferCountActual) {
@@ -274,6 +275,7 @@ OMX_ERRORTYPE SEC_OMX_AllocateBuffer(
                 temp_bufferHeader->nInputPortIndex = INPUT_PORT_INDEX;
             else
                 temp_bufferHeader->nOutputPortIndex = OUTPUT_PORT_INDEX;
+            SET_BUFFER_HEADER_INDEX(temp_bufferHeader, nPortIndex, i);
             pSECPort->assignedBufferNum++;
             if (pSECPort->assignedBufferNum == pSECPort->portDefinition.nBufferCountActual) {
                 pSECPort->portDefinition.bPopulated = OMX_TRUE;
@@ -2,7 +2,8 @@ LOCAL_PATH := $(call my-dir)
 include $(CLEAR_VARS)
 
 LOCAL_SRC_FILES := \
-	SEC_OMX_Venc.c
+	SEC_OMX_Venc.c \
+	SEC_OMX_SceneChange.c
 
 LOCAL_MODULE := libSEC_OMX_Venc
 LOCAL_ARM_MODE := arm
@@ -20,6 +21,10 @@ ifeq ($(BOARD_USE_METADATABUFFERTYPE), true)
 LOCAL_CFLAGS += -DUSE_METADATABUFFERTYPE
 endif
 
+ifeq ($(BOARD_USE_OPAQUE_NV12T), true)
+LOCAL_CFLAGS += -DUSE_OPAQUE_NV12T
+endif
+
 ifeq ($(BOARD_USE_STOREMETADATA), true)
 LOCAL_CFLAGS += -DUSE_STOREMETADATA
 endif
@@ -0,0 +1,249 @@
+/*
+ *
+ * Copyright 2010 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file        SEC_OMX_SceneChange.c
+ * @brief       Scene change detector of the video encoder
+ * @version     1.1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SEC_OMX_Macros.h"
+#include "SEC_OSAL_Memory.h"
+#include "SEC_OMX_SceneChange.h"
+
+#ifdef __ARM_NEON__
+#include <arm_neon.h>
+#endif
+
+#undef  SEC_LOG_TAG
+#define SEC_LOG_TAG    "SEC_SCENE_CHANGE"
+#define SEC_LOG_OFF
+#include "SEC_OSAL_Log.h"
+
+
+/* sum of 64 luma samples */
+static inline OMX_U32 SEC_SceneChange_RowSum64(const OMX_U8 *pSrc)
+{
+#ifdef __ARM_NEON__
+    uint16x8_t sum16;
+    uint32x4_t sum32;
+    uint64x2_t sum64;
+
+    sum16 = vpaddlq_u8(vld1q_u8(pSrc));
+    sum16 = vpadalq_u8(sum16, vld1q_u8(pSrc + 16));
+    sum16 = vpadalq_u8(sum16, vld1q_u8(pSrc + 32));
+    sum16 = vpadalq_u8(sum16, vld1q_u8(pSrc + 48));
+    sum32 = vpaddlq_u16(sum16);
+    sum64 = vpaddlq_u32(sum32);
+
+    return (OMX_U32)(vgetq_lane_u64(sum64, 0) + vgetq_lane_u64(sum64, 1));
+#else
+    OMX_U32 sum = 0;
+    int i;
+
+    for (i = 0; i < SCENECHANGE_BLOCK_WIDTH; i++)
+        sum += pSrc[i];
+
+    return sum;
+#endif
+}
+
+/* sum of absolute differences of two signatures */
+static OMX_U32 SEC_SceneChange_SAD(const OMX_U8 *pCur, const OMX_U8 *pPrev, OMX_U32 nLen)
+{
+    OMX_U32 sad = 0;
+    OMX_U32 i = 0;
+
+#ifdef __ARM_NEON__
+    uint32x4_t sum32 = vdupq_n_u32(0);
+    uint64x2_t sum64;
+
+    for (; i + 16 <= nLen; i += 16) {
+        uint16x8_t sum16 = vpaddlq_u8(vabdq_u8(vld1q_u8(pCur + i), vld1q_u8(pPrev + i)));
+        sum32 = vpadalq_u16(sum32, sum16);
+    }
+    sum64 = vpaddlq_u32(sum32);
+    sad = (OMX_U32)(vgetq_lane_u64(sum64, 0) + vgetq_lane_u64(sum64, 1));
+#endif
+    for (; i < nLen; i++)
+        sad += (pCur[i] > pPrev[i]) ? (pCur[i] - pPrev[i]) : (pPrev[i] - pCur[i]);
+
+    return sad;
+}
+
+/*
+ * Builds the downsampled luma signature: the mean of every 64x32 block,
+ * sampled on every SCENECHANGE_ROW_STEP-th row.
+ * For NV12T a block is exactly one tile, for linear Y only whole blocks are used.
+ */
+static OMX_U32 SEC_SceneChange_Signature(
+    OMX_U8   *pSignature,
+    OMX_U8   *pY,
+    OMX_U32   width,
+    OMX_U32   height,
+    OMX_BOOL  bTiled)
+{
+    OMX_U32 nBlockNum = 0;
+    OMX_U32 x, y, row;
+    OMX_U32 sum;
+
+    if (bTiled == OMX_TRUE) {
+        OMX_U32 nTileNum = (ALIGN_TO_128B(width) / SCENECHANGE_BLOCK_WIDTH) *
+                           (ALIGN_TO_32B(height) / SCENECHANGE_BLOCK_HEIGHT);
+        OMX_U8 *pTile = pY;
+
+        for (nBlockNum = 0; nBlockNum < nTileNum; nBlockNum++) {
+            sum = 0;
+            for (row = 0; row < SCENECHANGE_BLOCK_HEIGHT; row += SCENECHANGE_ROW_STEP)
+                sum += SEC_SceneChange_RowSum64(pTile + (row * SCENECHANGE_BLOCK_WIDTH));
+            pSignature[nBlockNum] = (OMX_U8)(sum / ((SCENECHANGE_BLOCK_HEIGHT / SCENECHANGE_ROW_STEP) * SCENECHANGE_BLOCK_WIDTH));
+            pTile += SCENECHANGE_BLOCK_WIDTH * SCENECHANGE_BLOCK_HEIGHT;
+        }
+    } else {
+        for (y = 0; y + SCENECHANGE_BLOCK_HEIGHT <= height; y += SCENECHANGE_BLOCK_HEIGHT) {
+            for (x = 0; x + SCENECHANGE_BLOCK_WIDTH <= width; x += SCENECHANGE_BLOCK_WIDTH) {
+                sum = 0;
+                for (row = 0; row < SCENECHANGE_BLOCK_HEIGHT; row += SCENECHANGE_ROW_STEP)
+                    sum += SEC_SceneChange_RowSum64(pY + ((y + row) * width) + x);
+                pSignature[nBlockNum++] = (OMX_U8)(sum / ((SCENECHANGE_BLOCK_HEIGHT / SCENECHANGE_ROW_STEP) * SCENECHANGE_BLOCK_WIDTH));
+            }
+        }
+    }
+
+    return nBlockNum;
+}
+
+/* histogram distance of two signatures, 0 ~ 1000 */
+static OMX_U32 SEC_SceneChange_HistDistance(const OMX_U8 *pCur, const OMX_U8 *pPrev, OMX_U32 nLen)
+{
+    OMX_U32 histCur[SCENECHANGE_HIST_BINS];
+    OMX_U32 histPrev[SCENECHANGE_HIST_BINS];
+    OMX_U32 distance = 0;
+    OMX_U32 i;
+
+    SEC_OSAL_Memset(histCur, 0, sizeof(histCur));
+    SEC_OSAL_Memset(histPrev, 0, sizeof(histPrev));
+
+    for (i = 0; i < nLen; i++) {
+        histCur[pCur[i] * SCENECHANGE_HIST_BINS / 256]++;
+        histPrev[pPrev[i] * SCENECHANGE_HIST_BINS / 256]++;
+    }
+
+    for (i = 0; i < SCENECHANGE_HIST_BINS; i++)
+        distance += (histCur[i] > histPrev[i]) ? (histCur[i] - histPrev[i]) : (histPrev[i] - histCur[i]);
+
+    return (distance * 1000) / (2 * nLen);
+}
+
+/*
+ * Scores the frame in the MFC input buffer against the previous one.
+ * Returns OMX_TRUE when both the block SAD and the histogram distance
+ * exceed their thresholds, the caller then requests an IDR.
+ */
+OMX_BOOL SEC_SceneChange_Process(
+    SEC_OMX_VIDEOENC_SCENECHANGE *pSceneChange,
+    OMX_U8                       *pY,
+    OMX_U32                       width,
+    OMX_U32                       height,
+    OMX_BOOL                      bTiled)
+{
+    OMX_BOOL bSceneChange = OMX_FALSE;
+    OMX_U32 nMaxBlockNum;
+    OMX_U32 nBlockNum;
+    OMX_U8 *pCur, *pPrev;
+
+    if ((pSceneChange->bEnable != OMX_TRUE) || (pY == NULL))
+        return OMX_FALSE;
+
+    nMaxBlockNum = (ALIGN_TO_128B(width) / SCENECHANGE_BLOCK_WIDTH) *
+                   (ALIGN_TO_32B(height) / SCENECHANGE_BLOCK_HEIGHT);
+    if (pSceneChange->nSignatureSize < nMaxBlockNum) {
+        if (pSceneChange->pSignature[0] != NULL)
+            SEC_OSAL_Free(pSceneChange->pSignature[0]);
+        pSceneChange->nSignatureSize = 0;
+        pSceneChange->pSignature[0] = SEC_OSAL_Malloc(nMaxBlockNum * 2);
+        if (pSceneChange->pSignature[0] == NULL) {
+            SEC_OSAL_Log(SEC_LOG_ERROR, "%s: signature alloc failed, disabled", __FUNCTION__);
+            pSceneChange->bEnable = OMX_FALSE;
+            return OMX_FALSE;
+        }
+        pSceneChange->pSignature[1] = pSceneChange->pSignature[0] + nMaxBlockNum;
+        pSceneChange->nSignatureSize = nMaxBlockNum;
+        pSceneChange->bValidPrevious = OMX_FALSE;
+    }
+
+    pCur = pSceneChange->pSignature[pSceneChange->indexSignature];
+    pPrev = pSceneChange->pSignature[pSceneChange->indexSignature ^ 1];
+
+    nBlockNum = SEC_SceneChange_Signature(pCur, pY, width, height, bTiled);
+    pSceneChange->nFrameCount++;
+    pSceneChange->nFramesSinceIntra++;
+
+    if ((nBlockNum != 0) && (pSceneChange->bValidPrevious == OMX_TRUE) &&
+        (nBlockNum == pSceneChange->nBlockNum)) {
+        pSceneChange->nLastSADScore = SEC_SceneChange_SAD(pCur, pPrev, nBlockNum) / nBlockNum;
+        pSceneChange->nLastHistScore = SEC_SceneChange_HistDistance(pCur, pPrev, nBlockNum);
+
+        SEC_OSAL_Log(SEC_LOG_TRACE, "scene change score frame:%d sad:%d hist:%d",
+                     pSceneChange->nFrameCount, pSceneChange->nLastSADScore, pSceneChange->nLastHistScore);
+
+        if ((pSceneChange->nLastSADScore >= pSceneChange->nSADThreshold) &&
+            (pSceneChange->nLastHistScore >= pSceneChange->nHistThreshold) &&
+            (pSceneChange->nFramesSinceIntra >= pSceneChange->nMinIntraDistance)) {
+            SEC_OSAL_Log(SEC_LOG_TRACE, "scene change at frame %d, request IDR", pSceneChange->nFrameCount);
+            bSceneChange = OMX_TRUE;
+            pSceneChange->nSceneChangeCount++;
+            pSceneChange->nFramesSinceIntra = 0;
+        }
+    } else {
+        pSceneChange->nLastSADScore = 0;
+        pSceneChange->nLastHistScore = 0;
+    }
+
+    pSceneChange->nBlockNum = nBlockNum;
+    pSceneChange->bValidPrevious = (nBlockNum != 0) ? OMX_TRUE : OMX_FALSE;
+    pSceneChange->indexSignature ^= 1;
+
+    return bSceneChange;
+}
+
+/*
+ * Forgets the previous frame, so the first frame after a flush or seek
+ * is not compared against a frame from before it.
+ */
+void SEC_SceneChange_Reset(SEC_OMX_VIDEOENC_SCENECHANGE *pSceneChange)
+{
+    pSceneChange->bValidPrevious = OMX_FALSE;
+    pSceneChange->nBlockNum = 0;
+    pSceneChange->indexSignature = 0;
+    pSceneChange->nLastSADScore = 0;
+    pSceneChange->nLastHistScore = 0;
+}
+
+void SEC_SceneChange_Deinit(SEC_OMX_VIDEOENC_SCENECHANGE *pSceneChange)
+{
+    if (pSceneChange->pSignature[0] != NULL) {
+        SEC_OSAL_Free(pSceneChange->pSignature[0]);
+        pSceneChange->pSignature[0] = NULL;
+        pSceneChange->pSignature[1] = NULL;
+    }
+    pSceneChange->nSignatureSize = 0;
+    pSceneChange->bValidPrevious = OMX_FALSE;
+}
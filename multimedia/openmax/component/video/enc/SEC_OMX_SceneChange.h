@@ -0,0 +1,73 @@
+/*
+ *
+ * Copyright 2010 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file        SEC_OMX_SceneChange.h
+ * @brief       Scene change detector of the video encoder
+ * @version     1.1.0
+ */
+
+#ifndef SEC_OMX_SCENE_CHANGE
+#define SEC_OMX_SCENE_CHANGE
+
+#include "OMX_Types.h"
+
+#define SCENECHANGE_BLOCK_WIDTH             64
+#define SCENECHANGE_BLOCK_HEIGHT            32
+#define SCENECHANGE_ROW_STEP                4
+#define SCENECHANGE_HIST_BINS               16
+#define DEFAULT_SCENECHANGE_SAD_THRESHOLD   30
+#define DEFAULT_SCENECHANGE_HIST_THRESHOLD  300
+#define DEFAULT_SCENECHANGE_MIN_DISTANCE    15
+
+typedef struct _SEC_OMX_VIDEOENC_SCENECHANGE
+{
+    OMX_BOOL bEnable;
+    OMX_U32  nSADThreshold;
+    OMX_U32  nHistThreshold;
+    OMX_U32  nMinIntraDistance;
+    OMX_U32  nFramesSinceIntra;
+    OMX_U32  nBlockNum;
+    OMX_U8  *pSignature[2];     /* downsampled luma of current and previous frame */
+    OMX_U32  nSignatureSize;
+    OMX_U32  indexSignature;
+    OMX_BOOL bValidPrevious;
+    OMX_U32  nLastSADScore;
+    OMX_U32  nLastHistScore;
+    OMX_U32  nFrameCount;
+    OMX_U32  nSceneChangeCount;
+} SEC_OMX_VIDEOENC_SCENECHANGE;
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+OMX_BOOL SEC_SceneChange_Process(
+    SEC_OMX_VIDEOENC_SCENECHANGE *pSceneChange,
+    OMX_U8                       *pY,
+    OMX_U32                       width,
+    OMX_U32                       height,
+    OMX_BOOL                      bTiled);
+void SEC_SceneChange_Reset(SEC_OMX_VIDEOENC_SCENECHANGE *pSceneChange);
+void SEC_SceneChange_Deinit(SEC_OMX_VIDEOENC_SCENECHANGE *pSceneChange);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -143,6 +143,7 @@ OMX_ERRORTYPE SEC_OMX_UseBuffer(
                 temp_bufferHeader->nInputPortIndex = INPUT_PORT_INDEX;
             else
                 temp_bufferHeader->nOutputPortIndex = OUTPUT_PORT_INDEX;
+            SET_BUFFER_HEADER_INDEX(temp_bufferHeader, nPortIndex, i);
 
             pSECPort->assignedBufferNum++;
             if (pSECPort->assignedBufferNum == pSECPort->portDefinition.nBufferCountActual) {
@@ -242,6 +243,7 @@ OMX_ERRORTYPE SEC_OMX_AllocateBuffer(
                 temp_bufferHeader->nInputPortIndex = INPUT_PORT_INDEX;
             else
                 temp_bufferHeader->nOutputPortIndex = OUTPUT_PORT_INDEX;
+            SET_BUFFER_HEADER_INDEX(temp_bufferHeader, nPortIndex, i);
             pSECPort->assignedBufferNum++;
             if (pSECPort->assignedBufferNum == pSECPort->portDefinition.nBufferCountActual) {
                 pSECPort->portDefinition.bPopulated = OMX_TRUE;
@@ -654,6 +656,18 @@ static OMX_ERRORTYPE SEC_DataReset(OMX_COMPONENTTYPE *pOMXComponent, OMX_U32 por
     return ret;
 }
 
+static OMX_ERRORTYPE SEC_FlushReset(OMX_COMPONENTTYPE *pOMXComponent, OMX_U32 portIndex)
+{
+    SEC_OMX_BASECOMPONENT      *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_OMX_VIDEOENC_COMPONENT *pVideoEnc = (SEC_OMX_VIDEOENC_COMPONENT *)pSECComponent->hComponentHandle;
+
+    /* frames after a flush or seek do not follow the ones before it */
+    if ((portIndex == INPUT_PORT_INDEX) && (pVideoEnc != NULL))
+        SEC_SceneChange_Reset(&pVideoEnc->sceneChange);
+
+    return OMX_ErrorNone;
+}
+
 OMX_BOOL SEC_Preprocessor_InputData(OMX_COMPONENTTYPE *pOMXComponent)
 {
     OMX_BOOL               ret = OMX_FALSE;
@@ -807,7 +821,12 @@ OMX_BOOL SEC_Preprocessor_InputData(OMX_COMPONENTTYPE *pOMXComponent)
                         if (pSECPort->portDefinition.format.video.eColorFormat == OMX_COLOR_FormatAndroidOpaque) {
                                 OMX_PTR pOutBuffer;
                                 csc_src_color_format = omx_2_hal_pixel_format((unsigned int)OMX_COLOR_Format32bitARGB8888);
+#ifdef USE_OPAQUE_NV12T
+                                /* MFC takes NV12T directly, ARGB is tiled in one pass */
+                                csc_dst_color_format = omx_2_hal_pixel_format((unsigned int)OMX_SEC_COLOR_FormatNV12Tiled);
+#else
                                 csc_dst_color_format = omx_2_hal_pixel_format((unsigned int)OMX_COLOR_FormatYUV420SemiPlanar);
+#endif
 
                                 SEC_OSAL_GetInfoFromMetaData(inputData, ppBuf);
                                 SEC_OSAL_LockANBHandle((OMX_U32)ppBuf[0], width, height, OMX_COLOR_FormatAndroidOpaque, &pOutBuffer);
@@ -852,6 +871,21 @@ OMX_BOOL SEC_Preprocessor_InputData(OMX_COMPONENTTYPE *pOMXComponent)
                         0);                     /* ion fd */
                     csc_convert(pVideoEnc->csc_handle);
 
+                    if (pVideoEnc->sceneChange.bEnable == OMX_TRUE) {
+                        OMX_BOOL bTiled = OMX_FALSE;
+
+                        if (pSECPort->portDefinition.format.video.eColorFormat == OMX_SEC_COLOR_FormatNV12Tiled)
+                            bTiled = OMX_TRUE;
+#if defined(USE_METADATABUFFERTYPE) && defined(USE_OPAQUE_NV12T)
+                        if (pSECPort->portDefinition.format.video.eColorFormat == OMX_COLOR_FormatAndroidOpaque)
+                            bTiled = OMX_TRUE;
+#endif
+                        if (SEC_SceneChange_Process(&pVideoEnc->sceneChange, pDstBuf[0], width, height, bTiled) == OMX_TRUE) {
+                            pVideoEnc->IntraRefreshVOP = OMX_TRUE;
+                            pVideoEnc->configChange = OMX_TRUE;
+                        }
+                    }
+
 #ifdef USE_METADATABUFFERTYPE
                     if (pSECPort->bStoreMetaData == OMX_TRUE) {
                         SEC_OSAL_UnlockANBHandle((OMX_U32)ppBuf[0]);
@@ -1596,6 +1630,25 @@ OMX_ERRORTYPE SEC_OMX_VideoEncodeGetConfig(
         }
     }
         break;
+    case OMX_IndexConfigVideoSceneChange:
+    {
+        SEC_OMX_VIDEO_CONFIG_SCENECHANGETYPE *pConfig = (SEC_OMX_VIDEO_CONFIG_SCENECHANGETYPE *)pComponentConfigStructure;
+        SEC_OMX_VIDEOENC_SCENECHANGE *pSceneChange = &((SEC_OMX_VIDEOENC_COMPONENT *)pSECComponent->hComponentHandle)->sceneChange;
+
+        if (pConfig->nPortIndex != INPUT_PORT_INDEX) {
+            ret = OMX_ErrorBadPortIndex;
+            goto EXIT;
+        }
+        pConfig->bEnable           = pSceneChange->bEnable;
+        pConfig->nSADThreshold     = pSceneChange->nSADThreshold;
+        pConfig->nHistThreshold    = pSceneChange->nHistThreshold;
+        pConfig->nMinIntraDistance = pSceneChange->nMinIntraDistance;
+        pConfig->nLastSADScore     = pSceneChange->nLastSADScore;
+        pConfig->nLastHistScore    = pSceneChange->nLastHistScore;
+        pConfig->nFrameCount       = pSceneChange->nFrameCount;
+        pConfig->nSceneChangeCount = pSceneChange->nSceneChangeCount;
+    }
+        break;
     default:
         ret = SEC_OMX_SetConfig(hComponent, nIndex, pComponentConfigStructure);
         break;
@@ -1683,6 +1736,23 @@ OMX_ERRORTYPE SEC_OMX_VideoEncodeSetConfig(
         }
     }
         break;
+    case OMX_IndexConfigVideoSceneChange:
+    {
+        SEC_OMX_VIDEO_CONFIG_SCENECHANGETYPE *pConfig = (SEC_OMX_VIDEO_CONFIG_SCENECHANGETYPE *)pComponentConfigStructure;
+        SEC_OMX_VIDEOENC_SCENECHANGE *pSceneChange = &((SEC_OMX_VIDEOENC_COMPONENT *)pSECComponent->hComponentHandle)->sceneChange;
+
+        if (pConfig->nPortIndex != INPUT_PORT_INDEX) {
+            ret = OMX_ErrorBadPortIndex;
+            goto EXIT;
+        }
+        if (pConfig->bEnable == OMX_TRUE && pSceneChange->bEnable == OMX_FALSE)
+            pSceneChange->bValidPrevious = OMX_FALSE;
+        pSceneChange->bEnable           = pConfig->bEnable;
+        pSceneChange->nSADThreshold     = pConfig->nSADThreshold;
+        pSceneChange->nHistThreshold    = pConfig->nHistThreshold;
+        pSceneChange->nMinIntraDistance = pConfig->nMinIntraDistance;
+    }
+        break;
     default:
         ret = SEC_OMX_SetConfig(hComponent, nIndex, pComponentConfigStructure);
         break;
@@ -1730,6 +1800,11 @@ OMX_ERRORTYPE SEC_OMX_VideoEncodeGetExtensionIndex(
         goto EXIT;
     }
 
+    if (SEC_OSAL_Strcmp(cParameterName, SEC_INDEX_CONFIG_VIDEO_SCENECHANGE) == 0) {
+        *pIndexType = (OMX_INDEXTYPE) OMX_IndexConfigVideoSceneChange;
+        goto EXIT;
+    }
+
 #ifdef USE_STOREMETADATA
     if (SEC_OSAL_Strcmp(cParameterName, SEC_INDEX_PARAM_STORE_METADATA_BUFFER) == 0) {
         *pIndexType = (OMX_INDEXTYPE) OMX_IndexParamStoreMetaDataBuffer;
@@ -1800,6 +1875,11 @@ OMX_ERRORTYPE SEC_OMX_VideoEncodeComponentInit(OMX_IN OMX_HANDLETYPE hComponent)
     pVideoEnc->quantization.nQpP = 20;
     pVideoEnc->quantization.nQpB = 20;
 
+    pVideoEnc->sceneChange.bEnable = OMX_FALSE;
+    pVideoEnc->sceneChange.nSADThreshold = DEFAULT_SCENECHANGE_SAD_THRESHOLD;
+    pVideoEnc->sceneChange.nHistThreshold = DEFAULT_SCENECHANGE_HIST_THRESHOLD;
+    pVideoEnc->sceneChange.nMinIntraDistance = DEFAULT_SCENECHANGE_MIN_DISTANCE;
+
     /* Input port */
     pSECPort = &pSECComponent->pSECPort[INPUT_PORT_INDEX];
     pSECPort->portDefinition.nBufferCountActual = MAX_VIDEO_INPUTBUFFER_NUM;
@@ -1857,6 +1937,7 @@ OMX_ERRORTYPE SEC_OMX_VideoEncodeComponentInit(OMX_IN OMX_HANDLETYPE hComponent)
     pSECComponent->sec_FreeTunnelBuffer     = &SEC_OMX_FreeTunnelBuffer;
     pSECComponent->sec_BufferProcess        = &SEC_OMX_BufferProcess;
     pSECComponent->sec_BufferReset          = &SEC_BufferReset;
+    pSECComponent->sec_FlushReset           = &SEC_FlushReset;
     pSECComponent->sec_InputBufferReturn    = &SEC_InputBufferReturn;
     pSECComponent->sec_OutputBufferReturn   = &SEC_OutputBufferReturn;
 
@@ -1894,6 +1975,7 @@ OMX_ERRORTYPE SEC_OMX_VideoEncodeComponentDeinit(OMX_IN OMX_HANDLETYPE hComponen
     pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
 
     pVideoEnc = (SEC_OMX_VIDEOENC_COMPONENT *)pSECComponent->hComponentHandle;
+    SEC_SceneChange_Deinit(&pVideoEnc->sceneChange);
     SEC_OSAL_Free(pVideoEnc);
     pSECComponent->hComponentHandle = pVideoEnc = NULL;
 
@@ -33,6 +33,7 @@
 #include "SEC_OSAL_Queue.h"
 #include "SEC_OMX_Baseport.h"
 #include "SEC_OMX_Basecomponent.h"
+#include "SEC_OMX_SceneChange.h"
 
 #define MAX_VIDEO_INPUTBUFFER_NUM    5
 #define MAX_VIDEO_OUTPUTBUFFER_NUM   4
@@ -99,6 +100,9 @@ typedef struct _SEC_OMX_VIDEOENC_COMPONENT
 
     /* CSC handle */
     OMX_PTR csc_handle;
+
+    /* scene change detection */
+    SEC_OMX_VIDEOENC_SCENECHANGE sceneChange;
 } SEC_OMX_VIDEOENC_COMPONENT;
 
 #ifdef __cplusplus
@@ -21,6 +21,10 @@ ifeq ($(BOARD_USE_METADATABUFFERTYPE), true)
 LOCAL_CFLAGS += -DUSE_METADATABUFFERTYPE
 endif
 
+ifeq ($(BOARD_USE_OPAQUE_NV12T), true)
+LOCAL_CFLAGS += -DUSE_OPAQUE_NV12T
+endif
+
 #ifeq ($(BOARD_USE_H264_PREPEND_SPS_PPS), true)
 #LOCAL_CFLAGS += -DUSE_H264_PREPEND_SPS_PPS
 #endif
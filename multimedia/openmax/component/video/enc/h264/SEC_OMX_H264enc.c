@@ -275,13 +275,16 @@ void Set_H264Enc_Param(SSBSIP_MFC_ENC_H264_PARAM *pH264Arg, SEC_OMX_BASECOMPONEN
     case OMX_SEC_COLOR_FormatNV12LVirtualAddress:
     case OMX_COLOR_FormatYUV420SemiPlanar:
     case OMX_COLOR_FormatYUV420Planar:
-#ifdef USE_METADATABUFFERTYPE
+#if defined(USE_METADATABUFFERTYPE) && !defined(USE_OPAQUE_NV12T)
     case OMX_COLOR_FormatAndroidOpaque:
 #endif
         pH264Arg->FrameMap = NV12_LINEAR;
         break;
     case OMX_SEC_COLOR_FormatNV12TPhysicalAddress:
     case OMX_SEC_COLOR_FormatNV12Tiled:
+#if defined(USE_METADATABUFFERTYPE) && defined(USE_OPAQUE_NV12T)
+    case OMX_COLOR_FormatAndroidOpaque:
+#endif
         pH264Arg->FrameMap = NV12_TILE;
         break;
     case OMX_SEC_COLOR_FormatNV21LPhysicalAddress:
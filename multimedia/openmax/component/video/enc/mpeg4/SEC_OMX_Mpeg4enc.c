@@ -253,13 +253,16 @@ void Set_Mpeg4Enc_Param(SSBSIP_MFC_ENC_MPEG4_PARAM *pMpeg4Param, SEC_OMX_BASECOM
     case OMX_SEC_COLOR_FormatNV12LVirtualAddress:
     case OMX_COLOR_FormatYUV420SemiPlanar:
     case OMX_COLOR_FormatYUV420Planar:
-#ifdef METADATABUFFERTYPE
+#if defined(USE_METADATABUFFERTYPE) && !defined(USE_OPAQUE_NV12T)
     case OMX_COLOR_FormatAndroidOpaque:
 #endif
         pMpeg4Param->FrameMap = NV12_LINEAR;
         break;
     case OMX_SEC_COLOR_FormatNV12TPhysicalAddress:
     case OMX_SEC_COLOR_FormatNV12Tiled:
+#if defined(USE_METADATABUFFERTYPE) && defined(USE_OPAQUE_NV12T)
+    case OMX_COLOR_FormatAndroidOpaque:
+#endif
         pMpeg4Param->FrameMap = NV12_TILE;
         break;
     case OMX_SEC_COLOR_FormatNV21LPhysicalAddress:
@@ -372,10 +375,16 @@ void Set_H263Enc_Param(SSBSIP_MFC_ENC_H263_PARAM *pH263Param, SEC_OMX_BASECOMPON
     case OMX_SEC_COLOR_FormatNV12LPhysicalAddress:
     case OMX_SEC_COLOR_FormatNV12LVirtualAddress:
     case OMX_COLOR_FormatYUV420SemiPlanar:
+#if defined(USE_METADATABUFFERTYPE) && !defined(USE_OPAQUE_NV12T)
+    case OMX_COLOR_FormatAndroidOpaque:
+#endif
         pH263Param->FrameMap = NV12_LINEAR;
         break;
     case OMX_SEC_COLOR_FormatNV12TPhysicalAddress:
     case OMX_SEC_COLOR_FormatNV12Tiled:
+#if defined(USE_METADATABUFFERTYPE) && defined(USE_OPAQUE_NV12T)
+    case OMX_COLOR_FormatAndroidOpaque:
+#endif
         pH263Param->FrameMap = NV12_TILE;
         break;
     case OMX_SEC_COLOR_FormatNV21LPhysicalAddress:
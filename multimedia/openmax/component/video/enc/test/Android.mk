@@ -0,0 +1,18 @@
+LOCAL_PATH := $(call my-dir)
+
+# scene change detector of the video encoder: scene_change_test
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := \
+	scene_change_test.c \
+	../SEC_OMX_SceneChange.c
+
+LOCAL_MODULE := scene_change_test
+LOCAL_MODULE_TAGS := tests
+
+LOCAL_C_INCLUDES := $(SEC_OMX_INC)/khronos \
+	$(SEC_OMX_INC)/sec \
+	$(SEC_OMX_TOP)/osal \
+	$(LOCAL_PATH)/..
+
+include $(BUILD_HOST_EXECUTABLE)
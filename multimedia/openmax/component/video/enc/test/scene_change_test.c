@@ -0,0 +1,125 @@
+/*
+ *
+ * Copyright 2010 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Feeds flat dark and bright frames to the scene change detector:
+ *   - a cut between two runs of frames requests an IDR,
+ *   - a run without a cut does not,
+ *   - the first frame after SEC_SceneChange_Reset(), as done on an input
+ *     port flush, is not compared against the frame before the flush.
+ * Linear and NV12T layouts are both checked.
+ *
+ * usage: scene_change_test
+ * Returns 1 on failure.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SEC_OSAL_Memory.h"
+#include "SEC_OSAL_Log.h"
+#include "SEC_OMX_SceneChange.h"
+
+#define WIDTH   (256)
+#define HEIGHT  (128)
+#define DARK    (20)
+#define BRIGHT  (200)
+
+static OMX_U8 frame[WIDTH * HEIGHT];
+
+OMX_PTR SEC_OSAL_Malloc(OMX_U32 size)
+{
+    return malloc(size);
+}
+
+void SEC_OSAL_Free(OMX_PTR addr)
+{
+    free(addr);
+}
+
+OMX_PTR SEC_OSAL_Memset(OMX_PTR dest, OMX_S32 c, OMX_S32 n)
+{
+    return memset(dest, c, n);
+}
+
+void _SEC_OSAL_Log(SEC_LOG_LEVEL logLevel, const char *tag, const char *msg, ...)
+{
+}
+
+static void init(SEC_OMX_VIDEOENC_SCENECHANGE *pSceneChange)
+{
+    memset(pSceneChange, 0, sizeof(*pSceneChange));
+    pSceneChange->bEnable = OMX_TRUE;
+    pSceneChange->nSADThreshold = DEFAULT_SCENECHANGE_SAD_THRESHOLD;
+    pSceneChange->nHistThreshold = DEFAULT_SCENECHANGE_HIST_THRESHOLD;
+    pSceneChange->nMinIntraDistance = 1;
+}
+
+/* number of IDR requests for count frames of one luma value */
+static int feed(SEC_OMX_VIDEOENC_SCENECHANGE *pSceneChange, OMX_U8 luma, int count, OMX_BOOL bTiled)
+{
+    int idr = 0;
+
+    memset(frame, luma, sizeof(frame));
+    while (count-- > 0) {
+        if (SEC_SceneChange_Process(pSceneChange, frame, WIDTH, HEIGHT, bTiled) == OMX_TRUE)
+            idr++;
+    }
+
+    return idr;
+}
+
+static int check(const char *name, int idr, int expect)
+{
+    printf("%-32s %d IDR (want %d)%s\n", name, idr, expect, (idr == expect) ? "" : "  <-- FAILED");
+    return idr == expect;
+}
+
+static int run(OMX_BOOL bTiled)
+{
+    SEC_OMX_VIDEOENC_SCENECHANGE sceneChange;
+    int ok = 1;
+
+    printf("%s\n", bTiled ? "NV12T" : "linear");
+
+    init(&sceneChange);
+    ok &= check("dark, dark", feed(&sceneChange, DARK, 4, bTiled), 0);
+    ok &= check("dark, then bright", feed(&sceneChange, BRIGHT, 4, bTiled), 1);
+    SEC_SceneChange_Deinit(&sceneChange);
+
+    init(&sceneChange);
+    feed(&sceneChange, DARK, 4, bTiled);
+    SEC_SceneChange_Reset(&sceneChange);
+    ok &= check("dark, flush, then bright", feed(&sceneChange, BRIGHT, 4, bTiled), 0);
+    ok &= check("bright after flush, then dark", feed(&sceneChange, DARK, 1, bTiled), 1);
+    SEC_SceneChange_Deinit(&sceneChange);
+
+    return ok;
+}
+
+int main(void)
+{
+    int ret = 0;
+
+    if (!run(OMX_FALSE))
+        ret = 1;
+    if (!run(OMX_TRUE))
+        ret = 1;
+
+    return ret;
+}
@@ -70,6 +70,10 @@ typedef enum _SEC_OMX_INDEXTYPE
     OMX_IndexVendorThumbnailMode        = 0x7F000001,
 #define SEC_INDEX_CONFIG_VIDEO_INTRAPERIOD "OMX.SEC.index.VideoIntraPeriod"
     OMX_IndexConfigVideoIntraPeriod     = 0x7F000002,
+#define SEC_INDEX_CONFIG_VIDEO_SCENECHANGE "OMX.SEC.index.VideoSceneChange"
+    OMX_IndexConfigVideoSceneChange     = 0x7F000003,
+#define SEC_INDEX_CONFIG_BUFFER_BATCH "OMX.SEC.index.BufferBatch"
+    OMX_IndexConfigBufferBatch          = 0x7F000004,
 
     /* for Android Native Window */
 #define SEC_INDEX_PARAM_ENABLE_ANB "OMX.google.android.index.enableAndroidNativeBuffers"
@@ -168,6 +172,35 @@ typedef struct _OMXComponentCapabilityFlagsType
     OMX_BOOL iOMXComponentUsesFullAVCFrames;
 } OMXComponentCapabilityFlagsType;
 
+/* scene change detection of video encoder input */
+typedef struct _SEC_OMX_VIDEO_CONFIG_SCENECHANGETYPE
+{
+    OMX_U32         nSize;
+    OMX_VERSIONTYPE nVersion;
+    OMX_U32         nPortIndex;
+    OMX_BOOL        bEnable;
+    OMX_U32         nSADThreshold;      /* mean abs diff of block luma, 0 ~ 255 */
+    OMX_U32         nHistThreshold;     /* luma histogram distance, 0 ~ 1000 */
+    OMX_U32         nMinIntraDistance;  /* min frames between forced IDRs */
+    OMX_U32         nLastSADScore;      /* read only */
+    OMX_U32         nLastHistScore;     /* read only */
+    OMX_U32         nFrameCount;        /* read only */
+    OMX_U32         nSceneChangeCount;  /* read only */
+} SEC_OMX_VIDEO_CONFIG_SCENECHANGETYPE;
+
+/*
+ * submit several buffer headers in one call,
+ * EmptyThisBuffer for input port and FillThisBuffer for output port
+ */
+typedef struct _SEC_OMX_CONFIG_BUFFERBATCHTYPE
+{
+    OMX_U32                       nSize;
+    OMX_VERSIONTYPE               nVersion;
+    OMX_U32                       nPortIndex;
+    OMX_U32                       nBufferCount;
+    struct OMX_BUFFERHEADERTYPE **ppBufferHeader;
+} SEC_OMX_CONFIG_BUFFERBATCHTYPE;
+
 typedef struct _SEC_OMX_VIDEO_PROFILELEVEL
 {
     OMX_S32  profile;
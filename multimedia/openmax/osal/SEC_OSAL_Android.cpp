@@ -100,6 +100,7 @@ OMX_ERRORTYPE useAndroidNativeBuffer(
                 temp_bufferHeader->nInputPortIndex = INPUT_PORT_INDEX;
             else
                 temp_bufferHeader->nOutputPortIndex = OUTPUT_PORT_INDEX;
+            SET_BUFFER_HEADER_INDEX(temp_bufferHeader, nPortIndex, i);
 
             pSECPort->assignedBufferNum++;
             if (pSECPort->assignedBufferNum == pSECPort->portDefinition.nBufferCountActual) {
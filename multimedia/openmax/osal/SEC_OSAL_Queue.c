@@ -125,6 +125,41 @@ int SEC_OSAL_Queue(SEC_QUEUE *queueHandle, void *data)
     return 0;
 }
 
+/* queue all of data[] under one lock, or nothing if there is no room */
+int SEC_OSAL_QueueBatch(SEC_QUEUE *queueHandle, void **data, int num)
+{
+    SEC_QUEUE *queue = (SEC_QUEUE *)queueHandle;
+    SEC_QElem *qelem = NULL;
+    int i = 0;
+
+    if ((queue == NULL) || (data == NULL) || (num <= 0))
+        return -1;
+
+    SEC_OSAL_MutexLock(queue->qMutex);
+
+    if (queue->numElem + num > MAX_QUEUE_ELEMENTS) {
+        SEC_OSAL_MutexUnlock(queue->qMutex);
+        return -1;
+    }
+    qelem = queue->last;
+    for (i = 0; i < num; i++) {
+        if (qelem->data != NULL) {
+            SEC_OSAL_MutexUnlock(queue->qMutex);
+            return -1;
+        }
+        qelem = qelem->qNext;
+    }
+
+    for (i = 0; i < num; i++) {
+        queue->last->data = data[i];
+        queue->last = queue->last->qNext;
+    }
+    queue->numElem += num;
+
+    SEC_OSAL_MutexUnlock(queue->qMutex);
+    return 0;
+}
+
 void *SEC_OSAL_Dequeue(SEC_QUEUE *queueHandle)
 {
     void *data = NULL;
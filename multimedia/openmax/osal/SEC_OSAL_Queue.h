@@ -55,6 +55,7 @@ extern "C" {
 OMX_ERRORTYPE SEC_OSAL_QueueCreate(SEC_QUEUE *queueHandle);
 OMX_ERRORTYPE SEC_OSAL_QueueTerminate(SEC_QUEUE *queueHandle);
 int           SEC_OSAL_Queue(SEC_QUEUE *queueHandle, void *data);
+int           SEC_OSAL_QueueBatch(SEC_QUEUE *queueHandle, void **data, int num);
 void         *SEC_OSAL_Dequeue(SEC_QUEUE *queueHandle);
 int           SEC_OSAL_GetElemNum(SEC_QUEUE *queueHandle);
 int           SEC_OSAL_SetElemNum(SEC_QUEUE *queueHandle, int ElemNum);
@@ -170,6 +170,15 @@ static CSC_ERRORCODE conv_sw_src_argb888(
             handle->src_format.height);
         ret = CSC_ErrorNone;
         break;
+    case HAL_PIXEL_FORMAT_YCbCr_420_SP_TILED:
+        csc_ARGB8888_to_NV12T_NEON(
+            (unsigned char *)handle->dst_buffer.planes[CSC_Y_PLANE],
+            (unsigned char *)handle->dst_buffer.planes[CSC_UV_PLANE],
+            (unsigned char *)handle->src_buffer.planes[CSC_RGB_PLANE],
+            handle->src_format.width,
+            handle->src_format.height);
+        ret = CSC_ErrorNone;
+        break;
     default:
         ret = CSC_ErrorUnsupportFormat;
         break;